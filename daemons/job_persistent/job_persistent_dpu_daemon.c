@@ -10,6 +10,7 @@
 #include <stdio.h>
 #include <unistd.h>
 #include <assert.h>
+#include <inttypes.h>
 
 #include "dpu_offload_service_daemon.h"
 #include "dpu_offload_envvars.h"
@@ -75,12 +76,26 @@ int main(int argc, char **argv)
     fprintf(stderr, "server for application processes to connect has been successfully created\n");
 
     /*
-     * PROGRESS UNTIL ALL PROCESSES ON THE HOST SEND A TERMINATION MESSAGE
+     * PROGRESS UNTIL ALL PROCESSES ON THE HOST SEND A TERMINATION MESSAGE.
+     * Up to MIMOSA_MAX_JOBS jobs are served: between two jobs, only the per-job
+     * state is released, the connections between DPUs are kept.
      */
     fprintf(stderr, "%s: progressing...\n", argv[0]);
-    while (!EXECUTION_CONTEXT_DONE(service_server))
+    while (true)
     {
-        lib_progress(service_server);
+        while (!EXECUTION_CONTEXT_DONE(service_server))
+        {
+            lib_progress(service_server);
+        }
+        if (offload_engine->settings.max_jobs != 0 && offload_engine->num_jobs + 1 >= offload_engine->settings.max_jobs)
+            break;
+        rc = offload_engine_job_reset(offload_engine);
+        if (rc)
+        {
+            fprintf(stderr, "offload_engine_job_reset() failed\n");
+            break;
+        }
+        fprintf(stderr, "%s: job #%" PRIu64 " done, waiting for the next one...\n", argv[0], offload_engine->num_jobs);
     }
 
     fprintf(stderr, "%s: server done, finalizing...\n", argv[0]);
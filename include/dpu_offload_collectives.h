@@ -0,0 +1,316 @@
+//
+// Copyright (c) 2023, NVIDIA CORPORATION. All rights reserved.
+//
+// See LICENSE.txt for license information
+//
+
+#include <inttypes.h>
+
+#include "dpu_offload_types.h"
+
+#ifndef DPU_OFFLOAD_COLLECTIVES_H
+#define DPU_OFFLOAD_COLLECTIVES_H
+
+/*
+ * Collective operations implemented by the library on top of the operation framework (see
+ * dpu_offload_ops.h). They are registered on every engine by offload_engine_init(): the ranks post
+ * an operation to their service process and return, the service processes execute it and the
+ * descriptor of each rank completes once its part of the collective is done.
+ */
+
+// Algorithm IDs reserved for the operations implemented by the library
+#define OP_ALG_BUILTIN_BASE (UINT64_C(0xFFFFFFFF00000000))
+#define OP_ALG_ALLTOALLV (OP_ALG_BUILTIN_BASE + 1)
+#define OP_ALG_ALLREDUCE (OP_ALG_BUILTIN_BASE + 2)
+#define OP_ALG_BCAST (OP_ALG_BUILTIN_BASE + 3)
+
+/**************/
+/* ALLTOALLV  */
+/**************/
+
+typedef struct alltoallv_params
+{
+    group_uid_t gp_uid;
+    int64_t group_rank;
+    int64_t group_size;
+
+    // Size in bytes of the datatype, counts and displacements are expressed in number of elements
+    size_t dt_size;
+
+    const void *sendbuf;
+    const int64_t *sendcounts;
+    const int64_t *sdispls;
+    void *recvbuf;
+    const int64_t *recvcounts;
+    const int64_t *rdispls;
+
+    // Memory keys of the send and receive buffers exported to the service process, i.e., the XGVMI
+    // keys otherwise given to the service process with send_key_to_dpu()
+    const void *send_key;
+    size_t send_key_len;
+    const void *recv_key;
+    size_t recv_key_len;
+} alltoallv_params_t;
+
+/*
+ * Arguments of an alltoallv operation as sent to the service process, followed by the send counts,
+ * send displacements, receive counts and receive displacements (group_size elements each) and the
+ * send and receive keys.
+ */
+typedef struct alltoallv_args
+{
+    int64_t group_size;
+    uint64_t dt_size;
+    uint64_t send_key_len;
+    uint64_t recv_key_len;
+} alltoallv_args_t;
+
+/**
+ * @brief Post an alltoallv to the service process of the calling rank. The function returns once the
+ * operation is submitted; the service processes of the group then move the data with RMA transfers,
+ * at most MIMOSA_ALLTOALLV_WINDOW of them in flight for each rank, and the descriptor completes once
+ * the data of the rank is sent and all the data it expects is received. The buffers must not be
+ * modified or released until then. All the ranks of the group must post the alltoallv with the same
+ * id.
+ *
+ * @param[in] econtext Client execution context to the service process of the rank.
+ * @param[in] id Identifier of the collective operation, the same for all the ranks.
+ * @param[in] params Description of the alltoallv, the arrays can be released once the function returns.
+ * @param[out] desc Descriptor of the operation, to return with op_desc_return() once completed.
+ * @return dpu_offload_status_t
+ */
+dpu_offload_status_t alltoallv_post(execution_context_t *econtext, uint64_t id, alltoallv_params_t *params, op_desc_t **desc);
+
+/**
+ * @brief Register the alltoallv operation with an engine, invoked by offload_engine_init().
+ */
+dpu_offload_status_t alltoallv_register(offloading_engine_t *engine);
+
+/**
+ * @brief Get the order in which the operation of a rank sends its ready-to-receive messages to the
+ * ranks it receives data from: the ranks on other hosts first, so the transfers through the network
+ * start early, then the ranks on the same host, both in rank order starting after the rank.
+ *
+ * @param[in] group_rank Rank whose order is computed.
+ * @param[in] group_size Number of ranks in the group.
+ * @param[in] recvcounts Number of elements the rank receives from every rank.
+ * @param[in] hosts Host of every rank.
+ * @param[out] order Array of at least group_size elements receiving the ranks.
+ * @return size_t Number of ranks the rank receives data from.
+ */
+size_t alltoallv_get_rtr_order(int64_t group_rank, int64_t group_size, const int64_t *recvcounts, const uint64_t *hosts, int64_t *order);
+
+/**************/
+/* REDUCTIONS */
+/**************/
+
+typedef enum
+{
+    REDUCE_OP_SUM = 0,
+    REDUCE_OP_PROD,
+    REDUCE_OP_MIN,
+    REDUCE_OP_MAX,
+    REDUCE_OP_LAST,
+} reduce_op_t;
+
+typedef enum
+{
+    REDUCE_DT_INT32 = 0,
+    REDUCE_DT_INT64,
+    REDUCE_DT_FLOAT,
+    REDUCE_DT_DOUBLE,
+    REDUCE_DT_LAST,
+} reduce_dt_t;
+
+/**
+ * @brief Size in bytes of an element of a reduction datatype.
+ *
+ * @return size_t 0 if the datatype is not supported.
+ */
+size_t reduce_dt_size(reduce_dt_t dt);
+
+/**
+ * @brief Reduce two arrays element-wise, i.e., inout[i] = inout[i] op in[i]. The kernels are
+ * vectorized and only use the CPU; the arrays do not need to be aligned but must not overlap.
+ *
+ * @param[in] op Reduction operation.
+ * @param[in] dt Datatype of the elements.
+ * @param[in,out] inout First operand and result.
+ * @param[in] in Second operand.
+ * @param[in] count Number of elements.
+ * @return dpu_offload_status_t DO_ERROR if the operation or datatype is not supported.
+ */
+dpu_offload_status_t reduce_kernel(reduce_op_t op, reduce_dt_t dt, void *inout, const void *in, size_t count);
+
+/**************/
+/* ALLREDUCE  */
+/**************/
+
+typedef struct allreduce_params
+{
+    group_uid_t gp_uid;
+    int64_t group_rank;
+    int64_t group_size;
+
+    reduce_op_t op;
+    reduce_dt_t dt;
+    // Number of elements
+    size_t count;
+
+    const void *sendbuf;
+    void *recvbuf;
+} allreduce_params_t;
+
+/*
+ * Arguments of an allreduce operation as sent to the service process, followed by the remote keys of
+ * the send and receive buffers.
+ */
+typedef struct allreduce_args
+{
+    int64_t group_size;
+    uint64_t op;
+    uint64_t dt;
+    uint64_t count;
+    uint64_t send_rkey_len;
+    uint64_t recv_rkey_len;
+} allreduce_args_t;
+
+/**
+ * @brief Post an allreduce to the service process of the calling rank. The buffers are registered
+ * and their remote keys sent with the operation; the service process reads the contribution of the
+ * rank, reduces the contributions of its local ranks, combines its result with the other service
+ * processes of the group (recursive doubling) and writes the result to the receive buffer before the
+ * descriptor completes. The buffers must not be modified or released until then. All the ranks of
+ * the group must post the allreduce with the same id.
+ *
+ * @param[in] econtext Execution context to the service process of the rank, i.e., a client execution
+ * context, or the self execution context when the calling process is the service process.
+ * @param[in] id Identifier of the collective operation, the same for all the ranks.
+ * @param[in] params Description of the allreduce.
+ * @param[out] desc Descriptor of the operation, to return with op_desc_return() once completed.
+ * @return dpu_offload_status_t
+ */
+dpu_offload_status_t allreduce_post(execution_context_t *econtext, uint64_t id, allreduce_params_t *params, op_desc_t **desc);
+
+/**
+ * @brief Register the allreduce operation with an engine, invoked by offload_engine_init().
+ */
+dpu_offload_status_t allreduce_register(offloading_engine_t *engine);
+
+/**
+ * @brief Get the leaders of an allreduce, i.e., the lowest rank associated to each service process of
+ * the group, in rank order. The service processes exchange data through their leader.
+ *
+ * @param[in] sp_ids Global ID of the service process of every rank of the group.
+ * @param[in] group_size Number of ranks in the group.
+ * @param[out] leaders Array of at least group_size elements receiving the leaders.
+ * @return size_t Number of leaders, i.e., of service processes involved in the group.
+ */
+size_t allreduce_get_leaders(const int64_t *sp_ids, int64_t group_size, int64_t *leaders);
+
+/**
+ * @brief Get the number of steps of the recursive doubling between the leaders of an allreduce, not
+ * counting the step in which the leaders beyond the largest power of two fold their data.
+ */
+size_t allreduce_get_num_steps(size_t num_leaders);
+
+/**
+ * @brief Get the peer of a leader at a step of the exchange between the leaders of an allreduce.
+ * Step 0 is the fold: the leaders beyond the largest power of two send their data to a peer, which
+ * sends the result back at the end. Steps 1 to allreduce_get_num_steps() are the recursive doubling,
+ * in which the leaders below the largest power of two exchange their data with a peer.
+ *
+ * @param[in] num_leaders Number of leaders.
+ * @param[in] leader_idx Index of the leader, in rank order.
+ * @param[in] step Step of the exchange.
+ * @return int64_t Index of the peer, -1 if the leader does not exchange data at that step.
+ */
+int64_t allreduce_get_step_peer(size_t num_leaders, size_t leader_idx, size_t step);
+
+/**************/
+/* BCAST      */
+/**************/
+
+/*
+ * Segmented broadcast between service processes. The data is split in segments that travel down a
+ * k-nomial or chain tree rooted at the service process posting the broadcast, every service process
+ * forwarding a segment to its children as soon as it receives it. The operation is implicit on the
+ * other service processes (see offload_op_t): they do not post anything, they get the data through
+ * the handler registered for its type once all the segments are received.
+ */
+
+// Types of the broadcasts used by the library, see bcast_register_handler()
+#define BCAST_TYPE_GROUP_CACHE (0)
+
+typedef struct bcast_params
+{
+    // Group the broadcast relates to, if any, INT_MAX otherwise. Identifies the broadcast with its id.
+    group_uid_t gp_uid;
+
+    // Type of the data, selects the handler invoked on the other service processes
+    uint64_t type;
+
+    const void *buf;
+    size_t len;
+
+    // Shape of the tree and size of the segments, BCAST_TREE_DEFAULT and 0 for the engine settings
+    // (see MIMOSA_BCAST_TREE, MIMOSA_BCAST_RADIX and MIMOSA_BCAST_SEGMENT_SIZE)
+    bcast_tree_t tree;
+    size_t radix;
+    size_t segment_size;
+} bcast_params_t;
+
+// Arguments of a broadcast operation as sent to the execution context of the root
+typedef struct bcast_args
+{
+    uint64_t type;
+    uint64_t tree;
+    uint64_t radix;
+    uint64_t segment_size;
+} bcast_args_t;
+
+/**
+ * @brief Broadcast data from the calling service process to all the other service processes of the
+ * engine. The descriptor completes once all the segments are sent to the children of the service
+ * process in the tree; the buffer must not be modified or released until then. The handler of the
+ * type of the broadcast is not invoked on the calling service process.
+ *
+ * @param[in] econtext Self execution context of the service process.
+ * @param[in] id Identifier of the broadcast, unique among the broadcasts in flight with the same
+ * gp_uid, for instance by including the global ID of the calling service process.
+ * @param[in] params Description of the broadcast.
+ * @param[out] desc Descriptor of the operation, to return with op_desc_return() once completed.
+ * @return dpu_offload_status_t
+ */
+dpu_offload_status_t bcast_post(execution_context_t *econtext, uint64_t id, bcast_params_t *params, op_desc_t **desc);
+
+/**
+ * @brief Set the function invoked on the service processes receiving a broadcast of a given type.
+ * The data is only valid for the time of the call.
+ *
+ * @param[in] engine Engine of the service process.
+ * @param[in] type Type of the broadcasts, lower than BCAST_MAX_TYPES.
+ * @param[in] cb Handler of the broadcasts.
+ * @return dpu_offload_status_t
+ */
+dpu_offload_status_t bcast_register_handler(offloading_engine_t *engine, uint64_t type, bcast_deliver_fn cb);
+
+/**
+ * @brief Register the broadcast operation with an engine, invoked by offload_engine_init().
+ */
+dpu_offload_status_t bcast_register(offloading_engine_t *engine);
+
+/**
+ * @brief Get the children of a service process in the tree of a broadcast.
+ *
+ * @param[in] tree Shape of the tree, BCAST_TREE_KNOMIAL or BCAST_TREE_CHAIN.
+ * @param[in] radix Radix of the k-nomial tree, at least 2.
+ * @param[in] num_sps Number of service processes.
+ * @param[in] root Global ID of the root of the broadcast.
+ * @param[in] me Global ID of the service process.
+ * @param[out] children Array of at least num_sps elements receiving the global IDs of the children.
+ * @return size_t Number of children.
+ */
+size_t bcast_get_children(bcast_tree_t tree, size_t radix, size_t num_sps, uint64_t root, uint64_t me, uint64_t *children);
+
+#endif // DPU_OFFLOAD_COLLECTIVES_H
@@ -55,6 +55,212 @@
  */
 #define MIMOSA_PERSISTENT_CACHE "MIMOSA_PERSISTENT_CACHE"
 
+/**
+ * @brief Environment variable defining the memory budget, in bytes, of the endpoint cache.
+ * When the budget is exceeded, group caches of revoked groups are evicted and the lookup tables
+ * of groups are released, least recently used first. If not defined or set to 0, the memory
+ * budget is unlimited.
+ */
+#define MIMOSA_GROUP_CACHE_MEM_BUDGET "MIMOSA_GROUP_CACHE_MEM_BUDGET"
+
+/**
+ * @brief Environment variable defining the maximum number of evicted groups whose sequence
+ * number is kept so they can be re-created. Once the limit is reached, no group is evicted
+ * anymore. Default: DEFAULT_GROUP_CACHE_MAX_EVICTED_GROUPS.
+ */
+#define MIMOSA_GROUP_CACHE_MAX_EVICTED_GROUPS "MIMOSA_GROUP_CACHE_MAX_EVICTED_GROUPS"
+
+/**
+ * @brief Environment variable defining the maximum number of endpoints to ranks that are kept
+ * open while not used by any group, e.g., after the groups of a rank are revoked. When the
+ * limit is exceeded, the least recently used endpoints are closed. If not defined, idle
+ * endpoints are never closed.
+ */
+#define MIMOSA_EP_POOL_MAX_IDLE "MIMOSA_EP_POOL_MAX_IDLE"
+
+/**
+ * @brief Environment variable defining the time budget, in microseconds, of each slice of the
+ * construction of the lookup tables of a group. Large groups have their lookup tables built
+ * across several progress calls so progress is never blocked longer than the budget. If set
+ * to 0, the lookup tables are built in a single step. Default: DEFAULT_LOOKUP_TABLES_BUILD_BUDGET_US.
+ */
+#define MIMOSA_LOOKUP_TABLES_BUILD_BUDGET "MIMOSA_LOOKUP_TABLES_BUILD_BUDGET"
+
+/**
+ * @brief Environment variable defining whether the timelines of the group caches, i.e., when
+ * each group reached the different milestones of its creation, and the latency histograms
+ * aggregated across groups are displayed on stderr when the engine is finalized (1) or not (0).
+ */
+#define MIMOSA_GROUP_CACHE_TIMELINES "MIMOSA_GROUP_CACHE_TIMELINES"
+
+/**
+ * @brief Environment variable defining the maximum time, in milliseconds, a client keeps trying
+ * to connect to its server, e.g., when ranks start before their service process is listening.
+ * If not defined or set to 0, the client tries until the connection succeeds, except for
+ * connections to other service processes that fail after DEFAULT_INTER_SP_CONNECT_TIMEOUT_MS
+ * and are restarted (see MIMOSA_INTER_SP_CONNECT_RETRIES).
+ */
+#define MIMOSA_CONNECT_TIMEOUT "MIMOSA_CONNECT_TIMEOUT"
+
+/**
+ * @brief Environment variables defining the bounds, in microseconds, of the delay between two
+ * attempts to connect to a server. The delay starts at the lower bound and doubles after each
+ * failed attempt, up to the upper bound, with random jitter so clients started at the same time
+ * do not retry in lockstep. Defaults: DEFAULT_CONNECT_BACKOFF_MIN_US and DEFAULT_CONNECT_BACKOFF_MAX_US.
+ */
+#define MIMOSA_CONNECT_BACKOFF_MIN "MIMOSA_CONNECT_BACKOFF_MIN"
+#define MIMOSA_CONNECT_BACKOFF_MAX "MIMOSA_CONNECT_BACKOFF_MAX"
+
+/**
+ * @brief Environment variable defining whether client_init() returns right away and the
+ * connection to the server is established while progressing the execution context (1), or
+ * client_init() blocks until the connection is established (0, default).
+ */
+#define MIMOSA_ASYNC_CONNECT "MIMOSA_ASYNC_CONNECT"
+
+/**
+ * @brief Environment variable defining whether service processes connect to each other
+ * on first use (1) instead of building a full mesh when they start (0, default). In on-demand
+ * mode, notifications to a service process that is not connected yet are queued and sent once
+ * the connection is established. Best combined with MIMOSA_ASYNC_CONNECT so that the first
+ * use of a connection does not block.
+ */
+#define MIMOSA_LAZY_INTER_SP_CONNECT "MIMOSA_LAZY_INTER_SP_CONNECT"
+
+/**
+ * @brief Environment variable defining the maximum number of outgoing connections to other
+ * service processes that are in progress at the same time while building the full mesh.
+ * Default: DEFAULT_INTER_SP_CONNECT_MAX_INFLIGHT; 0 means no limit.
+ */
+#define MIMOSA_INTER_SP_CONNECT_MAX_INFLIGHT "MIMOSA_INTER_SP_CONNECT_MAX_INFLIGHT"
+
+/**
+ * @brief Environment variable defining how many times a connection to another service process
+ * is restarted when it cannot be established before the deadline, i.e., MIMOSA_CONNECT_TIMEOUT
+ * or DEFAULT_INTER_SP_CONNECT_TIMEOUT_MS when MIMOSA_CONNECT_TIMEOUT is not set.
+ * Default: DEFAULT_INTER_SP_CONNECT_RETRIES.
+ */
+#define MIMOSA_INTER_SP_CONNECT_RETRIES "MIMOSA_INTER_SP_CONNECT_RETRIES"
+
+/**
+ * @brief Environment variable selecting how clients get the worker address of their server:
+ * "oob" (default) through a socket connection to the server; "file" by reading the address the
+ * server published in a directory, e.g., on a shared filesystem; "shm" by reading the address
+ * the server published in a POSIX shared memory segment, which requires the client and the
+ * server to run on the same node. All the processes of a job must use the same backend.
+ */
+#define MIMOSA_RENDEZVOUS "MIMOSA_RENDEZVOUS"
+
+/**
+ * @brief Environment variable defining where servers publish their address with the "file"
+ * (directory, default: DEFAULT_RENDEZVOUS_DIR) and "shm" (name prefix of the shared memory
+ * segments, default: DEFAULT_RENDEZVOUS_SHM_PREFIX) rendezvous backends.
+ */
+#define MIMOSA_RENDEZVOUS_PATH "MIMOSA_RENDEZVOUS_PATH"
+
+/**
+ * @brief Environment variable defining the directory where each process records when the phases
+ * of the bootstrapping of its connections begin and end (see dpu_offload_trace.h). The records
+ * can be converted to the Chrome trace format with mimosa_trace2json. If not defined, nothing
+ * is recorded.
+ */
+#define MIMOSA_TRACE_DIR "MIMOSA_TRACE_DIR"
+
+/**
+ * @brief Environment variable defining the number of records of the trace ring of a process,
+ * the oldest records being overwritten once the ring is full. Default: DEFAULT_TRACE_RING_SIZE.
+ */
+#define MIMOSA_TRACE_RING_SIZE "MIMOSA_TRACE_RING_SIZE"
+
+/**
+ * @brief Environment variable defining how long, in milliseconds, a server keeps the slot of a
+ * client that disconnected so the client can resume with the same identifier, e.g., when the
+ * ranks of back-to-back jobs on the same host connect to a job-persistent daemon. The client is
+ * given a new resume token every time it connects. Default: 0, clients never resume.
+ */
+#define MIMOSA_RESUME_TTL "MIMOSA_RESUME_TTL"
+
+/**
+ * @brief Environment variable defining the directory where clients keep the resume tokens given by
+ * their servers, one file per server and group rank. If not defined, clients do not resume.
+ */
+#define MIMOSA_RESUME_DIR "MIMOSA_RESUME_DIR"
+
+/**
+ * @brief Environment variable defining how many jobs a job-persistent service process, e.g.,
+ * daemons/job_persistent, serves before exiting; 0 means no limit. Between two jobs, only the
+ * per-job state is released (see offload_engine_job_reset()), the connections between service
+ * processes are kept. Default: 1, or 0 when clients can resume (see MIMOSA_RESUME_TTL).
+ */
+#define MIMOSA_MAX_JOBS "MIMOSA_MAX_JOBS"
+
+/**
+ * @brief Environment variable defining the maximum number of RMA transfers a service process keeps
+ * in flight for each rank of an offloaded alltoallv (see alltoallv_post()). Default: 8.
+ */
+#define MIMOSA_ALLTOALLV_WINDOW "MIMOSA_ALLTOALLV_WINDOW"
+
+/**
+ * @brief Environment variable defining the default size in bytes of the segments of a broadcast
+ * between service processes (see bcast_post()). Segments are forwarded down the tree as soon as
+ * they are received. Default: 64KB.
+ */
+#define MIMOSA_BCAST_SEGMENT_SIZE "MIMOSA_BCAST_SEGMENT_SIZE"
+
+/**
+ * @brief Environment variable defining the default tree of the broadcasts between service
+ * processes: "knomial" or "chain". Default: knomial.
+ */
+#define MIMOSA_BCAST_TREE "MIMOSA_BCAST_TREE"
+
+/**
+ * @brief Environment variable defining the default radix of the k-nomial tree of the broadcasts
+ * between service processes, at least 2. Default: 2, i.e., a binomial tree.
+ */
+#define MIMOSA_BCAST_RADIX "MIMOSA_BCAST_RADIX"
+
+/**
+ * @brief Environment variable defining the size in bytes of the cache entries of the local ranks of
+ * a group from which a service process distributes them to the other service processes with a
+ * broadcast rather than sending them to each of them; 0 disables the broadcast. Default: 64KB, the
+ * default size of a broadcast segment, i.e., the entries of a few tens of ranks.
+ */
+#define MIMOSA_CACHE_BCAST_THRESHOLD "MIMOSA_CACHE_BCAST_THRESHOLD"
+
+/**
+ * @brief Environment variable defining the time budget in microseconds of the progress of the
+ * operations of an execution context every time it is progressed, 0 meaning unlimited. Operations
+ * of the highest priority are progressed first. Default: 0.
+ */
+#define MIMOSA_OPS_PROGRESS_BUDGET "MIMOSA_OPS_PROGRESS_BUDGET"
+
+/**
+ * @brief Environment variable defining the maximum number of RMA transfers in flight across all
+ * the offloaded operations of a service process, 0 meaning unlimited (see op_rma_acquire()).
+ * Default: 64.
+ */
+#define MIMOSA_OPS_MAX_RMA "MIMOSA_OPS_MAX_RMA"
+
+/**
+ * @brief Environment variable defining the default weight of the queues of operations, one per
+ * group (see op_queue_set_weight()). Default: 1.
+ */
+#define MIMOSA_OP_QUEUE_WEIGHT "MIMOSA_OP_QUEUE_WEIGHT"
+
+/**
+ * @brief Environment variable defining the time in milliseconds after which a message between service
+ * processes that was not delivered to an operation is dropped, 0 meaning never. It is also how long
+ * the messages sent to a collective operation that reached a final state keep being dropped, so its
+ * ID must not be reused by the same group in the meantime. Default: 60000.
+ */
+#define MIMOSA_OP_MSG_TIMEOUT "MIMOSA_OP_MSG_TIMEOUT"
+
+/**
+ * @brief Environment variable defining whether the statistics of the queues of operations are
+ * displayed on stderr at the end of each job and when the engine is finalized (1) or not (0).
+ */
+#define MIMOSA_DUMP_OP_QUEUE_STATS "MIMOSA_DUMP_OP_QUEUE_STATS"
+
 #define DPU_OFFLOAD_DBG_VERBOSE "DPU_OFFLOAD_DBG_VERBOSE"
 
 #endif // DPU_OFFLOAD_ENVVARS_H
\ No newline at end of file
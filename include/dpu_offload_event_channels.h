@@ -276,4 +276,11 @@ dpu_offload_status_t send_term_msg(execution_context_t *ctx, dest_client_t *dest
 dpu_offload_status_t send_revoke_group_to_ranks(offloading_engine_t *engine, group_uid_t gp_uid, uint64_t num_ranks);
 dpu_offload_status_t handle_pending_group_cache_add_msgs(group_cache_t *group_cache);
 
+/**
+ * @brief Handle cache entries of local ranks received from another service process, either with a
+ * notification or a broadcast (see BCAST_TYPE_GROUP_CACHE). The entries are queued if the group is
+ * being revoked.
+ */
+dpu_offload_status_t recv_peer_cache_entries(execution_context_t *econtext, uint64_t sp_global_id, void *data, size_t data_len);
+
 #endif // DPU_OFFLOAD_EVENT_CHANNELS_H_
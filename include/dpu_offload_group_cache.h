@@ -17,6 +17,8 @@ extern execution_context_t *get_server_servicing_host(offloading_engine_t *engin
     {                                                                                        \
         RESET_CACHE(_cache);                                                                 \
         (_cache)->data = kh_init(group_hash_t);                                              \
+        (_cache)->evicted_groups = kh_init(evicted_groups_hash_t);                           \
+        (_cache)->bitset_pool = kh_init(group_cache_bitset_pool_t);                          \
         DYN_LIST_ALLOC((_cache)->group_cache_pool, DEFAULT_NUM_GROUPS, group_cache_t, item); \
     } while (0)
 
@@ -42,6 +44,21 @@ extern execution_context_t *get_server_servicing_host(offloading_engine_t *engin
             }                                                               \
     } while (0)
 
+// Drop the requests for cache entries from local ranks that are still waiting for entries
+// from other SPs, e.g., when the group is revoked.
+#define GROUP_CACHE_DROP_HOST_CACHE_REQUESTS(_gp_cache)                                              \
+    do                                                                                               \
+    {                                                                                                \
+        pending_host_cache_request_t *_host_req = NULL, *_next_host_req = NULL;                      \
+        ucs_list_for_each_safe(_host_req, _next_host_req,                                            \
+                               &((_gp_cache)->persistent.pending_host_cache_requests),               \
+                               item)                                                                 \
+        {                                                                                            \
+            ucs_list_del(&(_host_req->item));                                                        \
+            DYN_LIST_RETURN((_gp_cache)->engine->pool_pending_host_cache_requests, _host_req, item); \
+        }                                                                                            \
+    } while (0)
+
 #define GROUP_CACHE_TERMINATE_PENDING_MSGS(_gp_cache)                                                           \
     do                                                                                                          \
     {                                                                                                           \
@@ -59,9 +76,8 @@ extern execution_context_t *get_server_servicing_host(offloading_engine_t *engin
                                item)                                                                            \
         {                                                                                                       \
             ucs_list_del(&(_pending_revoke_from_sp->item));                                                     \
-            DYN_LIST_RETURN((_gp_cache)->engine->pool_group_revoke_msgs_from_sps,                               \
-                            _pending_revoke_from_sp,                                                            \
-                            item);                                                                              \
+            group_revoke_msg_return(&((_gp_cache)->engine->pool_group_revoke_msgs_from_sps),                    \
+                                    _pending_revoke_from_sp);                                                   \
         }                                                                                                       \
         ucs_list_for_each_safe(_pending_revoke_from_rank, _next_pending_revoke_from_rank,                       \
                                &((_gp_cache)->persistent.pending_group_revoke_msgs_from_ranks),                 \
@@ -98,6 +114,7 @@ extern execution_context_t *get_server_servicing_host(offloading_engine_t *engin
                             _pending_cache_entry,                                                               \
                             item);                                                                              \
         }                                                                                                       \
+        GROUP_CACHE_DROP_HOST_CACHE_REQUESTS(_gp_cache);                                                        \
     } while (0)
 
 #if NDEBUG
@@ -156,29 +173,10 @@ extern execution_context_t *get_server_servicing_host(offloading_engine_t *engin
                     group_cache_t *_gp_cache = NULL;                        \
                     _gp_cache = GET_GROUP_CACHE((_cache), key);             \
                     assert(_gp_cache);                                      \
-                    if (_gp_cache->rank_array_initialized)                  \
-                    {                                                       \
-                        DYN_ARRAY_FREE(&(_gp_cache->ranks));                \
-                        _gp_cache->rank_array_initialized = false;          \
-                    }                                                       \
-                    if (_gp_cache->sp_array_initialized)                    \
-                    {                                                       \
-                        DYN_ARRAY_FREE(&(_gp_cache->sps));                  \
-                        _gp_cache->sp_array_initialized = false;            \
-                    }                                                       \
-                    if (_gp_cache->host_array_initialized)                  \
-                    {                                                       \
-                        DYN_ARRAY_FREE(&(_gp_cache->hosts));                \
-                        _gp_cache->host_array_initialized = false;          \
-                    }                                                       \
-                    /* Free hash table(s) */                                \
-                    GROUP_CACHE_HASHES_FINI((_cache)->engine, _gp_cache);   \
-                    /* Free the bitset for SPs */                           \
-                    GROUP_CACHE_BITSET_DESTROY(_gp_cache->sps_bitset);      \
-                    /* Free the bitset for Hosts */                         \
-                    GROUP_CACHE_BITSET_DESTROY(_gp_cache->hosts_bitset);    \
                     /* Free the persistent data of the group cache */       \
                     GROUP_CACHE_TERMINATE_PERSISTENT_DATA(_gp_cache);       \
+                    /* Free the arrays, hash tables and bitsets */          \
+                    RESET_GROUP_CACHE((_cache)->engine, _gp_cache);         \
                 }                                                           \
             }) kh_destroy(group_hash_t, (_cache)->data);                    \
         }                                                                   \
@@ -186,6 +184,11 @@ extern execution_context_t *get_server_servicing_host(offloading_engine_t *engin
         {                                                                   \
             kh_destroy(group_hash_t, (_cache)->data);                       \
         }                                                                   \
+        kh_destroy(evicted_groups_hash_t, (_cache)->evicted_groups);        \
+        (_cache)->evicted_groups = NULL;                                    \
+        group_cache_bitset_pool_flush((_cache));                            \
+        kh_destroy(group_cache_bitset_pool_t, (_cache)->bitset_pool);       \
+        (_cache)->bitset_pool = NULL;                                       \
         DYN_LIST_FREE((_cache)->group_cache_pool, group_cache_t, item);     \
         (_cache)->group_cache_pool = NULL;                                  \
         (_cache)->size = 0;                                                 \
@@ -241,7 +244,6 @@ extern execution_context_t *get_server_servicing_host(offloading_engine_t *engin
                                &((_gp_cache)->persistent.pending_group_revoke_msgs_from_sps),   \
                                item)                                                            \
         {                                                                                       \
-            size_t _rank;                                                                       \
             size_t _new_revokes;                                                                \
             DBG("Handling queued revoke message (group UID: 0x%x)",                             \
                 _pending_revoke_msg->gp_uid);                                                   \
@@ -258,27 +260,16 @@ extern execution_context_t *get_server_servicing_host(offloading_engine_t *engin
             {                                                                                   \
                 /* This bitset always has a lazy initialization, like a group cache */          \
                 assert((_gp_cache)->group_size != 0);                                           \
-                GROUP_CACHE_BITSET_CREATE((_gp_cache)->revokes.ranks, (_gp_cache)->group_size); \
+                GROUP_CACHE_BITSET_POOL_GET(&((_gp_cache)->engine->procs_cache),                \
+                                            (_gp_cache)->revokes.ranks,                         \
+                                            (_gp_cache)->group_size);                           \
             }                                                                                   \
             assert((_gp_cache)->revokes.ranks);                                                 \
-            _new_revokes = 0;                                                                   \
-            for (_rank = 0; _rank < _pending_revoke_msg->num_ranks; _rank++)                    \
-            {                                                                                   \
-                size_t _idx = _pending_revoke_msg->rank_start + _rank;                          \
-                if (_pending_revoke_msg->ranks[_rank] == 1 &&                                   \
-                    !GROUP_CACHE_BITSET_TEST((_gp_cache)->revokes.ranks, _idx))                 \
-                {                                                                               \
-                    DBG("Marking rank %ld has revoking the group (seq num: %ld)",               \
-                        _idx, _pending_revoke_msg->gp_seq_num);                                 \
-                    GROUP_CACHE_BITSET_SET((_gp_cache)->revokes.ranks, _idx);                   \
-                    _new_revokes++;                                                             \
-                }                                                                               \
-            }                                                                                   \
+            _new_revokes = group_revoke_msg_apply((_gp_cache), _pending_revoke_msg);            \
             (_gp_cache)->revokes.global += _new_revokes;                                        \
             _total_new_revokes += _new_revokes;                                                 \
-            DYN_LIST_RETURN((_gp_cache)->engine->pool_group_revoke_msgs_from_sps,               \
-                            _pending_revoke_msg,                                                \
-                            item);                                                              \
+            group_revoke_msg_return(&((_gp_cache)->engine->pool_group_revoke_msgs_from_sps),    \
+                                    _pending_revoke_msg);                                       \
         }                                                                                       \
     } while (0)
 
@@ -294,6 +285,17 @@ extern execution_context_t *get_server_servicing_host(offloading_engine_t *engin
  */
 bool is_in_cache(cache_t *cache, group_uid_t gp_uid, int64_t rank_id, int64_t group_size);
 
+/**
+ * @brief Track a request for cache entries from a local rank that was forwarded to other service
+ * processes, so the entries are sent to the rank as they are received. Only used on DPUs.
+ *
+ * @param[in] engine Associated offload engine
+ * @param[in] client_id Client ID of the local rank
+ * @param[in] request Request for cache entries
+ * @return dpu_offload_status_t
+ */
+dpu_offload_status_t group_cache_add_host_request(offloading_engine_t *engine, uint64_t client_id, cache_entries_request_t *request);
+
 /**
  * @brief This function populated the cache's lookup tables. It assumes the cache is
  * fully ppopulated.
@@ -305,6 +307,28 @@ bool is_in_cache(cache_t *cache, group_uid_t gp_uid, int64_t rank_id, int64_t gr
 dpu_offload_status_t populate_group_cache_lookup_table(offloading_engine_t *engine,
                                                        group_cache_t *gp_cache);
 
+/**
+ * @brief Start the construction of the cache's lookup tables in slices bounded by the time budget
+ * of the engine (see MIMOSA_LOOKUP_TABLES_BUILD_BUDGET). The first slice is executed right away, the
+ * following ones by group_cache_lookup_tables_progress(). Any lookup requiring the tables completes
+ * the construction on demand. It assumes the cache is fully populated.
+ *
+ * @param[in] engine Associated offload engine
+ * @param[in] gp_cache Group cache for which we need to populated the lookup tables.
+ * @return dpu_offload_status_t
+ */
+dpu_offload_status_t start_group_cache_lookup_table_build(offloading_engine_t *engine,
+                                                          group_cache_t *gp_cache);
+
+/**
+ * @brief Execute a slice, bounded by the time budget of the engine, of the pending constructions
+ * of lookup tables. Called by the engine's progress function.
+ *
+ * @param[in] engine Associated offload engine
+ * @return dpu_offload_status_t
+ */
+dpu_offload_status_t group_cache_lookup_tables_progress(offloading_engine_t *engine);
+
 /**
  * @brief Get the global service process identifier within a group. Note that the
  * group global service process identifier differs from the global service process identifer
@@ -752,6 +776,69 @@ dpu_offload_status_t get_group_rank_host(offloading_engine_t *engine,
                                          int64_t rank,
                                          uint64_t *host_id);
 
+/**
+ * @brief Batch variant of get_sp_id_by_group_rank(): get the global service process ID associated
+ * to a set of ranks of a group with a single group lookup. Unlike get_sp_id_by_group_rank(), the
+ * function never requests missing cache entries: the SP ID of ranks that are not in the cache is
+ * set to -1 and the caller can fall back to get_sp_id_by_group_rank() for them.
+ *
+ * @param[in] engine Offloading engine for the query
+ * @param[in] gp_uid Target group's UID
+ * @param[in] ranks Array of n_ranks ranks in the group; if NULL, ranks 0 to n_ranks-1 are queried
+ * @param[in] n_ranks Number of ranks to query
+ * @param[in] sp_idx In case of multiple service processes per host, index of the target shadow service process
+ * @param[out] sp_ids Array of n_ranks elements that will hold the service process identifiers
+ * @param[out] n_missing Number of ranks that are not in the cache (can be NULL)
+ * @return dpu_offload_status_t
+ */
+dpu_offload_status_t get_sp_ids_by_group_ranks(offloading_engine_t *engine,
+                                               group_uid_t gp_uid,
+                                               const int64_t *ranks,
+                                               size_t n_ranks,
+                                               int64_t sp_idx,
+                                               int64_t *sp_ids,
+                                               size_t *n_missing);
+
+/**
+ * @brief Batch variant of get_group_rank_host(). The host ID of ranks that are not in the cache
+ * is set to UINT64_MAX.
+ *
+ * @param[in] engine Offloading engine for the query
+ * @param[in] gp_uid Target group's UID
+ * @param[in] ranks Array of n_ranks ranks in the group; if NULL, ranks 0 to n_ranks-1 are queried
+ * @param[in] n_ranks Number of ranks to query
+ * @param[out] host_ids Array of n_ranks elements that will hold the host identifiers
+ * @param[out] n_missing Number of ranks that are not in the cache (can be NULL)
+ * @return dpu_offload_status_t
+ */
+dpu_offload_status_t get_group_ranks_host(offloading_engine_t *engine,
+                                          group_uid_t gp_uid,
+                                          const int64_t *ranks,
+                                          size_t n_ranks,
+                                          uint64_t *host_ids,
+                                          size_t *n_missing);
+
+/**
+ * @brief Batch variant of GET_CLIENT_BY_RANK: get the endpoint and client ID of a set of ranks of a
+ * group. Endpoints are taken from the engine's endpoint pool when the entry has the address of the
+ * rank but no endpoint yet.
+ * The endpoint of ranks that are not in the cache is set to NULL and their ID to UINT64_MAX.
+ *
+ * @param[in] econtext Execution context, must be a server
+ * @param[in] gp_uid Target group's UID
+ * @param[in] ranks Array of n_ranks ranks in the group; if NULL, ranks 0 to n_ranks-1 are queried
+ * @param[in] n_ranks Number of ranks to query
+ * @param[out] clients Array of n_ranks elements that will hold the endpoints and IDs
+ * @param[out] n_missing Number of ranks for which no endpoint is available (can be NULL)
+ * @return dpu_offload_status_t
+ */
+dpu_offload_status_t get_clients_by_group_ranks(execution_context_t *econtext,
+                                                group_uid_t gp_uid,
+                                                const int64_t *ranks,
+                                                size_t n_ranks,
+                                                dest_client_t *clients,
+                                                size_t *n_missing);
+
 /**
  * @brief Checks whether two ranks of a same group are on the same host.
  * 
@@ -788,4 +875,90 @@ dpu_offload_status_t handle_peer_cache_entries_recv(execution_context_t *econtex
 
 dpu_offload_status_t revoke_group_cache(offloading_engine_t *engine, group_uid_t gp_uid);
 
+/**
+ * @brief Get a revoke message from SP able to carry data_size bytes of encoded ranks.
+ * Objects are variable-size and cached per size class.
+ *
+ * @param[in] pool Pool of revoke messages
+ * @param[in] data_size Size in bytes of the encoded list of ranks
+ * @return group_revoke_msg_from_sp_t* or NULL if the allocation failed
+ */
+group_revoke_msg_from_sp_t *group_revoke_msg_get(group_revoke_msg_pool_t *pool, size_t data_size);
+
+void group_revoke_msg_return(group_revoke_msg_pool_t *pool, group_revoke_msg_from_sp_t *msg);
+
+void group_revoke_msg_pool_fini(group_revoke_msg_pool_t *pool);
+
+/**
+ * @brief Figure out the smallest encoding of the ranks that revoked a group, i.e., ranges of ranks or bitmap.
+ *
+ * @param[in] gp_cache Group cache
+ * @param[out] encoding Encoding to use
+ * @return Size in bytes of the encoded list of ranks
+ */
+size_t group_revoke_msg_encoded_size(group_cache_t *gp_cache, group_revoke_encoding_t *encoding);
+
+/**
+ * @brief Encode the ranks that revoked a group in a message previously obtained with
+ * group_revoke_msg_get() for the size returned by group_revoke_msg_encoded_size().
+ */
+void group_revoke_msg_encode(group_cache_t *gp_cache, group_revoke_encoding_t encoding, group_revoke_msg_from_sp_t *msg);
+
+/**
+ * @brief Mark the ranks of a revoke message as revoking the group.
+ *
+ * @param[in] gp_cache Group cache, its bitset of revoked ranks must be initialized
+ * @param[in] msg Revoke message received from another SP
+ * @return Number of ranks that were not yet known as revoking the group
+ */
+size_t group_revoke_msg_apply(group_cache_t *gp_cache, group_revoke_msg_from_sp_t *msg);
+
+/**
+ * @brief Record that a group reached a milestone of its creation (see group_cache_milestone_t).
+ * Only the first time a milestone is reached by a version of the group is recorded. The latency
+ * since the beginning of the timeline of the group is aggregated in the histograms of the cache.
+ *
+ * @param[in] engine Associated offloading engine
+ * @param[in] gp_cache Group cache reaching the milestone
+ * @param[in] milestone Milestone that is reached
+ */
+void group_cache_record_milestone(offloading_engine_t *engine, group_cache_t *gp_cache, group_cache_milestone_t milestone);
+
+/**
+ * @brief Get a string describing a milestone of the creation of groups.
+ *
+ * @param[in] milestone Target milestone
+ * @return Name of the milestone
+ */
+const char *group_cache_milestone_to_str(group_cache_milestone_t milestone);
+
+/**
+ * @brief Get the time, in microseconds, at which the current version of a group reached each milestone.
+ * Once a group is revoked, the timeline of the revoked version is returned until the next version starts.
+ *
+ * @param[in] engine Associated offloading engine
+ * @param[in] gp_uid UID of the target group
+ * @param[out] timestamps Array of GROUP_CACHE_NUM_MILESTONES elements, 0 for milestones that are not reached
+ * @return DO_SUCCESS, DO_NOT_APPLICABLE if the group is not in the cache
+ */
+dpu_offload_status_t get_group_cache_timeline(offloading_engine_t *engine, group_uid_t gp_uid, uint64_t *timestamps);
+
+/**
+ * @brief Display the latency histograms of the milestones across all the groups, as well as the
+ * timeline of the groups that are in the cache (see also MIMOSA_GROUP_CACHE_TIMELINES).
+ *
+ * @param[in] engine Associated offloading engine
+ * @param[in] stream Stream to write to, e.g., stderr
+ */
+void group_cache_timelines_dump(offloading_engine_t *engine, FILE *stream);
+
+/**
+ * @brief Release all the group caches, including their pending messages and the references
+ * to the endpoints of the ranks, so the next job starts with an empty cache. The latency
+ * histograms of the milestones are preserved.
+ *
+ * @param[in] engine Associated offloading engine
+ */
+void group_caches_reset(offloading_engine_t *engine);
+
 #endif // DPU_OFFLOAD_GROUP_CACHE_H_
@@ -5,6 +5,7 @@
 //
 
 #include <inttypes.h>
+#include <stdio.h>
 
 #include "dpu_offload_types.h"
 
@@ -14,58 +15,183 @@
 /*
  * The registration of an operation only allows the offloading engine to know the definition
  * of an offloaded operation. It does not instanciate it. Once registered, it can be used to
- * start and execute many operations. An oepration is defined by three high-level functions that
- * can be used by developers: init, progress, complete.
+ * start and execute many operations. An operation is defined by a set of functions that
+ * can be used by developers: init, progress, cancel, complete and fini (see offload_op_t).
+ * The same algorithm must be registered on the process submitting operations, e.g., a rank on the
+ * host, and the process executing them, e.g., a service process on the DPU.
  * To execute an operation, one must get a descriptor. For that, the identifier returned during
  * the registration must be provided. Once the descriptor is acquired, developers can customized
- * the descriptor with run-time parameters and submit it for execution.
+ * the descriptor with run-time parameters (buffers, arguments, completion callback) and submit it
+ * for execution. The descriptor is then driven by progressing the engine: on the executing process
+ * the operation is initialized and progressed until completion, at which point the submitting
+ * process is notified and the descriptor reaches a final state (see op_state_t).
  */
 
 /**
  * @brief Register a new operation, i.e., implementation of an algorithm in the offload engine.
  *
- * @param engine Offload engine on the host or DPU where the operation needs to be registered.
- * @param op Description of the operation.
- * @return uint64_t
+ * @param[in] engine Offload engine on the host or DPU where the operation needs to be registered.
+ * @param[in] op Description of the operation, copied during the registration.
+ * @param[out] op_id Registration identifier to use with op_desc_get().
+ * @return dpu_offload_status_t DO_ERROR if an operation is already registered for the same algorithm.
  */
-uint64_t register_new_op(offloading_engine_t *engine, offload_op_t *op);
+dpu_offload_status_t register_new_op(offloading_engine_t *engine, offload_op_t *op, uint64_t *op_id);
+
+/**
+ * @brief Get the registration identifier of the operation implementing an algorithm.
+ *
+ * @param[in] engine Offload engine where the operation is registered.
+ * @param[in] alg_id Identifier of the algorithm.
+ * @param[out] op_id Registration identifier to use with op_desc_get().
+ * @return dpu_offload_status_t DO_NOT_APPLICABLE if no operation is registered for the algorithm.
+ */
+dpu_offload_status_t get_op_id_by_alg_id(offloading_engine_t *engine, uint64_t alg_id, uint64_t *op_id);
 
 /**
  * @brief Get a descriptor for the execution of a new operation
  *
- * @param engine Associated offload engine.
- * @param id Unique identifier associated with the operation. For collective operation, it must be the same for all app processes.
- * @param op_id Registration identifier returned by register_new_op().
- * @param desc Returned descriptor. The operation is active only once submited.
+ * @param[in] engine Associated offload engine.
+ * @param[in] id Unique identifier associated with the operation. For collective operation, it must be the same for all app processes.
+ * @param[in] op_id Registration identifier returned by register_new_op().
+ * @param[out] desc Returned descriptor, in the OP_STATE_INIT state. The operation is active only once submited.
  * @return dpu_offload_status_t
  */
 dpu_offload_status_t op_desc_get(offloading_engine_t *engine, const uint64_t id, uint64_t op_id, op_desc_t **desc);
 
 /**
- * @brief Start the execution of a operation descriptor.
+ * @brief Add an input or output buffer to a descriptor that is not submitted yet. Buffers are
+ * passed to the executing process in the order they are added.
+ *
+ * @param[in] desc Descriptor of the operation.
+ * @param[in] type OP_BUFFER_INPUT or OP_BUFFER_OUTPUT.
+ * @param[in] addr Address of the buffer.
+ * @param[in] len Size of the buffer in bytes.
+ * @return dpu_offload_status_t DO_ERROR if the descriptor already has OP_MAX_BUFFERS buffers of that type.
+ */
+dpu_offload_status_t op_desc_add_buffer(op_desc_t *desc, op_buffer_type_t type, void *addr, size_t len);
+
+/**
+ * @brief Start the execution of a operation descriptor. The priority of the descriptor, if set, is
+ * used by the executing process to schedule the operation (see progress_active_ops()).
  *
- * @param engine Associated offload engine.
- * @param desc Descriptor of the operation to execute.
+ * @param[in] econtext Execution context to the process executing the operation, e.g., client to the local service process.
+ * @param[in] desc Descriptor of the operation to execute.
  * @return dpu_offload_status_t
  */
-dpu_offload_status_t op_desc_submit(offloading_engine_t *engine, op_desc_t *desc);
+dpu_offload_status_t op_desc_submit(execution_context_t *econtext, op_desc_t *desc);
+
+/**
+ * @brief Request the cancellation of a submitted operation. The descriptor reaches its final state,
+ * OP_STATE_CANCELED or OP_STATE_COMPLETED if the operation could not be interrupted, once the
+ * completion notification is received.
+ *
+ * @param[in] econtext Execution context used to submit the operation.
+ * @param[in] desc Descriptor of the operation to cancel.
+ * @return dpu_offload_status_t
+ */
+dpu_offload_status_t op_desc_cancel(execution_context_t *econtext, op_desc_t *desc);
 
 /**
  * @brief Return the descriptor of a completed operation. Returning a non-completed operation
  * is an error.
  *
- * @param engine Associated offload engine.
- * @param desc Descriptor of the operation to return. In case of error, the descriptor is in an undefined step; upon success the descriptor shall be NULL.
+ * @param[in] engine Associated offload engine.
+ * @param[in,out] desc Descriptor of the operation to return. In case of error, the descriptor is in an undefined step; upon success the descriptor shall be NULL.
  * @return dpu_offload_status_t
  */
 dpu_offload_status_t op_desc_return(offloading_engine_t *engine, op_desc_t **desc);
 
 /**
- * @brief Progress all the active operations on a given execution context.
- * 
+ * @brief Progress all the active operations on a given execution context. Operations are progressed
+ * at most once per call, by decreasing priority (see op_priority_t) and, within a priority, in turn
+ * across the queues of the groups in proportion to their weight (see op_queue_set_weight()). The call
+ * returns once MIMOSA_OPS_PROGRESS_BUDGET is exhausted, if set; the operations that were not
+ * progressed are then the first ones of their priority next time.
+ *
  * @param econtext Execution context on which the active operations need to be progressed.
  * @return dpu_offload_status_t
  */
 dpu_offload_status_t progress_active_ops(execution_context_t *econtext);
 
-#endif // DPU_OFFLOAD_OPS_H
\ No newline at end of file
+/**
+ * @brief Reserve a slot for an RMA transfer of an operation, to be invoked by its implementation before
+ * starting the transfer. At most MIMOSA_OPS_MAX_RMA transfers are in flight across all the operations
+ * of the engine; when none is available, the operation must retry the next time it is progressed.
+ *
+ * @param[in] desc Descriptor of the operation on the executing process.
+ * @return true if the transfer can be started, false otherwise
+ */
+bool op_rma_acquire(op_desc_t *desc);
+
+/**
+ * @brief Release the slot of an RMA transfer of an operation once it completed. The slots still held by
+ * an operation when it reaches a final state are released automatically.
+ *
+ * @param[in] desc Descriptor of the operation on the executing process.
+ */
+void op_rma_release(op_desc_t *desc);
+
+/**
+ * @brief Set the weight of the queue of the operations of a group, i.e., how many of its operations
+ * are progressed when the operations of a queue of weight 1 are progressed once. Queues are per-job
+ * state, released by offload_engine_job_reset() with their weight.
+ *
+ * @param[in] engine Engine executing the operations.
+ * @param[in] gp_uid Group of the operations, INT_MAX for the operations without group.
+ * @param[in] weight Weight of the queue, at least 1.
+ * @return dpu_offload_status_t
+ */
+dpu_offload_status_t op_queue_set_weight(offloading_engine_t *engine, group_uid_t gp_uid, uint64_t weight);
+
+/**
+ * @brief Get the statistics of the queue of the operations of a group since the beginning of the job.
+ *
+ * @param[in] engine Engine executing the operations.
+ * @param[in] gp_uid Group of the operations, INT_MAX for the operations without group.
+ * @param[out] stats Statistics of the queue.
+ * @return dpu_offload_status_t DO_NOT_APPLICABLE if no operation of the group was executed.
+ */
+dpu_offload_status_t op_queue_get_stats(offloading_engine_t *engine, group_uid_t gp_uid, op_queue_stats_t *stats);
+
+/**
+ * @brief Display the statistics of the queues of operations (see MIMOSA_DUMP_OP_QUEUE_STATS).
+ */
+void op_queues_dump(offloading_engine_t *engine, FILE *stream);
+
+/**
+ * @brief Release the queues of operations at the end of a job, invoked by offload_engine_job_reset(),
+ * and when finalizing the engine.
+ */
+void op_queues_reset(offloading_engine_t *engine);
+void op_queues_fini(offloading_engine_t *engine);
+
+/**
+ * @brief Send a message to the instance of a collective operation executed on behalf of a rank of the
+ * same group, possibly by the local service process. The message is delivered with the op_recv
+ * function of the operation once the destination operation is running. Can only be used on
+ * service processes, for operations whose descriptor has a group. For implicit operations (see
+ * offload_op_t), the first message sent to a service process that has no matching operation starts
+ * one on its self execution context, with the group and rank of the message.
+ *
+ * @param[in] desc Descriptor of the local operation.
+ * @param[in] sp_gid Global ID of the service process executing the destination operation.
+ * @param[in] dst_rank Rank in the group of the descriptor whose operation is the destination.
+ * @param[in] data Data of the message, copied before the function returns.
+ * @param[in] len Size of the data in bytes.
+ * @return dpu_offload_status_t
+ */
+dpu_offload_status_t op_send_to_sp(op_desc_t *desc, uint64_t sp_gid, int64_t dst_rank, void *data, size_t len);
+
+/**
+ * @brief Release the messages between service processes that were never delivered, invoked when
+ * finalizing the engine.
+ */
+void op_pending_msgs_fini(offloading_engine_t *engine);
+
+/* Handlers of the notifications related to operations, see register_default_notifications() */
+dpu_offload_status_t handle_op_start_msg(execution_context_t *econtext, uint64_t origin_id, void *data, size_t data_len);
+dpu_offload_status_t handle_op_cancel_msg(execution_context_t *econtext, uint64_t origin_id, void *data, size_t data_len);
+dpu_offload_status_t handle_op_completion_msg(execution_context_t *econtext, void *data, size_t data_len);
+dpu_offload_status_t handle_op_sp_msg(offloading_engine_t *engine, void *data, size_t data_len);
+
+#endif // DPU_OFFLOAD_OPS_H
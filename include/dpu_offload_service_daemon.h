@@ -70,6 +70,19 @@ dpu_offload_status_t offload_engine_init_with_info(offloading_engine_t **engine,
 
 void offload_engine_fini(offloading_engine_t **engine);
 
+/**
+ * @brief Release the per-job state of an engine once the ranks of a job are gone, e.g., between
+ * two jobs served by a job-persistent service process: the group caches and their pending
+ * messages, the endpoints to the ranks and the slots of the ranks that disconnected. The fabric
+ * state, including the connections to the other service processes, is kept so the next job does
+ * not pay for it again. The servers the ranks connect to are ready to serve the next job.
+ * Must be invoked from the thread progressing the engine.
+ *
+ * @param[in] engine Offload engine
+ * @return DO_SUCCESS, DO_ERROR if ranks of the job are still connected
+ */
+dpu_offload_status_t offload_engine_job_reset(offloading_engine_t *engine);
+
 /**
  * @brief offload_engine_progress progresses the entire offloading engine, i.e., all the
  * associated execution context. It is for instance used to progress all communications
@@ -251,6 +264,9 @@ dpu_offload_status_t send_cache(execution_context_t *econtext, cache_t *cache, u
  * possible to perform the broadcast right away. The function checks whether the
  * broadcast can be performed before trying to send the cache. In other words, the
  * broadcast is not initiated if all the DPUs are not locally connected.
+ * When connections between service processes are established on demand, the cache
+ * is queued for the service processes that are not connected yet and sent once the
+ * connection is established.
  *
  * @param engine Current offloading engine.
  * @param group_cache Group cache to broadcast.
@@ -277,9 +293,29 @@ dpu_offload_status_t broadcast_group_cache_revoke(offloading_engine_t *engine, g
  * @param[out] econtext_comm The execution context to use for notification, must be used to get an event
  * @param[out] notif_dest_id The local identifier to send notification to the remote DPU
  * @return dpu_offload_status_t
+ *
+ * When connections between service processes are established on demand, the first call for a
+ * given service process starts the connection and returns a NULL endpoint and execution context
+ * until the connection is established; the caller is expected to try again later or to use
+ * send_notif_to_sp().
  */
 dpu_offload_status_t get_sp_ep_by_id(offloading_engine_t *engine, uint64_t sp_id, ucp_ep_h *sp_ep, execution_context_t **econtext_comm, uint64_t *comm_id);
 
+/**
+ * @brief send_notif_to_sp sends a notification to a service process. If the service process
+ * is not connected yet (on-demand connections), a copy of the payload is queued, the connection
+ * is started and the notification is sent while progressing the engine once connected.
+ * Notifications queued for a given service process are sent in order.
+ *
+ * @param[in] engine Offloading engine for the query
+ * @param[in] sp_gid Global service process identifier of the destination
+ * @param[in] notif_id Type of the notification
+ * @param[in] payload Payload of the notification, can be freed when the function returns
+ * @param[in] payload_size Size of the payload
+ * @return dpu_offload_status_t
+ */
+dpu_offload_status_t send_notif_to_sp(offloading_engine_t *engine, uint64_t sp_gid, uint64_t notif_id, void *payload, size_t payload_size);
+
 /**
  * @brief get_remote_sp_ep_by_id returns the UCX endpoint for any service process involved in the job.
  * The function can be used both in the context of host or service processes. The returned endpoint can
@@ -0,0 +1,187 @@
+//
+// Copyright (c) 2023, NVIDIA CORPORATION. All rights reserved.
+//
+// See LICENSE.txt for license information
+//
+
+#ifndef DPU_OFFLOAD_TRACE_H
+#define DPU_OFFLOAD_TRACE_H
+
+#include <stdint.h>
+
+#if defined(c_plusplus) || defined(__cplusplus)
+#    define _EXTERN_C_BEGIN extern "C" {
+#    define _EXTERN_C_END   }
+#else
+#    define _EXTERN_C_BEGIN
+#    define _EXTERN_C_END
+#endif
+
+_EXTERN_C_BEGIN
+
+/*
+ * Bootstrap tracing: when MIMOSA_TRACE_DIR is set, every process records when the phases of the
+ * bootstrapping of its connections begin and end in a ring of fixed-size records mapped from
+ * the file <MIMOSA_TRACE_DIR>/mimosa-trace.<hostname>.<pid>.bin. The ring survives a crash of the
+ * process and can be converted to the Chrome trace format with mimosa_trace2json.
+ *
+ * This header only depends on standard headers so tools can decode the files without UCX.
+ */
+
+#define TRACE_RING_MAGIC (0x4D494D4F53415452ULL) // "MIMOSATR"
+#define TRACE_RING_VERSION (1)
+
+// Default number of records in the ring of a process
+#define DEFAULT_TRACE_RING_SIZE (65536)
+
+#define TRACE_FILE_PREFIX "mimosa-trace"
+
+// Peer of events that are not specific to a peer
+#define TRACE_NO_PEER (UINT64_MAX)
+
+typedef enum
+{
+    // Process-wide phases
+    TRACE_PHASE_CLIENT_INIT = 0,
+    TRACE_PHASE_SERVER_INIT,
+    TRACE_PHASE_INTER_SP_CONNECT_MGR,
+    // Connection to a remote service process, from the time it is queued by the connection manager
+    TRACE_PHASE_INTER_SP_CONNECT,
+    // Client side of a connection
+    TRACE_PHASE_CLIENT_CONNECT,
+    TRACE_PHASE_OOB_CONNECT,
+    TRACE_PHASE_RENDEZVOUS_LOOKUP,
+    TRACE_PHASE_OOB_HANDSHAKE,
+    // Server side of a connection
+    TRACE_PHASE_OOB_ACCEPT,
+    TRACE_PHASE_SERVER_BOOTSTRAP,
+    // Both sides
+    TRACE_PHASE_UCX_EP_CREATE,
+    TRACE_NUM_PHASES,
+} trace_phase_t;
+
+typedef enum
+{
+    TRACE_EVENT_BEGIN = 0,
+    TRACE_EVENT_END,
+    TRACE_EVENT_INSTANT,
+} trace_event_type_t;
+
+typedef enum
+{
+    TRACE_ROLE_PROCESS = 0,
+    TRACE_ROLE_CLIENT,
+    TRACE_ROLE_SERVER,
+} trace_role_t;
+
+typedef struct trace_ring_hdr
+{
+    uint64_t magic;
+    uint32_t version;
+
+    // Size of a single record, to catch files created by an incompatible build
+    uint32_t record_size;
+
+    // Number of records in the ring
+    uint64_t capacity;
+
+    // Total number of records ever written, the next record is at index head % capacity
+    uint64_t head;
+
+    uint64_t pid;
+
+    // CLOCK_REALTIME - CLOCK_MONOTONIC in nanoseconds when the ring was created, used to
+    // align the traces of processes running on different nodes
+    int64_t clock_offset;
+
+    char hostname[64];
+} trace_ring_hdr_t;
+
+typedef struct trace_record
+{
+    // CLOCK_MONOTONIC in nanoseconds, 0 if the record was never written
+    uint64_t ts;
+
+    // Identifier of the execution context, 0 for process-wide events
+    uint64_t id;
+
+    // Client ID on servers, remote service process on the connection manager, TRACE_NO_PEER otherwise
+    uint64_t peer;
+
+    uint8_t phase; // See trace_phase_t
+    uint8_t type;  // See trace_event_type_t
+    uint8_t role;  // See trace_role_t
+    uint8_t scope; // Scope of the execution context
+
+    // Thread that recorded the event
+    uint32_t tid;
+} trace_record_t;
+
+static inline const char *trace_phase_to_str(int phase)
+{
+    switch (phase)
+    {
+    case TRACE_PHASE_CLIENT_INIT:
+        return "client_init";
+    case TRACE_PHASE_SERVER_INIT:
+        return "server_init";
+    case TRACE_PHASE_INTER_SP_CONNECT_MGR:
+        return "inter_dpus_connect_mgr";
+    case TRACE_PHASE_INTER_SP_CONNECT:
+        return "inter_sp_connect";
+    case TRACE_PHASE_CLIENT_CONNECT:
+        return "client_connect";
+    case TRACE_PHASE_OOB_CONNECT:
+        return "oob_connect";
+    case TRACE_PHASE_RENDEZVOUS_LOOKUP:
+        return "rendezvous_lookup";
+    case TRACE_PHASE_OOB_HANDSHAKE:
+        return "oob_handshake";
+    case TRACE_PHASE_OOB_ACCEPT:
+        return "oob_server_accept";
+    case TRACE_PHASE_SERVER_BOOTSTRAP:
+        return "server_bootstrap";
+    case TRACE_PHASE_UCX_EP_CREATE:
+        return "ucp_ep_create";
+    default:
+        return "unknown";
+    }
+}
+
+struct execution_context; // Forward declaration
+
+/**
+ * @brief Create the trace ring of the process. The ring is shared by all the engines of the
+ * process and released once trace_fini() is invoked as many times as trace_init().
+ *
+ * @param[in] dir Directory where the file of the ring is created
+ * @param[in] num_records Number of records in the ring, the oldest records are overwritten once it is full
+ * @return 0 on success, -1 otherwise
+ */
+int trace_init(const char *dir, uint64_t num_records);
+
+/**
+ * @brief Release the trace ring of the process, see trace_init().
+ */
+void trace_fini(void);
+
+/**
+ * @brief Record an event in the trace ring of the process. Does nothing if tracing is disabled.
+ * Safe to invoke from any thread.
+ *
+ * @param[in] phase Phase of the bootstrapping (see trace_phase_t)
+ * @param[in] type Beginning or end of the phase (see trace_event_type_t)
+ * @param[in] econtext Execution context the event is about, NULL for process-wide events
+ * @param[in] peer Client ID on servers, TRACE_NO_PEER otherwise
+ */
+void trace_event(trace_phase_t phase, trace_event_type_t type, struct execution_context *econtext, uint64_t peer);
+
+#define TRACE_BEGIN(_phase, _econtext, _peer) \
+    trace_event((_phase), TRACE_EVENT_BEGIN, (struct execution_context *)(_econtext), (_peer))
+
+#define TRACE_END(_phase, _econtext, _peer) \
+    trace_event((_phase), TRACE_EVENT_END, (struct execution_context *)(_econtext), (_peer))
+
+_EXTERN_C_END
+
+#endif // DPU_OFFLOAD_TRACE_H
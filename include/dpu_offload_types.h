@@ -13,10 +13,12 @@
 #include <ucs/datastruct/list.h>
 #include <ucs/datastruct/khash.h>
 #include <limits.h>
+#include <netinet/in.h>
 
 #include "dynamic_structs.h"
 #include "dpu_offload_common.h"
 #include "dpu_offload_utils.h"
+#include "dpu_offload_trace.h"
 
 _EXTERN_C_BEGIN
 
@@ -36,6 +38,70 @@ _EXTERN_C_BEGIN
 
 #define CACHE_IS_PERSISTENT (1)
 
+// Default time budget, in microseconds, of each slice of the construction of the
+// lookup tables of a group (see MIMOSA_LOOKUP_TABLES_BUILD_BUDGET).
+#define DEFAULT_LOOKUP_TABLES_BUILD_BUDGET_US (500)
+
+// Default maximum number of evicted groups whose sequence number is kept
+// (see MIMOSA_GROUP_CACHE_MAX_EVICTED_GROUPS).
+#define DEFAULT_GROUP_CACHE_MAX_EVICTED_GROUPS (4096)
+
+// Default bounds, in microseconds, of the delay between two attempts to connect to a
+// server (see MIMOSA_CONNECT_BACKOFF_MIN and MIMOSA_CONNECT_BACKOFF_MAX).
+#define DEFAULT_CONNECT_BACKOFF_MIN_US (1000)
+#define DEFAULT_CONNECT_BACKOFF_MAX_US (500000)
+
+// Default maximum number of outgoing connections to other service processes that are
+// established at the same time (see MIMOSA_INTER_SP_CONNECT_MAX_INFLIGHT).
+#define DEFAULT_INTER_SP_CONNECT_MAX_INFLIGHT (16)
+
+// Default number of times the connection to another service process is restarted after
+// failing to complete before the deadline (see MIMOSA_INTER_SP_CONNECT_RETRIES).
+#define DEFAULT_INTER_SP_CONNECT_RETRIES (3)
+
+// Default time, in milliseconds, after which an attempt to connect to another service process
+// fails when MIMOSA_CONNECT_TIMEOUT is not set, so the connection can be restarted (see
+// MIMOSA_INTER_SP_CONNECT_RETRIES).
+#define DEFAULT_INTER_SP_CONNECT_TIMEOUT_MS (30000)
+
+// Maximum time, in milliseconds, a client keeps trying to connect to its server, 0 meaning no
+// limit. Connections to other service processes are always bounded so they can be restarted.
+#define CLIENT_CONNECT_TIMEOUT(_econtext)                                   \
+    (((_econtext)->engine->settings.connect_timeout == 0 &&                 \
+      (_econtext)->scope_id == SCOPE_INTER_SERVICE_PROCS)                   \
+         ? DEFAULT_INTER_SP_CONNECT_TIMEOUT_MS                              \
+         : (_econtext)->engine->settings.connect_timeout)
+
+// Default location where servers publish their address with the file and shm rendezvous
+// backends (see MIMOSA_RENDEZVOUS_PATH).
+#define DEFAULT_RENDEZVOUS_DIR "/tmp"
+#define DEFAULT_RENDEZVOUS_SHM_PREFIX "mimosa-rdv"
+
+// Prefix of the files where clients keep their resume tokens (see MIMOSA_RESUME_DIR)
+#define RESUME_FILE_PREFIX "mimosa-resume"
+
+// Default maximum number of RMA transfers in flight for each rank of an offloaded alltoallv
+// (see MIMOSA_ALLTOALLV_WINDOW).
+#define DEFAULT_ALLTOALLV_WINDOW (8)
+
+// Defaults of the segmented broadcast between service processes (see MIMOSA_BCAST_SEGMENT_SIZE,
+// MIMOSA_BCAST_RADIX and MIMOSA_CACHE_BCAST_THRESHOLD).
+#define DEFAULT_BCAST_SEGMENT_SIZE (64 * 1024)
+#define DEFAULT_BCAST_RADIX (2)
+// A cache entry is about 2KB, so the cache entries of a few tens of local ranks already fill a
+// segment; from there the pipelined tree is used.
+#define DEFAULT_CACHE_BCAST_THRESHOLD (DEFAULT_BCAST_SEGMENT_SIZE)
+
+// Defaults of the scheduler of the operations (see MIMOSA_OPS_PROGRESS_BUDGET, MIMOSA_OPS_MAX_RMA and
+// MIMOSA_OP_QUEUE_WEIGHT): no time budget, at most 64 RMA transfers in flight and equal weights.
+#define DEFAULT_OPS_PROGRESS_BUDGET_US (0)
+#define DEFAULT_OPS_MAX_RMA (64)
+#define DEFAULT_OP_QUEUE_WEIGHT (1)
+
+// Default time after which messages between service processes that no running operation claimed are
+// dropped (see MIMOSA_OP_MSG_TIMEOUT).
+#define DEFAULT_OP_MSG_TIMEOUT_MS (60000)
+
 typedef enum
 {
     CONTEXT_UNKOWN = 0,
@@ -107,20 +173,48 @@ typedef enum
     _ep;                                      \
 })
 
+/*
+ * The ID a server assigns to a client combines the slot of the client in the server's list
+ * of clients (lower 32 bits) and the generation of the slot (upper 32 bits). Slots of clients
+ * that disconnected are reused and their generation incremented, so an ID from a previous user
+ * of a slot is detected as stale. The first generation is 0, i.e., the ID is then the slot.
+ */
+#define CLIENT_ID(_slot, _gen) ((((uint64_t)(_gen)) << 32) | (uint64_t)(_slot))
+#define CLIENT_ID_SLOT(_id) (((uint64_t)(_id)) & 0xFFFFFFFFULL)
+#define CLIENT_ID_GENERATION(_id) ((uint32_t)(((uint64_t)(_id)) >> 32))
+
 /**
- * @brief GET_CLIENT_EP returns the UCX endpoint based on a client's ID (warning, the ID is not equal to rank)
- */
-#define GET_CLIENT_EP(_exec_ctx, _client_id) ({                                                 \
-    ucp_ep_h _ep = NULL;                                                                        \
-    if ((_exec_ctx)->type == CONTEXT_SERVER)                                                    \
-    {                                                                                           \
-        peer_info_t *_pi = DYN_ARRAY_GET_ELT(&((_exec_ctx)->server->connected_clients.clients), \
-                                             _client_id,                                        \
-                                             peer_info_t);                                      \
-        assert(_pi);                                                                            \
-        _ep = _pi->ep;                                                                          \
-    }                                                                                           \
-    _ep;                                                                                        \
+ * @brief GET_CLIENT_INFO returns the data about a client of a server based on the client's ID,
+ * NULL if the ID is stale, i.e., the slot was since released or reused by another client, or
+ * if the slot is parked until the client resumes.
+ */
+#define GET_CLIENT_INFO(_exec_ctx, _client_id) ({                                      \
+    peer_info_t *_ci = NULL;                                                           \
+    assert((_exec_ctx)->type == CONTEXT_SERVER);                                       \
+    if (CLIENT_ID_SLOT(_client_id) < (_exec_ctx)->server->connected_clients.num_slots) \
+    {                                                                                  \
+        _ci = DYN_ARRAY_GET_ELT(&((_exec_ctx)->server->connected_clients.clients),     \
+                                CLIENT_ID_SLOT(_client_id),                            \
+                                peer_info_t);                                          \
+        if (_ci->generation != CLIENT_ID_GENERATION(_client_id) || _ci->parked)        \
+            _ci = NULL;                                                                \
+    }                                                                                  \
+    _ci;                                                                               \
+})
+
+/**
+ * @brief GET_CLIENT_EP returns the UCX endpoint based on a client's ID (warning, the ID is not equal to rank),
+ * NULL if the ID is stale
+ */
+#define GET_CLIENT_EP(_exec_ctx, _client_id) ({                        \
+    ucp_ep_h _ep = NULL;                                               \
+    if ((_exec_ctx)->type == CONTEXT_SERVER)                           \
+    {                                                                  \
+        peer_info_t *_pi = GET_CLIENT_INFO((_exec_ctx), (_client_id)); \
+        if (_pi != NULL)                                               \
+            _ep = _pi->ep;                                             \
+    }                                                                  \
+    _ep;                                                               \
 })
 
 
@@ -139,7 +233,7 @@ typedef enum
     {                                                                                       \
         peer_info_t *_c = NULL;                                                             \
         _c = DYN_ARRAY_GET_ELT(&((__econtext)->server->connected_clients.clients),          \
-                               (__local_id),                                                \
+                               CLIENT_ID_SLOT(__local_id),                                  \
                                peer_info_t);                                                \
         assert(_c);                                                                         \
         _global_id = _c->rank_data.group_rank;                                              \
@@ -250,14 +344,145 @@ typedef struct offload_config
     } infra;
 } offload_config_t;
 
+// group_uid_t is the type used to handle the uniquely identifiable value for any group
+// Technically, it is a hash of the group identifier, the group lead and the group
+// signature
+typedef int group_uid_t;
+
 /**************/
 /* OPERATIONS */
 /**************/
 
-typedef int (*op_init_fn)();
-typedef int (*op_complete_fn)();
-typedef int (*op_progress_fn)();
-typedef int (*op_fini_fn)();
+// Maximum number of input and output buffers of an operation descriptor
+#define OP_MAX_BUFFERS (8)
+
+// Default number of slots for the registration of operations, grows on demand
+#define DEFAULT_NUM_REGISTERED_OPS (8)
+
+/*
+ * State machine of an operation descriptor. On the process submitting an operation, the descriptor
+ * moves from OP_STATE_INIT to OP_STATE_SUBMITTED when op_desc_submit() is invoked and to a final
+ * state when the completion notification is received. On the process executing the operation, the
+ * descriptor is created in the OP_STATE_SUBMITTED state when the start notification is received,
+ * moves to OP_STATE_RUNNING once op_init() succeeded and to a final state once op_progress()
+ * reports its completion, the operation is canceled or an error occurs.
+ */
+typedef enum
+{
+    OP_STATE_INIT = 0,
+    OP_STATE_SUBMITTED,
+    OP_STATE_RUNNING,
+    OP_STATE_COMPLETED,
+    OP_STATE_CANCELED,
+    OP_STATE_FAILED,
+} op_state_t;
+
+#define OP_STATE_IS_FINAL(_state) ((_state) >= OP_STATE_COMPLETED)
+
+// Priority of an operation: the operations of the highest priority are progressed first
+typedef enum
+{
+    OP_PRIORITY_LOW = 0,
+    OP_PRIORITY_NORMAL,
+    OP_PRIORITY_HIGH,
+    OP_NUM_PRIORITIES,
+} op_priority_t;
+
+// Statistics of a queue of operations, see op_queue_get_stats()
+typedef struct op_queue_stats
+{
+    // Operations started, and reaching each final state
+    uint64_t num_ops;
+    uint64_t num_completed;
+    uint64_t num_canceled;
+    uint64_t num_failed;
+
+    // Number of times operations were progressed and time spent doing so, in nanoseconds
+    uint64_t num_progress;
+    uint64_t progress_time;
+
+    // Number of times an operation was not progressed because the time budget of a progress call
+    // was exhausted
+    uint64_t num_deferred;
+
+    // RMA transfers started and number of times one was delayed by the limit of transfers in flight
+    uint64_t num_rma;
+    uint64_t num_rma_throttled;
+} op_queue_stats_t;
+
+/*
+ * The operations executed by a process are scheduled with a queue per group, the operations without
+ * group sharing a queue. Queues get a number of progress slots proportional to their weight in turn,
+ * so a group with many operations cannot starve the others. Queues are per-job state.
+ */
+typedef struct op_queue
+{
+    group_uid_t gp_uid;
+    uint64_t weight;
+    // Progress slots left before the queue waits for the other queues to use theirs
+    uint64_t credits;
+    // Operations of the queue that are not in a final state yet
+    size_t num_active;
+    op_queue_stats_t stats;
+} op_queue_t;
+
+KHASH_MAP_INIT_INT(op_queue_hash_t, op_queue_t *);
+
+typedef enum
+{
+    OP_BUFFER_INPUT = 0,
+    OP_BUFFER_OUTPUT,
+} op_buffer_type_t;
+
+typedef struct op_buffer
+{
+    // Address in the address space of the process that submitted the operation
+    uint64_t addr;
+    uint64_t len;
+} op_buffer_t;
+
+struct op_desc; // Forward declaration
+
+/*
+ * Functions implementing an operation, all of them are optional and invoked with the execution
+ * context of the descriptor locked, they therefore cannot progress the execution context.
+ * - op_init: invoked once on the executing process before the operation starts.
+ * - op_progress: invoked on the executing process every time the engine is progressed until it
+ *   sets completed to true. Returning an error fails the operation.
+ * - op_cancel: invoked on the executing process when the cancellation of a running operation is
+ *   requested. Returns DO_SUCCESS if the operation is canceled, DO_NOT_APPLICABLE if it cannot be
+ *   interrupted and will complete normally. Without op_cancel, running operations are not
+ *   interruptible.
+ * - op_complete: invoked on the submitting process once the operation reached a final state.
+ * - op_fini: invoked on the executing process once an operation that was started by op_init()
+ *   reached a final state, to release op_data.
+ * - op_recv: invoked on the executing process when a message sent with op_send_to_sp() by the
+ *   same operation on another service process is received. Messages arriving before the operation
+ *   is started are kept until then.
+ */
+typedef dpu_offload_status_t (*op_init_fn)(struct op_desc *desc);
+typedef dpu_offload_status_t (*op_progress_fn)(struct op_desc *desc, bool *completed);
+typedef dpu_offload_status_t (*op_cancel_fn)(struct op_desc *desc);
+typedef void (*op_complete_fn)(struct op_desc *desc);
+typedef void (*op_fini_fn)(struct op_desc *desc);
+typedef dpu_offload_status_t (*op_recv_fn)(struct op_desc *desc, void *data, size_t data_len);
+
+// Per-operation completion callback of the submitting process, see op_desc_t
+typedef void (*op_completion_cb_t)(struct op_desc *desc, void *ctx);
+
+// Shape of the tree of service processes used by the segmented broadcast (see MIMOSA_BCAST_TREE)
+typedef enum
+{
+    BCAST_TREE_DEFAULT = 0, // Tree of the engine settings
+    BCAST_TREE_KNOMIAL,
+    BCAST_TREE_CHAIN,
+} bcast_tree_t;
+
+// Maximum number of types of segmented broadcasts, see bcast_register_handler()
+#define BCAST_MAX_TYPES (16)
+
+// Invoked on the service processes receiving a segmented broadcast once all its data is received
+typedef dpu_offload_status_t (*bcast_deliver_fn)(struct execution_context *econtext, uint64_t root_sp_gid, void *data, size_t data_len);
 
 typedef struct offload_op
 {
@@ -267,7 +492,14 @@ typedef struct offload_op
     op_init_fn op_init;
     op_complete_fn op_complete;
     op_progress_fn op_progress;
+    op_cancel_fn op_cancel;
     op_fini_fn op_fini;
+    op_recv_fn op_recv;
+
+    // When true, instances are started by the first message sent to them with op_send_to_sp() on the
+    // service processes that did not post them. They run on the self execution context, have no
+    // arguments nor buffers and nobody is notified of their completion.
+    bool implicit;
 
     // alg_data is a pointer that can be used by developers to store data
     // that can be used for the execution of all operations that is specific
@@ -281,27 +513,165 @@ typedef struct op_desc
     uint64_t id;
     offload_op_t *op_definition;
 
+    // Execution context the operation is active on
+    struct execution_context *econtext;
+
+    // True on the process executing the operation, false on the process that submitted it
+    bool executor;
+
+    // On the executing process, ID of the peer that submitted the operation (see am_header_t)
+    uint64_t origin_id;
+
+    // Started by a message rather than submitted, see offload_op_t
+    bool implicit;
+
+    // Set by the submitting process before op_desc_submit(), OP_PRIORITY_NORMAL by default
+    op_priority_t priority;
+
+    // On the executing process, scheduling queue of the operation, sequence number of the last
+    // progress call that progressed it and number of RMA transfers it has in flight (see op_rma_acquire())
+    op_queue_t *queue;
+    uint64_t sched_seq;
+    size_t num_rma;
+
+    // For collective operations, group and rank of the submitting process. Used to route the messages
+    // exchanged by the service processes executing the operation (see op_send_to_sp()).
+    group_uid_t gp_uid;
+    int64_t group_rank;
+
+    op_state_t state;
+
+    // Status of the operation once it reached a final state
+    dpu_offload_status_t status;
+
+    // Set when the cancellation of the operation is requested
+    bool cancel_requested;
+
+    // On the executing process, set once op_init() succeeded so op_fini() is invoked
+    bool started;
+
+    size_t num_inputs;
+    op_buffer_t inputs[OP_MAX_BUFFERS];
+    size_t num_outputs;
+    op_buffer_t outputs[OP_MAX_BUFFERS];
+
+    // Arguments specific to the algorithm, copied in the start notification. On the submitting process,
+    // they only need to remain valid until op_desc_submit() returns. On the executing process, they
+    // are owned by the descriptor.
+    void *args;
+    size_t args_len;
+
+    // Invoked on the submitting process once the operation reached a final state, after op_complete
+    op_completion_cb_t completion_cb;
+    void *completion_ctx;
+
     // op_data can be used by developers to associate any run-time data to the execution of the operation.
     void *op_data;
     bool completed;
 } op_desc_t;
 
-#define RESET_OP_DESC(_op_desc)           \
-    do                                    \
-    {                                     \
-        (_op_desc)->id = 0;               \
-        (_op_desc)->op_definition = NULL; \
-        (_op_desc)->op_data = NULL;       \
-        (_op_desc)->completed = false;    \
+#define RESET_OP_DESC(_op_desc)                    \
+    do                                             \
+    {                                              \
+        (_op_desc)->id = 0;                        \
+        (_op_desc)->op_definition = NULL;          \
+        (_op_desc)->econtext = NULL;               \
+        (_op_desc)->executor = false;              \
+        (_op_desc)->origin_id = UINT64_MAX;        \
+        (_op_desc)->implicit = false;              \
+        (_op_desc)->priority = OP_PRIORITY_NORMAL; \
+        (_op_desc)->queue = NULL;                  \
+        (_op_desc)->sched_seq = 0;                 \
+        (_op_desc)->num_rma = 0;                   \
+        (_op_desc)->gp_uid = INT_MAX;              \
+        (_op_desc)->group_rank = -1;               \
+        (_op_desc)->state = OP_STATE_INIT;         \
+        (_op_desc)->status = DO_SUCCESS;           \
+        (_op_desc)->cancel_requested = false;      \
+        (_op_desc)->started = false;               \
+        (_op_desc)->num_inputs = 0;                \
+        (_op_desc)->num_outputs = 0;               \
+        (_op_desc)->args = NULL;                   \
+        (_op_desc)->args_len = 0;                  \
+        (_op_desc)->completion_cb = NULL;          \
+        (_op_desc)->completion_ctx = NULL;         \
+        (_op_desc)->op_data = NULL;                \
+        (_op_desc)->completed = false;             \
     } while (0)
 
-#if 0
-typedef struct active_ops
+/*
+ * Payload of AM_OP_START_MSG_ID: the header is followed by the input buffers, the output buffers
+ * and the arguments of the operation.
+ */
+typedef struct op_start_msg
 {
-    size_t num_active_ops;
-    op_desc_t *ops;
-} active_ops_t;
-#endif
+    uint64_t alg_id;
+    uint64_t id;
+    int64_t gp_uid;
+    int64_t group_rank;
+    uint64_t num_inputs;
+    uint64_t num_outputs;
+    uint64_t args_len;
+    uint64_t priority; // See op_priority_t
+} op_start_msg_t;
+
+// Payload of AM_OP_COMPLETION_MSG_ID. The group and rank identify the operation along with its ID,
+// e.g., when the ranks of a group sharing an execution context post the same collective.
+typedef struct op_completion_msg
+{
+    uint64_t id;
+    int64_t gp_uid;
+    int64_t group_rank;
+    uint64_t state; // See op_state_t
+    int64_t status;
+} op_completion_msg_t;
+
+// Payload of AM_OP_CANCEL_MSG_ID
+typedef struct op_cancel_msg
+{
+    uint64_t id;
+    int64_t gp_uid;
+    int64_t group_rank;
+} op_cancel_msg_t;
+
+// Header of the payload of AM_OP_SP_MSG_ID, followed by the data of the operation
+typedef struct op_sp_msg_hdr
+{
+    uint64_t alg_id;
+    uint64_t id;
+    int64_t gp_uid;
+    // Rank whose operation is the destination of the message
+    int64_t dst_rank;
+    uint64_t len;
+} op_sp_msg_hdr_t;
+
+// Message between service processes waiting to be delivered to its operation
+typedef struct op_pending_msg
+{
+    ucs_list_link_t item;
+    // Time in microseconds at which the message was queued (monotonic_time_us())
+    uint64_t ts;
+    op_sp_msg_hdr_t hdr;
+    void *data;
+} op_pending_msg_t;
+
+// Collective operation that reached a final state, the messages still sent to it are dropped
+typedef struct op_final
+{
+    ucs_list_link_t item;
+    // Next record with the same key in the hash table of the engine (hash collision)
+    struct op_final *next;
+    // Key in the hash table of the engine, hash of the tuple identifying the operation
+    uint64_t key;
+    uint64_t alg_id;
+    uint64_t id;
+    int64_t gp_uid;
+    int64_t group_rank;
+    // Time in microseconds at which the operation reached its final state (monotonic_time_us())
+    uint64_t ts;
+} op_final_t;
+
+KHASH_MAP_INIT_INT64(op_final_hash_t, op_final_t *);
 
 /* OFFLOADING ENGINE, CLIENTS/SERVERS */
 
@@ -348,11 +718,6 @@ typedef struct group_id
         (__dest_gp_id)->lead = (__src_gp_id)->lead; \
     } while (0)
 
-// group_uid_t is the type used to handle the uniquely identifiable value for any group
-// Technically, it is a hash of the group identifier, the group lead and the group
-// signature
-typedef int group_uid_t;
-
 typedef uint64_t host_uid_t;
 
 #define UNKNOWN_HOST UINT64_MAX
@@ -490,6 +855,434 @@ typedef struct shadow_service_proc_info
     ucp_ep_h shadow_ep;      // endpoint to reach the attached DPU
 } shadow_service_pro_info_t;
 
+// Endpoint to a remote worker, shared by all the cache entries of all the groups
+// the remote worker is involved in.
+typedef struct ep_pool_entry
+{
+    // So it can be used with lists (idle endpoints, pool of free entries)
+    ucs_list_link_t item;
+
+    // Next entry with the same address hash
+    struct ep_pool_entry *next;
+
+    // Hash of the worker address, key in the pool's hash table
+    uint64_t key;
+
+    // Endpoint to reach the remote worker
+    ucp_ep_h ep;
+
+    // Number of cache entries referencing the endpoint
+    size_t refcount;
+
+    // Address of the remote worker, used to resolve hash collisions
+    size_t addr_len;
+    char addr[MAX_ADDR_LEN];
+} ep_pool_entry_t;
+
+// Keys are hashes of worker addresses, values the first entry with that hash
+KHASH_MAP_INIT_INT64(ep_pool_hash_t, ep_pool_entry_t *);
+
+// Engine-level pool of endpoints so a single endpoint is created per remote worker,
+// no matter how many groups the remote worker is involved in. Endpoints that are not
+// referenced anymore are kept open so they can be reused when a group is re-created,
+// unless the number of idle endpoints goes over the limit (see MIMOSA_EP_POOL_MAX_IDLE).
+typedef struct ep_pool
+{
+    // Endpoints in the pool, referenced or idle
+    khash_t(ep_pool_hash_t) * eps;
+
+    // Pool of ep_pool_entry_t objects
+    dyn_list_t *free_entries;
+
+    // Endpoints that are not referenced anymore, least recently released first
+    ucs_list_link_t idle_eps;
+
+    // Number of endpoints on the idle list
+    size_t num_idle;
+
+    // Maximum number of idle endpoints kept open, SIZE_MAX meaning no limit
+    size_t max_idle;
+
+    // Total number of endpoints in the pool
+    size_t num_eps;
+} ep_pool_t;
+
+struct offloading_engine;
+
+/**
+ * @brief Initialize an endpoint pool.
+ *
+ * @param[in,out] pool Pool to initialize
+ * @return dpu_offload_status_t
+ */
+dpu_offload_status_t ep_pool_init(ep_pool_t *pool);
+
+/**
+ * @brief Close all the endpoints of the engine's endpoint pool, referenced or not, and free the pool.
+ *
+ * @param[in] engine Engine associated to the pool
+ */
+void ep_pool_fini(struct offloading_engine *engine);
+
+/**
+ * @brief Get a reference to the endpoint of a remote worker, creating it if necessary.
+ *
+ * @param[in] engine Engine associated to the pool
+ * @param[in] addr Address of the remote worker
+ * @param[in] addr_len Length of the address
+ * @return The pool entry with a reference for the caller, NULL if the endpoint cannot be created
+ */
+ep_pool_entry_t *ep_pool_get(struct offloading_engine *engine, const void *addr, size_t addr_len);
+
+/**
+ * @brief Release a reference to an endpoint obtained with ep_pool_get(). Endpoints without
+ * reference are kept open for reuse, unless there are too many idle endpoints, in which case
+ * the least recently released ones are closed.
+ *
+ * @param[in] engine Engine associated to the pool
+ * @param[in] entry Pool entry to release
+ */
+void ep_pool_release(struct offloading_engine *engine, ep_pool_entry_t *entry);
+
+/**
+ * @brief Close all the endpoints of the pool that are not referenced, e.g., once the ranks
+ * of a job are gone.
+ *
+ * @param[in] engine Engine associated to the pool
+ */
+void ep_pool_flush(struct offloading_engine *engine);
+
+/*
+ * Bootstrapping over OOB is a single exchange of frames: right after the connection
+ * is established, the client sends its frame and the server answers with its own. Each
+ * frame is a fixed-size header followed by the sender's worker address.
+ */
+
+// Frame sent by a client to the server it connects to
+typedef struct oob_client_hello
+{
+    // Total length of the frame, including the header
+    uint64_t frame_len;
+
+    // Group/rank of the client
+    rank_info_t rank_info;
+
+    // Resume token the server gave us during our previous connection, 0 if none (see MIMOSA_RESUME_DIR)
+    uint64_t resume_token;
+
+    // Length of the client's worker address following the header
+    uint64_t addr_len;
+} oob_client_hello_t;
+
+// Frame sent by a server to a client it just accepted
+typedef struct oob_server_hello
+{
+    // Total length of the frame, including the header
+    uint64_t frame_len;
+
+    // Unique identifier of the server
+    uint64_t server_id;
+
+    // Global identifier of the service process running the server, UINT64_MAX on the host
+    uint64_t server_global_id;
+
+    // Identifier assigned to the client
+    uint64_t client_id;
+
+    // Token the client presents to get its slot back when it reconnects, 0 if resuming is disabled
+    uint64_t resume_token;
+
+    // Length of the server's worker address following the header
+    uint64_t addr_len;
+} oob_server_hello_t;
+
+/*
+ * With the file and shm rendezvous backends (see MIMOSA_RENDEZVOUS), servers publish a
+ * record with their worker address instead of accepting socket connections. A client reads
+ * the record of its server, creates its endpoint to the server right away and sends a hello
+ * active message carrying its own address. The server answers with a welcome active message
+ * carrying the client's identifier once its endpoint to the client is created.
+ */
+
+typedef enum
+{
+    RENDEZVOUS_OOB = 0,
+    RENDEZVOUS_FILE,
+    RENDEZVOUS_SHM,
+} rendezvous_backend_t;
+
+// Record published by a server, followed by the server's worker address
+typedef struct rendezvous_record
+{
+    uint64_t magic;
+
+    // Set last so a client never uses a partially written record (shm backend)
+    uint64_t ready;
+
+    // Opaque key identifying the server in the hello messages
+    uint64_t server_key;
+
+    // Unique identifier of the server
+    uint64_t server_id;
+
+    // Global identifier of the service process running the server, UINT64_MAX on the host
+    uint64_t server_global_id;
+
+    // Length of the server's worker address following the record
+    uint64_t addr_len;
+} rendezvous_record_t;
+
+// Header of the hello active message, the payload is the client's worker address
+typedef struct rendezvous_hello
+{
+    // Key of the server from its record
+    uint64_t server_key;
+
+    // Opaque token the server sends back in its welcome
+    uint64_t token;
+
+    // Group/rank of the client
+    rank_info_t rank_info;
+
+    // Resume token from the client's previous connection, 0 if none
+    uint64_t resume_token;
+
+    // Length of the client's worker address
+    uint64_t addr_len;
+} rendezvous_hello_t;
+
+// Header of the welcome active message, no payload
+typedef struct rendezvous_welcome
+{
+    // Token from the client's hello, 0 when the client did not connect through a rendezvous backend
+    uint64_t token;
+
+    // Identifier assigned to the client
+    uint64_t client_id;
+
+    // Token the client presents to get its slot back when it reconnects, 0 if resuming is disabled
+    uint64_t resume_token;
+} rendezvous_welcome_t;
+
+// Hello received by a server and not handled yet
+typedef struct rendezvous_pending_hello
+{
+    ucs_list_link_t item;
+    rendezvous_hello_t hello;
+    void *peer_addr;
+} rendezvous_pending_hello_t;
+
+// Engine-level state of the rendezvous backends, shared with the active message handlers
+typedef struct rendezvous
+{
+    pthread_mutex_t mutex;
+
+    // Clients waiting for the welcome of their server (type: dpu_offload_client_t)
+    ucs_list_link_t clients;
+
+    // Hellos received for the servers of the engine (type: rendezvous_pending_hello_t)
+    ucs_list_link_t hellos;
+} rendezvous_t;
+
+#define RESET_RENDEZVOUS(_r)                                      \
+    do                                                            \
+    {                                                             \
+        (_r)->mutex = (pthread_mutex_t)PTHREAD_MUTEX_INITIALIZER; \
+        ucs_list_head_init(&((_r)->clients));                     \
+        ucs_list_head_init(&((_r)->hellos));                      \
+    } while (0)
+
+// Rendezvous backend used by the engine, RENDEZVOUS_OOB when the engine has no configuration
+#define RENDEZVOUS_BACKEND(_engine) \
+    ((_engine)->config != NULL ? (_engine)->config->rendezvous.backend : RENDEZVOUS_OOB)
+
+// Forward declarations
+struct execution_context;
+struct peer_info;
+
+/**
+ * @brief Publish the record of a server so clients can find its address.
+ * Note: the function assumes the execution context is NOT locked before it is invoked.
+ *
+ * @param[in] econtext Server execution context
+ * @return dpu_offload_status_t
+ */
+dpu_offload_status_t rendezvous_server_publish(struct execution_context *econtext);
+
+/**
+ * @brief Remove the record of a server and drop the hellos that were not handled.
+ *
+ * @param[in] econtext Server execution context
+ */
+void rendezvous_server_unpublish(struct execution_context *econtext);
+
+/**
+ * @brief Handle the hellos received for a server: the clients are assigned an identifier
+ * and are then in the OOB_CONNECT_DONE phase, like after an OOB handshake.
+ * Note: the function assumes the execution context is NOT locked before it is invoked.
+ *
+ * @param[in] econtext Server execution context
+ */
+void rendezvous_server_progress(struct execution_context *econtext);
+
+/**
+ * @brief Send the welcome to a client that connected through a rendezvous backend, once the
+ * endpoint to the client is created. Nothing is sent to clients that connected through OOB.
+ * Note: the function assumes the execution context is locked before it is invoked.
+ *
+ * @param[in] econtext Server execution context
+ * @param[in] client_info Data about the client
+ * @return dpu_offload_status_t
+ */
+dpu_offload_status_t rendezvous_server_welcome(struct execution_context *econtext, struct peer_info *client_info);
+
+/**
+ * @brief Initiate the connection of a client through the rendezvous backend of the engine.
+ * The connection is then established by rendezvous_client_connect_progress().
+ * Note: the function assumes the execution context is locked before it is invoked.
+ *
+ * @param[in] econtext Client execution context
+ * @return dpu_offload_status_t
+ */
+dpu_offload_status_t rendezvous_client_connect(struct execution_context *econtext);
+
+/**
+ * @brief Make progress on the connection of a client, without blocking: look up the record of
+ * the server until it is published, then send the hello. The client reaches the OOB_CONNECT_DONE
+ * phase when the welcome of the server is received.
+ * Note: the function assumes the execution context is locked before it is invoked.
+ *
+ * @param[in] econtext Client execution context
+ * @return DO_ERROR if the connection could not be established before the deadline, DO_SUCCESS otherwise
+ */
+dpu_offload_status_t rendezvous_client_connect_progress(struct execution_context *econtext);
+
+/**
+ * @brief Release the rendezvous resources of a client, e.g., before it is finalized or reconnects.
+ *
+ * @param[in] econtext Client execution context
+ */
+void rendezvous_client_fini(struct execution_context *econtext);
+
+/**
+ * @brief Release the rendezvous resources of the engine.
+ *
+ * @param[in] engine
+ */
+void rendezvous_fini(struct offloading_engine *engine);
+
+typedef enum
+{
+    OOB_REACTOR_WAKEUP = 0,
+    OOB_REACTOR_LISTENER,
+    OOB_REACTOR_CONN,
+} oob_reactor_handle_type_t;
+
+// File descriptor registered with the OOB reactor. Handles are heap-allocated so they
+// remain valid until the reactor is done with the batch of events that may reference them.
+typedef struct oob_reactor_handle
+{
+    // So it can be used with lists (listeners, pending handshakes, closed handles)
+    ucs_list_link_t item;
+
+    oob_reactor_handle_type_t type;
+
+    // Socket, -1 once closed
+    int fd;
+
+    // epoll events the socket is registered for, 0 when not registered
+    uint32_t events;
+
+    // Server execution context the socket is associated to
+    struct execution_context *econtext;
+
+    // OOB_REACTOR_CONN only: identifier assigned to the client (UINT64_MAX until the client's
+    // frame is received) and peer IP address
+    uint64_t client_id;
+    char peer_addr_str[INET_ADDRSTRLEN];
+
+    // OOB_REACTOR_CONN only: handshake frame being sent to the client
+    void *frame;
+    size_t frame_len;
+    size_t frame_offset;
+
+    // OOB_REACTOR_CONN only: handshake frame being received from the client,
+    // the worker address is allocated once the header is received
+    oob_client_hello_t hello;
+    void *peer_addr;
+    size_t recv_offset;
+} oob_reactor_handle_t;
+
+// Engine-level reactor accepting and handshaking OOB connections for all the
+// servers of the engine, using a single thread and non-blocking sockets.
+typedef struct oob_reactor
+{
+    // epoll file descriptor, -1 until the reactor is started
+    int epfd;
+
+    // eventfd used to interrupt the reactor thread
+    int wakeup_fd;
+    oob_reactor_handle_t wakeup;
+
+    bool running;
+    pthread_t tid;
+    pthread_mutex_t mutex;
+
+    // Listening sockets of the servers
+    ucs_list_link_t listeners;
+    size_t num_listeners;
+
+    // Connections accepted for which the handshake is in progress
+    ucs_list_link_t conns;
+    size_t num_conns;
+
+    // Handles closed while the reactor thread may still reference them
+    ucs_list_link_t closed;
+} oob_reactor_t;
+
+#define RESET_OOB_REACTOR(_r)                                     \
+    do                                                            \
+    {                                                             \
+        (_r)->epfd = -1;                                          \
+        (_r)->wakeup_fd = -1;                                     \
+        (_r)->running = false;                                    \
+        (_r)->mutex = (pthread_mutex_t)PTHREAD_MUTEX_INITIALIZER; \
+        ucs_list_head_init(&((_r)->listeners));                   \
+        (_r)->num_listeners = 0;                                  \
+        ucs_list_head_init(&((_r)->conns));                       \
+        (_r)->num_conns = 0;                                      \
+        ucs_list_head_init(&((_r)->closed));                      \
+    } while (0)
+
+/**
+ * @brief Register a server with the engine's OOB reactor. The server's listening
+ * socket is created and the reactor thread is started if necessary.
+ * Note: the function assumes the execution context is NOT locked before it is invoked.
+ *
+ * @param[in] engine Engine associated to the reactor
+ * @param[in] econtext Server execution context
+ * @return dpu_offload_status_t
+ */
+dpu_offload_status_t oob_reactor_add_server(struct offloading_engine *engine, struct execution_context *econtext);
+
+/**
+ * @brief Unregister a server from the engine's OOB reactor, closing its listening socket
+ * and aborting the handshakes in progress. Once the function returns, the reactor does
+ * not reference the server anymore.
+ * Note: the function assumes the execution context is NOT locked before it is invoked.
+ *
+ * @param[in] engine Engine associated to the reactor
+ * @param[in] econtext Server execution context
+ */
+void oob_reactor_remove_server(struct offloading_engine *engine, struct execution_context *econtext);
+
+/**
+ * @brief Stop the reactor thread and close all the sockets managed by the reactor.
+ *
+ * @param[in] engine Engine associated to the reactor
+ */
+void oob_reactor_fini(struct offloading_engine *engine);
+
 typedef struct peer_cache_entry
 {
     // Is the entry set?
@@ -504,6 +1297,9 @@ typedef struct peer_cache_entry
     // endpoint to reach the peer
     ucp_ep_h ep;
 
+    // Entry of the engine's endpoint pool that 'ep' comes from, NULL if not from the pool
+    ep_pool_entry_t *pooled_ep;
+
     // Number of the peer's shadow service process(es)
     size_t num_shadow_service_procs;
 
@@ -528,6 +1324,7 @@ typedef struct peer_cache_entry
         RESET_PEER_DATA(&((_e)->peer));                               \
         (_e)->client_id = UINT64_MAX;                                 \
         (_e)->ep = NULL;                                              \
+        (_e)->pooled_ep = NULL;                                       \
         for (_idx = 0; _idx < (_e)->num_shadow_service_procs; _idx++) \
         {                                                             \
             (_e)->shadow_service_procs[_idx] = UINT64_MAX;            \
@@ -547,6 +1344,42 @@ typedef struct peer_cache_entry
         (_e)->events_initialized = false;                             \
     } while (0)
 
+// Invalidate a cache entry when its group is revoked. Only the state of the entry is
+// cleared, its endpoint having been released; the data of the entry is reset when the
+// entry is set again (see PREPARE_PEER_CACHE_ENTRY()).
+#define REVOKE_PEER_CACHE_ENTRY(_e)                                   \
+    do                                                                \
+    {                                                                 \
+        dpu_offload_event_t *__ev = NULL;                             \
+        (_e)->set = false;                                            \
+        (_e)->ep = NULL;                                              \
+        (_e)->pooled_ep = NULL;                                       \
+        if ((_e)->events_initialized)                                 \
+        {                                                             \
+            while (!SIMPLE_LIST_IS_EMPTY(&((_e)->events)))            \
+            {                                                         \
+                __ev = SIMPLE_LIST_EXTRACT_HEAD(&((_e)->events),      \
+                                                dpu_offload_event_t,  \
+                                                item);                \
+                assert(__ev);                                         \
+                event_return(&__ev);                                  \
+            }                                                         \
+        }                                                             \
+    } while (0)
+
+// Reset the data left in a cache entry by a revoked version of its group before setting
+// the entry. Pending events, e.g., requests waiting for the entry, are kept.
+#define PREPARE_PEER_CACHE_ENTRY(_e)                                  \
+    do                                                                \
+    {                                                                 \
+        if (!(_e)->set)                                               \
+        {                                                             \
+            RESET_PEER_DATA(&((_e)->peer));                           \
+            (_e)->client_id = UINT64_MAX;                             \
+            (_e)->num_shadow_service_procs = 0;                       \
+        }                                                             \
+    } while (0)
+
 typedef struct cache_entry_request
 {
     ucs_list_link_t item;
@@ -563,6 +1396,28 @@ typedef struct cache_entry_request
     int64_t rank;
 } cache_entry_request_t;
 
+// Number of ranks covered by a single on-demand cache entry request. When a rank is missing
+// from the cache, the entries of all the ranks of its block that are still missing are
+// requested at once, i.e., neighbouring ranks are prefetched.
+#define CACHE_ENTRIES_REQUEST_BLOCK_SIZE (64)
+
+// Payload of a AM_PEER_CACHE_ENTRIES_REQUEST_MSG_ID notification, requesting the cache
+// entries of a contiguous range of ranks of a group.
+typedef struct cache_entries_request
+{
+    // UID of the group
+    group_uid_t gp_uid;
+
+    // Size of the group, GROUP_SIZE_UNKNOWN if not known by the requester
+    int64_t group_size;
+
+    // First rank of the range
+    int64_t rank_start;
+
+    // Number of ranks in the range
+    int64_t num_ranks;
+} cache_entries_request_t;
+
 /**
  * @brief am_header_t is the structure used to represent the header sent with UCX active messages
  */
@@ -784,24 +1639,12 @@ typedef struct notif_reception
 typedef struct boostrapping
 {
     int phase;
-    struct ucx_context *addr_size_request;
-    am_req_t addr_size_ctx;
-    struct ucx_context *addr_request;
-    am_req_t addr_ctx;
-    struct ucx_context *rank_request;
-    am_req_t rank_ctx;
 } bootstrapping_t;
 
 #define RESET_BOOTSTRAPPING(_b)                \
     do                                         \
     {                                          \
         (_b)->phase = BOOTSTRAP_NOT_INITIATED; \
-        (_b)->addr_size_request = NULL;        \
-        RESET_AM_REQ(&((_b)->addr_size_ctx));  \
-        (_b)->addr_request = NULL;             \
-        RESET_AM_REQ(&((_b)->addr_ctx));       \
-        (_b)->rank_request = NULL;             \
-        RESET_AM_REQ(&((_b)->rank_ctx));       \
     } while (0)
 
 typedef struct peer_info
@@ -810,6 +1653,16 @@ typedef struct peer_info
 
     uint64_t id;
 
+    // Generation of the slot, incremented every time the slot is released (see CLIENT_ID)
+    uint32_t generation;
+
+    // Token the client presents to get the slot back when it reconnects, 0 if resuming is disabled
+    uint64_t resume_token;
+
+    // Whether the client disconnected and the slot is kept for it until resume_deadline (see MIMOSA_RESUME_TTL)
+    bool parked;
+    uint64_t resume_deadline;
+
 #if USE_AM_IMPLEM
     am_req_t ctx;
 #else
@@ -832,6 +1685,9 @@ typedef struct peer_info
     // Peer's endpoint status
     ucs_status_t ep_status;
 
+    // Welcome to send to a client that connected through a rendezvous backend
+    rendezvous_welcome_t rdv_welcome;
+
     rank_info_t rank_data;
 
     // Dynamic array of group/proc entries, one per group. A rank can belong to multiple groups but have a single endpoint.
@@ -917,8 +1773,28 @@ typedef struct connected_clients
     // Number of clients in the process of connecting
     size_t num_ongoing_connections;
 
-    // Dynamic array of structures to track connected clients (type: peer_info_t)
+    // Number of clients accepted for which the OOB handshake is still in progress
+    size_t num_oob_handshakes;
+
+    // Number of clients that disconnected and whose slot is not released yet
+    size_t num_disconnected_clients;
+
+    // Number of slots kept for clients that disconnected and may resume (see MIMOSA_RESUME_TTL)
+    size_t num_parked_clients;
+
+    // Earliest time in microseconds at which a parked slot expires
+    uint64_t resume_expiry;
+
+    // Dynamic array of structures to track connected clients, indexed by slot (type: peer_info_t)
     dyn_array_t clients;
+
+    // Number of slots in use or available for reuse, i.e., slots past it were never used.
+    // Reset once all the clients are gone, e.g., at the end of a job, so the slots are compacted.
+    size_t num_slots;
+
+    // Stack of released slots, reused before new slots (type: uint64_t)
+    dyn_array_t free_slots;
+    size_t num_free_slots;
 } connected_clients_t;
 
 #define RESET_CONNECTED_CLIENTS(_c)            \
@@ -927,6 +1803,11 @@ typedef struct connected_clients
         (_c)->num_total_connected_clients = 0; \
         (_c)->num_connected_clients = 0;       \
         (_c)->num_ongoing_connections = 0;     \
+        (_c)->num_oob_handshakes = 0;          \
+        (_c)->num_disconnected_clients = 0;    \
+        (_c)->num_parked_clients = 0;          \
+        (_c)->num_slots = 0;                   \
+        (_c)->num_free_slots = 0;              \
     } while (0)
 
 /**
@@ -1041,6 +1922,10 @@ typedef struct init_params
 
     // Callback to invoke when a connection completes
     connect_completed_cb connected_cb;
+
+    // Whether client_init() returns right away and the connection is established while
+    // progressing the execution context, regardless of MIMOSA_ASYNC_CONNECT
+    bool async_connect;
 } init_params_t;
 
 #define RESET_INIT_PARAMS(_params)            \
@@ -1053,6 +1938,7 @@ typedef struct init_params
         (_params)->id_set = false;            \
         (_params)->connected_cb = NULL;       \
         (_params)->scope_id = SCOPE_HOST_DPU; \
+        (_params)->async_connect = false;     \
     } while (0)
 
 #if OFFLOADING_MT_ENABLE
@@ -1238,6 +2124,18 @@ typedef struct dpu_offload_server_t
             size_t peer_addr_len;
             int sock;
             int listenfd;
+            // Handle of the listening socket in the engine's OOB reactor
+            oob_reactor_handle_t *listener;
+
+            // Record published with the file and shm rendezvous backends
+            struct
+            {
+                bool published;
+
+                // Mapping of the shared memory segment (shm backend)
+                void *map;
+                size_t map_len;
+            } rdv;
             int tag;
             char *addr_msg_str;
             ucp_tag_t tag_mask;
@@ -1273,6 +2171,10 @@ typedef struct dpu_offload_client_t
 
     uint64_t server_global_id;
 
+    // Resume token presented to the server when connecting (loaded from MIMOSA_RESUME_DIR), replaced
+    // by the token the server gives us once connected. 0 if none.
+    uint64_t resume_token;
+
     // Execution context the server is associated to
     struct execution_context *econtext;
 
@@ -1283,6 +2185,9 @@ typedef struct dpu_offload_client_t
     // Callback to invoke when a connection completes
     connect_completed_cb connected_cb;
 
+    // Whether the connection is established while progressing the execution context
+    bool async_connect;
+
     ucp_ep_h server_ep;
     ucs_status_t server_ep_status;
 #if OFFLOADING_MT_ENABLE
@@ -1306,6 +2211,43 @@ typedef struct dpu_offload_client_t
             int sock;
             char *addr_msg_str;
             int tag;
+
+            // State of the non-blocking connection to the server
+            struct
+            {
+                // Addresses of the server and address currently tried
+                struct addrinfo *addrs;
+                struct addrinfo *cur;
+
+                // Whether a connect() is pending on the socket
+                bool pending;
+
+                // Time in microseconds when the connection was initiated
+                uint64_t start;
+
+                // Time in microseconds of the next attempt and delay before the attempt after it
+                uint64_t next_attempt;
+                uint64_t backoff;
+
+                size_t num_attempts;
+
+                // Seed to add jitter to the delay between attempts
+                unsigned int seed;
+            } connect;
+
+            // State of the connection with the file and shm rendezvous backends
+            struct
+            {
+                bool active;
+
+                // Whether the hello was sent, the client then waits for the server's welcome
+                bool hello_sent;
+                rendezvous_hello_t hello;
+
+                // So the client can be added to the engine's list of clients waiting for a welcome
+                ucs_list_link_t item;
+                bool queued;
+            } rdv;
         } oob;
     } conn_data;
 } dpu_offload_client_t;
@@ -1321,6 +2263,7 @@ typedef struct dpu_offload_client_t
         RESET_CONN_PARAMS(&((_c)->conn_params));     \
         (_c)->done = false;                          \
         (_c)->connected_cb = NULL;                   \
+        (_c)->async_connect = false;                 \
         (_c)->server_ep = NULL;                      \
         (_c)->event_channels = NULL;                 \
     } while (0)
@@ -1336,6 +2279,9 @@ typedef enum
     // Bootstrapping is not yet initiated but bootstrapping can be initiated any time.
     BOOTSTRAP_NOT_INITIATED = 0,
 
+    // The client is trying to connect to its server, see MIMOSA_ASYNC_CONNECT.
+    OOB_CONNECT_IN_PROGRESS,
+
     // Bootstrapping OOB connection has been completed.
     OOB_CONNECT_DONE,
 
@@ -1672,15 +2618,20 @@ typedef enum
 /*********************/
 
 /**
- * @brief Type used to define and use bitset of any size
+ * @brief Type used to define and use bitset of any size. Bitsets are arrays of 64-bit
+ * words so counting, looking up set bits and bulk operations are performed a word at
+ * a time instead of a bit at a time.
  */
-typedef char group_cache_bitset_t;
+typedef uint64_t group_cache_bitset_t;
+
+// Number of bits in a slot of a bitset
+#define GROUP_CACHE_BITSET_SLOT_BITS (64)
 
 // Create a bitset mask
-#define GROUP_CACHE_BITSET_MASK(_bit) (1 << ((_bit) % CHAR_BIT))
+#define GROUP_CACHE_BITSET_MASK(_bit) (1ULL << ((_bit) % GROUP_CACHE_BITSET_SLOT_BITS))
 
 // Return the slot of a given bit
-#define GROUP_CACHE_BITSET_SLOT(_bit) ((_bit) / CHAR_BIT)
+#define GROUP_CACHE_BITSET_SLOT(_bit) ((_bit) / GROUP_CACHE_BITSET_SLOT_BITS)
 
 // Set a given bit in a bitset
 #define GROUP_CACHE_BITSET_SET(_bitset, _bit) ((_bitset)[GROUP_CACHE_BITSET_SLOT(_bit)] |= GROUP_CACHE_BITSET_MASK(_bit))
@@ -1691,8 +2642,109 @@ typedef char group_cache_bitset_t;
 // Test if a bit in the bitset is set; returns 0 if the bit is not set, non-zero otherwise.
 #define GROUP_CACHE_BITSET_TEST(_bitset, _bitset_idx) ((_bitset)[GROUP_CACHE_BITSET_SLOT(_bitset_idx)] & GROUP_CACHE_BITSET_MASK(_bitset_idx))
 
-// Return the number of slots required to implement a bitset of a given size
-#define GROUP_CACHE_BITSET_NSLOTS(_bitset_size) ((_bitset_size + CHAR_BIT - 1) / CHAR_BIT)
+// Return the number of slots required to implement a bitset of a given size
+#define GROUP_CACHE_BITSET_NSLOTS(_bitset_size) (((_bitset_size) + GROUP_CACHE_BITSET_SLOT_BITS - 1) / GROUP_CACHE_BITSET_SLOT_BITS)
+
+// Return the number of bits that are set among the first _nbits bits of a bitset.
+// Used for instance to get the index of an element in a contiguous list built from the bitset.
+#define GROUP_CACHE_BITSET_COUNT(_bitset, _nbits) ({                                      \
+    size_t __n_set = 0;                                                                   \
+    size_t __slot;                                                                        \
+    size_t __full_slots = (size_t)(_nbits) / GROUP_CACHE_BITSET_SLOT_BITS;                \
+    size_t __remainder = (size_t)(_nbits) % GROUP_CACHE_BITSET_SLOT_BITS;                 \
+    for (__slot = 0; __slot < __full_slots; __slot++)                                     \
+        __n_set += __builtin_popcountll((_bitset)[__slot]);                               \
+    if (__remainder != 0)                                                                 \
+        __n_set += __builtin_popcountll((_bitset)[__full_slots] &                         \
+                                        ((1ULL << __remainder) - 1));                     \
+    __n_set;                                                                              \
+})
+
+// Execute the code passed as last argument for every bit set among the first _nbits bits of a bitset,
+// in order; _bit is the index of the set bit. Set bits are found a word at a time using ctz.
+// The code can use 'continue' but must not use 'break'.
+#define GROUP_CACHE_BITSET_FOREACH(_bitset, _nbits, _bit, ...)                           \
+    do                                                                                    \
+    {                                                                                     \
+        size_t __fe_slot;                                                                 \
+        size_t __fe_nslots = GROUP_CACHE_BITSET_NSLOTS((size_t)(_nbits));                 \
+        for (__fe_slot = 0; __fe_slot < __fe_nslots; __fe_slot++)                         \
+        {                                                                                 \
+            group_cache_bitset_t __fe_word = (_bitset)[__fe_slot];                        \
+            while (__fe_word != 0)                                                        \
+            {                                                                             \
+                size_t _bit = __fe_slot * GROUP_CACHE_BITSET_SLOT_BITS +                  \
+                              __builtin_ctzll(__fe_word);                                 \
+                __fe_word &= __fe_word - 1;                                               \
+                if (_bit >= (size_t)(_nbits))                                             \
+                    break;                                                                \
+                __VA_ARGS__;                                                              \
+            }                                                                             \
+        }                                                                                 \
+    } while (0)
+
+// Bulk OR of two bitsets of _nbits bits: _dst |= _src. Simple loop on words that compilers vectorize.
+#define GROUP_CACHE_BITSET_OR(_dst, _src, _nbits)                                         \
+    do                                                                                    \
+    {                                                                                     \
+        size_t __or_slot;                                                                 \
+        size_t __or_nslots = GROUP_CACHE_BITSET_NSLOTS((size_t)(_nbits));                 \
+        group_cache_bitset_t *__restrict__ __or_dst = (_dst);                             \
+        const group_cache_bitset_t *__restrict__ __or_src = (_src);                       \
+        for (__or_slot = 0; __or_slot < __or_nslots; __or_slot++)                         \
+            __or_dst[__or_slot] |= __or_src[__or_slot];                                   \
+    } while (0)
+
+// Bulk AND of two bitsets of _nbits bits: _dst &= _src. Simple loop on words that compilers vectorize.
+#define GROUP_CACHE_BITSET_AND(_dst, _src, _nbits)                                        \
+    do                                                                                    \
+    {                                                                                     \
+        size_t __and_slot;                                                                \
+        size_t __and_nslots = GROUP_CACHE_BITSET_NSLOTS((size_t)(_nbits));                \
+        group_cache_bitset_t *__restrict__ __and_dst = (_dst);                            \
+        const group_cache_bitset_t *__restrict__ __and_src = (_src);                      \
+        for (__and_slot = 0; __and_slot < __and_nslots; __and_slot++)                     \
+            __and_dst[__and_slot] &= __and_src[__and_slot];                               \
+    } while (0)
+
+// Bulk OR of _src into _dst (_dst |= _src) that returns how many bits were not already
+// set in _dst, e.g., how many new ranks revoked a group.
+#define GROUP_CACHE_BITSET_OR_COUNT_NEW(_dst, _src, _nbits) ({                            \
+    size_t __new_bits = 0;                                                                \
+    size_t __ocn_slot;                                                                    \
+    size_t __ocn_nslots = GROUP_CACHE_BITSET_NSLOTS((size_t)(_nbits));                    \
+    group_cache_bitset_t *__restrict__ __ocn_dst = (_dst);                                \
+    const group_cache_bitset_t *__restrict__ __ocn_src = (_src);                          \
+    for (__ocn_slot = 0; __ocn_slot < __ocn_nslots; __ocn_slot++)                         \
+    {                                                                                     \
+        __new_bits += __builtin_popcountll(__ocn_src[__ocn_slot] & ~__ocn_dst[__ocn_slot]); \
+        __ocn_dst[__ocn_slot] |= __ocn_src[__ocn_slot];                                   \
+    }                                                                                     \
+    __new_bits;                                                                           \
+})
+
+// Set the _num bits starting at bit _start, one word at a time, and return how many bits
+// were not already set, e.g., how many new ranks revoked a group.
+#define GROUP_CACHE_BITSET_SET_RANGE_COUNT_NEW(_dst, _start, _num) ({                     \
+    size_t __range_new = 0;                                                               \
+    size_t __range_bit = (size_t)(_start);                                                \
+    size_t __range_end = __range_bit + (size_t)(_num);                                    \
+    while (__range_bit < __range_end)                                                     \
+    {                                                                                     \
+        size_t __range_off = __range_bit % GROUP_CACHE_BITSET_SLOT_BITS;                  \
+        size_t __range_len = GROUP_CACHE_BITSET_SLOT_BITS - __range_off;                  \
+        group_cache_bitset_t __range_mask = ~0ULL;                                        \
+        group_cache_bitset_t *__range_word = &((_dst)[GROUP_CACHE_BITSET_SLOT(__range_bit)]); \
+        if (__range_len > __range_end - __range_bit)                                      \
+            __range_len = __range_end - __range_bit;                                      \
+        if (__range_len < GROUP_CACHE_BITSET_SLOT_BITS)                                   \
+            __range_mask = ((1ULL << __range_len) - 1) << __range_off;                    \
+        __range_new += __builtin_popcountll(__range_mask & ~(*__range_word));             \
+        *__range_word |= __range_mask;                                                    \
+        __range_bit += __range_len;                                                       \
+    }                                                                                     \
+    __range_new;                                                                          \
+})
 
 // Create a given bitset based on a size
 // It is assumed that the bitset is set to NULL when not initialized
@@ -1717,6 +2769,40 @@ typedef char group_cache_bitset_t;
         }                                       \
     } while (0)
 
+// Number of bits of the bitsets tracking service processes of a group. These bitsets are
+// indexed by global SP identifiers, so they must cover all the SPs known by the engine,
+// even when the group is smaller than the number of SPs.
+#define GROUP_CACHE_SPS_BITSET_SIZE(_engine, _gp_cache)                 \
+    (((_engine)->num_service_procs > (size_t)(_gp_cache)->group_size) ? \
+         (_engine)->num_service_procs                                   \
+         : (size_t)(_gp_cache)->group_size)
+
+// Bitsets of group caches come from a pool kept by the cache (see cache_t), so the bitsets of a
+// revoked group can be reused by any group of the same size, including the same group when it is
+// re-created. Free bitsets are keyed by their number of slots and chained through their first
+// slot. A pooled bitset is preceded by a hidden slot holding its number of slots so it must be
+// created and released with the following macros, not with GROUP_CACHE_BITSET_CREATE/DESTROY.
+KHASH_MAP_INIT_INT64(group_cache_bitset_pool_t, group_cache_bitset_t *);
+
+// Get a zeroed bitset of _size bits from the pool of a cache, when the bitset is not set yet
+#define GROUP_CACHE_BITSET_POOL_GET(_cache, _bitset_ptr, _size)                        \
+    do                                                                                 \
+    {                                                                                  \
+        if ((_bitset_ptr) == NULL)                                                     \
+            _bitset_ptr = group_cache_bitset_pool_get((_cache), (size_t)(_size));      \
+    } while (0)
+
+// Return a bitset to the pool of a cache
+#define GROUP_CACHE_BITSET_POOL_PUT(_cache, _bitset_ptr)                               \
+    do                                                                                 \
+    {                                                                                  \
+        if ((_bitset_ptr) != NULL)                                                     \
+        {                                                                              \
+            group_cache_bitset_pool_put((_cache), (_bitset_ptr));                      \
+            _bitset_ptr = NULL;                                                        \
+        }                                                                              \
+    } while (0)
+
 /**
  * @brief Elements saved in a group cache hash used to know which SPs are
  * involved in a group.
@@ -1759,7 +2845,6 @@ typedef struct sp_cache_data
         (_sp_data)->host_uid = UINT64_MAX;      \
         (_sp_data)->gp_uid = 0;                 \
         (_sp_data)->ranks_bitset = NULL;        \
-        (_sp_data)->ranks_initialized = false;  \
     } while (0)
 
 // Keys for group_sps_hash_t are the SP's GID, i.e., uint64_t
@@ -1843,10 +2928,61 @@ KHASH_MAP_INIT_INT64(group_hosts_hash_t, host_cache_data_t *);
 
 struct remote_service_proc_info; // Forward declaration
 
+// Milestones of the state machine of a group cache, recorded for each version of a group
+// so we can figure out where the time goes when groups are created.
+typedef enum
+{
+    // A rank tried to add the group while its previous version was still being revoked
+    GROUP_CACHE_MILESTONE_ADD_DEFERRED = 0,
+    // The first local rank of the group was added to the cache
+    GROUP_CACHE_MILESTONE_FIRST_LOCAL_RANK,
+    // All the local ranks are in the cache and all the SPs are connected, the broadcast to the other SPs starts
+    GROUP_CACHE_MILESTONE_LOCAL_RANKS_COMPLETE,
+    // The entries of the local ranks have been sent to the other SPs
+    GROUP_CACHE_MILESTONE_BCAST_POSTED,
+    // First cache entries received from another SP
+    GROUP_CACHE_MILESTONE_FIRST_REMOTE_ENTRIES,
+    // All the ranks of the group are in the cache
+    GROUP_CACHE_MILESTONE_CACHE_COMPLETE,
+    // The cache has been sent to all the local ranks
+    GROUP_CACHE_MILESTONE_SENT_TO_HOST,
+    // The lookup tables of the group are populated
+    GROUP_CACHE_MILESTONE_LOOKUP_TABLES,
+    // The group has been revoked. The timeline of the revoked version is kept until the
+    // next version of the group reaches its first milestone.
+    GROUP_CACHE_MILESTONE_REVOKED,
+    GROUP_CACHE_NUM_MILESTONES,
+} group_cache_milestone_t;
+
+// Number of buckets of the histograms of milestone latencies. Bucket 0 is for latencies
+// below 1 microsecond, bucket i for latencies in [2^(i-1), 2^i) microseconds, the last
+// bucket for everything above.
+#define GROUP_CACHE_MILESTONE_HIST_BUCKETS (32)
+
+// Latencies of a milestone, relative to the beginning of the timeline of the group,
+// aggregated across all the groups.
+typedef struct group_cache_milestone_stats
+{
+    uint64_t count;
+
+    // Sum and maximum latency in microseconds
+    uint64_t sum;
+    uint64_t max;
+
+    // UID and sequence number of the group with the maximum latency
+    group_uid_t max_gp_uid;
+    uint64_t max_gp_seq_num;
+
+    uint64_t hist[GROUP_CACHE_MILESTONE_HIST_BUCKETS];
+} group_cache_milestone_stats_t;
+
 typedef struct group_cache
 {
     ucs_list_link_t item;
 
+    // Element used to track the group cache on the LRU list of the cache (most recently used first)
+    ucs_list_link_t lru_item;
+
     // Track whether or not a group cache has been fully initialized
     bool initialized;
 
@@ -1855,6 +2991,9 @@ typedef struct group_cache
     struct {
         bool initialized;
 
+        // UID of the group. Unlike group_uid, it is not reset when the group is revoked.
+        group_uid_t uid;
+
         // A group UID always represents the same exact communicator, num tracks how many times
         // the group was globally created (number of time the communicator was created - and of
         // course the communicator is being destroyed between each creation).
@@ -1890,8 +3029,29 @@ typedef struct group_cache
         // pending_recv_cache_entries is the list of pending cache entries that needs
         // to be processed once the associated group has been fully revoked (type: pending_recv_cache_entry_t).
         ucs_list_link_t pending_recv_cache_entries;
+
+        // List of requests for cache entries from local ranks that are waiting for entries
+        // from other SPs (type: pending_host_cache_request_t). Only used on DPUs.
+        ucs_list_link_t pending_host_cache_requests;
+
+        // Time, in microseconds, at which the add of the next version of the group has been
+        // deferred because the group was being revoked, 0 if not deferred
+        uint64_t add_deferred_ts;
+
+        // Memory footprint of the group cache when it was last accounted in the footprint of
+        // the cache (see group_cache_update_footprint())
+        size_t footprint;
     } persistent;
 
+    // Time in microseconds at which each milestone was reached by the current version of
+    // the group, 0 if not reached (see group_cache_milestone_t). Element 'start' is the time of
+    // the first milestone that was reached, i.e., the beginning of the timeline.
+    struct
+    {
+        uint64_t start;
+        uint64_t ts[GROUP_CACHE_NUM_MILESTONES];
+    } timeline;
+
     // Engine the group cache is associated with
     struct offloading_engine *engine;
 
@@ -1933,6 +3093,10 @@ typedef struct group_cache
     // Boolean to track if the dynamic array
     bool rank_array_initialized;
 
+    // Bitset of the blocks of CACHE_ENTRIES_REQUEST_BLOCK_SIZE ranks for which an on-demand
+    // request for cache entries is in flight, so a single request is sent per block.
+    group_cache_bitset_t *requested_blocks;
+
     // Hash for all the hosts in the group. We use a hash so we can efficiently
     // track which hosts are used in a group as we receive cache entries.
     // The key is the host ID (64-bit hash of the hostname), the value the
@@ -1969,6 +3133,11 @@ typedef struct group_cache
     // the group
     khash_t(group_sps_hash_t) * sps_hash;
 
+    // SP objects of the previous version of the group, kept with their ordered list of
+    // ranks when the group is revoked so re-creating the group does not require new
+    // allocations (type: sp_cache_data_t, element: item)
+    ucs_list_link_t recycled_sps;
+
     // Bitset used to identify all the SPs involed in the group. This creates a
     // non-contiguous but ordered list of all the SPs that are involed.
     group_cache_bitset_t *sps_bitset;
@@ -1991,61 +3160,142 @@ typedef struct group_cache
 
     // Specifies whether the lookup tables have been populated
     bool lookup_tables_populated;
+
+    // State of the construction of the lookup tables when it is split into slices
+    // executed across progress calls, so large groups do not stall progress.
+    struct
+    {
+        // Whether the group is on the cache's list of pending constructions
+        bool pending;
+
+        // Element used to put the group on the cache's list of pending constructions
+        ucs_list_link_t item;
+
+        // Current phase of the construction
+        int phase;
+
+        // Current position in the SP or host hash table
+        khiter_t iter;
+
+        // Next bitset slot and next index in the ranks array of the current SP
+        size_t slot;
+        size_t idx;
+    } lookup_tables_build;
 } group_cache_t;
 
-#define GROUP_CACHE_HASHES_FINI(_engine, _gp_cache)                         \
+// Remove a group from the list of pending constructions of lookup tables, e.g.,
+// when the group is revoked before the construction completes.
+#define GROUP_CACHE_CANCEL_LOOKUP_TABLES_BUILD(__g)             \
+    do                                                          \
+    {                                                           \
+        if ((__g)->lookup_tables_build.pending)                 \
+        {                                                       \
+            ucs_list_del(&((__g)->lookup_tables_build.item));   \
+            (__g)->lookup_tables_build.pending = false;         \
+        }                                                       \
+    } while (0)
+
+// Return the SP and host objects of the hashes of a group cache, and their bitsets, to the engine's pools
+#define GROUP_CACHE_HASHES_RETURN_OBJS(_engine, _gp_cache)                  \
     do                                                                      \
     {                                                                       \
         uint64_t __k;                                                       \
         sp_cache_data_t *__sp_v = NULL;                                     \
         host_cache_data_t *__host_v = NULL;                                 \
-        assert((_gp_cache)->sps_hash);                                      \
         /* safeguard around kh_foreach which proved picky and tend */       \
         /* to segfault in some cases */                                     \
-        if ((_gp_cache)->sps_hash)                                          \
+        if ((_gp_cache)->sps_hash && kh_size((_gp_cache)->sps_hash) != 0)   \
         {                                                                   \
-            if (kh_size((_gp_cache)->sps_hash) != 0)                        \
-            {                                                               \
-                kh_foreach((_gp_cache)->sps_hash, __k, __sp_v, {            \
-                    GROUP_CACHE_BITSET_DESTROY(__sp_v->ranks_bitset);       \
-                    if (__sp_v->ranks_initialized)                          \
-                    {                                                       \
-                        DYN_ARRAY_FREE(&(__sp_v->ranks));                   \
-                        __sp_v->ranks_initialized = false;                  \
-                    }                                                       \
-                    DYN_LIST_RETURN((_engine)->free_sp_cache_hash_obj,      \
-                                    __sp_v,                                 \
-                                    item);                                  \
-                }) kh_destroy(group_sps_hash_t, (_gp_cache->sps_hash));     \
-            }                                                               \
-            else                                                            \
-                kh_destroy(group_sps_hash_t, (_gp_cache->sps_hash));        \
+            kh_foreach((_gp_cache)->sps_hash, __k, __sp_v, {                \
+                GROUP_CACHE_BITSET_POOL_PUT(&((_engine)->procs_cache),      \
+                                            __sp_v->ranks_bitset);          \
+                if (__sp_v->ranks_initialized)                              \
+                {                                                           \
+                    DYN_ARRAY_FREE(&(__sp_v->ranks));                       \
+                    __sp_v->ranks_initialized = false;                      \
+                }                                                           \
+                DYN_LIST_RETURN((_engine)->free_sp_cache_hash_obj,          \
+                                __sp_v,                                     \
+                                item);                                      \
+            })                                                              \
         }                                                                   \
-        assert((_gp_cache)->hosts_hash);                                    \
-        /* safeguard around kh_foreach which proved picky and tend */       \
-        /* to segfault in some cases */                                     \
-        if ((_gp_cache)->hosts_hash)                                        \
+        if ((_gp_cache)->hosts_hash && kh_size((_gp_cache)->hosts_hash) != 0) \
+        {                                                                   \
+            kh_foreach((_gp_cache)->hosts_hash, __k, __host_v, {            \
+                GROUP_CACHE_BITSET_POOL_PUT(&((_engine)->procs_cache),      \
+                                            __host_v->sps_bitset);          \
+                GROUP_CACHE_BITSET_POOL_PUT(&((_engine)->procs_cache),      \
+                                            __host_v->ranks_bitset);        \
+                if (__host_v->sps_initialized)                              \
+                {                                                           \
+                    DYN_ARRAY_FREE(&(__host_v->sps));                       \
+                    __host_v->sps_initialized = false;                      \
+                }                                                           \
+                DYN_LIST_RETURN((_engine)->free_host_cache_hash_obj,        \
+                                __host_v,                                   \
+                                item);                                      \
+            })                                                              \
+        }                                                                   \
+    } while (0)
+
+// Move the SP objects of a group cache to its list of recycled SP objects. Their bitsets
+// go back to the pool of the cache but their lists of ranks are kept.
+#define GROUP_CACHE_RECYCLE_SPS(_engine, _gp_cache)                         \
+    do                                                                      \
+    {                                                                       \
+        sp_cache_data_t *__rsp_v = NULL;                                    \
+        if ((_gp_cache)->sps_hash && kh_size((_gp_cache)->sps_hash) != 0)   \
+        {                                                                   \
+            kh_foreach_value((_gp_cache)->sps_hash, __rsp_v, {              \
+                GROUP_CACHE_BITSET_POOL_PUT(&((_engine)->procs_cache),      \
+                                            __rsp_v->ranks_bitset);         \
+                ucs_list_add_tail(&((_gp_cache)->recycled_sps),             \
+                                  &(__rsp_v->item));                        \
+            })                                                              \
+            kh_clear(group_sps_hash_t, (_gp_cache)->sps_hash);              \
+        }                                                                   \
+    } while (0)
+
+// Free the lists of ranks of the recycled SP objects of a group cache and return the
+// objects to the engine's pool
+#define GROUP_CACHE_RELEASE_RECYCLED_SPS(_engine, _gp_cache)                \
+    do                                                                      \
+    {                                                                       \
+        while (!ucs_list_is_empty(&((_gp_cache)->recycled_sps)))            \
         {                                                                   \
-            if (kh_size((_gp_cache)->hosts_hash) != 0)                      \
+            sp_cache_data_t *__rel_sp;                                      \
+            __rel_sp = ucs_list_extract_head(&((_gp_cache)->recycled_sps),  \
+                                             sp_cache_data_t,               \
+                                             item);                         \
+            if (__rel_sp->ranks_initialized)                                \
             {                                                               \
-                kh_foreach((_gp_cache)->hosts_hash, __k, __host_v, {        \
-                    GROUP_CACHE_BITSET_DESTROY(__host_v->sps_bitset);       \
-                    GROUP_CACHE_BITSET_DESTROY(__host_v->ranks_bitset);     \
-                    if (__host_v->sps_initialized)                          \
-                    {                                                       \
-                        DYN_ARRAY_FREE(&(__host_v->sps));                   \
-                        __host_v->sps_initialized = false;                  \
-                    }                                                       \
-                    DYN_LIST_RETURN((_engine)->free_host_cache_hash_obj,    \
-                                    __host_v,                               \
-                                    item);                                  \
-                }) kh_destroy(group_hosts_hash_t, (_gp_cache->hosts_hash)); \
+                DYN_ARRAY_FREE(&(__rel_sp->ranks));                         \
+                __rel_sp->ranks_initialized = false;                        \
             }                                                               \
-            else                                                            \
-                kh_destroy(group_hosts_hash_t, (_gp_cache->hosts_hash));    \
+            DYN_LIST_RETURN((_engine)->free_sp_cache_hash_obj,              \
+                            __rel_sp,                                       \
+                            item);                                          \
         }                                                                   \
     } while (0)
 
+#define GROUP_CACHE_HASHES_FINI(_engine, _gp_cache)                 \
+    do                                                              \
+    {                                                               \
+        assert((_gp_cache)->sps_hash);                              \
+        assert((_gp_cache)->hosts_hash);                            \
+        GROUP_CACHE_HASHES_RETURN_OBJS(_engine, _gp_cache);         \
+        if ((_gp_cache)->sps_hash)                                  \
+        {                                                           \
+            kh_destroy(group_sps_hash_t, (_gp_cache)->sps_hash);    \
+            (_gp_cache)->sps_hash = NULL;                           \
+        }                                                           \
+        if ((_gp_cache)->hosts_hash)                                \
+        {                                                           \
+            kh_destroy(group_hosts_hash_t, (_gp_cache)->hosts_hash); \
+            (_gp_cache)->hosts_hash = NULL;                         \
+        }                                                           \
+    } while (0)
+
 #define BASIC_INIT_GROUP_CACHE(__g)                 \
     do                                              \
     {                                               \
@@ -2064,42 +3314,90 @@ typedef struct group_cache
         (__g)->n_sps = 0;                           \
         (__g)->sps_bitset = NULL;                   \
         (__g)->hosts_bitset = NULL;                 \
+        (__g)->requested_blocks = NULL;             \
+        (__g)->lookup_tables_populated = false;     \
+        memset(&((__g)->timeline), 0,               \
+               sizeof((__g)->timeline));            \
+        (__g)->lookup_tables_build.pending = false; \
+        (__g)->lookup_tables_build.phase = 0;       \
+        (__g)->lookup_tables_build.iter = 0;        \
+        (__g)->lookup_tables_build.slot = 0;        \
+        (__g)->lookup_tables_build.idx = 0;         \
+    } while(0)
+
+// Reset the fields tracking the storage of a group cache, i.e., the dynamic arrays
+// and hash tables. Only used on group caches without storage.
+#define INIT_GROUP_CACHE_STORAGE(__g)               \
+    do                                              \
+    {                                               \
         (__g)->sp_array_initialized = false;        \
         (__g)->host_array_initialized = false;      \
         (__g)->rank_array_initialized = false;      \
-        (__g)->lookup_tables_populated = false;     \
-    } while(0)
+        (__g)->sps_hash = NULL;                     \
+        (__g)->hosts_hash = NULL;                   \
+        ucs_list_head_init(&((__g)->recycled_sps)); \
+    } while (0)
 
+// Initialize a group cache, reusing the storage kept when the group was previously revoked, if any
 #define INIT_GROUP_CACHE(__g)                                                           \
     do                                                                                  \
     {                                                                                   \
         BASIC_INIT_GROUP_CACHE((__g));                                                  \
-        DYN_ARRAY_ALLOC(&((__g)->ranks), 1024, peer_cache_entry_t);                     \
-        (__g)->rank_array_initialized = true;                                           \
+        if (!(__g)->rank_array_initialized)                                             \
+        {                                                                               \
+            DYN_ARRAY_ALLOC(&((__g)->ranks), 1024, peer_cache_entry_t);                 \
+            (__g)->rank_array_initialized = true;                                       \
+        }                                                                               \
         /* No need to allocate _new_group_cache->hosts, we handle it when we populte */ \
         /* lookup tables in populate_group_cache_lookup_table() */                      \
-        (__g)->sps_hash = kh_init(group_sps_hash_t);                                    \
-        (__g)->hosts_hash = kh_init(group_hosts_hash_t);                                \
+        if ((__g)->sps_hash == NULL)                                                    \
+            (__g)->sps_hash = kh_init(group_sps_hash_t);                                \
+        if ((__g)->hosts_hash == NULL)                                                  \
+            (__g)->hosts_hash = kh_init(group_hosts_hash_t);                            \
         (__g)->initialized = true;                                                      \
         /* revokes.ranks is initialized during the lazy group cache initialization */   \
     } while (0)
 
-#define RESET_GROUP_CACHE(__e, __g)                             \
-    do                                                          \
-    {                                                           \
-        GROUP_CACHE_HASHES_FINI(__e, __g);                      \
-        if ((__g)->sp_array_initialized)                        \
-            DYN_ARRAY_FREE(&((__g)->sps));                      \
-        if ((__g)->host_array_initialized)                      \
-            DYN_ARRAY_FREE(&((__g)->hosts));                    \
-        if ((__g)->rank_array_initialized)                      \
-            DYN_ARRAY_FREE(&((__g)->ranks));                    \
-        if ((__g)->revokes.ranks)                               \
-        {                                                       \
-            GROUP_CACHE_BITSET_DESTROY((__g)->revokes.ranks);   \
-            ((__g)->revokes.ranks) = NULL;                      \
-        }                                                       \
-        BASIC_INIT_GROUP_CACHE((__g));                          \
+// Release all the storage of a group cache, its bitsets going back to the pool of the cache
+#define RESET_GROUP_CACHE(__e, __g)                                                          \
+    do                                                                                       \
+    {                                                                                        \
+        if ((__g)->sps_hash != NULL && (__g)->hosts_hash != NULL)                            \
+            GROUP_CACHE_HASHES_FINI(__e, __g);                                               \
+        GROUP_CACHE_RELEASE_RECYCLED_SPS(__e, __g);                                          \
+        if ((__g)->sp_array_initialized)                                                     \
+            DYN_ARRAY_FREE(&((__g)->sps));                                                   \
+        if ((__g)->host_array_initialized)                                                   \
+            DYN_ARRAY_FREE(&((__g)->hosts));                                                 \
+        if ((__g)->rank_array_initialized)                                                   \
+            DYN_ARRAY_FREE(&((__g)->ranks));                                                 \
+        GROUP_CACHE_BITSET_POOL_PUT(&((__e)->procs_cache), (__g)->revokes.ranks);            \
+        GROUP_CACHE_BITSET_POOL_PUT(&((__e)->procs_cache), (__g)->sps_bitset);               \
+        GROUP_CACHE_BITSET_POOL_PUT(&((__e)->procs_cache), (__g)->hosts_bitset);             \
+        GROUP_CACHE_BITSET_POOL_PUT(&((__e)->procs_cache), (__g)->requested_blocks);         \
+        GROUP_CACHE_CANCEL_LOOKUP_TABLES_BUILD((__g));                                       \
+        INIT_GROUP_CACHE_STORAGE((__g));                                                     \
+        BASIC_INIT_GROUP_CACHE((__g));                                                       \
+    } while (0)
+
+// Reset a group cache after a revoke but keep its storage so it can be reused when the
+// group is re-created: the dynamic arrays are kept as is (the rank entries must have been
+// revoked, see REVOKE_PEER_CACHE_ENTRY()), the SP objects are kept with their list of ranks
+// and the hash tables are emptied. Bitsets go back to the pool of the cache, where any group
+// of the same size can reuse them.
+#define RECYCLE_GROUP_CACHE(__e, __g)                                                        \
+    do                                                                                       \
+    {                                                                                        \
+        GROUP_CACHE_RECYCLE_SPS(__e, __g);                                                   \
+        GROUP_CACHE_HASHES_RETURN_OBJS(__e, __g);                                            \
+        if ((__g)->hosts_hash != NULL)                                                       \
+            kh_clear(group_hosts_hash_t, (__g)->hosts_hash);                                 \
+        GROUP_CACHE_BITSET_POOL_PUT(&((__e)->procs_cache), (__g)->revokes.ranks);            \
+        GROUP_CACHE_BITSET_POOL_PUT(&((__e)->procs_cache), (__g)->sps_bitset);               \
+        GROUP_CACHE_BITSET_POOL_PUT(&((__e)->procs_cache), (__g)->hosts_bitset);             \
+        GROUP_CACHE_BITSET_POOL_PUT(&((__e)->procs_cache), (__g)->requested_blocks);         \
+        GROUP_CACHE_CANCEL_LOOKUP_TABLES_BUILD((__g));                                       \
+        BASIC_INIT_GROUP_CACHE((__g));                                                       \
     } while (0)
 
 #define GET_GROUP_SP_HASH_ENTRY(_gp_cache, _sp_gid) ({                          \
@@ -2241,10 +3539,12 @@ typedef struct group_cache
         khiter_t _newKey = kh_put(group_hash_t, (_cache)->data, (_gp_uid), &_ret);                  \
         DYN_LIST_GET((_cache)->group_cache_pool, group_cache_t, item, _new_group_cache);            \
         assert(_new_group_cache);                                                                   \
+        INIT_GROUP_CACHE_STORAGE(_new_group_cache);                                                 \
         INIT_GROUP_CACHE(_new_group_cache);                                                         \
         _new_group_cache->persistent.initialized = false;                                           \
         _new_group_cache->engine = (_cache)->engine;                                                \
         _new_group_cache->group_uid = (_gp_uid);                                                    \
+        _new_group_cache->persistent.uid = (_gp_uid);                                               \
         /* We set the value for the first group when we add */                                      \
         /* the first rank to a cache. GET_GROUP_CACHE only made */                                  \
         /* sure we could use the structure */                                                       \
@@ -2258,11 +3558,31 @@ typedef struct group_cache
         ucs_list_head_init(&((_new_group_cache)->persistent.pending_group_add_msgs));               \
         ucs_list_head_init(&((_new_group_cache)->persistent.pending_send_group_add_msgs));          \
         ucs_list_head_init(&((_new_group_cache)->persistent.pending_recv_cache_entries));           \
+        ucs_list_head_init(&((_new_group_cache)->persistent.pending_host_cache_requests));          \
         _new_group_cache->persistent.initialized = true;                                            \
         _new_group_cache->persistent.num = 0;                                                       \
         _new_group_cache->persistent.sent_to_host = _new_group_cache->persistent.num;               \
         _new_group_cache->persistent.revoke_send_to_host_posted = _new_group_cache->persistent.num; \
         _new_group_cache->persistent.revoke_sent_to_host = _new_group_cache->persistent.num;        \
+        _new_group_cache->persistent.add_deferred_ts = 0;                                           \
+        _new_group_cache->persistent.footprint = 0;                                                 \
+        if ((_cache)->evicted_groups != NULL && kh_size((_cache)->evicted_groups) != 0)             \
+        {                                                                                           \
+            /* The group was evicted, restore its sequence number so re-creating it is */           \
+            /* transparent */                                                                       \
+            khiter_t _ek = kh_get(evicted_groups_hash_t, (_cache)->evicted_groups, (_gp_uid));      \
+            if (_ek != kh_end((_cache)->evicted_groups))                                            \
+            {                                                                                       \
+                uint64_t _seq_num = kh_value((_cache)->evicted_groups, _ek);                        \
+                _new_group_cache->persistent.num = _seq_num;                                        \
+                _new_group_cache->persistent.sent_to_host = _seq_num;                               \
+                _new_group_cache->persistent.revoke_send_to_host_posted = _seq_num;                 \
+                _new_group_cache->persistent.revoke_sent_to_host = _seq_num;                        \
+                kh_del(evicted_groups_hash_t, (_cache)->evicted_groups, _ek);                       \
+            }                                                                                       \
+        }                                                                                           \
+        ucs_list_add_head(&((_cache)->lru_groups), &(_new_group_cache->lru_item));                  \
+        group_cache_update_footprint((_cache), _new_group_cache);                                   \
         _gp_cache = _new_group_cache;                                                               \
     }                                                                                               \
     else                                                                                            \
@@ -2286,6 +3606,12 @@ typedef struct group_cache
         assert(_gp_cache->engine != NULL);                                                          \
         assert(_gp_uid == _gp_cache->group_uid);                                                    \
         assert(_gp_cache->persistent.initialized == true);                                          \
+        if ((_cache)->lru_groups.next != &(_gp_cache->lru_item))                                    \
+        {                                                                                           \
+            /* Move the group cache to the front of the LRU list */                                 \
+            ucs_list_del(&(_gp_cache->lru_item));                                                   \
+            ucs_list_add_head(&((_cache)->lru_groups), &(_gp_cache->lru_item));                     \
+        }                                                                                           \
     }                                                                                               \
     _gp_cache;                                                                                      \
 })
@@ -2326,23 +3652,15 @@ typedef struct group_cache
         __entry = GET_GROUPRANK_CACHE_ENTRY((__cache), (_gp_uid), _rank);      \
         if (__entry)                                                           \
         {                                                                      \
-            if (__entry->ep != NULL)                                           \
-            {                                                                  \
-                _c.ep = __entry->ep;                                           \
-            }                                                                  \
-            else                                                               \
+            if (__entry->ep == NULL && __entry->peer.addr_len > 0)             \
             {                                                                  \
-                if (__entry->peer.addr != NULL)                                \
-                {                                                              \
-                    /* Generate the endpoint with the data we have */          \
-                    ucp_ep_params_t _ep_params;                                \
-                    _ep_params.field_mask = UCP_EP_PARAM_FIELD_REMOTE_ADDRESS; \
-                    _ep_params.address = (ucp_address_t *)__entry->peer.addr;  \
-                    ucp_ep_create((_exec_ctx)->engine->ucp_worker,             \
-                                  &_ep_params,                                 \
-                                  &(__entry->ep));                             \
-                    assert(__entry->ep);                                       \
-                }                                                              \
+                /* Get the endpoint from the engine's pool, which creates */   \
+                /* it only if no group already has one for the peer */         \
+                __entry->pooled_ep = ep_pool_get((_exec_ctx)->engine,          \
+                                                 __entry->peer.addr,           \
+                                                 __entry->peer.addr_len);      \
+                if (__entry->pooled_ep != NULL)                                \
+                    __entry->ep = __entry->pooled_ep->ep;                      \
             }                                                                  \
             assert(__entry->ep);                                               \
             _c.ep = __entry->ep;                                               \
@@ -2355,6 +3673,9 @@ typedef struct group_cache
 // Keys are group UIDs (group_uid_t), i.e., int
 KHASH_MAP_INIT_INT(group_hash_t, group_cache_t *);
 
+// Keys for evicted_groups_hash_t are group UIDs, values the sequence number of the group when evicted
+KHASH_MAP_INIT_INT(evicted_groups_hash_t, uint64_t);
+
 typedef struct cache
 {
     // Associated offload engine
@@ -2371,18 +3692,97 @@ typedef struct cache
 
     // Pool of cache group caches (type: group_cache_t)
     dyn_list_t *group_cache_pool;
+
+    // List of all the group caches, most recently used first (type: group_cache_t, element: lru_item)
+    ucs_list_link_t lru_groups;
+
+    // Sequence numbers of the groups that have been evicted from the cache, so they can
+    // transparently be re-created. Bounded by the group_cache_max_evicted_groups setting.
+    khash_t(evicted_groups_hash_t) * evicted_groups;
+
+    // Number of group caches that have been evicted
+    size_t num_evictions;
+
+    // Memory footprint of all the group caches, in bytes, updated when a group is created,
+    // when its array of ranks grows, when its lookup tables are populated or released and
+    // when it is revoked
+    size_t footprint;
+
+    // Bitsets released by group caches, reusable by any group (see GROUP_CACHE_BITSET_POOL_GET)
+    khash_t(group_cache_bitset_pool_t) * bitset_pool;
+
+    // Memory used by the bitsets of the pool, in bytes
+    size_t bitset_pool_size;
+
+    // Groups for which the construction of the lookup tables is not completed yet
+    // (type: group_cache_t, element: lookup_tables_build.item)
+    ucs_list_link_t pending_lookup_tables;
+
+    // Latencies of the milestones of all the groups (see group_cache_milestone_t)
+    group_cache_milestone_stats_t milestone_stats[GROUP_CACHE_NUM_MILESTONES];
 } cache_t;
 
-#define RESET_CACHE(__c)                \
-    do                                  \
-    {                                   \
-        (__c)->engine = NULL;           \
-        (__c)->size = 0;                \
-        (__c)->data = NULL;             \
-        (__c)->group_cache_pool = NULL; \
-        (__c)->world_group = INT_MAX;   \
+#define RESET_CACHE(__c)                                     \
+    do                                                       \
+    {                                                        \
+        (__c)->engine = NULL;                                \
+        (__c)->size = 0;                                     \
+        (__c)->data = NULL;                                  \
+        (__c)->group_cache_pool = NULL;                      \
+        (__c)->world_group = INT_MAX;                        \
+        ucs_list_head_init(&((__c)->lru_groups));            \
+        (__c)->evicted_groups = NULL;                        \
+        (__c)->num_evictions = 0;                            \
+        (__c)->footprint = 0;                                \
+        (__c)->bitset_pool = NULL;                           \
+        (__c)->bitset_pool_size = 0;                         \
+        ucs_list_head_init(&((__c)->pending_lookup_tables)); \
+        memset((__c)->milestone_stats, 0,                    \
+               sizeof((__c)->milestone_stats));              \
     } while (0)
 
+/**
+ * @brief Get a zeroed bitset of a given number of bits from the pool of bitsets of a cache,
+ * allocating it when no bitset of the same size is available.
+ *
+ * @param[in] cache The cache
+ * @param[in] nbits Number of bits of the bitset
+ * @return group_cache_bitset_t* NULL when the allocation failed
+ */
+group_cache_bitset_t *group_cache_bitset_pool_get(cache_t *cache, size_t nbits);
+
+/**
+ * @brief Return a bitset obtained with group_cache_bitset_pool_get() to the pool of a cache.
+ */
+void group_cache_bitset_pool_put(cache_t *cache, group_cache_bitset_t *bitset);
+
+/**
+ * @brief Free all the bitsets of the pool of a cache.
+ */
+void group_cache_bitset_pool_flush(cache_t *cache);
+
+/**
+ * @brief Update the memory footprint of the cache with the current footprint of a group cache.
+ *
+ * @param[in] cache The cache of the group
+ * @param[in] gp_cache The group cache to account for
+ */
+void group_cache_update_footprint(cache_t *cache, group_cache_t *gp_cache);
+
+/**
+ * @brief Bring the memory footprint of the cache below the memory budget (see
+ * MIMOSA_GROUP_CACHE_MEM_BUDGET). The bitsets of the pool of the cache are released first.
+ * Then the least recently used group caches that are fully revoked and without any pending
+ * operation are evicted, as long as the number of evicted groups is below the limit (see
+ * MIMOSA_GROUP_CACHE_MAX_EVICTED_GROUPS). Finally, the lookup tables of the least recently used
+ * groups are released; they are rebuilt the next time they are needed. The world group is never
+ * evicted. Evicted group caches are returned to the pool and lookup tables are freed so the
+ * function is only invoked while progressing the engine, when no group cache handle is in use.
+ *
+ * @param[in] cache The cache to check
+ */
+void group_cache_enforce_mem_budget(cache_t *cache);
+
 #define HASH_GROUP_FROM_STRING(_s, _len) ({              \
     assert(_s);                                          \
     unsigned int __hash = 5381;                          \
@@ -2427,6 +3827,7 @@ typedef struct cache
         peer_cache_entry_t *_entry = NULL;                                  \
         group_cache_t *_gp_cache = NULL;                                    \
         dyn_array_t *_rank_cache = NULL;                                    \
+        size_t _capacity;                                                   \
         _gp_cache = GET_GROUP_CACHE((_cache), _gp_uid);                     \
         assert(_gp_cache);                                                  \
         _rank_cache = &(_gp_cache->ranks);                                  \
@@ -2437,14 +3838,26 @@ typedef struct cache
             /* the cache was initialized without a group size */            \
             /* but we now know it now */                                    \
             _gp_cache->group_size = _gp_size;                               \
-            _gp_cache->group_size = _gp_size;                               \
-            GROUP_CACHE_BITSET_CREATE(_gp_cache->sps_bitset, _gp_size);     \
-            GROUP_CACHE_BITSET_CREATE(_gp_cache->hosts_bitset,              \
-                                      (_cache)->engine->config->num_hosts); \
-            GROUP_CACHE_BITSET_CREATE(_gp_cache->revokes.ranks,             \
-                                      _gp_cache->group_size);               \
+            GROUP_CACHE_BITSET_POOL_GET((_cache),                           \
+                                        _gp_cache->sps_bitset,              \
+                                        GROUP_CACHE_SPS_BITSET_SIZE(        \
+                                            (_cache)->engine,               \
+                                            _gp_cache));                    \
+            GROUP_CACHE_BITSET_POOL_GET((_cache),                           \
+                                        _gp_cache->hosts_bitset,            \
+                                        (_cache)->engine->config->num_hosts); \
+            GROUP_CACHE_BITSET_POOL_GET((_cache),                           \
+                                        _gp_cache->revokes.ranks,           \
+                                        _gp_cache->group_size);             \
+            group_cache_update_footprint((_cache), _gp_cache);              \
         }                                                                   \
+        _capacity = _rank_cache->capacity;                                  \
         _entry = DYN_ARRAY_GET_ELT(_rank_cache, _rank, peer_cache_entry_t); \
+        if (_rank_cache->capacity != _capacity)                             \
+        {                                                                   \
+            /* The array of ranks grew */                                   \
+            group_cache_update_footprint((_cache), _gp_cache);              \
+        }                                                                   \
         _entry;                                                             \
     })
 
@@ -2517,27 +3930,86 @@ typedef struct remote_dpu_connect_tracker
 {
     struct remote_service_proc_info *remote_service_proc_info;
     execution_context_t *client_econtext;
+
+    // Whether the connection is accounted for as in progress by the connection manager
+    bool in_progress;
 } remote_service_procs_connect_tracker_t;
 
+/**
+ * @brief inter_sp_connect_mgr_t drives the outgoing connections to other service processes
+ * when building the full mesh: connections are queued and initiated in the background
+ * (see init_params_t.async_connect) so that at most settings.inter_sp_connect_max_inflight
+ * of them are in progress at any time.
+ */
+typedef struct inter_sp_connect_mgr
+{
+    // Service processes to connect to once a slot is available (type: remote_service_proc_info_t, element: connect_item)
+    ucs_list_link_t queue;
+
+    // Number of connections initiated and not completed yet
+    size_t num_in_flight;
+
+    // Number of connections managed, i.e., queued since the manager started
+    size_t num_connections;
+
+    // Number of connections that completed
+    size_t num_completed;
+
+    // Number of connections that had to be restarted after failing
+    size_t num_restarts;
+
+    // Time in microseconds when the first connection was queued
+    uint64_t start;
+
+    // Time in microseconds it took to get connected to all the other service processes, 0 until then
+    uint64_t time_to_full_mesh;
+} inter_sp_connect_mgr_t;
+
+#define RESET_INTER_SP_CONNECT_MGR(_mgr)          \
+    do                                            \
+    {                                             \
+        ucs_list_head_init(&((_mgr)->queue));     \
+        (_mgr)->num_in_flight = 0;                \
+        (_mgr)->num_connections = 0;              \
+        (_mgr)->num_completed = 0;                \
+        (_mgr)->num_restarts = 0;                 \
+        (_mgr)->start = 0;                        \
+        (_mgr)->time_to_full_mesh = 0;            \
+    } while (0)
+
 // Forward declaration
 struct offloading_config;
 
+typedef enum
+{
+    // The data of the message is an array of group_revoke_range_t
+    GROUP_REVOKE_ENCODING_RANGES = 0,
+    // The data of the message is a bitset of group_size bits (group_cache_bitset_t words)
+    GROUP_REVOKE_ENCODING_BITMAP,
+} group_revoke_encoding_t;
+
+// Run of contiguous ranks that revoked a group
+typedef struct group_revoke_range
+{
+    uint64_t start;
+    uint64_t num;
+} group_revoke_range_t;
+
 /**
- * @brief group_revoke_msg_t is the structure used to define the payload of a revoke notification
+ * @brief group_revoke_msg_t is the structure used to define the payload of a revoke notification.
+ * The message has a variable size: the ranks that revoked the group are encoded after the header,
+ * either as ranges of ranks or as a bitmap, whichever is the smallest, so a single message is
+ * always enough regardless of the group size.
  */
 typedef struct group_revoke_from_sps_msg
 {
     ucs_list_link_t item;
 
-    // Number of ranks in the array of ranks
-    size_t num_ranks;
-
-    // Which rank the array starts with
-    size_t rank_start;
+    // Size in bytes of the data buffer of the object; only meaningful locally, used by the pool
+    size_t capacity;
 
-    // List of ranks in the group that revoked the group, based on the group cache bitset. If the group has more
-    // than 1024 ranks, multiple messages must be used.
-    int ranks[1024];
+    // Number of ranks that revoked the group according to the message
+    size_t num_ranks;
 
     // Group that has been revoked
     group_uid_t gp_uid;
@@ -2549,8 +4021,46 @@ typedef struct group_revoke_from_sps_msg
     int gp_signature;
 
     uint64_t gp_seq_num;
+
+    // How the list of ranks is encoded in data
+    group_revoke_encoding_t encoding;
+
+    // Size in bytes of the encoded list of ranks
+    size_t data_size;
+
+    // Encoded list of ranks in the group that revoked the group
+    uint64_t data[];
 } group_revoke_msg_from_sp_t;
 
+// Total size of a revoke message from a SP, including the encoded list of ranks
+#define GROUP_REVOKE_MSG_FROM_SP_SIZE(_data_size) (sizeof(group_revoke_msg_from_sp_t) + (_data_size))
+
+// Number of size classes for the pool of revoke messages from SPs. The smallest class can carry
+// 8 ranges; each class doubles the capacity of the previous one. Larger messages are not cached.
+#define GROUP_REVOKE_MSG_POOL_NUM_CLASSES (16)
+#define GROUP_REVOKE_MSG_POOL_MIN_CAPACITY (8 * sizeof(group_revoke_range_t))
+
+/**
+ * @brief Pool of variable-size group_revoke_msg_from_sp_t objects, organized in size classes.
+ */
+typedef struct group_revoke_msg_pool
+{
+    // Free objects for each size class (type: group_revoke_msg_from_sp_t)
+    ucs_list_link_t free_msgs[GROUP_REVOKE_MSG_POOL_NUM_CLASSES];
+
+    // Number of objects currently allocated and not cached in the pool
+    size_t num_used;
+} group_revoke_msg_pool_t;
+
+#define GROUP_REVOKE_MSG_POOL_INIT(_pool)                               \
+    do                                                                  \
+    {                                                                   \
+        size_t _c;                                                      \
+        for (_c = 0; _c < GROUP_REVOKE_MSG_POOL_NUM_CLASSES; _c++)      \
+            ucs_list_head_init(&((_pool)->free_msgs[_c]));              \
+        (_pool)->num_used = 0;                                          \
+    } while (0)
+
 typedef struct group_revoke_from_rank_msg
 {
     ucs_list_link_t item;
@@ -2649,6 +4159,82 @@ typedef struct pending_recv_cache_entry
         (_p)->payload_size = 0;            \
     } while (0)
 
+// Request for cache entries from a local rank that could not be fully served when received and
+// that was forwarded to the other service processes. The entries of the request are sent to the
+// rank as they are received. Only used on DPUs.
+typedef struct pending_host_cache_request
+{
+    // So it can be put on a list
+    ucs_list_link_t item;
+
+    // Client ID of the local rank that sent the request
+    uint64_t client_id;
+
+    // The request as received from the local rank
+    cache_entries_request_t request;
+} pending_host_cache_request_t;
+
+typedef enum
+{
+    // Notification emitted with a payload copied when the notification was queued
+    PENDING_SP_NOTIF_EMIT = 0,
+    // Cache entries of the local ranks for a group, i.e., broadcast_group_cache()
+    PENDING_SP_NOTIF_GROUP_CACHE,
+    // Local revoke of a group, i.e., broadcast_group_cache_revoke()
+    PENDING_SP_NOTIF_GROUP_REVOKE,
+} pending_sp_notif_type_t;
+
+/**
+ * @brief pending_sp_notif_t tracks a notification for a remote service process that
+ * cannot be sent yet because the connection to that service process is still being
+ * established (on-demand inter-service-process connections).
+ */
+typedef struct pending_sp_notif
+{
+    // So it can be put on a list
+    ucs_list_link_t item;
+
+    // What needs to be sent once connected
+    pending_sp_notif_type_t type;
+
+    // Global ID of the target service process
+    uint64_t sp_gid;
+
+    // Group the notification is about (group cache and revoke notifications)
+    group_uid_t gp_uid;
+
+    // Notification type (PENDING_SP_NOTIF_EMIT)
+    uint64_t notif_id;
+
+    // Copy of the notification's payload, freed once the notification is emitted
+    void *payload;
+
+    // Size of the payload
+    size_t payload_size;
+} pending_sp_notif_t;
+
+#define RESET_PENDING_SP_NOTIF(_p)           \
+    do                                       \
+    {                                        \
+        (_p)->type = PENDING_SP_NOTIF_EMIT;  \
+        (_p)->sp_gid = UINT64_MAX;           \
+        (_p)->gp_uid = INT_MAX;              \
+        (_p)->notif_id = UINT64_MAX;         \
+        (_p)->payload = NULL;                \
+        (_p)->payload_size = 0;              \
+    } while (0)
+
+/*
+ * The state of an engine is either long-lived fabric state or per-job state. The fabric
+ * state is created once per allocation and survives job boundaries: the execution contexts
+ * to and from the other service processes and their endpoints and pre-posted receives, the
+ * list of service processes and DPUs, the servers and the OOB reactor, the pools and the
+ * default notifications. The per-job state is everything that is about the ranks of a job:
+ * the group caches (procs_cache) with their pending messages, the endpoints to the ranks in
+ * ep_pool, and the slots of the ranks in the servers the ranks connect to. Service processes
+ * serving back-to-back jobs release the per-job state with offload_engine_job_reset() once
+ * the ranks of a job are gone, so the mesh between service processes is only built once.
+ */
 typedef struct offloading_engine
 {
 #if OFFLOADING_MT_ENABLE
@@ -2666,8 +4252,91 @@ typedef struct offloading_engine
         bool buddy_buffer_system_enabled;
         bool ucx_am_backend_enabled;
         bool persistent_endpoint_cache;
+
+        // Memory budget in bytes for the endpoint cache, 0 meaning unlimited
+        size_t group_cache_mem_budget;
+
+        // Maximum number of evicted groups whose sequence number is kept, no group
+        // is evicted once the limit is reached
+        size_t group_cache_max_evicted_groups;
+
+        // Time budget in microseconds of each slice of the construction of the lookup
+        // tables of a group, 0 meaning that the tables are built in a single step
+        uint64_t lookup_tables_build_budget;
+
+        // Whether the timelines of the group caches are dumped when the engine is finalized
+        bool dump_group_cache_timelines;
+
+        // Maximum time in milliseconds a client keeps trying to connect to its server, 0 meaning no limit
+        uint64_t connect_timeout;
+
+        // Bounds in microseconds of the delay between two attempts to connect to a server
+        uint64_t connect_backoff_min;
+        uint64_t connect_backoff_max;
+
+        // Whether clients connect to their server while progressing their execution context
+        // instead of blocking in client_init()
+        bool async_connect;
+
+        // Whether connections between service processes are established on first use instead
+        // of building a full mesh when the engine starts
+        bool lazy_inter_sp_connect;
+
+        // Maximum number of outgoing connections to other service processes in progress at the same time
+        size_t inter_sp_connect_max_inflight;
+
+        // Number of times a failed connection to another service process is restarted
+        size_t inter_sp_connect_retries;
+
+        // Directory where the bootstrap trace of the process is recorded (NULL if disabled)
+        char *trace_dir;
+
+        // Number of records of the bootstrap trace ring
+        uint64_t trace_ring_size;
+
+        // Time in milliseconds servers keep the slot of a client that disconnected so it can
+        // resume, 0 meaning clients never resume
+        uint64_t resume_ttl;
+
+        // Directory where clients keep the resume tokens given by their servers (NULL if disabled)
+        char *resume_dir;
+
+        // Number of jobs a job-persistent service process serves before exiting, 0 meaning no limit
+        uint64_t max_jobs;
+
+        // Maximum number of RMA transfers in flight for each rank of an offloaded alltoallv
+        size_t alltoallv_window;
+
+        // Default size of the segments, shape and radix of the tree of the segmented broadcast
+        size_t bcast_segment_size;
+        bcast_tree_t bcast_tree;
+        size_t bcast_radix;
+
+        // Size in bytes of the cache entries of the local ranks from which they are distributed to the
+        // other service processes with the segmented broadcast, 0 meaning never
+        size_t cache_bcast_threshold;
+
+        // Time budget in microseconds of the progress of the operations of an execution context, 0
+        // meaning unlimited; operations not progressed when it is exhausted are the first next time
+        uint64_t ops_progress_budget;
+
+        // Maximum number of RMA transfers of the operations in flight, 0 meaning unlimited
+        size_t ops_max_rma;
+
+        // Weight of the queues of operations whose weight is not set with op_queue_set_weight()
+        uint64_t op_queue_weight;
+
+        // Time in milliseconds after which messages between service processes that were not delivered
+        // to an operation are dropped, 0 meaning never
+        uint64_t op_msg_timeout;
+
+        // Whether the statistics of the queues of operations are dumped at the end of each job
+        bool dump_op_queue_stats;
     } settings;
 
+    // Number of jobs whose per-job state was released with offload_engine_job_reset()
+    uint64_t num_jobs;
+
     bool host_dpu_data_initialized;
     union
     {
@@ -2738,13 +4407,48 @@ typedef struct offloading_engine
     size_t num_max_inter_service_proc_clients;
     remote_service_procs_connect_tracker_t *inter_service_proc_clients;
 
-    /* Vector of registered operation, ready for execution */
+    // Manager of the outgoing connections to other service processes
+    inter_sp_connect_mgr_t inter_sp_connect_mgr;
+
+    /* Vector of registered operation (offload_op_t *), ready for execution */
     size_t num_registered_ops;
-    offload_op_t *registered_ops;
+    dyn_array_t registered_ops;
     dyn_list_t *free_op_descs;
 
+    // Messages between service processes that are not delivered to their operation yet (op_pending_msg_t)
+    ucs_list_link_t pending_op_msgs;
+
+    // Collective operations executed by the engine that recently reached a final state (op_final_t),
+    // oldest first so they expire from the head of the list
+    ucs_list_link_t final_ops;
+
+    // Same records, keyed by the hash of (alg_id, id, gp_uid, group_rank) for the lookups
+    khash_t(op_final_hash_t) * final_ops_hash;
+
+    // Handlers of the segmented broadcasts received from other service processes, indexed by type
+    bcast_deliver_fn bcast_handlers[BCAST_MAX_TYPES];
+
+    // Scheduling of the operations executed by the engine, see progress_active_ops()
+    struct
+    {
+        khash_t(op_queue_hash_t) * queues;
+        // Sequence number of the progress calls, used to progress an operation once per call
+        uint64_t seq;
+        // RMA transfers in flight across all the operations
+        size_t num_rma;
+    } ops_sched;
+
     /* Cache for groups/rank so we can propagate rank and DPU related data */
     cache_t procs_cache;
+
+    // Endpoints to the ranks of the groups in the cache, shared by all the groups
+    ep_pool_t ep_pool;
+
+    // Reactor accepting the OOB connections of all the servers
+    oob_reactor_t oob_reactor;
+
+    // State of the file and shm rendezvous backends
+    rendezvous_t rendezvous;
     dyn_list_t *free_cache_entry_requests; // pool of descriptors to issue asynchronous cache updates (type: cache_entry_request_t)
 
     /* Objects used during wire-up */
@@ -2753,8 +4457,8 @@ typedef struct offloading_engine
     /* Pool of remote_dpu_info_t structures, used when getting the configuration */
     dyn_list_t *pool_remote_dpu_info;
 
-    // Pool of group_revoke_msg_from_sp_t objects that are available to send notifications to revoke messages from remote SPs
-    dyn_list_t *pool_group_revoke_msgs_from_sps;
+    // Pool of variable-size group_revoke_msg_from_sp_t objects that are available to send notifications to revoke messages from remote SPs
+    group_revoke_msg_pool_t pool_group_revoke_msgs_from_sps;
 
     // Pool of group_revoke_msg_from_rank_t objects that are available to send notifications to revoke messages from local ranks
     dyn_list_t *pool_group_revoke_msgs_from_ranks;
@@ -2768,6 +4472,15 @@ typedef struct offloading_engine
     // Pool of pool_pending_recv_cache_entries objects that are available to track received cache entries that cannot be handled right away because the group is not fully revoked yet
     dyn_list_t *pool_pending_recv_cache_entries;
 
+    // Pool of pending_host_cache_request_t objects used to track the requests for cache entries from local ranks that were forwarded to other service processes
+    dyn_list_t *pool_pending_host_cache_requests;
+
+    // Pool of pending_sp_notif_t objects used to queue notifications while connecting to a remote service process
+    dyn_list_t *pool_pending_sp_notifs;
+
+    // List of notifications waiting for a connection to a remote service process (type: pending_sp_notif_t)
+    ucs_list_link_t pending_sp_notifs;
+
     // Flag to specify if we are on the DPU or not
     bool on_dpu;
 
@@ -2837,6 +4550,7 @@ typedef struct offloading_engine
         (_core_engine)->host_dpu_data_initialized = false;                                                                   \
         (_core_engine)->buf_data_sps = NULL;                                                                                 \
         (_core_engine)->done = false;                                                                                        \
+        (_core_engine)->num_jobs = 0;                                                                                        \
         (_core_engine)->config = NULL;                                                                                       \
         (_core_engine)->client = NULL;                                                                                       \
         (_core_engine)->num_max_servers = DEFAULT_MAX_NUM_SERVERS;                                                           \
@@ -2858,6 +4572,7 @@ typedef struct offloading_engine
         (_core_engine)->self_ep = NULL;                                                                                      \
         (_core_engine)->num_inter_service_proc_clients = 0;                                                                  \
         (_core_engine)->num_max_inter_service_proc_clients = DEFAULT_MAX_NUM_SERVERS;                                        \
+        RESET_INTER_SP_CONNECT_MGR(&((_core_engine)->inter_sp_connect_mgr));                                                 \
         (_core_engine)->inter_service_proc_clients = NULL;                                                                   \
         (_core_engine)->inter_service_proc_clients = DPU_OFFLOAD_MALLOC((_core_engine)->num_max_inter_service_proc_clients * \
                                                                         sizeof(remote_service_procs_connect_tracker_t));     \
@@ -2868,6 +4583,14 @@ typedef struct offloading_engine
             break;                                                                                                           \
         }                                                                                                                    \
         (_core_engine)->num_registered_ops = 0;                                                                              \
+        DYN_ARRAY_ALLOC(&((_core_engine)->registered_ops), DEFAULT_NUM_REGISTERED_OPS, offload_op_t *);                       \
+        ucs_list_head_init(&((_core_engine)->pending_op_msgs));                                                               \
+        ucs_list_head_init(&((_core_engine)->final_ops));                                                                     \
+        (_core_engine)->final_ops_hash = kh_init(op_final_hash_t);                                                           \
+        memset((_core_engine)->bcast_handlers, 0, sizeof((_core_engine)->bcast_handlers));                                    \
+        (_core_engine)->ops_sched.queues = kh_init(op_queue_hash_t);                                                         \
+        (_core_engine)->ops_sched.seq = 0;                                                                                   \
+        (_core_engine)->ops_sched.num_rma = 0;                                                                               \
         DYN_LIST_ALLOC((_core_engine)->free_op_descs, 8, op_desc_t, item);                                                   \
         if ((_core_engine)->free_op_descs == NULL)                                                                           \
         {                                                                                                                    \
@@ -2876,6 +4599,14 @@ typedef struct offloading_engine
             break;                                                                                                           \
         }                                                                                                                    \
         GROUPS_CACHE_INIT(&((_core_engine)->procs_cache));                                                                   \
+        if (ep_pool_init(&((_core_engine)->ep_pool)) != DO_SUCCESS)                                                          \
+        {                                                                                                                    \
+            fprintf(stderr, "unable to initialize the endpoint pool\n");                                                     \
+            _core_ret = -1;                                                                                                  \
+            break;                                                                                                           \
+        }                                                                                                                    \
+        RESET_OOB_REACTOR(&((_core_engine)->oob_reactor));                                                                   \
+        RESET_RENDEZVOUS(&((_core_engine)->rendezvous));                                                                     \
         DYN_LIST_ALLOC((_core_engine)->free_cache_entry_requests, DEFAULT_NUM_PEERS, cache_entry_request_t, item);           \
         if ((_core_engine)->free_cache_entry_requests == NULL)                                                               \
         {                                                                                                                    \
@@ -2901,13 +4632,7 @@ typedef struct offloading_engine
             _core_ret = -1;                                                                                                  \
             break;                                                                                                           \
         }                                                                                                                    \
-        DYN_LIST_ALLOC((_core_engine)->pool_group_revoke_msgs_from_sps, 32, group_revoke_msg_from_sp_t, item);               \
-        if ((_core_engine)->pool_group_revoke_msgs_from_sps == NULL)                                                         \
-        {                                                                                                                    \
-            fprintf(stderr, "unable to allocate pool of objects for group revoke messages from sps\n");                      \
-            _core_ret = -1;                                                                                                  \
-            break;                                                                                                           \
-        }                                                                                                                    \
+        GROUP_REVOKE_MSG_POOL_INIT(&((_core_engine)->pool_group_revoke_msgs_from_sps));                                     \
         DYN_LIST_ALLOC((_core_engine)->pool_group_revoke_msgs_from_ranks, 32, group_revoke_msg_from_rank_t, item);           \
         if ((_core_engine)->pool_group_revoke_msgs_from_ranks == NULL)                                                       \
         {                                                                                                                    \
@@ -2936,6 +4661,21 @@ typedef struct offloading_engine
             _core_ret = -1;                                                                                                  \
             break;                                                                                                           \
         }                                                                                                                    \
+        DYN_LIST_ALLOC((_core_engine)->pool_pending_host_cache_requests, 32, pending_host_cache_request_t, item);            \
+        if ((_core_engine)->pool_pending_host_cache_requests == NULL)                                                        \
+        {                                                                                                                    \
+            fprintf(stderr, "unable to allocate pool of objects for pending requests of cache entries\n");                   \
+            _core_ret = -1;                                                                                                  \
+            break;                                                                                                           \
+        }                                                                                                                    \
+        DYN_LIST_ALLOC((_core_engine)->pool_pending_sp_notifs, 32, pending_sp_notif_t, item);                                \
+        if ((_core_engine)->pool_pending_sp_notifs == NULL)                                                                  \
+        {                                                                                                                    \
+            fprintf(stderr, "unable to allocate pool of objects for pending notifications to service processes\n");          \
+            _core_ret = -1;                                                                                                  \
+            break;                                                                                                           \
+        }                                                                                                                    \
+        ucs_list_head_init(&((_core_engine)->pending_sp_notifs));                                                            \
         DYN_ARRAY_ALLOC(GET_ENGINE_LIST_SERVICE_PROCS((_core_engine)),                                                       \
                         DEFAULT_NUM_SERVICE_PROCS,                                                                           \
                         remote_service_proc_info_t);                                                                         \
@@ -3180,6 +4920,9 @@ typedef struct pending_notification
     _list;                                                  \
 })
 
+// Whether connections between service processes are established on demand (see MIMOSA_LAZY_INTER_SP_CONNECT)
+#define LAZY_INTER_SP_CONNECT(_engine) ((_engine)->on_dpu && (_engine)->settings.lazy_inter_sp_connect)
+
 #define ECONTEXT_FOR_SERVICE_PROC_COMMUNICATION(_engine, _service_proc_idx) ({  \
     execution_context_t *_e = NULL;                                             \
     remote_service_proc_info_t *_sp;                                            \
@@ -3196,7 +4939,8 @@ typedef struct pending_notification
 
 #define GET_REMOTE_SERVICE_PROC_ECONTEXT(_engine, _service_proc_idx) ({                 \
     execution_context_t *_e = NULL;                                                     \
-    if ((_service_proc_idx) <= (_engine)->num_connected_service_procs)                  \
+    if (LAZY_INTER_SP_CONNECT(_engine) ||                                               \
+        (_service_proc_idx) <= (_engine)->num_connected_service_procs)                  \
     {                                                                                   \
         remote_service_proc_info_t *_sp;                                                \
         if ((_engine)->on_dpu)                                                          \
@@ -3246,7 +4990,8 @@ typedef struct pending_notification
 #define GET_REMOTE_SERVICE_PROC_EP_FROM_SP(_engine, _idx) ({                \
     ucp_ep_h __ep = NULL;                                                   \
     assert((_engine)->on_dpu);                                              \
-    if (_idx <= (_engine)->num_connected_service_procs)                     \
+    if (LAZY_INTER_SP_CONNECT(_engine) ||                                   \
+        _idx <= (_engine)->num_connected_service_procs)                     \
     {                                                                       \
         remote_service_proc_info_t *_sp = NULL;                             \
         _sp = DYN_ARRAY_GET_ELT(GET_ENGINE_LIST_SERVICE_PROCS((_engine)),   \
@@ -3298,7 +5043,8 @@ typedef enum
 {
     CONNECT_STATUS_UNKNOWN = 0,
     CONNECT_STATUS_CONNECTED,
-    CONNECT_STATUS_DISCONNECTED
+    CONNECT_STATUS_DISCONNECTED,
+    CONNECT_STATUS_IN_PROGRESS
 } connect_status_t;
 
 typedef struct service_proc
@@ -3367,8 +5113,11 @@ typedef struct remote_service_proc_info
     // Connection parameters for bootstrapping
     connect_status_t conn_status;
 
-    // identifier of the connection thread
-    pthread_t connection_tid;
+    // Element used to put the service process on the connection manager's queue
+    ucs_list_link_t connect_item;
+
+    // Number of times the connection to the service process was initiated
+    size_t num_connect_attempts;
 
     // Associated offloading engine
     offloading_engine_t *offload_engine;
@@ -3503,6 +5252,15 @@ typedef struct offloading_config
     // Hash of host UID for quick lookup. Key: host_iud_t; value: host_info_t.
     khash_t(host_info_hash_t) * host_lookup_table;
 
+    // How clients get the address of their server (see MIMOSA_RENDEZVOUS)
+    struct
+    {
+        rendezvous_backend_t backend;
+
+        // Directory (file backend) or name prefix (shm backend), NULL for the default
+        char *path;
+    } rendezvous;
+
     // Configuration of the local DPU (only valid on DPUs)
     struct
     {
@@ -3547,6 +5305,8 @@ typedef struct offloading_config
         DYN_ARRAY_ALLOC(&((_data)->sps_config), 256, service_proc_config_data_t);                                   \
         DYN_ARRAY_ALLOC(&((_data)->hosts_config), 32, host_info_t);                                                 \
         (_data)->host_lookup_table = kh_init(host_info_hash_t);                                                     \
+        (_data)->rendezvous.backend = RENDEZVOUS_OOB;                                                               \
+        (_data)->rendezvous.path = NULL;                                                                            \
         RESET_SERVICE_PROC(&((_data)->local_service_proc.info));                                                    \
         (_data)->local_service_proc.config = NULL;                                                                  \
         (_data)->local_service_proc.hostname[1023] = '\0';                                                          \
@@ -3571,6 +5331,15 @@ typedef struct offloading_config
 dpu_offload_status_t get_dpu_config(offloading_engine_t *, offloading_config_t *);
 
 dpu_offload_status_t get_host_config(offloading_config_t *);
+
+/**
+ * @brief Get the rendezvous backend from the environment (see MIMOSA_RENDEZVOUS), invoked by
+ * get_dpu_config() and get_host_config().
+ *
+ * @param[in/out] config_data Configuration to update
+ * @return dpu_offload_status_t
+ */
+dpu_offload_status_t get_rendezvous_config(offloading_config_t *config_data);
 dpu_offload_status_t find_dpu_config_from_platform_configfile(char *, offloading_config_t *);
 dpu_offload_status_t find_config_from_platform_configfile(char *, char *, offloading_config_t *);
 
@@ -3597,6 +5366,10 @@ typedef enum
     AM_REVOKE_GP_SP_MSG_ID,  // 45
     AM_SP_DATA_MSG_ID,
     AM_TEST_MSG_ID,
+    AM_RDV_HELLO_MSG_ID, // 48
+    AM_RDV_WELCOME_MSG_ID,
+    AM_OP_CANCEL_MSG_ID, // 50
+    AM_OP_SP_MSG_ID,
     LAST_RESERVED_NOTIF_ID,
 
     /* Internal emit-independent events */
@@ -7,6 +7,9 @@
 #ifndef DPU_OFFLOAD_UTILS_H
 #define DPU_OFFLOAD_UTILS_H
 
+#include <stdint.h>
+#include <time.h>
+
 #if defined(c_plusplus) || defined(__cplusplus)
 #    define _EXTERN_C_BEGIN extern "C" {
 #    define _EXTERN_C_END   }
@@ -24,4 +27,18 @@
     _list_sps;                                      \
 })
 
+// Current time of the monotonic clock in nanoseconds
+static inline uint64_t monotonic_time_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000 + (uint64_t)ts.tv_nsec;
+}
+
+// Current time of the monotonic clock in microseconds
+static inline uint64_t monotonic_time_us(void)
+{
+    return monotonic_time_ns() / 1000;
+}
+
 #endif // DPU_OFFLOAD_UTILS_H
\ No newline at end of file
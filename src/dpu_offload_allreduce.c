@@ -0,0 +1,785 @@
+//
+// Copyright (c) 2023, NVIDIA CORPORATION. All rights reserved.
+//
+// See LICENSE.txt for license information
+//
+
+#include <stdlib.h>
+#include <string.h>
+#include <inttypes.h>
+
+#include <ucp/api/ucp.h>
+
+#include "dpu_offload_types.h"
+#include "dpu_offload_mem_mgt.h"
+#include "dpu_offload_debug.h"
+#include "dpu_offload_event_channels.h"
+#include "dpu_offload_group_cache.h"
+#include "dpu_offload_ops.h"
+#include "dpu_offload_collectives.h"
+
+/*
+ * Offloaded allreduce. The operation of each rank is executed by its service process, which:
+ * 1. reads the contribution of the rank from its send buffer (RMA get);
+ * 2. gathers the contributions of the ranks associated to the same service process on the operation
+ *    of the lowest of these ranks, the leader, which reduces them in rank order once all arrived;
+ * 3. for leaders, combines the result with the leaders of the other service processes of the group
+ *    with a recursive doubling, the leaders beyond the largest power of two folding their data on a
+ *    partner first and getting the result from it at the end;
+ * 4. for leaders, sends the result to the operations of the other local ranks;
+ * 5. writes the result to the receive buffer of the rank (RMA put) and completes.
+ * The local contributions are reduced in rank order and the data of the lowest rank is the first
+ * operand of every reduction between leaders, so the result does not depend on the order in which
+ * messages arrive and all the ranks get the exact same result, even for floating point datatypes.
+ */
+
+typedef enum
+{
+    ALLREDUCE_MSG_CONTRIB = 0, // Contribution of a local rank, to the leader
+    ALLREDUCE_MSG_STEP,        // Data of a leader for a step of the inter-SP stage
+    ALLREDUCE_MSG_RESULT,      // Final result
+} allreduce_msg_type_t;
+
+// Step of the messages from the leaders folding their data, the recursive doubling steps start at 1
+#define ALLREDUCE_FOLD_STEP (0)
+#define ALLREDUCE_MAX_STEPS (64)
+
+typedef struct allreduce_msg
+{
+    uint64_t type; // See allreduce_msg_type_t
+    int64_t src_rank;
+    uint64_t step;
+} allreduce_msg_t;
+
+typedef enum
+{
+    ALLREDUCE_STAGE_RESOLVE = 0,
+    ALLREDUCE_STAGE_FETCH,
+    ALLREDUCE_STAGE_GATHER,
+    ALLREDUCE_STAGE_INTER_SP,
+    ALLREDUCE_STAGE_WAIT_RESULT,
+    ALLREDUCE_STAGE_WRITE,
+    ALLREDUCE_STAGE_DONE,
+} allreduce_stage_t;
+
+typedef struct allreduce_state
+{
+    int64_t group_size;
+    reduce_op_t op;
+    reduce_dt_t dt;
+    size_t count;
+    size_t len;
+    allreduce_stage_t stage;
+
+    // Endpoint to the rank and remote keys of its buffers
+    ucp_ep_h ep;
+    ucp_rkey_h send_rkey;
+    ucp_rkey_h recv_rkey;
+    void *req;
+    void *flush_req;
+
+    // Service process of every rank of the group
+    int64_t *sp_ids;
+    // Events of the cache lookups of the ranks that were not in the cache yet, indexed by rank
+    dpu_offload_event_t **cache_evs;
+
+    int64_t leader;
+    size_t num_local_ranks;
+    // Leaders of all the service processes of the group, ordered by rank, and our index in it
+    int64_t *leaders;
+    size_t num_leaders;
+    size_t leader_idx;
+    size_t num_steps;
+    size_t cur_step;
+
+    // Contribution of the rank, then result
+    void *buf;
+    // Contributions of the local ranks indexed by rank until they all arrived, leader only
+    void **contribs;
+    size_t num_contribs;
+    // Reduction of the contributions of the local ranks, leader only
+    void *acc;
+    bool step_sent;
+    // Data received from other leaders, indexed by step
+    void *step_data[ALLREDUCE_MAX_STEPS];
+    void *result;
+} allreduce_state_t;
+
+static dpu_offload_status_t allreduce_send(op_desc_t *desc, allreduce_state_t *state, int64_t dst_rank, allreduce_msg_type_t type, uint64_t step, void *data)
+{
+    allreduce_msg_t *msg;
+    dpu_offload_status_t rc;
+
+    msg = DPU_OFFLOAD_MALLOC(sizeof(allreduce_msg_t) + state->len);
+    CHECK_ERR_RETURN((msg == NULL), DO_ERROR, "unable to allocate memory");
+    msg->type = type;
+    msg->src_rank = desc->group_rank;
+    msg->step = step;
+    memcpy(msg + 1, data, state->len);
+    rc = op_send_to_sp(desc, state->sp_ids[dst_rank], dst_rank, msg, sizeof(allreduce_msg_t) + state->len);
+    free(msg);
+    CHECK_ERR_RETURN((rc != DO_SUCCESS), DO_ERROR, "unable to send data to rank %" PRId64, dst_rank);
+    return DO_SUCCESS;
+}
+
+// Reduce the data of two ranks into acc, the data of the lowest rank being the first operand
+static void allreduce_combine(allreduce_state_t *state, void **acc, int64_t acc_rank, void **data, int64_t data_rank)
+{
+    if (acc_rank < data_rank)
+    {
+        reduce_kernel(state->op, state->dt, *acc, *data, state->count);
+    }
+    else
+    {
+        void *tmp = *acc;
+        reduce_kernel(state->op, state->dt, *data, *acc, state->count);
+        *acc = *data;
+        *data = tmp;
+    }
+}
+
+static dpu_offload_status_t allreduce_add_contrib(allreduce_state_t *state, int64_t rank, void **data)
+{
+    if (state->contribs == NULL)
+    {
+        state->contribs = DPU_OFFLOAD_MALLOC(state->group_size * sizeof(void *));
+        CHECK_ERR_RETURN((state->contribs == NULL), DO_ERROR, "unable to allocate memory");
+        memset(state->contribs, 0, state->group_size * sizeof(void *));
+    }
+    CHECK_ERR_RETURN((state->contribs[rank] != NULL), DO_ERROR, "duplicate contribution from rank %" PRId64, rank);
+    state->contribs[rank] = *data;
+    *data = NULL;
+    state->num_contribs++;
+    return DO_SUCCESS;
+}
+
+// Reduce the contributions of the local ranks in rank order, whatever the order they arrived in
+static void allreduce_reduce_contribs(allreduce_state_t *state)
+{
+    int64_t i;
+    for (i = 0; i < state->group_size; i++)
+    {
+        if (state->contribs[i] == NULL)
+            continue;
+        if (state->acc == NULL)
+        {
+            state->acc = state->contribs[i];
+        }
+        else
+        {
+            reduce_kernel(state->op, state->dt, state->acc, state->contribs[i], state->count);
+            free(state->contribs[i]);
+        }
+        state->contribs[i] = NULL;
+    }
+}
+
+size_t allreduce_get_leaders(const int64_t *sp_ids, int64_t group_size, int64_t *leaders)
+{
+    size_t num_leaders = 0, l;
+    int64_t i;
+
+    // The leader of a service process is the lowest rank associated to it
+    for (i = 0; i < group_size; i++)
+    {
+        bool first_of_sp = true;
+        for (l = 0; l < num_leaders && first_of_sp; l++)
+        {
+            if (sp_ids[leaders[l]] == sp_ids[i])
+                first_of_sp = false;
+        }
+        if (first_of_sp)
+            leaders[num_leaders++] = i;
+    }
+    return num_leaders;
+}
+
+size_t allreduce_get_num_steps(size_t num_leaders)
+{
+    size_t num_steps = 0, p2;
+    for (p2 = 1; p2 * 2 <= num_leaders; p2 *= 2)
+        num_steps++;
+    return num_steps;
+}
+
+int64_t allreduce_get_step_peer(size_t num_leaders, size_t leader_idx, size_t step)
+{
+    size_t num_steps = allreduce_get_num_steps(num_leaders);
+    size_t p2 = (size_t)1 << num_steps;
+
+    if (leader_idx >= num_leaders || step > num_steps)
+        return -1;
+    if (step == ALLREDUCE_FOLD_STEP)
+    {
+        if (leader_idx >= p2)
+            return (int64_t)(leader_idx - p2);
+        if (leader_idx + p2 < num_leaders)
+            return (int64_t)(leader_idx + p2);
+        return -1;
+    }
+    // Leaders that folded their data wait for the result
+    if (leader_idx >= p2)
+        return -1;
+    return (int64_t)(leader_idx ^ ((size_t)1 << (step - 1)));
+}
+
+static dpu_offload_status_t allreduce_resolve(op_desc_t *desc, allreduce_state_t *state)
+{
+    offloading_engine_t *engine = desc->econtext->engine;
+    size_t n_missing = 0, l;
+    dpu_offload_status_t rc;
+    int64_t i;
+
+    if (state->cache_evs != NULL)
+    {
+        for (i = 0; i < state->group_size; i++)
+        {
+            if (state->cache_evs[i] == NULL)
+                continue;
+            if (!event_completed(state->cache_evs[i]))
+                return DO_SUCCESS;
+            event_return(&(state->cache_evs[i]));
+        }
+    }
+
+    rc = get_sp_ids_by_group_ranks(engine, desc->gp_uid, NULL, state->group_size, 0, state->sp_ids, &n_missing);
+    CHECK_ERR_RETURN((rc != DO_SUCCESS), DO_ERROR, "get_sp_ids_by_group_ranks() failed");
+    if (n_missing > 0)
+    {
+        DBG("%zu ranks of group 0x%x are not in the cache, requesting them", n_missing, desc->gp_uid);
+        if (state->cache_evs == NULL)
+        {
+            state->cache_evs = DPU_OFFLOAD_MALLOC(state->group_size * sizeof(dpu_offload_event_t *));
+            CHECK_ERR_RETURN((state->cache_evs == NULL), DO_ERROR, "unable to allocate memory");
+            memset(state->cache_evs, 0, state->group_size * sizeof(dpu_offload_event_t *));
+        }
+        for (i = 0; i < state->group_size; i++)
+        {
+            int64_t sp_id;
+            if (state->sp_ids[i] != -1)
+                continue;
+            rc = get_sp_id_by_group_rank(engine, desc->gp_uid, i, 0, &sp_id, &(state->cache_evs[i]));
+            CHECK_ERR_RETURN((rc != DO_SUCCESS), DO_ERROR, "get_sp_id_by_group_rank() failed");
+        }
+        return DO_SUCCESS;
+    }
+
+    state->num_leaders = allreduce_get_leaders(state->sp_ids, state->group_size, state->leaders);
+    for (l = 0; l < state->num_leaders; l++)
+    {
+        if (state->sp_ids[state->leaders[l]] == state->sp_ids[desc->group_rank])
+        {
+            state->leader = state->leaders[l];
+            state->leader_idx = l;
+            break;
+        }
+    }
+    for (i = 0; i < state->group_size; i++)
+    {
+        if (state->sp_ids[i] == state->sp_ids[desc->group_rank])
+            state->num_local_ranks++;
+    }
+    state->num_steps = allreduce_get_num_steps(state->num_leaders);
+    CHECK_ERR_RETURN((state->num_steps >= ALLREDUCE_MAX_STEPS), DO_ERROR, "too many service processes");
+    state->cur_step = 1;
+    state->stage = ALLREDUCE_STAGE_FETCH;
+    return DO_SUCCESS;
+}
+
+static bool allreduce_req_completed(void **req)
+{
+    if (*req == NULL)
+        return true;
+    if (ucp_request_check_status(*req) == UCS_INPROGRESS)
+        return false;
+    ucp_request_free(*req);
+    *req = NULL;
+    return true;
+}
+
+// Recursive doubling between the leaders, done is set once the leader has the final result
+static dpu_offload_status_t allreduce_inter_sp(op_desc_t *desc, allreduce_state_t *state, bool *done)
+{
+    size_t p2 = (size_t)1 << state->num_steps;
+    size_t idx = state->leader_idx;
+    int64_t fold_peer = allreduce_get_step_peer(state->num_leaders, idx, ALLREDUCE_FOLD_STEP);
+    dpu_offload_status_t rc;
+
+    *done = false;
+    if (idx >= p2)
+    {
+        // Fold our data on our partner, the result comes back as a RESULT message
+        rc = allreduce_send(desc, state, state->leaders[fold_peer], ALLREDUCE_MSG_STEP, ALLREDUCE_FOLD_STEP, state->acc);
+        CHECK_ERR_RETURN((rc != DO_SUCCESS), DO_ERROR, "allreduce_send() failed");
+        state->stage = ALLREDUCE_STAGE_WAIT_RESULT;
+        return DO_SUCCESS;
+    }
+
+    if (state->cur_step == 1 && fold_peer != -1)
+    {
+        if (state->step_data[ALLREDUCE_FOLD_STEP] == NULL)
+            return DO_SUCCESS;
+        allreduce_combine(state,
+                          &(state->acc),
+                          state->leaders[idx],
+                          &(state->step_data[ALLREDUCE_FOLD_STEP]),
+                          state->leaders[fold_peer]);
+        free(state->step_data[ALLREDUCE_FOLD_STEP]);
+        state->step_data[ALLREDUCE_FOLD_STEP] = NULL;
+    }
+
+    while (state->cur_step <= state->num_steps)
+    {
+        int64_t partner = allreduce_get_step_peer(state->num_leaders, idx, state->cur_step);
+        if (!state->step_sent)
+        {
+            rc = allreduce_send(desc, state, state->leaders[partner], ALLREDUCE_MSG_STEP, state->cur_step, state->acc);
+            CHECK_ERR_RETURN((rc != DO_SUCCESS), DO_ERROR, "allreduce_send() failed");
+            state->step_sent = true;
+        }
+        if (state->step_data[state->cur_step] == NULL)
+            return DO_SUCCESS;
+        allreduce_combine(state,
+                          &(state->acc),
+                          state->leaders[idx],
+                          &(state->step_data[state->cur_step]),
+                          state->leaders[partner]);
+        free(state->step_data[state->cur_step]);
+        state->step_data[state->cur_step] = NULL;
+        state->step_sent = false;
+        state->cur_step++;
+    }
+
+    if (fold_peer != -1)
+    {
+        rc = allreduce_send(desc, state, state->leaders[fold_peer], ALLREDUCE_MSG_RESULT, 0, state->acc);
+        CHECK_ERR_RETURN((rc != DO_SUCCESS), DO_ERROR, "allreduce_send() failed");
+    }
+    *done = true;
+    return DO_SUCCESS;
+}
+
+static dpu_offload_status_t allreduce_init_state(op_desc_t *desc)
+{
+    offloading_engine_t *engine = desc->econtext->engine;
+    allreduce_args_t *args = (allreduce_args_t *)desc->args;
+    allreduce_state_t *state;
+    ucs_status_t status;
+    uint8_t *keys;
+
+    CHECK_ERR_RETURN((desc->args_len < sizeof(allreduce_args_t)), DO_ERROR, "invalid allreduce arguments");
+    CHECK_ERR_RETURN((desc->args_len != sizeof(allreduce_args_t) + args->send_rkey_len + args->recv_rkey_len ||
+                      desc->num_inputs != 1 || desc->num_outputs != 1 ||
+                      desc->group_rank < 0 || desc->group_rank >= args->group_size ||
+                      args->op >= REDUCE_OP_LAST || args->dt >= REDUCE_DT_LAST ||
+                      desc->inputs[0].len != args->count * reduce_dt_size(args->dt) ||
+                      desc->outputs[0].len != args->count * reduce_dt_size(args->dt)),
+                     DO_ERROR,
+                     "invalid allreduce arguments");
+
+    state = DPU_OFFLOAD_MALLOC(sizeof(allreduce_state_t));
+    CHECK_ERR_RETURN((state == NULL), DO_ERROR, "unable to allocate memory");
+    memset(state, 0, sizeof(allreduce_state_t));
+    desc->op_data = state;
+    state->group_size = args->group_size;
+    state->op = (reduce_op_t)args->op;
+    state->dt = (reduce_dt_t)args->dt;
+    state->count = args->count;
+    state->len = args->count * reduce_dt_size(state->dt);
+    state->stage = ALLREDUCE_STAGE_RESOLVE;
+
+    switch (desc->econtext->type)
+    {
+    case CONTEXT_SERVER:
+        state->ep = GET_CLIENT_EP(desc->econtext, desc->origin_id);
+        break;
+    case CONTEXT_SELF:
+        state->ep = engine->self_ep;
+        break;
+    default:
+        break;
+    }
+    CHECK_ERR_RETURN((state->ep == NULL), DO_ERROR, "unable to get the endpoint of rank %" PRId64, desc->group_rank);
+
+    keys = (uint8_t *)(args + 1);
+    status = ucp_ep_rkey_unpack(state->ep, keys, &(state->send_rkey));
+    CHECK_ERR_RETURN((status != UCS_OK), DO_ERROR, "ucp_ep_rkey_unpack() failed: %s", ucs_status_string(status));
+    status = ucp_ep_rkey_unpack(state->ep, keys + args->send_rkey_len, &(state->recv_rkey));
+    CHECK_ERR_RETURN((status != UCS_OK), DO_ERROR, "ucp_ep_rkey_unpack() failed: %s", ucs_status_string(status));
+
+    state->sp_ids = DPU_OFFLOAD_MALLOC(state->group_size * sizeof(int64_t));
+    state->leaders = DPU_OFFLOAD_MALLOC(state->group_size * sizeof(int64_t));
+    state->buf = DPU_OFFLOAD_MALLOC(state->len);
+    CHECK_ERR_RETURN((state->sp_ids == NULL || state->leaders == NULL || state->buf == NULL),
+                     DO_ERROR,
+                     "unable to allocate memory");
+    return DO_SUCCESS;
+}
+
+static void allreduce_op_fini(op_desc_t *desc)
+{
+    offloading_engine_t *engine = desc->econtext->engine;
+    allreduce_state_t *state = (allreduce_state_t *)desc->op_data;
+    size_t i;
+
+    if (state == NULL)
+        return;
+    if (state->req != NULL)
+    {
+        ucp_request_cancel(engine->ucp_worker, state->req);
+        ucp_request_free(state->req);
+    }
+    if (state->flush_req != NULL)
+    {
+        ucp_request_cancel(engine->ucp_worker, state->flush_req);
+        ucp_request_free(state->flush_req);
+    }
+    if (state->send_rkey != NULL)
+        ucp_rkey_destroy(state->send_rkey);
+    if (state->recv_rkey != NULL)
+        ucp_rkey_destroy(state->recv_rkey);
+    for (i = 0; i < ALLREDUCE_MAX_STEPS; i++)
+    {
+        if (state->step_data[i] != NULL)
+            free(state->step_data[i]);
+    }
+    // Events of cache lookups still in progress are on the list of their cache entry, they cannot
+    // be returned before they complete
+    if (state->cache_evs != NULL)
+        free(state->cache_evs);
+    if (state->sp_ids != NULL)
+        free(state->sp_ids);
+    if (state->leaders != NULL)
+        free(state->leaders);
+    if (state->buf != NULL)
+        free(state->buf);
+    if (state->contribs != NULL)
+    {
+        for (i = 0; i < state->group_size; i++)
+        {
+            if (state->contribs[i] != NULL)
+                free(state->contribs[i]);
+        }
+        free(state->contribs);
+    }
+    if (state->acc != NULL)
+        free(state->acc);
+    if (state->result != NULL)
+        free(state->result);
+    free(state);
+    desc->op_data = NULL;
+}
+
+static dpu_offload_status_t allreduce_op_init(op_desc_t *desc)
+{
+    dpu_offload_status_t rc = allreduce_init_state(desc);
+    // op_fini is only invoked for operations that started
+    if (rc != DO_SUCCESS)
+        allreduce_op_fini(desc);
+    return rc;
+}
+
+static dpu_offload_status_t allreduce_op_recv(op_desc_t *desc, void *data, size_t data_len)
+{
+    allreduce_state_t *state = (allreduce_state_t *)desc->op_data;
+    allreduce_msg_t *msg = (allreduce_msg_t *)data;
+    void *copy;
+
+    CHECK_ERR_RETURN((data_len != sizeof(allreduce_msg_t) + state->len ||
+                      msg->src_rank < 0 || msg->src_rank >= state->group_size ||
+                      msg->step >= ALLREDUCE_MAX_STEPS),
+                     DO_ERROR,
+                     "invalid allreduce message");
+    copy = DPU_OFFLOAD_MALLOC(state->len);
+    CHECK_ERR_RETURN((copy == NULL), DO_ERROR, "unable to allocate memory");
+    memcpy(copy, msg + 1, state->len);
+
+    switch (msg->type)
+    {
+    case ALLREDUCE_MSG_CONTRIB:
+        if (allreduce_add_contrib(state, msg->src_rank, &copy) != DO_SUCCESS)
+        {
+            free(copy);
+            return DO_ERROR;
+        }
+        break;
+    case ALLREDUCE_MSG_STEP:
+        // Leaders can be ahead of us by one step, the data is kept until we reach that step
+        if (state->step_data[msg->step] != NULL)
+        {
+            free(copy);
+            ERR_MSG("duplicate data for step %" PRIu64 " from rank %" PRId64, msg->step, msg->src_rank);
+            return DO_ERROR;
+        }
+        state->step_data[msg->step] = copy;
+        copy = NULL;
+        break;
+    case ALLREDUCE_MSG_RESULT:
+        if (state->result != NULL)
+        {
+            free(copy);
+            ERR_MSG("duplicate result from rank %" PRId64, msg->src_rank);
+            return DO_ERROR;
+        }
+        state->result = copy;
+        copy = NULL;
+        break;
+    default:
+        free(copy);
+        ERR_MSG("invalid allreduce message type %" PRIu64, msg->type);
+        return DO_ERROR;
+    }
+    if (copy != NULL)
+        free(copy);
+    return DO_SUCCESS;
+}
+
+static dpu_offload_status_t allreduce_op_progress(op_desc_t *desc, bool *completed)
+{
+    allreduce_state_t *state = (allreduce_state_t *)desc->op_data;
+    ucp_request_param_t params;
+    ucs_status_ptr_t req;
+    dpu_offload_status_t rc;
+    bool done;
+    int64_t i;
+
+    *completed = false;
+    switch (state->stage)
+    {
+    case ALLREDUCE_STAGE_RESOLVE:
+        rc = allreduce_resolve(desc, state);
+        CHECK_ERR_RETURN((rc != DO_SUCCESS), DO_ERROR, "allreduce_resolve() failed");
+        if (state->stage == ALLREDUCE_STAGE_RESOLVE)
+            return DO_SUCCESS;
+        // fall through
+    case ALLREDUCE_STAGE_FETCH:
+        if (state->req == NULL)
+        {
+            if (!op_rma_acquire(desc))
+                return DO_SUCCESS;
+            memset(&params, 0, sizeof(params));
+            req = ucp_get_nbx(state->ep, state->buf, state->len, desc->inputs[0].addr, state->send_rkey, &params);
+            CHECK_ERR_RETURN((UCS_PTR_IS_ERR(req)), DO_ERROR, "ucp_get_nbx() failed: %s", ucs_status_string(UCS_PTR_STATUS(req)));
+            state->req = UCS_PTR_IS_PTR(req) ? req : NULL;
+        }
+        if (!allreduce_req_completed(&(state->req)))
+            return DO_SUCCESS;
+        op_rma_release(desc);
+        if (state->leader == desc->group_rank)
+        {
+            rc = allreduce_add_contrib(state, desc->group_rank, &(state->buf));
+            CHECK_ERR_RETURN((rc != DO_SUCCESS), DO_ERROR, "allreduce_add_contrib() failed");
+            state->stage = ALLREDUCE_STAGE_GATHER;
+        }
+        else
+        {
+            rc = allreduce_send(desc, state, state->leader, ALLREDUCE_MSG_CONTRIB, 0, state->buf);
+            CHECK_ERR_RETURN((rc != DO_SUCCESS), DO_ERROR, "allreduce_send() failed");
+            state->stage = ALLREDUCE_STAGE_WAIT_RESULT;
+            return DO_SUCCESS;
+        }
+        // fall through
+    case ALLREDUCE_STAGE_GATHER:
+        if (state->num_contribs < state->num_local_ranks)
+            return DO_SUCCESS;
+        allreduce_reduce_contribs(state);
+        state->stage = ALLREDUCE_STAGE_INTER_SP;
+        // fall through
+    case ALLREDUCE_STAGE_INTER_SP:
+        rc = allreduce_inter_sp(desc, state, &done);
+        CHECK_ERR_RETURN((rc != DO_SUCCESS), DO_ERROR, "allreduce_inter_sp() failed");
+        if (!done)
+            return DO_SUCCESS;
+        state->result = state->acc;
+        state->acc = NULL;
+        state->stage = ALLREDUCE_STAGE_WAIT_RESULT;
+        // fall through
+    case ALLREDUCE_STAGE_WAIT_RESULT:
+        if (state->result == NULL || !op_rma_acquire(desc))
+            return DO_SUCCESS;
+        if (state->leader == desc->group_rank)
+        {
+            for (i = desc->group_rank + 1; i < state->group_size; i++)
+            {
+                if (state->sp_ids[i] != state->sp_ids[desc->group_rank])
+                    continue;
+                rc = allreduce_send(desc, state, i, ALLREDUCE_MSG_RESULT, 0, state->result);
+                CHECK_ERR_RETURN((rc != DO_SUCCESS), DO_ERROR, "allreduce_send() failed");
+            }
+        }
+        memset(&params, 0, sizeof(params));
+        req = ucp_put_nbx(state->ep, state->result, state->len, desc->outputs[0].addr, state->recv_rkey, &params);
+        CHECK_ERR_RETURN((UCS_PTR_IS_ERR(req)), DO_ERROR, "ucp_put_nbx() failed: %s", ucs_status_string(UCS_PTR_STATUS(req)));
+        state->req = UCS_PTR_IS_PTR(req) ? req : NULL;
+        // The operation completes, and the rank is notified, once the result is in the receive buffer
+        memset(&params, 0, sizeof(params));
+        req = ucp_ep_flush_nbx(state->ep, &params);
+        CHECK_ERR_RETURN((UCS_PTR_IS_ERR(req)), DO_ERROR, "ucp_ep_flush_nbx() failed: %s", ucs_status_string(UCS_PTR_STATUS(req)));
+        state->flush_req = UCS_PTR_IS_PTR(req) ? req : NULL;
+        state->stage = ALLREDUCE_STAGE_WRITE;
+        // fall through
+    case ALLREDUCE_STAGE_WRITE:
+        if (!allreduce_req_completed(&(state->req)) || !allreduce_req_completed(&(state->flush_req)))
+            return DO_SUCCESS;
+        op_rma_release(desc);
+        state->stage = ALLREDUCE_STAGE_DONE;
+        // fall through
+    case ALLREDUCE_STAGE_DONE:
+        *completed = true;
+        break;
+    }
+    return DO_SUCCESS;
+}
+
+static dpu_offload_status_t allreduce_op_cancel(op_desc_t *desc)
+{
+    allreduce_state_t *state = (allreduce_state_t *)desc->op_data;
+    // Once the contribution of the rank is out, the other ranks of the group depend on the operation
+    if (state->stage > ALLREDUCE_STAGE_FETCH)
+        return DO_NOT_APPLICABLE;
+    return DO_SUCCESS;
+}
+
+/*
+ * On the process submitting the operation, the buffers are registered for the time of the
+ * operation; op_complete releases them.
+ */
+typedef struct allreduce_host_state
+{
+    ucp_context_h ucp_context;
+    ucp_mem_h send_memh;
+    ucp_mem_h recv_memh;
+} allreduce_host_state_t;
+
+static void allreduce_host_state_free(allreduce_host_state_t *host_state)
+{
+    if (host_state->send_memh != NULL)
+        ucp_mem_unmap(host_state->ucp_context, host_state->send_memh);
+    if (host_state->recv_memh != NULL)
+        ucp_mem_unmap(host_state->ucp_context, host_state->recv_memh);
+    free(host_state);
+}
+
+static void allreduce_op_complete(op_desc_t *desc)
+{
+    if (desc->op_data == NULL)
+        return;
+    allreduce_host_state_free((allreduce_host_state_t *)desc->op_data);
+    desc->op_data = NULL;
+}
+
+dpu_offload_status_t allreduce_register(offloading_engine_t *engine)
+{
+    offload_op_t op = {
+        .alg_id = OP_ALG_ALLREDUCE,
+        .op_init = allreduce_op_init,
+        .op_complete = allreduce_op_complete,
+        .op_progress = allreduce_op_progress,
+        .op_cancel = allreduce_op_cancel,
+        .op_fini = allreduce_op_fini,
+        .op_recv = allreduce_op_recv,
+        .alg_data = NULL,
+    };
+    uint64_t op_id;
+    return register_new_op(engine, &op, &op_id);
+}
+
+static dpu_offload_status_t allreduce_map_buffer(ucp_context_h ucp_context, void *addr, size_t len, ucp_mem_h *memh, void **rkey_buf, size_t *rkey_len)
+{
+    ucp_mem_map_params_t params;
+    ucs_status_t status;
+
+    memset(&params, 0, sizeof(params));
+    params.field_mask = UCP_MEM_MAP_PARAM_FIELD_ADDRESS | UCP_MEM_MAP_PARAM_FIELD_LENGTH;
+    params.address = addr;
+    params.length = len;
+    status = ucp_mem_map(ucp_context, &params, memh);
+    CHECK_ERR_RETURN((status != UCS_OK), DO_ERROR, "ucp_mem_map() failed: %s", ucs_status_string(status));
+    status = ucp_rkey_pack(ucp_context, *memh, rkey_buf, rkey_len);
+    CHECK_ERR_RETURN((status != UCS_OK), DO_ERROR, "ucp_rkey_pack() failed: %s", ucs_status_string(status));
+    return DO_SUCCESS;
+}
+
+dpu_offload_status_t allreduce_post(execution_context_t *econtext, uint64_t id, allreduce_params_t *params, op_desc_t **desc)
+{
+    allreduce_host_state_t *host_state = NULL;
+    void *send_rkey = NULL, *recv_rkey = NULL;
+    size_t send_rkey_len = 0, recv_rkey_len = 0, len;
+    allreduce_args_t *args = NULL;
+    dpu_offload_status_t rc;
+    op_desc_t *d = NULL;
+    uint64_t op_id;
+
+    CHECK_ERR_RETURN((econtext == NULL || (econtext->type != CONTEXT_CLIENT && econtext->type != CONTEXT_SELF)),
+                     DO_ERROR,
+                     "a client or self execution context is required");
+    CHECK_ERR_RETURN((params == NULL || desc == NULL), DO_ERROR, "undefined parameters");
+    CHECK_ERR_RETURN((params->group_size <= 0 || params->group_rank < 0 || params->group_rank >= params->group_size),
+                     DO_ERROR,
+                     "invalid group rank %" PRId64 " or size %" PRId64, params->group_rank, params->group_size);
+    len = params->count * reduce_dt_size(params->dt);
+    CHECK_ERR_RETURN((params->op >= REDUCE_OP_LAST || len == 0 || params->sendbuf == NULL || params->recvbuf == NULL),
+                     DO_ERROR,
+                     "invalid allreduce parameters");
+    rc = get_op_id_by_alg_id(econtext->engine, OP_ALG_ALLREDUCE, &op_id);
+    CHECK_ERR_RETURN((rc != DO_SUCCESS), DO_ERROR, "allreduce is not registered");
+
+    host_state = DPU_OFFLOAD_MALLOC(sizeof(allreduce_host_state_t));
+    CHECK_ERR_RETURN((host_state == NULL), DO_ERROR, "unable to allocate memory");
+    memset(host_state, 0, sizeof(allreduce_host_state_t));
+    host_state->ucp_context = econtext->engine->ucp_context;
+    rc = allreduce_map_buffer(host_state->ucp_context, (void *)params->sendbuf, len, &(host_state->send_memh), &send_rkey, &send_rkey_len);
+    CHECK_ERR_GOTO((rc != DO_SUCCESS), error_out, "unable to register the send buffer");
+    rc = allreduce_map_buffer(host_state->ucp_context, params->recvbuf, len, &(host_state->recv_memh), &recv_rkey, &recv_rkey_len);
+    CHECK_ERR_GOTO((rc != DO_SUCCESS), error_out, "unable to register the receive buffer");
+
+    args = DPU_OFFLOAD_MALLOC(sizeof(allreduce_args_t) + send_rkey_len + recv_rkey_len);
+    CHECK_ERR_GOTO((args == NULL), error_out, "unable to allocate memory");
+    args->group_size = params->group_size;
+    args->op = params->op;
+    args->dt = params->dt;
+    args->count = params->count;
+    args->send_rkey_len = send_rkey_len;
+    args->recv_rkey_len = recv_rkey_len;
+    memcpy(args + 1, send_rkey, send_rkey_len);
+    memcpy((uint8_t *)(args + 1) + send_rkey_len, recv_rkey, recv_rkey_len);
+
+    rc = op_desc_get(econtext->engine, id, op_id, &d);
+    CHECK_ERR_GOTO((rc != DO_SUCCESS), error_out, "op_desc_get() failed");
+    d->gp_uid = params->gp_uid;
+    d->group_rank = params->group_rank;
+    d->args = args;
+    d->args_len = sizeof(allreduce_args_t) + send_rkey_len + recv_rkey_len;
+    d->op_data = host_state;
+    rc = op_desc_add_buffer(d, OP_BUFFER_INPUT, (void *)params->sendbuf, len);
+    CHECK_ERR_GOTO((rc != DO_SUCCESS), error_out, "op_desc_add_buffer() failed");
+    rc = op_desc_add_buffer(d, OP_BUFFER_OUTPUT, params->recvbuf, len);
+    CHECK_ERR_GOTO((rc != DO_SUCCESS), error_out, "op_desc_add_buffer() failed");
+    rc = op_desc_submit(econtext, d);
+    CHECK_ERR_GOTO((rc != DO_SUCCESS), error_out, "op_desc_submit() failed");
+
+    // The arguments are copied in the start notification
+    free(args);
+    d->args = NULL;
+    d->args_len = 0;
+    ucp_rkey_buffer_release(send_rkey);
+    ucp_rkey_buffer_release(recv_rkey);
+    *desc = d;
+    return DO_SUCCESS;
+
+error_out:
+    if (args != NULL)
+        free(args);
+    if (send_rkey != NULL)
+        ucp_rkey_buffer_release(send_rkey);
+    if (recv_rkey != NULL)
+        ucp_rkey_buffer_release(recv_rkey);
+    allreduce_host_state_free(host_state);
+    if (d != NULL)
+    {
+        d->args = NULL;
+        d->op_data = NULL;
+        op_desc_return(econtext->engine, &d);
+    }
+    return DO_ERROR;
+}
@@ -0,0 +1,651 @@
+//
+// Copyright (c) 2023, NVIDIA CORPORATION. All rights reserved.
+//
+// See LICENSE.txt for license information
+//
+
+#include <stdlib.h>
+#include <string.h>
+#include <inttypes.h>
+
+#include <ucp/api/ucp.h>
+
+#include "dpu_offload_types.h"
+#include "dpu_offload_mem_mgt.h"
+#include "dpu_offload_debug.h"
+#include "dpu_offload_event_channels.h"
+#include "dpu_offload_group_cache.h"
+#include "dpu_offload_ops.h"
+#include "dpu_offload_collectives.h"
+
+/*
+ * Offloaded alltoallv: each rank posts its counts, displacements and the keys of its buffers exported
+ * to its service process, which imports them. Data is then moved with RMA puts issued by the service
+ * process of the sender, directly from the send buffer of the sender to the receive buffer of the
+ * receiver:
+ * 1. the operation of every rank sends a ready-to-receive (RTR) message to the operation of each rank
+ *    it receives data from, with the address where the data goes and a remote key of its receive
+ *    buffer, packed by its service process;
+ * 2. upon reception of a RTR, the operation of the sender puts the data, flushes the endpoint and
+ *    sends a DONE message to the operation of the receiver;
+ * 3. the operation of a rank completes once all its data is sent and all the DONE messages it expects
+ *    are received.
+ * RTRs for peers on other hosts are sent first so the transfers that go through the network start
+ * early, and the order is shifted by the rank so ranks do not all target the same peers at the same
+ * time.
+ */
+
+typedef enum
+{
+    ALLTOALLV_MSG_RTR = 0,
+    ALLTOALLV_MSG_DONE,
+} alltoallv_msg_type_t;
+
+typedef struct alltoallv_msg
+{
+    uint64_t type; // See alltoallv_msg_type_t
+    int64_t src_rank;
+
+    // RTR only: where the data goes, number of bytes expected and size of the packed remote key that follows
+    uint64_t addr;
+    uint64_t len;
+    uint64_t rkey_len;
+} alltoallv_msg_t;
+
+typedef struct alltoallv_peer
+{
+    int64_t sp_gid;
+    uint64_t host;
+
+    // Target of the data sent to the peer, known once its RTR is received
+    uint64_t remote_addr;
+    void *rkey_buf;
+    ucp_rkey_h rkey;
+} alltoallv_peer_t;
+
+typedef struct alltoallv_xfer
+{
+    int64_t peer;
+    void *put_req;
+    void *flush_req;
+} alltoallv_xfer_t;
+
+typedef struct alltoallv_state
+{
+    int64_t group_size;
+    size_t dt_size;
+    int64_t *sendcounts;
+    int64_t *sdispls;
+    int64_t *recvcounts;
+    int64_t *rdispls;
+
+    ucp_mem_h send_memh;
+    ucp_mem_h recv_memh;
+    void *rkey_buf;
+    size_t rkey_len;
+
+    alltoallv_peer_t *peers;
+    bool peers_resolved;
+    // Events of the cache lookups of the peers that were not in the cache yet, indexed by rank
+    dpu_offload_event_t **cache_evs;
+
+    // Order in which the RTRs are sent
+    int64_t *rtr_order;
+    size_t num_rtrs;
+    size_t rtr_cursor;
+
+    // Peers whose RTR was received and whose data was not sent yet, FIFO
+    int64_t *ready;
+    size_t ready_head;
+    size_t ready_tail;
+
+    alltoallv_xfer_t *xfers;
+    size_t window;
+    size_t num_inflight;
+
+    size_t num_to_send;
+    size_t num_sent;
+    size_t num_to_recv;
+    size_t num_recv;
+} alltoallv_state_t;
+
+static dpu_offload_status_t alltoallv_import_key(offloading_engine_t *engine, void *key, ucp_mem_h *memh)
+{
+#if HAVE_DECL_UCP_MEM_MAP_PARAM_FIELD_EXPORTED_MEMH_BUFFER
+    ucp_mem_map_params_t params;
+    ucs_status_t status;
+    memset(&params, 0, sizeof(params));
+    params.field_mask = UCP_MEM_MAP_PARAM_FIELD_EXPORTED_MEMH_BUFFER;
+    params.exported_memh_buffer = key;
+    status = ucp_mem_map(engine->ucp_context, &params, memh);
+    CHECK_ERR_RETURN((status != UCS_OK), DO_ERROR, "ucp_mem_map() failed: %s", ucs_status_string(status));
+    return DO_SUCCESS;
+#else
+    ERR_MSG("UCX does not support exported memory keys, alltoallv cannot be offloaded");
+    return DO_NOT_APPLICABLE;
+#endif
+}
+
+size_t alltoallv_get_rtr_order(int64_t group_rank, int64_t group_size, const int64_t *recvcounts, const uint64_t *hosts, int64_t *order)
+{
+    size_t n_remote = 0, n_local = 0, num_rtrs = 0;
+    int64_t i;
+
+    for (i = 0; i < group_size; i++)
+    {
+        if (recvcounts[i] > 0 && hosts[i] != hosts[group_rank])
+            n_remote++;
+    }
+
+    // RTRs to the peers on other hosts first, then to the peers on the same host, both starting
+    // after our own rank
+    for (i = 1; i <= group_size; i++)
+    {
+        int64_t peer = (group_rank + i) % group_size;
+        if (recvcounts[peer] == 0)
+            continue;
+        if (hosts[peer] != hosts[group_rank])
+            order[num_rtrs++] = peer;
+        else
+            order[n_remote + n_local++] = peer;
+    }
+    return num_rtrs + n_local;
+}
+
+// Get the service process and host of every peer from the cache, requesting the missing entries
+static dpu_offload_status_t alltoallv_resolve_peers(op_desc_t *desc, alltoallv_state_t *state)
+{
+    offloading_engine_t *engine = desc->econtext->engine;
+    int64_t *sp_ids = NULL;
+    uint64_t *hosts = NULL;
+    size_t n_missing = 0;
+    dpu_offload_status_t rc = DO_ERROR;
+    int64_t i;
+
+    if (state->cache_evs != NULL)
+    {
+        for (i = 0; i < state->group_size; i++)
+        {
+            if (state->cache_evs[i] == NULL)
+                continue;
+            if (!event_completed(state->cache_evs[i]))
+                return DO_SUCCESS;
+            event_return(&(state->cache_evs[i]));
+        }
+    }
+
+    sp_ids = DPU_OFFLOAD_MALLOC(state->group_size * sizeof(int64_t));
+    hosts = DPU_OFFLOAD_MALLOC(state->group_size * sizeof(uint64_t));
+    CHECK_ERR_GOTO((sp_ids == NULL || hosts == NULL), out, "unable to allocate memory");
+    rc = get_sp_ids_by_group_ranks(engine, desc->gp_uid, NULL, state->group_size, 0, sp_ids, &n_missing);
+    CHECK_ERR_GOTO((rc != DO_SUCCESS), out, "get_sp_ids_by_group_ranks() failed");
+    if (n_missing > 0)
+    {
+        DBG("%zu ranks of group 0x%x are not in the cache, requesting them", n_missing, desc->gp_uid);
+        if (state->cache_evs == NULL)
+        {
+            state->cache_evs = DPU_OFFLOAD_MALLOC(state->group_size * sizeof(dpu_offload_event_t *));
+            CHECK_ERR_GOTO((state->cache_evs == NULL), out, "unable to allocate memory");
+            memset(state->cache_evs, 0, state->group_size * sizeof(dpu_offload_event_t *));
+        }
+        for (i = 0; i < state->group_size; i++)
+        {
+            int64_t sp_id;
+            if (sp_ids[i] != -1)
+                continue;
+            rc = get_sp_id_by_group_rank(engine, desc->gp_uid, i, 0, &sp_id, &(state->cache_evs[i]));
+            CHECK_ERR_GOTO((rc != DO_SUCCESS), out, "get_sp_id_by_group_rank() failed");
+        }
+        goto out;
+    }
+    rc = get_group_ranks_host(engine, desc->gp_uid, NULL, state->group_size, hosts, NULL);
+    CHECK_ERR_GOTO((rc != DO_SUCCESS), out, "get_group_ranks_host() failed");
+
+    for (i = 0; i < state->group_size; i++)
+    {
+        state->peers[i].sp_gid = sp_ids[i];
+        state->peers[i].host = hosts[i];
+    }
+    state->num_rtrs = alltoallv_get_rtr_order(desc->group_rank, state->group_size, state->recvcounts, hosts, state->rtr_order);
+    state->peers_resolved = true;
+    rc = DO_SUCCESS;
+out:
+    if (sp_ids != NULL)
+        free(sp_ids);
+    if (hosts != NULL)
+        free(hosts);
+    return rc;
+}
+
+static dpu_offload_status_t alltoallv_send_rtrs(op_desc_t *desc, alltoallv_state_t *state)
+{
+    alltoallv_msg_t *msg;
+    size_t n = 0;
+
+    msg = DPU_OFFLOAD_MALLOC(sizeof(alltoallv_msg_t) + state->rkey_len);
+    CHECK_ERR_RETURN((msg == NULL), DO_ERROR, "unable to allocate memory");
+    memcpy(msg + 1, state->rkey_buf, state->rkey_len);
+    // Bounded by the window so a large group does not hold the execution context for too long
+    while (state->rtr_cursor < state->num_rtrs && n < state->window)
+    {
+        int64_t peer = state->rtr_order[state->rtr_cursor];
+        dpu_offload_status_t rc;
+        msg->type = ALLTOALLV_MSG_RTR;
+        msg->src_rank = desc->group_rank;
+        msg->addr = desc->outputs[0].addr + state->rdispls[peer] * state->dt_size;
+        msg->len = state->recvcounts[peer] * state->dt_size;
+        msg->rkey_len = state->rkey_len;
+        rc = op_send_to_sp(desc, state->peers[peer].sp_gid, peer, msg, sizeof(alltoallv_msg_t) + state->rkey_len);
+        if (rc != DO_SUCCESS)
+        {
+            ERR_MSG("unable to send RTR to rank %" PRId64, peer);
+            free(msg);
+            return DO_ERROR;
+        }
+        state->rtr_cursor++;
+        n++;
+    }
+    free(msg);
+    return DO_SUCCESS;
+}
+
+static dpu_offload_status_t alltoallv_start_xfer(op_desc_t *desc, alltoallv_state_t *state, int64_t peer)
+{
+    offloading_engine_t *engine = desc->econtext->engine;
+    alltoallv_peer_t *p = &(state->peers[peer]);
+    alltoallv_xfer_t *xfer = NULL;
+    ucp_request_param_t params;
+    ucs_status_ptr_t req;
+    ucs_status_t status;
+    ucp_ep_h ep;
+    size_t i;
+
+    ep = GET_REMOTE_SERVICE_PROC_EP(engine, (uint64_t)p->sp_gid);
+    CHECK_ERR_RETURN((ep == NULL), DO_ERROR, "no endpoint to service process #%" PRId64, p->sp_gid);
+    status = ucp_ep_rkey_unpack(ep, p->rkey_buf, &(p->rkey));
+    CHECK_ERR_RETURN((status != UCS_OK), DO_ERROR, "ucp_ep_rkey_unpack() failed: %s", ucs_status_string(status));
+
+    for (i = 0; i < state->window; i++)
+    {
+        if (state->xfers[i].peer == -1)
+        {
+            xfer = &(state->xfers[i]);
+            break;
+        }
+    }
+    assert(xfer);
+
+    memset(&params, 0, sizeof(params));
+#if HAVE_DECL_UCP_MEM_MAP_PARAM_FIELD_EXPORTED_MEMH_BUFFER
+    params.op_attr_mask = UCP_OP_ATTR_FIELD_MEMH;
+    params.memh = state->send_memh;
+#endif
+    req = ucp_put_nbx(ep,
+                      (void *)(uintptr_t)(desc->inputs[0].addr + state->sdispls[peer] * state->dt_size),
+                      state->sendcounts[peer] * state->dt_size,
+                      p->remote_addr,
+                      p->rkey,
+                      &params);
+    CHECK_ERR_RETURN((UCS_PTR_IS_ERR(req)), DO_ERROR, "ucp_put_nbx() failed: %s", ucs_status_string(UCS_PTR_STATUS(req)));
+    xfer->put_req = UCS_PTR_IS_PTR(req) ? req : NULL;
+
+    // The receiver is notified once the data is in its buffer
+    memset(&params, 0, sizeof(params));
+    req = ucp_ep_flush_nbx(ep, &params);
+    CHECK_ERR_RETURN((UCS_PTR_IS_ERR(req)), DO_ERROR, "ucp_ep_flush_nbx() failed: %s", ucs_status_string(UCS_PTR_STATUS(req)));
+    xfer->flush_req = UCS_PTR_IS_PTR(req) ? req : NULL;
+    xfer->peer = peer;
+    state->num_inflight++;
+    return DO_SUCCESS;
+}
+
+static bool alltoallv_req_completed(void **req)
+{
+    if (*req == NULL)
+        return true;
+    if (ucp_request_check_status(*req) == UCS_INPROGRESS)
+        return false;
+    ucp_request_free(*req);
+    *req = NULL;
+    return true;
+}
+
+static dpu_offload_status_t alltoallv_progress_xfers(op_desc_t *desc, alltoallv_state_t *state)
+{
+    size_t i;
+    for (i = 0; i < state->window; i++)
+    {
+        alltoallv_xfer_t *xfer = &(state->xfers[i]);
+        alltoallv_peer_t *p;
+        alltoallv_msg_t msg;
+        dpu_offload_status_t rc;
+
+        if (xfer->peer == -1)
+            continue;
+        if (!alltoallv_req_completed(&(xfer->put_req)) || !alltoallv_req_completed(&(xfer->flush_req)))
+            continue;
+
+        p = &(state->peers[xfer->peer]);
+        ucp_rkey_destroy(p->rkey);
+        p->rkey = NULL;
+        free(p->rkey_buf);
+        p->rkey_buf = NULL;
+
+        memset(&msg, 0, sizeof(msg));
+        msg.type = ALLTOALLV_MSG_DONE;
+        msg.src_rank = desc->group_rank;
+        rc = op_send_to_sp(desc, p->sp_gid, xfer->peer, &msg, sizeof(msg));
+        CHECK_ERR_RETURN((rc != DO_SUCCESS), DO_ERROR, "unable to notify rank %" PRId64, xfer->peer);
+        xfer->peer = -1;
+        state->num_inflight--;
+        state->num_sent++;
+        op_rma_release(desc);
+    }
+    return DO_SUCCESS;
+}
+
+static dpu_offload_status_t alltoallv_init_state(op_desc_t *desc)
+{
+    offloading_engine_t *engine = desc->econtext->engine;
+    alltoallv_args_t *args = (alltoallv_args_t *)desc->args;
+    alltoallv_state_t *state;
+    dpu_offload_status_t rc;
+    ucs_status_t status;
+    size_t expected_len;
+    uint8_t *keys;
+    int64_t i;
+
+    CHECK_ERR_RETURN((desc->args_len < sizeof(alltoallv_args_t)), DO_ERROR, "invalid alltoallv arguments");
+    expected_len = sizeof(alltoallv_args_t) + 4 * args->group_size * sizeof(int64_t) + args->send_key_len + args->recv_key_len;
+    CHECK_ERR_RETURN((desc->args_len != expected_len || desc->num_inputs != 1 || desc->num_outputs != 1 ||
+                      desc->group_rank < 0 || desc->group_rank >= args->group_size),
+                     DO_ERROR,
+                     "invalid alltoallv arguments");
+
+    state = DPU_OFFLOAD_MALLOC(sizeof(alltoallv_state_t));
+    CHECK_ERR_RETURN((state == NULL), DO_ERROR, "unable to allocate memory");
+    memset(state, 0, sizeof(alltoallv_state_t));
+    desc->op_data = state;
+    state->group_size = args->group_size;
+    state->dt_size = args->dt_size;
+    state->sendcounts = (int64_t *)(args + 1);
+    state->sdispls = state->sendcounts + args->group_size;
+    state->recvcounts = state->sdispls + args->group_size;
+    state->rdispls = state->recvcounts + args->group_size;
+    keys = (uint8_t *)(state->rdispls + args->group_size);
+    state->window = engine->settings.alltoallv_window;
+
+    state->peers = DPU_OFFLOAD_MALLOC(args->group_size * sizeof(alltoallv_peer_t));
+    state->rtr_order = DPU_OFFLOAD_MALLOC(args->group_size * sizeof(int64_t));
+    state->ready = DPU_OFFLOAD_MALLOC(args->group_size * sizeof(int64_t));
+    state->xfers = DPU_OFFLOAD_MALLOC(state->window * sizeof(alltoallv_xfer_t));
+    CHECK_ERR_RETURN((state->peers == NULL || state->rtr_order == NULL || state->ready == NULL || state->xfers == NULL),
+                     DO_ERROR,
+                     "unable to allocate memory");
+    memset(state->peers, 0, args->group_size * sizeof(alltoallv_peer_t));
+    for (i = 0; i < (int64_t)state->window; i++)
+    {
+        state->xfers[i].peer = -1;
+        state->xfers[i].put_req = NULL;
+        state->xfers[i].flush_req = NULL;
+    }
+    for (i = 0; i < args->group_size; i++)
+    {
+        if (state->sendcounts[i] > 0)
+            state->num_to_send++;
+        if (state->recvcounts[i] > 0)
+            state->num_to_recv++;
+    }
+
+    rc = alltoallv_import_key(engine, keys, &(state->send_memh));
+    CHECK_ERR_RETURN((rc != DO_SUCCESS), rc, "unable to import the key of the send buffer");
+    rc = alltoallv_import_key(engine, keys + args->send_key_len, &(state->recv_memh));
+    CHECK_ERR_RETURN((rc != DO_SUCCESS), rc, "unable to import the key of the receive buffer");
+    status = ucp_rkey_pack(engine->ucp_context, state->recv_memh, &(state->rkey_buf), &(state->rkey_len));
+    CHECK_ERR_RETURN((status != UCS_OK), DO_ERROR, "ucp_rkey_pack() failed: %s", ucs_status_string(status));
+    return DO_SUCCESS;
+}
+
+static dpu_offload_status_t alltoallv_op_recv(op_desc_t *desc, void *data, size_t data_len)
+{
+    alltoallv_state_t *state = (alltoallv_state_t *)desc->op_data;
+    alltoallv_msg_t *msg = (alltoallv_msg_t *)data;
+    alltoallv_peer_t *p;
+
+    CHECK_ERR_RETURN((data_len < sizeof(alltoallv_msg_t) || msg->src_rank < 0 || msg->src_rank >= state->group_size),
+                     DO_ERROR,
+                     "invalid alltoallv message");
+    if (msg->type == ALLTOALLV_MSG_DONE)
+    {
+        state->num_recv++;
+        return DO_SUCCESS;
+    }
+
+    CHECK_ERR_RETURN((data_len != sizeof(alltoallv_msg_t) + msg->rkey_len), DO_ERROR, "invalid alltoallv RTR");
+    CHECK_ERR_RETURN((msg->len != state->sendcounts[msg->src_rank] * state->dt_size),
+                     DO_ERROR,
+                     "rank %" PRId64 " expects %" PRIu64 " bytes from rank %" PRId64 " but %" PRIu64 " are sent",
+                     msg->src_rank, msg->len, desc->group_rank, state->sendcounts[msg->src_rank] * state->dt_size);
+    p = &(state->peers[msg->src_rank]);
+    CHECK_ERR_RETURN((p->rkey_buf != NULL), DO_ERROR, "duplicate RTR from rank %" PRId64, msg->src_rank);
+    // The key is unpacked when the transfer starts, the endpoint to the peer's service process may not be known yet
+    p->rkey_buf = DPU_OFFLOAD_MALLOC(msg->rkey_len);
+    CHECK_ERR_RETURN((p->rkey_buf == NULL), DO_ERROR, "unable to allocate memory");
+    memcpy(p->rkey_buf, msg + 1, msg->rkey_len);
+    p->remote_addr = msg->addr;
+    state->ready[state->ready_tail++] = msg->src_rank;
+    return DO_SUCCESS;
+}
+
+static dpu_offload_status_t alltoallv_op_progress(op_desc_t *desc, bool *completed)
+{
+    alltoallv_state_t *state = (alltoallv_state_t *)desc->op_data;
+    dpu_offload_status_t rc;
+
+    if (!state->peers_resolved)
+    {
+        rc = alltoallv_resolve_peers(desc, state);
+        CHECK_ERR_RETURN((rc != DO_SUCCESS), DO_ERROR, "alltoallv_resolve_peers() failed");
+        if (!state->peers_resolved)
+            return DO_SUCCESS;
+    }
+
+    if (state->rtr_cursor < state->num_rtrs)
+    {
+        rc = alltoallv_send_rtrs(desc, state);
+        CHECK_ERR_RETURN((rc != DO_SUCCESS), DO_ERROR, "alltoallv_send_rtrs() failed");
+    }
+
+    rc = alltoallv_progress_xfers(desc, state);
+    CHECK_ERR_RETURN((rc != DO_SUCCESS), DO_ERROR, "alltoallv_progress_xfers() failed");
+
+    while (state->num_inflight < state->window && state->ready_head < state->ready_tail)
+    {
+        // Transfers are also bounded across all the operations of the service process
+        if (!op_rma_acquire(desc))
+            break;
+        rc = alltoallv_start_xfer(desc, state, state->ready[state->ready_head]);
+        CHECK_ERR_RETURN((rc != DO_SUCCESS), DO_ERROR, "alltoallv_start_xfer() failed");
+        state->ready_head++;
+    }
+
+    *completed = (state->num_sent == state->num_to_send && state->num_recv == state->num_to_recv);
+    return DO_SUCCESS;
+}
+
+static dpu_offload_status_t alltoallv_op_cancel(op_desc_t *desc)
+{
+    alltoallv_state_t *state = (alltoallv_state_t *)desc->op_data;
+    // Once an RTR is sent, the peer may be writing to the receive buffer of the rank; once one is
+    // received, the peer expects the data. Either way the peers would wait forever for a canceled
+    // operation so it completes normally.
+    if (state->rtr_cursor > 0 || state->ready_tail > 0 || state->num_inflight > 0 || state->num_sent > 0)
+        return DO_NOT_APPLICABLE;
+    return DO_SUCCESS;
+}
+
+static void alltoallv_op_fini(op_desc_t *desc)
+{
+    offloading_engine_t *engine = desc->econtext->engine;
+    alltoallv_state_t *state = (alltoallv_state_t *)desc->op_data;
+    int64_t i;
+
+    if (state == NULL)
+        return;
+    if (state->xfers != NULL)
+    {
+        for (i = 0; i < (int64_t)state->window; i++)
+        {
+            if (state->xfers[i].put_req != NULL)
+            {
+                ucp_request_cancel(engine->ucp_worker, state->xfers[i].put_req);
+                ucp_request_free(state->xfers[i].put_req);
+            }
+            if (state->xfers[i].flush_req != NULL)
+            {
+                ucp_request_cancel(engine->ucp_worker, state->xfers[i].flush_req);
+                ucp_request_free(state->xfers[i].flush_req);
+            }
+        }
+        free(state->xfers);
+    }
+    if (state->peers != NULL)
+    {
+        for (i = 0; i < state->group_size; i++)
+        {
+            if (state->peers[i].rkey != NULL)
+                ucp_rkey_destroy(state->peers[i].rkey);
+            if (state->peers[i].rkey_buf != NULL)
+                free(state->peers[i].rkey_buf);
+        }
+        free(state->peers);
+    }
+    // Events of cache lookups still in progress are on the list of their cache entry, they cannot
+    // be returned before they complete
+    if (state->cache_evs != NULL)
+        free(state->cache_evs);
+    if (state->rtr_order != NULL)
+        free(state->rtr_order);
+    if (state->ready != NULL)
+        free(state->ready);
+    if (state->rkey_buf != NULL)
+        ucp_rkey_buffer_release(state->rkey_buf);
+    if (state->send_memh != NULL)
+        ucp_mem_unmap(engine->ucp_context, state->send_memh);
+    if (state->recv_memh != NULL)
+        ucp_mem_unmap(engine->ucp_context, state->recv_memh);
+    free(state);
+    desc->op_data = NULL;
+}
+
+static dpu_offload_status_t alltoallv_op_init(op_desc_t *desc)
+{
+    dpu_offload_status_t rc = alltoallv_init_state(desc);
+    // op_fini is only invoked for operations that started
+    if (rc != DO_SUCCESS)
+        alltoallv_op_fini(desc);
+    return rc;
+}
+
+dpu_offload_status_t alltoallv_register(offloading_engine_t *engine)
+{
+    offload_op_t op = {
+        .alg_id = OP_ALG_ALLTOALLV,
+        .op_init = alltoallv_op_init,
+        .op_complete = NULL,
+        .op_progress = alltoallv_op_progress,
+        .op_cancel = alltoallv_op_cancel,
+        .op_fini = alltoallv_op_fini,
+        .op_recv = alltoallv_op_recv,
+        .alg_data = NULL,
+    };
+    uint64_t op_id;
+    return register_new_op(engine, &op, &op_id);
+}
+
+static size_t alltoallv_extent(const int64_t *counts, const int64_t *displs, int64_t group_size, size_t dt_size)
+{
+    size_t extent = 0;
+    int64_t i;
+    for (i = 0; i < group_size; i++)
+    {
+        if (counts[i] > 0 && (size_t)(displs[i] + counts[i]) * dt_size > extent)
+            extent = (size_t)(displs[i] + counts[i]) * dt_size;
+    }
+    return extent;
+}
+
+dpu_offload_status_t alltoallv_post(execution_context_t *econtext, uint64_t id, alltoallv_params_t *params, op_desc_t **desc)
+{
+    alltoallv_args_t *args;
+    size_t args_len, arrays_len;
+    dpu_offload_status_t rc;
+    op_desc_t *d = NULL;
+    uint64_t op_id;
+    uint8_t *ptr;
+
+    CHECK_ERR_RETURN((econtext == NULL || econtext->type != CONTEXT_CLIENT), DO_ERROR, "a client execution context is required");
+    CHECK_ERR_RETURN((params == NULL || desc == NULL), DO_ERROR, "undefined parameters");
+    CHECK_ERR_RETURN((params->group_size <= 0 || params->group_rank < 0 || params->group_rank >= params->group_size),
+                     DO_ERROR,
+                     "invalid group rank %" PRId64 " or size %" PRId64, params->group_rank, params->group_size);
+    CHECK_ERR_RETURN((params->send_key == NULL || params->recv_key == NULL), DO_ERROR, "the memory keys of the buffers are required");
+    rc = get_op_id_by_alg_id(econtext->engine, OP_ALG_ALLTOALLV, &op_id);
+    CHECK_ERR_RETURN((rc != DO_SUCCESS), DO_ERROR, "alltoallv is not registered");
+
+    arrays_len = params->group_size * sizeof(int64_t);
+    args_len = sizeof(alltoallv_args_t) + 4 * arrays_len + params->send_key_len + params->recv_key_len;
+    args = DPU_OFFLOAD_MALLOC(args_len);
+    CHECK_ERR_RETURN((args == NULL), DO_ERROR, "unable to allocate memory");
+    args->group_size = params->group_size;
+    args->dt_size = params->dt_size;
+    args->send_key_len = params->send_key_len;
+    args->recv_key_len = params->recv_key_len;
+    ptr = (uint8_t *)(args + 1);
+    memcpy(ptr, params->sendcounts, arrays_len);
+    ptr += arrays_len;
+    memcpy(ptr, params->sdispls, arrays_len);
+    ptr += arrays_len;
+    memcpy(ptr, params->recvcounts, arrays_len);
+    ptr += arrays_len;
+    memcpy(ptr, params->rdispls, arrays_len);
+    ptr += arrays_len;
+    memcpy(ptr, params->send_key, params->send_key_len);
+    ptr += params->send_key_len;
+    memcpy(ptr, params->recv_key, params->recv_key_len);
+
+    rc = op_desc_get(econtext->engine, id, op_id, &d);
+    CHECK_ERR_GOTO((rc != DO_SUCCESS), error_out, "op_desc_get() failed");
+    d->gp_uid = params->gp_uid;
+    d->group_rank = params->group_rank;
+    d->args = args;
+    d->args_len = args_len;
+    rc = op_desc_add_buffer(d,
+                            OP_BUFFER_INPUT,
+                            (void *)params->sendbuf,
+                            alltoallv_extent(params->sendcounts, params->sdispls, params->group_size, params->dt_size));
+    CHECK_ERR_GOTO((rc != DO_SUCCESS), error_out, "op_desc_add_buffer() failed");
+    rc = op_desc_add_buffer(d,
+                            OP_BUFFER_OUTPUT,
+                            params->recvbuf,
+                            alltoallv_extent(params->recvcounts, params->rdispls, params->group_size, params->dt_size));
+    CHECK_ERR_GOTO((rc != DO_SUCCESS), error_out, "op_desc_add_buffer() failed");
+    rc = op_desc_submit(econtext, d);
+    CHECK_ERR_GOTO((rc != DO_SUCCESS), error_out, "op_desc_submit() failed");
+
+    // The arguments are copied in the start notification
+    free(args);
+    d->args = NULL;
+    d->args_len = 0;
+    *desc = d;
+    return DO_SUCCESS;
+
+error_out:
+    free(args);
+    if (d != NULL)
+    {
+        d->args = NULL;
+        op_desc_return(econtext->engine, &d);
+    }
+    return DO_ERROR;
+}
@@ -0,0 +1,354 @@
+//
+// Copyright (c) 2023, NVIDIA CORPORATION. All rights reserved.
+//
+// See LICENSE.txt for license information
+//
+
+#include <stdlib.h>
+#include <string.h>
+#include <inttypes.h>
+
+#include "dpu_offload_types.h"
+#include "dpu_offload_mem_mgt.h"
+#include "dpu_offload_debug.h"
+#include "dpu_offload_ops.h"
+#include "dpu_offload_collectives.h"
+
+/*
+ * Segmented broadcast between service processes. The service processes are the ranks of the
+ * operation, i.e., the rank of a service process is its global ID, and are renumbered so the root
+ * is virtual rank 0:
+ * - with a chain, virtual rank i forwards the segments to i + 1;
+ * - with a k-nomial tree, the subtree of virtual rank i covers the ranks i to i + m - 1, m being the
+ *   lowest power of k that does not divide i (the number of service processes for the root), and its
+ *   children are i + j * m / k^l, j = 1..k-1, l >= 1, the largest subtrees first.
+ * Every segment carries the description of the broadcast so the other service processes can set up
+ * their implicit operation with the first segment they receive, whichever it is.
+ */
+
+// Maximum number of segments the root sends every time the operation is progressed
+#define BCAST_SEGS_PER_PROGRESS (8)
+
+typedef struct bcast_seg_hdr
+{
+    uint64_t root;
+    uint64_t type;
+    uint64_t len;
+    uint64_t segment_size;
+    uint64_t tree;
+    uint64_t radix;
+    uint64_t seg_idx;
+} bcast_seg_hdr_t;
+
+typedef struct bcast_state
+{
+    // Set once the description of the broadcast is known, i.e., the first segment is received for
+    // the service processes other than the root
+    bool configured;
+    uint64_t root;
+    uint64_t type;
+    size_t len;
+    size_t segment_size;
+    size_t num_segs;
+    bcast_tree_t tree;
+    size_t radix;
+
+    // Global IDs of the children of the service process in the tree
+    uint64_t *children;
+    size_t num_children;
+
+    // Data of the root, or buffer in which the segments are received
+    uint8_t *buf;
+    bool own_buf;
+    // Root: next segment to send, others: number of segments received
+    size_t num_segs_done;
+    // Root: message in which the segments are copied before being sent
+    bcast_seg_hdr_t *msg;
+} bcast_state_t;
+
+size_t bcast_get_children(bcast_tree_t tree, size_t radix, size_t num_sps, uint64_t root, uint64_t me, uint64_t *children)
+{
+    size_t vrank = (me + num_sps - root) % num_sps;
+    size_t n = 0, mask = 1, j;
+
+    if (tree == BCAST_TREE_CHAIN)
+    {
+        if (vrank + 1 < num_sps)
+            children[n++] = (vrank + 1 + root) % num_sps;
+        return n;
+    }
+
+    while (mask < num_sps)
+    {
+        if (vrank % (radix * mask) != 0)
+            break;
+        mask *= radix;
+    }
+    for (mask /= radix; mask > 0; mask /= radix)
+    {
+        for (j = 1; j < radix; j++)
+        {
+            if (vrank + j * mask < num_sps)
+                children[n++] = (vrank + j * mask + root) % num_sps;
+        }
+    }
+    return n;
+}
+
+static dpu_offload_status_t bcast_configure(op_desc_t *desc, bcast_state_t *state, uint64_t root, uint64_t type, size_t len, bcast_tree_t tree, size_t radix, size_t segment_size)
+{
+    offloading_engine_t *engine = desc->econtext->engine;
+
+    CHECK_ERR_RETURN((root >= engine->num_service_procs || type >= BCAST_MAX_TYPES ||
+                      (tree != BCAST_TREE_KNOMIAL && tree != BCAST_TREE_CHAIN) || radix < 2 || segment_size == 0),
+                     DO_ERROR,
+                     "invalid broadcast");
+    state->root = root;
+    state->type = type;
+    state->len = len;
+    state->tree = tree;
+    state->radix = radix;
+    state->segment_size = segment_size;
+    // Empty broadcasts still send a segment so the other service processes get notified
+    state->num_segs = len == 0 ? 1 : (len + segment_size - 1) / segment_size;
+    state->children = DPU_OFFLOAD_MALLOC(engine->num_service_procs * sizeof(uint64_t));
+    CHECK_ERR_RETURN((state->children == NULL), DO_ERROR, "unable to allocate memory");
+    state->num_children = bcast_get_children(tree,
+                                             radix,
+                                             engine->num_service_procs,
+                                             root,
+                                             engine->config->local_service_proc.info.global_id,
+                                             state->children);
+    state->configured = true;
+    return DO_SUCCESS;
+}
+
+static dpu_offload_status_t bcast_forward(op_desc_t *desc, bcast_state_t *state, void *msg, size_t msg_len)
+{
+    size_t i;
+    for (i = 0; i < state->num_children; i++)
+    {
+        dpu_offload_status_t rc = op_send_to_sp(desc, state->children[i], (int64_t)state->children[i], msg, msg_len);
+        CHECK_ERR_RETURN((rc != DO_SUCCESS), DO_ERROR, "unable to send a segment to service process %" PRIu64, state->children[i]);
+    }
+    return DO_SUCCESS;
+}
+
+static size_t bcast_seg_len(bcast_state_t *state, size_t seg_idx)
+{
+    size_t offset = seg_idx * state->segment_size;
+    return state->len - offset < state->segment_size ? state->len - offset : state->segment_size;
+}
+
+static void bcast_op_fini(op_desc_t *desc)
+{
+    bcast_state_t *state = (bcast_state_t *)desc->op_data;
+    if (state == NULL)
+        return;
+    if (state->children != NULL)
+        free(state->children);
+    if (state->own_buf && state->buf != NULL)
+        free(state->buf);
+    if (state->msg != NULL)
+        free(state->msg);
+    free(state);
+    desc->op_data = NULL;
+}
+
+static dpu_offload_status_t bcast_init_state(op_desc_t *desc)
+{
+    bcast_args_t *args = (bcast_args_t *)desc->args;
+    bcast_state_t *state;
+    dpu_offload_status_t rc;
+
+    state = DPU_OFFLOAD_MALLOC(sizeof(bcast_state_t));
+    CHECK_ERR_RETURN((state == NULL), DO_ERROR, "unable to allocate memory");
+    memset(state, 0, sizeof(bcast_state_t));
+    desc->op_data = state;
+    if (desc->implicit)
+        return DO_SUCCESS; // Configured with the first segment
+
+    CHECK_ERR_RETURN((desc->args_len != sizeof(bcast_args_t) || desc->num_inputs != 1),
+                     DO_ERROR,
+                     "invalid broadcast arguments");
+    rc = bcast_configure(desc,
+                         state,
+                         (uint64_t)desc->group_rank,
+                         args->type,
+                         desc->inputs[0].len,
+                         (bcast_tree_t)args->tree,
+                         args->radix,
+                         args->segment_size);
+    CHECK_ERR_RETURN((rc != DO_SUCCESS), DO_ERROR, "bcast_configure() failed");
+    state->buf = (uint8_t *)(uintptr_t)desc->inputs[0].addr;
+    state->msg = DPU_OFFLOAD_MALLOC(sizeof(bcast_seg_hdr_t) + state->segment_size);
+    CHECK_ERR_RETURN((state->msg == NULL), DO_ERROR, "unable to allocate memory");
+    state->msg->root = state->root;
+    state->msg->type = state->type;
+    state->msg->len = state->len;
+    state->msg->segment_size = state->segment_size;
+    state->msg->tree = state->tree;
+    state->msg->radix = state->radix;
+    return DO_SUCCESS;
+}
+
+static dpu_offload_status_t bcast_op_init(op_desc_t *desc)
+{
+    dpu_offload_status_t rc = bcast_init_state(desc);
+    // op_fini is only invoked for operations that started
+    if (rc != DO_SUCCESS)
+        bcast_op_fini(desc);
+    return rc;
+}
+
+static dpu_offload_status_t bcast_op_recv(op_desc_t *desc, void *data, size_t data_len)
+{
+    bcast_state_t *state = (bcast_state_t *)desc->op_data;
+    bcast_seg_hdr_t *hdr = (bcast_seg_hdr_t *)data;
+    dpu_offload_status_t rc;
+
+    CHECK_ERR_RETURN((data_len < sizeof(bcast_seg_hdr_t)), DO_ERROR, "invalid broadcast segment");
+    if (!state->configured)
+    {
+        rc = bcast_configure(desc, state, hdr->root, hdr->type, hdr->len, (bcast_tree_t)hdr->tree, hdr->radix, hdr->segment_size);
+        CHECK_ERR_RETURN((rc != DO_SUCCESS), DO_ERROR, "bcast_configure() failed");
+        if (state->len > 0)
+        {
+            state->buf = DPU_OFFLOAD_MALLOC(state->len);
+            CHECK_ERR_RETURN((state->buf == NULL), DO_ERROR, "unable to allocate memory");
+            state->own_buf = true;
+        }
+    }
+    CHECK_ERR_RETURN((hdr->root != state->root || hdr->len != state->len || hdr->segment_size != state->segment_size ||
+                      hdr->seg_idx >= state->num_segs ||
+                      data_len != sizeof(bcast_seg_hdr_t) + bcast_seg_len(state, hdr->seg_idx)),
+                     DO_ERROR,
+                     "invalid broadcast segment");
+
+    // Forward the segment before copying it so it moves down the tree as early as possible
+    rc = bcast_forward(desc, state, data, data_len);
+    CHECK_ERR_RETURN((rc != DO_SUCCESS), DO_ERROR, "bcast_forward() failed");
+    if (data_len > sizeof(bcast_seg_hdr_t))
+        memcpy(state->buf + hdr->seg_idx * state->segment_size, hdr + 1, data_len - sizeof(bcast_seg_hdr_t));
+    state->num_segs_done++;
+    return DO_SUCCESS;
+}
+
+static dpu_offload_status_t bcast_op_progress(op_desc_t *desc, bool *completed)
+{
+    offloading_engine_t *engine = desc->econtext->engine;
+    bcast_state_t *state = (bcast_state_t *)desc->op_data;
+    dpu_offload_status_t rc;
+    size_t n;
+
+    if (desc->implicit)
+    {
+        bcast_deliver_fn cb;
+        if (!state->configured || state->num_segs_done < state->num_segs)
+            return DO_SUCCESS;
+        cb = engine->bcast_handlers[state->type];
+        if (cb == NULL)
+            WARN_MSG("no handler for broadcasts of type %" PRIu64 " from service process %" PRIu64 ", dropping it", state->type, state->root);
+        else
+        {
+            rc = cb(desc->econtext, state->root, state->buf, state->len);
+            CHECK_ERR_RETURN((rc != DO_SUCCESS), DO_ERROR, "handler of broadcasts of type %" PRIu64 " failed", state->type);
+        }
+        *completed = true;
+        return DO_SUCCESS;
+    }
+
+    for (n = 0; n < BCAST_SEGS_PER_PROGRESS && state->num_segs_done < state->num_segs; n++)
+    {
+        size_t seg_len = bcast_seg_len(state, state->num_segs_done);
+        state->msg->seg_idx = state->num_segs_done;
+        if (seg_len > 0)
+            memcpy(state->msg + 1, state->buf + state->num_segs_done * state->segment_size, seg_len);
+        rc = bcast_forward(desc, state, state->msg, sizeof(bcast_seg_hdr_t) + seg_len);
+        CHECK_ERR_RETURN((rc != DO_SUCCESS), DO_ERROR, "bcast_forward() failed");
+        state->num_segs_done++;
+    }
+    // The segments are copied when sent, the buffer of the root is not needed anymore
+    if (state->num_segs_done == state->num_segs)
+        *completed = true;
+    return DO_SUCCESS;
+}
+
+dpu_offload_status_t bcast_register(offloading_engine_t *engine)
+{
+    offload_op_t op = {
+        .alg_id = OP_ALG_BCAST,
+        .op_init = bcast_op_init,
+        .op_complete = NULL,
+        .op_progress = bcast_op_progress,
+        .op_cancel = NULL,
+        .op_fini = bcast_op_fini,
+        .op_recv = bcast_op_recv,
+        .implicit = true,
+        .alg_data = NULL,
+    };
+    uint64_t op_id;
+    return register_new_op(engine, &op, &op_id);
+}
+
+dpu_offload_status_t bcast_register_handler(offloading_engine_t *engine, uint64_t type, bcast_deliver_fn cb)
+{
+    CHECK_ERR_RETURN((engine == NULL), DO_ERROR, "engine is undefined");
+    CHECK_ERR_RETURN((type >= BCAST_MAX_TYPES), DO_ERROR, "invalid broadcast type %" PRIu64, type);
+    engine->bcast_handlers[type] = cb;
+    return DO_SUCCESS;
+}
+
+dpu_offload_status_t bcast_post(execution_context_t *econtext, uint64_t id, bcast_params_t *params, op_desc_t **desc)
+{
+    offloading_engine_t *engine;
+    bcast_args_t *args = NULL;
+    dpu_offload_status_t rc;
+    op_desc_t *d = NULL;
+    uint64_t op_id;
+
+    CHECK_ERR_RETURN((econtext == NULL || econtext->type != CONTEXT_SELF), DO_ERROR, "the self execution context is required");
+    CHECK_ERR_RETURN((params == NULL || desc == NULL), DO_ERROR, "undefined parameters");
+    engine = econtext->engine;
+    CHECK_ERR_RETURN((!engine->on_dpu), DO_ERROR, "not on a service process");
+    CHECK_ERR_RETURN((params->type >= BCAST_MAX_TYPES || (params->buf == NULL && params->len > 0) ||
+                      params->tree > BCAST_TREE_CHAIN || params->radix == 1),
+                     DO_ERROR,
+                     "invalid broadcast parameters");
+    rc = get_op_id_by_alg_id(engine, OP_ALG_BCAST, &op_id);
+    CHECK_ERR_RETURN((rc != DO_SUCCESS), DO_ERROR, "broadcast is not registered");
+
+    args = DPU_OFFLOAD_MALLOC(sizeof(bcast_args_t));
+    CHECK_ERR_RETURN((args == NULL), DO_ERROR, "unable to allocate memory");
+    args->type = params->type;
+    args->tree = params->tree == BCAST_TREE_DEFAULT ? engine->settings.bcast_tree : params->tree;
+    args->radix = params->radix == 0 ? engine->settings.bcast_radix : params->radix;
+    args->segment_size = params->segment_size == 0 ? engine->settings.bcast_segment_size : params->segment_size;
+
+    rc = op_desc_get(engine, id, op_id, &d);
+    CHECK_ERR_GOTO((rc != DO_SUCCESS), error_out, "op_desc_get() failed");
+    d->gp_uid = params->gp_uid;
+    d->group_rank = (int64_t)engine->config->local_service_proc.info.global_id;
+    d->args = args;
+    d->args_len = sizeof(bcast_args_t);
+    rc = op_desc_add_buffer(d, OP_BUFFER_INPUT, (void *)params->buf, params->len);
+    CHECK_ERR_GOTO((rc != DO_SUCCESS), error_out, "op_desc_add_buffer() failed");
+    rc = op_desc_submit(econtext, d);
+    CHECK_ERR_GOTO((rc != DO_SUCCESS), error_out, "op_desc_submit() failed");
+
+    // The arguments are copied in the start notification
+    free(args);
+    d->args = NULL;
+    d->args_len = 0;
+    *desc = d;
+    return DO_SUCCESS;
+
+error_out:
+    free(args);
+    if (d != NULL)
+    {
+        d->args = NULL;
+        op_desc_return(engine, &d);
+    }
+    return DO_ERROR;
+}
@@ -0,0 +1,222 @@
+//
+// Copyright (c) 2023, NVIDIA CORPORATION. All rights reserved.
+//
+// See LICENSE.txt for license information
+//
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <assert.h>
+
+#include "dpu_offload_types.h"
+#include "dpu_offload_debug.h"
+
+/*
+ * Endpoints to the ranks of the groups in the cache are created lazily, when a
+ * rank is first used as a destination. Since the same remote worker is usually
+ * involved in many groups, e.g., many communicators, endpoints are managed by
+ * an engine-level pool keyed by the hash of the worker's address and cache
+ * entries only hold a reference to the pool entry.
+ */
+
+// Close an endpoint of the pool. Idle endpoints are closed while the peer may still be
+// running, so outstanding operations are flushed; the close is only forced when the engine
+// is finalized, when peers may already be gone.
+static void ep_pool_close_ep(ucp_worker_h worker, ucp_ep_h ep, bool force, bool blocking)
+{
+    ucp_request_param_t param = {0};
+    void *close_req;
+    param.op_attr_mask = UCP_OP_ATTR_FIELD_FLAGS;
+    param.flags = force ? UCP_EP_CLOSE_FLAG_FORCE : 0;
+    close_req = ucp_ep_close_nbx(ep, &param);
+    if (UCS_PTR_IS_PTR(close_req))
+    {
+        if (blocking)
+        {
+            ucs_status_t status;
+            do
+            {
+                ucp_worker_progress(worker);
+                status = ucp_request_check_status(close_req);
+            } while (status == UCS_INPROGRESS);
+        }
+        // If the request did not complete yet, UCX releases it upon completion
+        ucp_request_free(close_req);
+    }
+    else if (UCS_PTR_STATUS(close_req) != UCS_OK)
+    {
+        ERR_MSG("failed to close ep %p", (void *)ep);
+    }
+}
+
+// Remove an entry from the hash table, the entry must be in the pool
+static void ep_pool_unlink(ep_pool_t *pool, ep_pool_entry_t *entry)
+{
+    khiter_t k = kh_get(ep_pool_hash_t, pool->eps, entry->key);
+    assert(k != kh_end(pool->eps));
+    if (kh_value(pool->eps, k) == entry)
+    {
+        if (entry->next == NULL)
+            kh_del(ep_pool_hash_t, pool->eps, k);
+        else
+            kh_value(pool->eps, k) = entry->next;
+    }
+    else
+    {
+        ep_pool_entry_t *prev = kh_value(pool->eps, k);
+        while (prev->next != entry)
+        {
+            assert(prev->next);
+            prev = prev->next;
+        }
+        prev->next = entry->next;
+    }
+    entry->next = NULL;
+    pool->num_eps--;
+}
+
+// Close the least recently released idle endpoints until at most max_idle are left
+static void ep_pool_trim(offloading_engine_t *engine, size_t max_idle)
+{
+    ep_pool_t *pool = &(engine->ep_pool);
+    while (pool->num_idle > max_idle)
+    {
+        ep_pool_entry_t *idle = ucs_list_extract_head(&(pool->idle_eps), ep_pool_entry_t, item);
+        pool->num_idle--;
+        ep_pool_unlink(pool, idle);
+        DBG("Reclaiming idle endpoint %p (%ld idle endpoints left)", (void *)idle->ep, pool->num_idle);
+        ep_pool_close_ep(engine->ucp_worker, idle->ep, false, false);
+        idle->ep = NULL;
+        DYN_LIST_RETURN(pool->free_entries, idle, item);
+    }
+}
+
+dpu_offload_status_t ep_pool_init(ep_pool_t *pool)
+{
+    assert(pool);
+    pool->eps = kh_init(ep_pool_hash_t);
+    CHECK_ERR_RETURN((pool->eps == NULL), DO_ERROR, "unable to allocate the endpoint pool hash table");
+    DYN_LIST_ALLOC(pool->free_entries, 32, ep_pool_entry_t, item);
+    CHECK_ERR_RETURN((pool->free_entries == NULL), DO_ERROR, "unable to allocate the pool of endpoint entries");
+    ucs_list_head_init(&(pool->idle_eps));
+    pool->num_idle = 0;
+    pool->max_idle = SIZE_MAX;
+    pool->num_eps = 0;
+    return DO_SUCCESS;
+}
+
+void ep_pool_fini(offloading_engine_t *engine)
+{
+    ep_pool_entry_t *entry = NULL;
+    ep_pool_t *pool = &(engine->ep_pool);
+
+    if (pool->eps == NULL)
+        return;
+
+    DBG("Closing %ld endpoints from the pool (%ld idle)", pool->num_eps, pool->num_idle);
+    kh_foreach_value(pool->eps, entry, {
+        while (entry != NULL)
+        {
+            ep_pool_entry_t *next = entry->next;
+            if (entry->ep != NULL && engine->ucp_worker != NULL)
+                ep_pool_close_ep(engine->ucp_worker, entry->ep, true, true);
+            entry->ep = NULL;
+            entry = next;
+        }
+    });
+    kh_destroy(ep_pool_hash_t, pool->eps);
+    pool->eps = NULL;
+    DYN_LIST_FREE(pool->free_entries, ep_pool_entry_t, item);
+    ucs_list_head_init(&(pool->idle_eps));
+    pool->num_idle = 0;
+    pool->num_eps = 0;
+}
+
+ep_pool_entry_t *ep_pool_get(offloading_engine_t *engine, const void *addr, size_t addr_len)
+{
+    int ret;
+    khiter_t k;
+    ucs_status_t status;
+    ucp_ep_params_t ep_params;
+    ep_pool_entry_t *entry = NULL;
+    ep_pool_t *pool = &(engine->ep_pool);
+    uint64_t key = HASH64_FROM_STRING((const unsigned char *)addr, addr_len);
+
+    assert(addr_len > 0);
+    assert(addr_len <= MAX_ADDR_LEN);
+    k = kh_get(ep_pool_hash_t, pool->eps, key);
+    if (k != kh_end(pool->eps))
+    {
+        entry = kh_value(pool->eps, k);
+        while (entry != NULL)
+        {
+            if (entry->addr_len == addr_len && memcmp(entry->addr, addr, addr_len) == 0)
+            {
+                if (entry->refcount == 0)
+                {
+                    // The endpoint was idle, it is not anymore
+                    ucs_list_del(&(entry->item));
+                    pool->num_idle--;
+                }
+                entry->refcount++;
+                return entry;
+            }
+            entry = entry->next;
+        }
+    }
+
+    // First time the remote worker is used, create the endpoint
+    ep_params.field_mask = UCP_EP_PARAM_FIELD_REMOTE_ADDRESS;
+    ep_params.address = (const ucp_address_t *)addr;
+    DYN_LIST_GET(pool->free_entries, ep_pool_entry_t, item, entry);
+    CHECK_ERR_RETURN((entry == NULL), NULL, "unable to get an endpoint pool entry");
+    status = ucp_ep_create(engine->ucp_worker, &ep_params, &(entry->ep));
+    if (status != UCS_OK)
+    {
+        ERR_MSG("ucp_ep_create() failed: %s", ucs_status_string(status));
+        DYN_LIST_RETURN(pool->free_entries, entry, item);
+        return NULL;
+    }
+    entry->key = key;
+    entry->refcount = 1;
+    entry->addr_len = addr_len;
+    memcpy(entry->addr, addr, addr_len);
+    entry->next = NULL;
+    if (k != kh_end(pool->eps))
+    {
+        // Hash collision, chain the new entry
+        entry->next = kh_value(pool->eps, k);
+    }
+    else
+    {
+        k = kh_put(ep_pool_hash_t, pool->eps, key, &ret);
+    }
+    kh_value(pool->eps, k) = entry;
+    pool->num_eps++;
+    return entry;
+}
+
+void ep_pool_release(offloading_engine_t *engine, ep_pool_entry_t *entry)
+{
+    ep_pool_t *pool = &(engine->ep_pool);
+
+    assert(entry);
+    assert(entry->refcount > 0);
+    entry->refcount--;
+    if (entry->refcount > 0)
+        return;
+
+    // Keep the endpoint open so it can be reused, e.g., when a group is re-created
+    ucs_list_add_tail(&(pool->idle_eps), &(entry->item));
+    pool->num_idle++;
+
+    // Reclaim the least recently released endpoints if too many are idle
+    ep_pool_trim(engine, pool->max_idle);
+}
+
+void ep_pool_flush(offloading_engine_t *engine)
+{
+    DBG("Closing the %ld idle endpoints of the pool", engine->ep_pool.num_idle);
+    ep_pool_trim(engine, 0);
+}
@@ -17,6 +17,7 @@
 #include "dpu_offload_event_channels.h"
 #include "dpu_offload_debug.h"
 #include "dpu_offload_comms.h"
+#include "dpu_offload_ops.h"
 
 #define DEFAULT_NUM_EVTS (32)
 #define DEFAULT_NUM_NOTIFICATION_CALLBACKS (5000)
@@ -924,7 +925,7 @@ int tag_send_event_msg(dpu_offload_event_t **event)
     PREP_EVENT_FOR_EMIT(*event);
     if (econtext->type == CONTEXT_CLIENT && econtext->scope_id == SCOPE_HOST_DPU && econtext->rank.n_local_ranks > 0 && econtext->rank.n_local_ranks != UINT64_MAX)
     {
-        assert((*event)->client_id < econtext->rank.n_local_ranks);
+        assert(CLIENT_ID_SLOT((*event)->client_id) < econtext->rank.n_local_ranks);
     }
 
     rc = do_tag_send_event_msg(*event);
@@ -1350,58 +1351,31 @@ event_completed:
 
 static dpu_offload_status_t op_completion_cb(struct dpu_offload_ev_sys *ev_sys, execution_context_t *context, am_header_t *hdr, size_t hdr_size, void *data, size_t data_len)
 {
-    execution_context_t *econtext = (execution_context_t *)context;
-    uint64_t *_data = (uint64_t *)data;
-
-    // Find the operation and add it to the local list of active operations
-    op_desc_t *cur_op, *next_op, *op = NULL;
-    ucs_list_for_each_safe(cur_op, next_op, &(econtext->active_ops), item)
-    {
-        if (cur_op->id == _data[0])
-        {
-            op = cur_op;
-            break;
-        }
-    }
-
-    CHECK_ERR_RETURN((op == NULL), DO_ERROR, "unable to look up operation");
-
-    op->completed = true;
-    if (op->op_definition->op_complete != NULL)
-        op->op_definition->op_complete();
-
-    return DO_SUCCESS;
+    assert(context);
+    assert(data);
+    return handle_op_completion_msg(context, data, data_len);
 }
 
 static dpu_offload_status_t op_start_cb(struct dpu_offload_ev_sys *ev_sys, execution_context_t *context, am_header_t *hdr, size_t hdr_size, void *data, size_t data_len)
 {
     assert(context);
     assert(data);
-    execution_context_t *econtext = (execution_context_t *)context;
-    uint64_t *_data = (uint64_t *)data;
+    // The operation is started the next time the execution context is progressed
+    return handle_op_start_msg(context, hdr->id, data, data_len);
+}
 
-    // Find the operation and add it to the local list of registered operations
-    offload_op_t *op_cfg = NULL;
-    int i;
-    for (i = 0; i < econtext->engine->num_registered_ops; i++)
-    {
-        if (_data[0] == econtext->engine->registered_ops[i].alg_id)
-        {
-            op_cfg = &(econtext->engine->registered_ops[i]);
-            break;
-        }
-    }
-    CHECK_ERR_RETURN((op_cfg == NULL), DO_ERROR, "unable to find a matching registered function");
+static dpu_offload_status_t op_cancel_cb(struct dpu_offload_ev_sys *ev_sys, execution_context_t *context, am_header_t *hdr, size_t hdr_size, void *data, size_t data_len)
+{
+    assert(context);
+    assert(data);
+    return handle_op_cancel_msg(context, hdr->id, data, data_len);
+}
 
-    // Instantiate the operation
-    op_desc_t *op_desc;
-    DYN_LIST_GET(econtext->engine->free_op_descs, op_desc_t, item, op_desc);
-    CHECK_ERR_RETURN((op_desc == NULL), DO_ERROR, "unable to get a free operation descriptor");
-    RESET_OP_DESC(op_desc);
-    ucs_list_add_tail(&(econtext->active_ops), &(op_desc->item));
-    // Call the init function of the operation
-    op_cfg->op_init();
-    return DO_SUCCESS;
+static dpu_offload_status_t op_sp_msg_cb(struct dpu_offload_ev_sys *ev_sys, execution_context_t *context, am_header_t *hdr, size_t hdr_size, void *data, size_t data_len)
+{
+    assert(context);
+    assert(data);
+    return handle_op_sp_msg(context->engine, data, data_len);
 }
 
 static dpu_offload_status_t xgvmi_key_revoke_cb(struct dpu_offload_ev_sys *ev_sys, execution_context_t *context, am_header_t *hdr, size_t hdr_size, void *data, size_t data_len)
@@ -1420,55 +1394,87 @@ static dpu_offload_status_t xgvmi_key_recv_cb(struct dpu_offload_ev_sys *ev_sys,
 /* Endpoint cache related functions */
 /************************************/
 
-extern int send_cache_entry_request(execution_context_t *econtext, ucp_ep_h ep, rank_info_t *requested_peer, dpu_offload_event_t **ev);
+extern dpu_offload_status_t send_cache_entry_request(execution_context_t *econtext, ucp_ep_h ep, uint64_t dest_id, cache_entries_request_t *request, dpu_offload_event_t **ev);
+extern dpu_offload_status_t send_cache_entries_range(execution_context_t *econtext, ucp_ep_h ep, uint64_t dest_id, cache_entries_request_t *request, dpu_offload_event_t *metaev, size_t *n_sent);
 
 static dpu_offload_status_t peer_cache_entries_request_recv_cb(struct dpu_offload_ev_sys *ev_sys, execution_context_t *econtext, am_header_t *hdr, size_t hdr_size, void *data, size_t data_len)
 {
+    dpu_offload_status_t rc;
+    dpu_offload_event_t *send_cache_ev;
+    ucp_ep_h reply_ep;
+    uint64_t reply_id;
+    size_t n_sent = 0;
     assert(econtext);
     assert(data);
-    rank_info_t *rank_info = (rank_info_t *)data;
+    assert(data_len == sizeof(cache_entries_request_t));
+    cache_entries_request_t *request = (cache_entries_request_t *)data;
 
-    DBG("Cache entry requested received for gp/rank 0x%x/%" PRIu64, rank_info->group_uid, rank_info->group_rank);
+    DBG("Cache entries request received for gp 0x%x, ranks %" PRId64 "-%" PRId64,
+        request->gp_uid, request->rank_start, request->rank_start + request->num_ranks - 1);
 
-    if (is_in_cache(&(econtext->engine->procs_cache), rank_info->group_uid, rank_info->group_rank, rank_info->group_size))
+    // We send back to the sender all the entries of the range that we have
+    if (econtext->type == CONTEXT_SERVER)
     {
-        // We send the cache back to the sender
-        dpu_offload_status_t rc;
-        dpu_offload_event_t *send_cache_ev;
-        peer_info_t *peer_info = DYN_ARRAY_GET_ELT(&(econtext->server->connected_clients.clients), hdr->id, peer_info_t);
-        assert(peer_info);
-        event_get(econtext->event_channels, NULL, &send_cache_ev);
-        assert(send_cache_ev);
-        EVENT_HDR_TYPE(send_cache_ev) = META_EVENT_TYPE;
-        assert(econtext->type == CONTEXT_SERVER);
-        DBG("Sending group cache to DPU #%" PRIu64 ": event=%p", hdr->id, send_cache_ev);
-        rc = send_group_cache(econtext, peer_info->ep, peer_info->id, rank_info->group_uid, send_cache_ev);
-        CHECK_ERR_RETURN((rc), DO_ERROR, "send_group_cache() failed");
-        if (!event_completed(send_cache_ev))
-            QUEUE_EVENT(send_cache_ev);
-        else
-            event_return(&send_cache_ev);
-        return DO_SUCCESS;
+        reply_ep = GET_CLIENT_EP(econtext, hdr->id);
+        reply_id = hdr->id;
+        if (reply_ep == NULL)
+        {
+            // The client disconnected since, its slot may already be used by another client
+            DBG("Cache entries request from stale client ID %" PRIu64 ", dropping it", hdr->id);
+            return DO_SUCCESS;
+        }
+    }
+    else
+    {
+        assert(econtext->type == CONTEXT_CLIENT);
+        reply_ep = GET_SERVER_EP(econtext);
+        reply_id = econtext->client->server_id;
     }
+    rc = event_get(econtext->event_channels, NULL, &send_cache_ev);
+    CHECK_ERR_RETURN((rc), DO_ERROR, "event_get() failed");
+    EVENT_HDR_TYPE(send_cache_ev) = META_EVENT_TYPE;
+    rc = send_cache_entries_range(econtext, reply_ep, reply_id, request, send_cache_ev, &n_sent);
+    CHECK_ERR_RETURN((rc), DO_ERROR, "send_cache_entries_range() failed");
+    if (!event_completed(send_cache_ev))
+        QUEUE_EVENT(send_cache_ev);
+    else
+        event_return(&send_cache_ev);
+    if (n_sent == (size_t)request->num_ranks)
+        return DO_SUCCESS;
 
-    // If the entry is not in the cache we forward the request
-    // and also trigger the send of our cache for the target group
+    // If some entries are not in the cache, we forward the request to the other service processes,
+    // the entries are sent to the local rank as we receive them.
     if (econtext->engine->on_dpu && econtext->scope_id == SCOPE_HOST_DPU)
     {
         size_t i;
-        DBG("Entry not in the cache, forwarding the request to other DPUs");
-        for (i = 0; i < econtext->engine->num_dpus; i++)
+        DBG("%ld entries not in the cache, forwarding the request to other service processes", request->num_ranks - n_sent);
+        for (i = 0; i < econtext->engine->num_service_procs; i++)
         {
-            dpu_offload_status_t rc;
             dpu_offload_event_t *req_fwd_ev;
-            remote_service_proc_info_t **list_sps = (remote_service_proc_info_t **)econtext->engine->service_procs.base;
-            rc = send_cache_entry_request(econtext, list_sps[i]->ep, rank_info, &req_fwd_ev);
+            remote_service_proc_info_t *sp;
+            execution_context_t *sp_econtext;
+            if (i == econtext->engine->config->local_service_proc.info.global_id)
+                continue;
+            sp = DYN_ARRAY_GET_ELT(GET_ENGINE_LIST_SERVICE_PROCS(econtext->engine), i, remote_service_proc_info_t);
+            if (sp == NULL || sp->ep == NULL || sp->init_params.conn_params == NULL)
+                continue;
+            sp_econtext = ECONTEXT_FOR_SERVICE_PROC_COMMUNICATION(econtext->engine, i);
+            CHECK_ERR_RETURN((sp_econtext == NULL), DO_ERROR, "unable to get execution context to communicate with service process #%ld", i);
+            rc = send_cache_entry_request(sp_econtext, sp->ep, i, request, &req_fwd_ev);
             CHECK_ERR_RETURN((rc), DO_ERROR, "send_cache_entry_request() failed");
-            return DO_SUCCESS;
+            if (req_fwd_ev != NULL)
+            {
+                if (!event_completed(req_fwd_ev))
+                    QUEUE_EVENT(req_fwd_ev);
+                else
+                    event_return(&req_fwd_ev);
+            }
         }
+        rc = group_cache_add_host_request(econtext->engine, hdr->id, request);
+        CHECK_ERR_RETURN((rc), DO_ERROR, "group_cache_add_host_request() failed");
     }
 
-    return DO_ERROR;
+    return DO_SUCCESS;
 }
 
 /**
@@ -1519,31 +1525,10 @@ static dpu_offload_status_t is_group_ready(group_cache_t *gp_cache, uint64_t rec
     return DO_SUCCESS;
 }
 
-/**
- * @brief receive handler for cache entry notifications. Note that a single notification
- * can hold multiple cache entries. An SP also sends all the cache entries it holds at
- * the time it initiates the send, i.e., the "local" ranks, as well as all the entries
- * it may have received
- *
- * @param ev_sys Associated event channels/system
- * @param econtext Associated execution context
- * @param hdr Header of the notification
- * @param hdr_size Size of the header
- * @param data Notifaction's payload, i.e., the cache entries
- * @param data_len Total size of the notification's payload
- * @return dpu_offload_status_t
- */
-static dpu_offload_status_t peer_cache_entries_recv_cb(struct dpu_offload_ev_sys *ev_sys,
-                                                       execution_context_t *econtext,
-                                                       am_header_t *hdr,
-                                                       size_t hdr_size,
-                                                       void *data,
-                                                       size_t data_len)
+dpu_offload_status_t recv_peer_cache_entries(execution_context_t *econtext, uint64_t sp_global_id, void *data, size_t data_len)
 {
     offloading_engine_t *engine = NULL;
     peer_cache_entry_t *entries = NULL;
-    int64_t group_size;
-    uint64_t sp_global_id = UINT64_MAX;
     int group_uid;
     dpu_offload_status_t rc;
     group_cache_t *gp_cache = NULL;
@@ -1553,18 +1538,10 @@ static dpu_offload_status_t peer_cache_entries_recv_cb(struct dpu_offload_ev_sys
     assert(data);
     engine = (offloading_engine_t *)econtext->engine;
     assert(engine);
-    sp_global_id = LOCAL_ID_TO_GLOBAL(econtext, hdr->id);
     entries = (peer_cache_entry_t *)data;
     group_uid = entries[0].peer.proc_info.group_uid;
-    group_size = entries[0].peer.proc_info.group_size;
     gp_cache = GET_GROUP_CACHE(&(econtext->engine->procs_cache), group_uid);
     assert(gp_cache);
-#if !NDEBUG
-    {
-        DBG("Receive cache entry for group 0x%x (seq num: %ld) from SP %" PRIu64 ", ev: %" PRIu64,
-            group_uid, entries[0].peer.proc_info.group_seq_num, sp_global_id, hdr->event_id);
-    }
-#endif
 
     assert(entries[0].peer.proc_info.group_seq_num >= gp_cache->persistent.num);
 
@@ -1607,6 +1584,42 @@ static dpu_offload_status_t peer_cache_entries_recv_cb(struct dpu_offload_ev_sys
     return DO_SUCCESS;
 }
 
+/**
+ * @brief receive handler for cache entry notifications. Note that a single notification
+ * can hold multiple cache entries. An SP also sends all the cache entries it holds at
+ * the time it initiates the send, i.e., the "local" ranks, as well as all the entries
+ * it may have received
+ *
+ * @param ev_sys Associated event channels/system
+ * @param econtext Associated execution context
+ * @param hdr Header of the notification
+ * @param hdr_size Size of the header
+ * @param data Notifaction's payload, i.e., the cache entries
+ * @param data_len Total size of the notification's payload
+ * @return dpu_offload_status_t
+ */
+static dpu_offload_status_t peer_cache_entries_recv_cb(struct dpu_offload_ev_sys *ev_sys,
+                                                       execution_context_t *econtext,
+                                                       am_header_t *hdr,
+                                                       size_t hdr_size,
+                                                       void *data,
+                                                       size_t data_len)
+{
+    uint64_t sp_global_id = UINT64_MAX;
+
+    assert(econtext);
+    assert(data);
+    sp_global_id = LOCAL_ID_TO_GLOBAL(econtext, hdr->id);
+#if !NDEBUG
+    {
+        peer_cache_entry_t *entries = (peer_cache_entry_t *)data;
+        DBG("Receive cache entry for group 0x%x (seq num: %ld) from SP %" PRIu64 ", ev: %" PRIu64,
+            entries[0].peer.proc_info.group_uid, entries[0].peer.proc_info.group_seq_num, sp_global_id, hdr->event_id);
+    }
+#endif
+    return recv_peer_cache_entries(econtext, sp_global_id, data, data_len);
+}
+
 static bool rank_is_on_sp(int64_t world_rank, offloading_engine_t *engine)
 {
     group_cache_t *c = GET_GROUP_CACHE(&(engine->procs_cache), engine->procs_cache.world_group);
@@ -1676,12 +1689,13 @@ dpu_offload_status_t send_revoke_group_to_ranks(offloading_engine_t *engine, gro
         metaev,
         metaev->ctx.completion_cb);
 
-    while (n < host_server->server->connected_clients.num_connected_clients)
+    while (n < host_server->server->connected_clients.num_connected_clients &&
+           idx < host_server->server->connected_clients.num_slots)
     {
         peer_info_t *c = NULL;
         c = DYN_ARRAY_GET_ELT(&(host_server->server->connected_clients.clients),
                               idx, peer_info_t);
-        if (c == NULL)
+        if (c == NULL || c->bootstrapping.phase != BOOTSTRAP_DONE)
         {
             idx++;
             continue;
@@ -1744,6 +1758,7 @@ static dpu_offload_status_t do_add_group_rank_recv_cb(offloading_engine_t *engin
         DBG("Queuing group add msg (UID: 0x%x, local seq num: %ld, add seq num: %ld)",
             gp_cache->group_uid, gp_cache->persistent.num, rank_info->group_seq_num);
         QUEUE_PENDING_GROUP_ADD_MSG(gp_cache, client_id, data, data_len);
+        group_cache_record_milestone(engine, gp_cache, GROUP_CACHE_MILESTONE_ADD_DEFERRED);
         return DO_SUCCESS;
     }
 
@@ -1754,6 +1769,16 @@ static dpu_offload_status_t do_add_group_rank_recv_cb(offloading_engine_t *engin
         peer_info_t *client_info = NULL;
         dpu_offload_status_t rc;
 
+        host_server = get_server_servicing_host(engine);
+        assert(host_server);
+        client_info = GET_CLIENT_INFO(host_server, client_id);
+        if (client_info == NULL)
+        {
+            // The client disconnected since, e.g., a deferred group add replayed after its slot was reused
+            DBG("Group add from stale client ID %" PRIu64 ", dropping it", client_id);
+            return DO_SUCCESS;
+        }
+
         if (gp_cache->num_local_entries == 0)
         {
             // First time a rank notifies us about a new group
@@ -1761,17 +1786,12 @@ static dpu_offload_status_t do_add_group_rank_recv_cb(offloading_engine_t *engin
             DBG("Switched to seq num: %ld for group 0x%x", gp_cache->persistent.num, gp_cache->group_uid);
         }
 
-        host_server = get_server_servicing_host(engine);
-        assert(host_server);
-        client_info = DYN_ARRAY_GET_ELT(&(host_server->server->connected_clients.clients),
-                                        client_id,
-                                        peer_info_t);
-        assert(client_info);
         cache_entry = GET_GROUP_RANK_CACHE_ENTRY(&(engine->procs_cache),
                                                  rank_info->group_uid,
                                                  rank_info->group_rank,
                                                  rank_info->group_size);
         assert(cache_entry);
+        PREPARE_PEER_CACHE_ENTRY(cache_entry);
         cache_entry->peer.addr_len = client_info->peer_addr_len;
         memcpy(cache_entry->peer.addr,
                client_info->peer_addr,
@@ -1791,6 +1811,7 @@ static dpu_offload_status_t do_add_group_rank_recv_cb(offloading_engine_t *engin
         }
         gp_cache->n_local_ranks_populated++;
         gp_cache->num_local_entries++;
+        group_cache_record_milestone(engine, gp_cache, GROUP_CACHE_MILESTONE_FIRST_LOCAL_RANK);
         DBG("group 0x%x (seq num: %ld) now has %ld entries, %ld local ranks, %ld being populated",
             gp_cache->group_uid,
             gp_cache->persistent.num,
@@ -1923,28 +1944,26 @@ static dpu_offload_status_t handle_revoke_group_rank_through_list_ranks(executio
             DBG("Queuing revoke msg from another SP (group seq num: %ld, n_local_ranks: %ld, local_revoked: %ld, group ID: 0x%x, ranks for SP: %ld)",
                 gp_cache->persistent.num, gp_cache->n_local_ranks, gp_cache->revokes.local, revoke_msg->gp_uid, gp_cache->sp_ranks);
             assert(gp_cache->persistent.num == revoke_msg->gp_seq_num);
-            DYN_LIST_GET(econtext->engine->pool_group_revoke_msgs_from_sps,
-                         group_revoke_msg_from_sp_t,
-                         item,
-                         pending_msg);
+            pending_msg = group_revoke_msg_get(&(econtext->engine->pool_group_revoke_msgs_from_sps),
+                                               revoke_msg->data_size);
+            CHECK_ERR_RETURN((pending_msg == NULL), DO_ERROR, "unable to allocate pending revoke message");
             pending_msg->num_ranks = revoke_msg->num_ranks;
             pending_msg->gp_uid = revoke_msg->gp_uid;
-            pending_msg->rank_start = revoke_msg->rank_start;
             pending_msg->group_size = revoke_msg->group_size;
             pending_msg->gp_seq_num = revoke_msg->gp_seq_num;
-            memcpy(pending_msg->ranks, revoke_msg->ranks, revoke_msg->num_ranks * sizeof(int));
+            pending_msg->encoding = revoke_msg->encoding;
+            memcpy(pending_msg->data, revoke_msg->data, revoke_msg->data_size);
             // Queue the new pending message
             ucs_list_add_tail(&(gp_cache->persistent.pending_group_revoke_msgs_from_sps), &(pending_msg->item));
         }
         else
         {
             size_t new_revokes = 0;
-            size_t rank;
-            DBG("Handling the revoke message from another SP (UID: 0x%x, seq num: %ld, num_ranks: %ld, rank_start: %ld, local revokes: %ld, global revokes: %ld)",
+            DBG("Handling the revoke message from another SP (UID: 0x%x, seq num: %ld, num_ranks: %ld, encoding: %d, local revokes: %ld, global revokes: %ld)",
                 gp_cache->group_uid,
                 revoke_msg->gp_seq_num,
                 revoke_msg->num_ranks,
-                revoke_msg->rank_start,
+                revoke_msg->encoding,
                 gp_cache->revokes.local,
                 gp_cache->revokes.global);
             if (gp_cache->group_size == 0)
@@ -1953,23 +1972,15 @@ static dpu_offload_status_t handle_revoke_group_rank_through_list_ranks(executio
                 // we need to initialize a few more things based on the revoke message's data.
                 gp_cache->group_size = revoke_msg->group_size;
                 assert(gp_cache->revokes.ranks == NULL);
-                GROUP_CACHE_BITSET_CREATE(gp_cache->revokes.ranks, gp_cache->group_size);
+                GROUP_CACHE_BITSET_POOL_GET(&(econtext->engine->procs_cache),
+                                            gp_cache->revokes.ranks,
+                                            gp_cache->group_size);
             }
             assert(gp_cache->revokes.ranks);
             assert(gp_cache->revokes.global <= gp_cache->group_size);
 
-            // Go through the list of ranks from the message that revoked the group
-            for (rank = 0; rank < revoke_msg->num_ranks; rank++)
-            {
-                assert(revoke_msg->rank_start + rank <= gp_cache->group_size);
-                if (revoke_msg->ranks[rank] == 1 && !GROUP_CACHE_BITSET_TEST(gp_cache->revokes.ranks, revoke_msg->rank_start + rank))
-                {
-                    DBG("Marking rank %ld as revoked (group seq num: %ld)",
-                        revoke_msg->rank_start + rank, revoke_msg->gp_seq_num);
-                    GROUP_CACHE_BITSET_SET(gp_cache->revokes.ranks, revoke_msg->rank_start + rank);
-                    new_revokes++;
-                }
-            }
+            // Merge the list of ranks from the message that revoked the group
+            new_revokes = group_revoke_msg_apply(gp_cache, revoke_msg);
 
             gp_cache->revokes.global += new_revokes;
             assert(gp_cache->revokes.global <= gp_cache->group_size);
@@ -2160,8 +2171,9 @@ static dpu_offload_status_t revoke_group_from_sp_recv_cb(struct dpu_offload_ev_s
     assert(econtext);
     assert(econtext->engine);
     assert(data);
-    assert(data_len == sizeof(group_revoke_msg_from_sp_t));
+    assert(data_len >= sizeof(group_revoke_msg_from_sp_t));
     revoke_msg = (group_revoke_msg_from_sp_t *)data;
+    assert(data_len == GROUP_REVOKE_MSG_FROM_SP_SIZE(revoke_msg->data_size));
     if (econtext->engine->on_dpu)
         assert(hdr->scope_id == SCOPE_INTER_SERVICE_PROCS);
     return handle_revoke_group_rank_through_list_ranks(econtext, revoke_msg);
@@ -2233,10 +2245,16 @@ static dpu_offload_status_t term_msg_cb(struct dpu_offload_ev_sys *ev_sys, execu
     {
     case CONTEXT_SERVER:
     {
-        peer_info_t *client;
-        client = DYN_ARRAY_GET_ELT(&(econtext->server->connected_clients.clients), hdr->id, peer_info_t);
+        peer_info_t *client = GET_CLIENT_INFO(econtext, hdr->id);
+        if (client == NULL || client->bootstrapping.phase != BOOTSTRAP_DONE)
+        {
+            DBG("Termination message from stale client ID %" PRIu64 ", ignoring it", hdr->id);
+            break;
+        }
+        // The slot is released and made available to new clients when progressing the execution context
         client->bootstrapping.phase = DISCONNECTED;
         econtext->server->connected_clients.num_connected_clients--;
+        econtext->server->connected_clients.num_disconnected_clients++;
         DBG("Remaining number of connected clients: %ld, ongoing connections: %ld",
             econtext->server->connected_clients.num_connected_clients,
             econtext->server->connected_clients.num_ongoing_connections);
@@ -2280,6 +2298,12 @@ dpu_offload_status_t register_default_notifications(dpu_offload_ev_sys_t *ev_sys
     rc = event_channel_register(ev_sys, AM_OP_COMPLETION_MSG_ID, op_completion_cb, NULL);
     CHECK_ERR_GOTO(rc, error_out, "cannot register handler for operation completion");
 
+    rc = event_channel_register(ev_sys, AM_OP_CANCEL_MSG_ID, op_cancel_cb, NULL);
+    CHECK_ERR_GOTO(rc, error_out, "cannot register handler to cancel operations");
+
+    rc = event_channel_register(ev_sys, AM_OP_SP_MSG_ID, op_sp_msg_cb, NULL);
+    CHECK_ERR_GOTO(rc, error_out, "cannot register handler for messages between operations");
+
     rc = event_channel_register(ev_sys, AM_XGVMI_ADD_MSG_ID, xgvmi_key_recv_cb, NULL);
     CHECK_ERR_GOTO(rc, error_out, "cannot register handler for receiving XGVMI keys");
 
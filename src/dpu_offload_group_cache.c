@@ -4,10 +4,14 @@
 // See LICENSE.txt for license information
 //
 
+#include <stdio.h>
+#include <string.h>
 #include <limits.h>
 #include <inttypes.h>
+#include <time.h>
 
 #include "dpu_offload_types.h"
+#include "dpu_offload_mem_mgt.h"
 #include "dpu_offload_debug.h"
 #include "dpu_offload_group_cache.h"
 #include "dpu_offload_event_channels.h"
@@ -16,9 +20,11 @@ extern dpu_offload_status_t send_sp_data_to_host(offloading_engine_t *engine, ex
 
 // Forward declarations
 static dpu_offload_status_t do_populate_group_cache_lookup_table(offloading_engine_t *engine, group_cache_t *gp_cache);
+static void group_cache_release_lookup_tables(cache_t *cache, group_cache_t *gp_cache);
 dpu_offload_status_t offload_engine_progress(offloading_engine_t *engine);
-dpu_offload_status_t do_send_cache_entry_request(execution_context_t *econtext, ucp_ep_h ep, uint64_t dest_id, rank_info_t *requested_peer, dpu_offload_event_t *ev);
-dpu_offload_status_t send_cache_entry_request(execution_context_t *econtext, ucp_ep_h ep, uint64_t dest_id, rank_info_t *requested_peer, dpu_offload_event_t **ev);
+dpu_offload_status_t do_send_cache_entry_request(execution_context_t *econtext, ucp_ep_h ep, uint64_t dest_id, cache_entries_request_t *request, dpu_offload_event_t *ev);
+dpu_offload_status_t send_cache_entry_request(execution_context_t *econtext, ucp_ep_h ep, uint64_t dest_id, cache_entries_request_t *request, dpu_offload_event_t **ev);
+dpu_offload_status_t send_cache_entries_range(execution_context_t *econtext, ucp_ep_h ep, uint64_t dest_id, cache_entries_request_t *request, dpu_offload_event_t *metaev, size_t *n_sent);
 
 bool is_in_cache(cache_t *cache, group_uid_t gp_uid, int64_t rank_id, int64_t group_size)
 {
@@ -78,6 +84,7 @@ void group_cache_send_to_local_ranks_cb(void *context)
     assert(gp_cache->engine);
     assert(gp_cache->revokes.global <= gp_cache->group_size);
     gp_cache->persistent.sent_to_host = gp_cache->persistent.num;
+    group_cache_record_milestone(gp_cache->engine, gp_cache, GROUP_CACHE_MILESTONE_SENT_TO_HOST);
 
     DBG("Handling potential pending revoke messages (seq num: %ld, global revokes: %ld)",
         gp_cache->persistent.num, gp_cache->revokes.global);
@@ -182,6 +189,7 @@ dpu_offload_status_t send_gp_cache_to_host(execution_context_t *econtext, group_
             econtext->server->connected_clients.num_total_connected_clients);
         assert(group_cache_populated(econtext->engine, group_uid));
         assert(gp_cache->group_uid == group_uid);
+        group_cache_record_milestone(econtext->engine, gp_cache, GROUP_CACHE_MILESTONE_CACHE_COMPLETE);
 
         rc = event_get(econtext->event_channels, NULL, &metaev);
         CHECK_ERR_RETURN((rc), DO_ERROR, "event_get() failed");
@@ -191,11 +199,12 @@ dpu_offload_status_t send_gp_cache_to_host(execution_context_t *econtext, group_
         metaev->ctx.completion_cb = group_cache_send_to_local_ranks_cb;
         metaev->ctx.completion_cb_ctx = gp_cache;
 
-        while (n < econtext->server->connected_clients.num_connected_clients)
+        while (n < econtext->server->connected_clients.num_connected_clients &&
+               idx < econtext->server->connected_clients.num_slots)
         {
             peer_info_t *c = DYN_ARRAY_GET_ELT(&(econtext->server->connected_clients.clients),
                                                idx, peer_info_t);
-            if (c == NULL)
+            if (c == NULL || c->bootstrapping.phase != BOOTSTRAP_DONE)
             {
                 idx++;
                 continue;
@@ -223,9 +232,10 @@ dpu_offload_status_t send_gp_cache_to_host(execution_context_t *econtext, group_
         // populate the few lookup table.
         // Note that we pre-emptively create the cache on the SPs, it might not
         // be the case on the host where these tables may be populated in a lazy
-        // manner.
-        rc = populate_group_cache_lookup_table(econtext->engine, gp_cache);
-        CHECK_ERR_RETURN((rc), DO_ERROR, "populate_group_cache_lookup_table() failed");
+        // manner. For large groups, the construction is split in slices that are
+        // executed during progress so it does not stall the handling of notifications.
+        rc = start_group_cache_lookup_table_build(econtext->engine, gp_cache);
+        CHECK_ERR_RETURN((rc), DO_ERROR, "start_group_cache_lookup_table_build() failed");
 
         // We check for completion only after populating the topology because in some
         // corner cases (e.g., the SP not being involved in the group at all), completion
@@ -240,6 +250,121 @@ dpu_offload_status_t send_gp_cache_to_host(execution_context_t *econtext, group_
     return DO_SUCCESS;
 }
 
+// Check whether all the ranks between first_rank and last_rank are in the cache
+static bool group_cache_range_populated(cache_t *cache, group_cache_t *gp_cache, int64_t first_rank, int64_t last_rank)
+{
+    int64_t rank;
+    for (rank = first_rank; rank <= last_rank; rank++)
+    {
+        if (!is_in_cache(cache, gp_cache->persistent.uid, rank, gp_cache->group_size))
+            return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Clear the bits of the blocks between first_rank and last_rank for which the on-demand
+ * request is over, i.e., all the ranks of the block are in the cache or none of the ranks of the
+ * block that are still missing has a pending lookup. Following misses in these blocks trigger a
+ * new request.
+ */
+static void group_cache_update_requested_blocks(cache_t *cache, group_cache_t *gp_cache, int64_t first_rank, int64_t last_rank)
+{
+    size_t block;
+    if (gp_cache->requested_blocks == NULL || gp_cache->group_size <= 0)
+        return;
+    for (block = first_rank / CACHE_ENTRIES_REQUEST_BLOCK_SIZE; block <= last_rank / CACHE_ENTRIES_REQUEST_BLOCK_SIZE; block++)
+    {
+        int64_t rank = block * CACHE_ENTRIES_REQUEST_BLOCK_SIZE;
+        int64_t rank_end = rank + CACHE_ENTRIES_REQUEST_BLOCK_SIZE;
+        bool request_pending = false;
+        if (!GROUP_CACHE_BITSET_TEST(gp_cache->requested_blocks, block))
+            continue;
+        if (rank_end > (int64_t)gp_cache->group_size)
+            rank_end = gp_cache->group_size;
+        for (; rank < rank_end && !request_pending; rank++)
+        {
+            peer_cache_entry_t *e;
+            if (is_in_cache(cache, gp_cache->persistent.uid, rank, gp_cache->group_size))
+                continue;
+            e = GET_GROUP_RANK_CACHE_ENTRY(cache, gp_cache->persistent.uid, rank, gp_cache->group_size);
+            if (e->events_initialized && !SIMPLE_LIST_IS_EMPTY(&(e->events)))
+                request_pending = true;
+        }
+        if (!request_pending)
+            GROUP_CACHE_BITSET_CLEAR(gp_cache->requested_blocks, block);
+    }
+}
+
+dpu_offload_status_t group_cache_add_host_request(offloading_engine_t *engine, uint64_t client_id, cache_entries_request_t *request)
+{
+    pending_host_cache_request_t *host_req = NULL;
+    group_cache_t *gp_cache = GET_GROUP_CACHE(&(engine->procs_cache), request->gp_uid);
+    assert(gp_cache);
+    DYN_LIST_GET(engine->pool_pending_host_cache_requests, pending_host_cache_request_t, item, host_req);
+    CHECK_ERR_RETURN((host_req == NULL), DO_ERROR, "unable to get a pending request object");
+    host_req->client_id = client_id;
+    host_req->request = *request;
+    ucs_list_add_tail(&(gp_cache->persistent.pending_host_cache_requests), &(host_req->item));
+    return DO_SUCCESS;
+}
+
+/**
+ * @brief Send the cache entries between first_rank and last_rank that were just received to the
+ * local ranks that requested them. Requests are dropped once all their ranks are in the cache or
+ * when the local rank is gone.
+ */
+static dpu_offload_status_t group_cache_serve_host_requests(offloading_engine_t *engine, group_cache_t *gp_cache, int64_t first_rank, int64_t last_rank)
+{
+    execution_context_t *server;
+    pending_host_cache_request_t *host_req = NULL, *next_host_req = NULL;
+    if (ucs_list_is_empty(&(gp_cache->persistent.pending_host_cache_requests)))
+        return DO_SUCCESS;
+
+    server = get_server_servicing_host(engine);
+    assert(server);
+    ucs_list_for_each_safe(host_req, next_host_req, &(gp_cache->persistent.pending_host_cache_requests), item)
+    {
+        cache_entries_request_t range;
+        int64_t req_first = host_req->request.rank_start < 0 ? 0 : host_req->request.rank_start;
+        int64_t req_last = host_req->request.rank_start + host_req->request.num_ranks - 1;
+        ucp_ep_h ep = GET_CLIENT_EP(server, host_req->client_id);
+        if (req_last >= (int64_t)gp_cache->group_size)
+            req_last = gp_cache->group_size - 1;
+        if (ep != NULL)
+        {
+            range.gp_uid = gp_cache->persistent.uid;
+            range.group_size = gp_cache->group_size;
+            range.rank_start = first_rank > req_first ? first_rank : req_first;
+            range.num_ranks = (last_rank < req_last ? last_rank : req_last) - range.rank_start + 1;
+            if (range.num_ranks > 0)
+            {
+                dpu_offload_event_t *send_cache_ev;
+                size_t n_sent;
+                dpu_offload_status_t rc = event_get(server->event_channels, NULL, &send_cache_ev);
+                CHECK_ERR_RETURN((rc), DO_ERROR, "event_get() failed");
+                EVENT_HDR_TYPE(send_cache_ev) = META_EVENT_TYPE;
+                rc = send_cache_entries_range(server, ep, host_req->client_id, &range, send_cache_ev, &n_sent);
+                CHECK_ERR_RETURN((rc), DO_ERROR, "send_cache_entries_range() failed");
+                if (!event_completed(send_cache_ev))
+                    QUEUE_EVENT(send_cache_ev);
+                else
+                    event_return(&send_cache_ev);
+            }
+            if (!group_cache_range_populated(&(engine->procs_cache), gp_cache, req_first, req_last))
+                continue;
+        }
+        else
+        {
+            // The client disconnected since, its slot may already be used by another client
+            DBG("Dropping cache entries request from stale client ID %" PRIu64, host_req->client_id);
+        }
+        ucs_list_del(&(host_req->item));
+        DYN_LIST_RETURN(engine->pool_pending_host_cache_requests, host_req, item);
+    }
+    return DO_SUCCESS;
+}
+
 dpu_offload_status_t handle_peer_cache_entries_recv(execution_context_t *econtext, uint64_t sp_gid, void *data, size_t data_len)
 {
     size_t cur_size = 0;
@@ -251,6 +376,7 @@ dpu_offload_status_t handle_peer_cache_entries_recv(execution_context_t *econtex
     cache_t *cache = NULL;
     offloading_engine_t *engine = NULL;
     int group_uid = INT_MAX;
+    int64_t first_rank = INT64_MAX, last_rank = -1;
 
     assert(econtext);
     engine = econtext->engine;
@@ -273,6 +399,10 @@ dpu_offload_status_t handle_peer_cache_entries_recv(execution_context_t *econtex
         }
 #endif
         assert(entries[idx].peer.proc_info.group_size == group_size);
+        if (group_rank < first_rank)
+            first_rank = group_rank;
+        if (group_rank > last_rank)
+            last_rank = group_rank;
         DBG("Received a cache entry for rank:%ld, group:0x%x, group size:%ld, group seq num: %ld, number of local rank: %ld from SP %" PRId64 " (msg size=%ld, peer addr len=%ld)",
             group_rank,
             group_uid,
@@ -305,6 +435,7 @@ dpu_offload_status_t handle_peer_cache_entries_recv(execution_context_t *econtex
             DBG("Adding rank %ld to group 0x%x (seq_num: %ld/%ld)",
                 group_rank, gp_cache->group_uid, gp_cache->persistent.num, entries[idx].peer.proc_info.group_seq_num);
             cache_entry = GET_GROUP_RANK_CACHE_ENTRY(cache, group_uid, group_rank, group_size);
+            PREPARE_PEER_CACHE_ENTRY(cache_entry);
             cache_entry->set = true;
             COPY_PEER_DATA(&(entries[idx].peer), &(cache_entry->peer));
             assert(entries[idx].num_shadow_service_procs > 0);
@@ -346,11 +477,26 @@ dpu_offload_status_t handle_peer_cache_entries_recv(execution_context_t *econtex
         idx++;
     }
 
+    // Following misses in the blocks for which the request is over trigger a new request
+    if (last_rank >= 0)
+        group_cache_update_requested_blocks(cache, gp_cache, first_rank, last_rank);
+
+    if (n_added > 0)
+    {
+        group_cache_record_milestone(engine, gp_cache, GROUP_CACHE_MILESTONE_FIRST_REMOTE_ENTRIES);
+        if (gp_cache->num_local_entries == gp_cache->group_size)
+            group_cache_record_milestone(engine, gp_cache, GROUP_CACHE_MILESTONE_CACHE_COMPLETE);
+    }
+
     // Once we handled all the cache entries we received, we check whether the cache is full and if so, send it to the local ranks
     DBG("The cache for group 0x%x now has %ld entries after receiving data from SP %" PRIu64 " (group size: %ld)",
         group_uid, gp_cache->num_local_entries, sp_gid, gp_cache->group_size);
     if (econtext->engine->on_dpu && n_added > 0)
     {
+        // Local ranks waiting for some of the entries we just received get them right away
+        dpu_offload_status_t rc = group_cache_serve_host_requests(engine, gp_cache, first_rank, last_rank);
+        CHECK_ERR_RETURN((rc), DO_ERROR, "group_cache_serve_host_requests() failed");
+
         // If all the ranks are on the local hosts, the case is handled in the callback that deals with the
         // final step of the connecting with the ranks.
         bool all_ranks_are_local = false;
@@ -361,7 +507,7 @@ dpu_offload_status_t handle_peer_cache_entries_recv(execution_context_t *econtex
             DBG("Sending group cache for group 0x%x to local ranks (gp_sz=%ld)", gp_cache->group_uid, gp_cache->group_size);
             execution_context_t *server = get_server_servicing_host(engine);
             assert(server->scope_id == SCOPE_HOST_DPU);
-            dpu_offload_status_t rc = send_gp_cache_to_host(server, group_uid);
+            rc = send_gp_cache_to_host(server, group_uid);
             CHECK_ERR_RETURN((rc), DO_ERROR, "send_gp_cache_to_host() failed");
         }
         else
@@ -374,6 +520,258 @@ dpu_offload_status_t handle_peer_cache_entries_recv(execution_context_t *econtex
 }
 
 
+static size_t group_cache_footprint(group_cache_t *gp_cache)
+{
+    size_t footprint = sizeof(group_cache_t);
+    size_t bitset_size = GROUP_CACHE_BITSET_NSLOTS(gp_cache->group_size) * sizeof(group_cache_bitset_t);
+    sp_cache_data_t *sp_data = NULL;
+
+    if (gp_cache->rank_array_initialized)
+        footprint += gp_cache->ranks.capacity * gp_cache->ranks.type_size;
+    if (gp_cache->sp_array_initialized)
+        footprint += gp_cache->sps.capacity * gp_cache->sps.type_size;
+    if (gp_cache->host_array_initialized)
+        footprint += gp_cache->hosts.capacity * gp_cache->hosts.type_size;
+    if (gp_cache->revokes.ranks != NULL)
+        footprint += bitset_size;
+    if (gp_cache->sps_bitset != NULL)
+        footprint += bitset_size;
+    if (gp_cache->hosts_bitset != NULL)
+        footprint += bitset_size;
+    if (gp_cache->initialized)
+    {
+        host_cache_data_t *host_data = NULL;
+
+        // Each SP or host in the group has its own bitset(s) and, once the lookup tables
+        // are populated, its own lookup table
+        footprint += kh_size(gp_cache->sps_hash) * (sizeof(sp_cache_data_t) + bitset_size);
+        footprint += kh_size(gp_cache->hosts_hash) * (sizeof(host_cache_data_t) + 2 * bitset_size);
+        kh_foreach_value(gp_cache->sps_hash, sp_data, {
+            if (sp_data->ranks_initialized)
+                footprint += sp_data->ranks.capacity * sp_data->ranks.type_size;
+        })
+        kh_foreach_value(gp_cache->hosts_hash, host_data, {
+            if (host_data->sps_initialized)
+                footprint += host_data->sps.capacity * host_data->sps.type_size;
+        })
+    }
+    ucs_list_for_each(sp_data, &(gp_cache->recycled_sps), item)
+    {
+        footprint += sizeof(sp_cache_data_t);
+        if (sp_data->ranks_initialized)
+            footprint += sp_data->ranks.capacity * sp_data->ranks.type_size;
+    }
+    return footprint;
+}
+
+static bool group_cache_evictable(cache_t *cache, group_cache_t *gp_cache)
+{
+    if (gp_cache->persistent.uid == cache->world_group)
+        return false;
+
+    // The group must have been created at least once and be fully revoked, i.e., no entry left
+    if (gp_cache->persistent.num == 0 || gp_cache->num_local_entries != 0)
+        return false;
+    if (gp_cache->revokes.global != 0 || gp_cache->revokes.local != 0)
+        return false;
+
+    // The sequence number of the group must be kept, which is bounded
+    if (kh_size(cache->evicted_groups) >= cache->engine->settings.group_cache_max_evicted_groups)
+        return false;
+
+    // On SPs, the host must have been notified of both the creation and the revoke of the group
+    if (cache->engine->on_dpu &&
+        (gp_cache->persistent.sent_to_host != gp_cache->persistent.num ||
+         gp_cache->persistent.revoke_send_to_host_posted != gp_cache->persistent.num ||
+         gp_cache->persistent.revoke_sent_to_host != gp_cache->persistent.num))
+        return false;
+
+    // Nothing pending for the group
+    if (!ucs_list_is_empty(&(gp_cache->persistent.pending_group_revoke_msgs_from_sps)) ||
+        !ucs_list_is_empty(&(gp_cache->persistent.pending_group_revoke_msgs_from_ranks)) ||
+        !ucs_list_is_empty(&(gp_cache->persistent.pending_group_add_msgs)) ||
+        !ucs_list_is_empty(&(gp_cache->persistent.pending_send_group_add_msgs)) ||
+        !ucs_list_is_empty(&(gp_cache->persistent.pending_recv_cache_entries)))
+        return false;
+
+    return true;
+}
+
+static void group_cache_evict(cache_t *cache, group_cache_t *gp_cache)
+{
+    khiter_t k;
+    int ret;
+
+    DBG("Evicting cache of group 0x%x (seq num: %ld)", gp_cache->persistent.uid, gp_cache->persistent.num);
+    // Release everything, including the storage kept when the group was revoked
+    RESET_GROUP_CACHE(cache->engine, gp_cache);
+
+    // Keep track of the sequence number, the only data required to transparently re-create the group
+    k = kh_put(evicted_groups_hash_t, cache->evicted_groups, gp_cache->persistent.uid, &ret);
+    kh_value(cache->evicted_groups, k) = gp_cache->persistent.num;
+
+    k = kh_get(group_hash_t, cache->data, gp_cache->persistent.uid);
+    assert(k != kh_end(cache->data));
+    kh_del(group_hash_t, cache->data, k);
+    ucs_list_del(&(gp_cache->lru_item));
+    gp_cache->persistent.initialized = false;
+    assert(cache->footprint >= gp_cache->persistent.footprint);
+    cache->footprint -= gp_cache->persistent.footprint;
+    gp_cache->persistent.footprint = 0;
+    DYN_LIST_RETURN(cache->group_cache_pool, gp_cache, item);
+    cache->size--;
+    cache->num_evictions++;
+}
+
+group_cache_bitset_t *group_cache_bitset_pool_get(cache_t *cache, size_t nbits)
+{
+    size_t nslots = GROUP_CACHE_BITSET_NSLOTS(nbits);
+    group_cache_bitset_t *bitset = NULL;
+    khiter_t k;
+
+    // The first slot of free bitsets chains them in the pool
+    if (nslots == 0)
+        nslots = 1;
+    k = kh_get(group_cache_bitset_pool_t, cache->bitset_pool, nslots);
+    if (k != kh_end(cache->bitset_pool) && kh_value(cache->bitset_pool, k) != NULL)
+    {
+        // Bitsets are zeroed when returned to the pool, except for the slot used for chaining
+        bitset = kh_value(cache->bitset_pool, k);
+        kh_value(cache->bitset_pool, k) = (group_cache_bitset_t *)(uintptr_t)bitset[0];
+        bitset[0] = 0;
+        cache->bitset_pool_size -= nslots * sizeof(group_cache_bitset_t);
+        return bitset;
+    }
+
+    bitset = calloc(nslots + 1, sizeof(group_cache_bitset_t));
+    if (bitset == NULL)
+        return NULL;
+    bitset[0] = nslots;
+    return &(bitset[1]);
+}
+
+void group_cache_bitset_pool_put(cache_t *cache, group_cache_bitset_t *bitset)
+{
+    size_t nslots = bitset[-1];
+    khiter_t k;
+    int ret;
+
+    memset(bitset, 0, nslots * sizeof(group_cache_bitset_t));
+    k = kh_put(group_cache_bitset_pool_t, cache->bitset_pool, nslots, &ret);
+    if (ret == -1)
+    {
+        free(&(bitset[-1]));
+        return;
+    }
+    if (ret != 0)
+        kh_value(cache->bitset_pool, k) = NULL;
+    bitset[0] = (group_cache_bitset_t)(uintptr_t)kh_value(cache->bitset_pool, k);
+    kh_value(cache->bitset_pool, k) = bitset;
+    cache->bitset_pool_size += nslots * sizeof(group_cache_bitset_t);
+}
+
+void group_cache_bitset_pool_flush(cache_t *cache)
+{
+    group_cache_bitset_t *bitset;
+
+    kh_foreach_value(cache->bitset_pool, bitset, {
+        while (bitset != NULL)
+        {
+            group_cache_bitset_t *next = (group_cache_bitset_t *)(uintptr_t)bitset[0];
+            free(&(bitset[-1]));
+            bitset = next;
+        }
+    })
+    kh_clear(group_cache_bitset_pool_t, cache->bitset_pool);
+    cache->bitset_pool_size = 0;
+}
+
+void group_cache_update_footprint(cache_t *cache, group_cache_t *gp_cache)
+{
+    size_t footprint = group_cache_footprint(gp_cache);
+    assert(cache->footprint >= gp_cache->persistent.footprint);
+    cache->footprint = cache->footprint - gp_cache->persistent.footprint + footprint;
+    gp_cache->persistent.footprint = footprint;
+}
+
+void group_cache_enforce_mem_budget(cache_t *cache)
+{
+    size_t budget;
+    group_cache_t *gp_cache = NULL, *prev = NULL;
+
+    assert(cache);
+    assert(cache->engine);
+    budget = cache->engine->settings.group_cache_mem_budget;
+    if (budget == 0 || cache->footprint + cache->bitset_pool_size <= budget)
+        return;
+
+    // Bitsets kept for reuse go first
+    DBG("Releasing %ld bytes of bitsets kept for reuse", cache->bitset_pool_size);
+    group_cache_bitset_pool_flush(cache);
+    if (cache->footprint <= budget)
+        return;
+
+    // Go through the group caches starting with the least recently used one
+    gp_cache = ucs_list_tail(&(cache->lru_groups), group_cache_t, lru_item);
+    while (&(gp_cache->lru_item) != &(cache->lru_groups) && cache->footprint > budget)
+    {
+        prev = ucs_container_of(gp_cache->lru_item.prev, group_cache_t, lru_item);
+        if (group_cache_evictable(cache, gp_cache))
+            group_cache_evict(cache, gp_cache);
+        gp_cache = prev;
+    }
+    // The bitsets of the evicted groups went back to the pool
+    group_cache_bitset_pool_flush(cache);
+
+    // Groups that are in use cannot be evicted but their lookup tables can be rebuilt
+    gp_cache = ucs_list_tail(&(cache->lru_groups), group_cache_t, lru_item);
+    while (&(gp_cache->lru_item) != &(cache->lru_groups) && cache->footprint > budget)
+    {
+        prev = ucs_container_of(gp_cache->lru_item.prev, group_cache_t, lru_item);
+        if (gp_cache->persistent.uid != cache->world_group)
+            group_cache_release_lookup_tables(cache, gp_cache);
+        gp_cache = prev;
+    }
+
+    if (cache->footprint > budget)
+        DBG("Endpoint cache footprint (%ld bytes) is above the budget (%ld bytes) but no group can be evicted",
+            cache->footprint, budget);
+}
+
+void group_caches_reset(offloading_engine_t *engine)
+{
+    cache_t *cache = &(engine->procs_cache);
+    group_cache_t *gp_cache = NULL, *next = NULL;
+
+    DBG("Releasing the %ld group caches of the job", cache->size);
+    ucs_list_for_each_safe(gp_cache, next, &(cache->lru_groups), lru_item)
+    {
+        if (gp_cache->rank_array_initialized)
+        {
+            size_t i;
+            for (i = 0; i < gp_cache->ranks.capacity; i++)
+            {
+                peer_cache_entry_t *e = DYN_ARRAY_GET_ELT(&(gp_cache->ranks), i, peer_cache_entry_t);
+                if (e->pooled_ep != NULL)
+                    ep_pool_release(engine, e->pooled_ep);
+                RESET_PEER_CACHE_ENTRY(e);
+            }
+        }
+        GROUP_CACHE_TERMINATE_PERSISTENT_DATA(gp_cache);
+        RESET_GROUP_CACHE(engine, gp_cache);
+        ucs_list_del(&(gp_cache->lru_item));
+        gp_cache->persistent.initialized = false;
+        DYN_LIST_RETURN(cache->group_cache_pool, gp_cache, item);
+    }
+    kh_clear(group_hash_t, cache->data);
+    // Sequence numbers are specific to the job, the next job starts over
+    kh_clear(evicted_groups_hash_t, cache->evicted_groups);
+    cache->size = 0;
+    cache->footprint = 0;
+    cache->world_group = INT_MAX;
+    assert(ucs_list_is_empty(&(cache->pending_lookup_tables)));
+}
+
 /**
  * @brief Actually revoke a group: all the elements in the rank array are reset and the cache itself is also
  * reset.
@@ -386,6 +784,8 @@ dpu_offload_status_t handle_peer_cache_entries_recv(execution_context_t *econtex
 dpu_offload_status_t revoke_group_cache(offloading_engine_t *engine, group_uid_t gp_uid)
 {
     size_t i;
+    uint64_t timeline_start;
+    uint64_t timeline_ts[GROUP_CACHE_NUM_MILESTONES];
     notification_callback_entry_t *cb = NULL;
     group_cache_t *c = GET_GROUP_CACHE(&(engine->procs_cache), gp_uid);
     assert(c);
@@ -405,19 +805,30 @@ dpu_offload_status_t revoke_group_cache(offloading_engine_t *engine, group_uid_t
                                                   i,
                                                   peer_cache_entry_t);
         assert(e);
-        RESET_PEER_CACHE_ENTRY(e);
-    }
-    if (c->sps_bitset != NULL)
-    {
-        GROUP_CACHE_BITSET_DESTROY(c->sps_bitset);
-    }
-    if (c->hosts_bitset != NULL)
-    {
-        GROUP_CACHE_BITSET_DESTROY(c->hosts_bitset);
-    }
-    RESET_GROUP_CACHE(engine, c);
+        if (e->pooled_ep != NULL)
+        {
+            // Release the endpoint so it can be reused when the peer is in another group
+            ep_pool_release(engine, e->pooled_ep);
+        }
+        // The data of the entry is reset only if the entry is set again
+        REVOKE_PEER_CACHE_ENTRY(e);
+    }
+    group_cache_record_milestone(engine, c, GROUP_CACHE_MILESTONE_REVOKED);
+    // The timeline of the revoked version remains available until the next version of the
+    // group reaches its first milestone (see group_cache_record_milestone())
+    timeline_start = c->timeline.start;
+    memcpy(timeline_ts, c->timeline.ts, sizeof(timeline_ts));
+    // Keep the storage of the group cache so re-creating the group, which is common
+    // for applications creating and freeing communicators at every timestep, does not
+    // require new allocations.
+    RECYCLE_GROUP_CACHE(engine, c);
+    c->timeline.start = timeline_start;
+    memcpy(c->timeline.ts, timeline_ts, sizeof(timeline_ts));
+    // Requests from local ranks target the revoked version of the group
+    GROUP_CACHE_DROP_HOST_CACHE_REQUESTS(c);
     assert(c->revokes.local == 0);
     assert(c->revokes.global == 0);
+    group_cache_update_footprint(&(engine->procs_cache), c);
 
     // We invoke the handler for the internal MIMOSA group revoke event when one is registered
     cb = get_notif_callback_entry(engine->self_econtext->event_channels, MIMOSA_GROUP_REVOKE_EVENT_ID);
@@ -701,7 +1112,7 @@ get_rank_idx_by_group_host_idx(offloading_engine_t *engine,
     group_cache_t *gp_cache = NULL;
     host_info_t **host_info_ptr = NULL;
     host_cache_data_t *host_data = NULL;
-    size_t i, rank_index = 0;
+    size_t rank_index = 0;
 
     assert(engine);
     gp_cache = GET_GROUP_CACHE(&(engine->procs_cache), group_uid);
@@ -729,15 +1140,8 @@ get_rank_idx_by_group_host_idx(offloading_engine_t *engine,
     }
 
     // From there we know the rank is on the host and involved in the rank, we just need
-    // to find its index
-    for (i = 0; i < host_data->num_ranks; i++)
-    {
-        if (i == rank)
-            break;
-
-        if (GROUP_CACHE_BITSET_TEST(host_data->ranks_bitset, i))
-            rank_index++;
-    }
+    // to find its index, i.e., the number of ranks of the group on the host before it
+    rank_index = GROUP_CACHE_BITSET_COUNT(host_data->ranks_bitset, rank);
     *idx = rank_index;
     return DO_SUCCESS;
 }
@@ -1171,91 +1575,147 @@ dpu_offload_status_t get_group_rank_sps(offloading_engine_t *engine,
     return DO_SUCCESS;
 }
 
-static void
-populate_sp_ranks(offloading_engine_t *engine, group_cache_t *gp_cache, sp_cache_data_t *sp_data)
+// Number of bitset slots of a SP handled between two checks of the time budget
+// when the lookup tables are built in slices
+#define LOOKUP_TABLES_BUILD_CHECK_SLOTS (64)
+
+// Phases of the construction of the lookup tables of a group
+enum
 {
-    size_t i = 0, idx = 0;
-    DYN_ARRAY_ALLOC(&(sp_data->ranks),
-                    gp_cache->group_size,
-                    peer_cache_entry_t *);
-    sp_data->ranks_initialized = true;
-    assert(sp_data->n_ranks);
-    while (idx < sp_data->n_ranks)
+    LOOKUP_TABLES_BUILD_SPS = 0,
+    LOOKUP_TABLES_BUILD_SP_RANKS,
+    LOOKUP_TABLES_BUILD_HOSTS,
+    LOOKUP_TABLES_BUILD_HOST_SPS,
+    LOOKUP_TABLES_BUILD_DONE,
+};
+
+// A deadline of 0 means that the construction is not bounded in time
+#define LOOKUP_TABLES_BUILD_DEADLINE_PASSED(_deadline) \
+    ((_deadline) != 0 && monotonic_time_us() >= (_deadline))
+
+/**
+ * @brief Populate the contiguous and ordered list of ranks associated to a SP, resuming from
+ * the position saved in the group cache. At most max_slots slots of the ranks bitset are handled.
+ *
+ * @return true when the list is complete, false otherwise
+ */
+static bool
+populate_sp_ranks(offloading_engine_t *engine, group_cache_t *gp_cache, sp_cache_data_t *sp_data, size_t max_slots)
+{
+    size_t nslots = GROUP_CACHE_BITSET_NSLOTS(gp_cache->group_size);
+    size_t *slot = &(gp_cache->lookup_tables_build.slot);
+    size_t *idx = &(gp_cache->lookup_tables_build.idx);
+    size_t end_slot;
+    if (*slot == 0 && *idx == 0)
+    {
+        // The list may come from a previous version of the group, it grows if needed
+        if (!sp_data->ranks_initialized)
+        {
+            DYN_ARRAY_ALLOC(&(sp_data->ranks),
+                            gp_cache->group_size,
+                            peer_cache_entry_t *);
+            sp_data->ranks_initialized = true;
+        }
+        assert(sp_data->n_ranks);
+        assert(GROUP_CACHE_BITSET_COUNT(sp_data->ranks_bitset, gp_cache->group_size) == sp_data->n_ranks);
+    }
+    end_slot = (max_slots < nslots - *slot) ? *slot + max_slots : nslots;
+    for (; *slot < end_slot; (*slot)++)
     {
-        if (GROUP_CACHE_BITSET_TEST(sp_data->ranks_bitset, i))
+        group_cache_bitset_t word = sp_data->ranks_bitset[*slot];
+        while (word != 0)
         {
+            size_t rank = *slot * GROUP_CACHE_BITSET_SLOT_BITS + __builtin_ctzll(word);
             peer_cache_entry_t *rank_info = NULL;
             peer_cache_entry_t **ptr = NULL;
-            rank_info = GET_GROUP_RANK_CACHE_ENTRY(&(engine->procs_cache),
-                                                   gp_cache->group_uid,
-                                                   i,
-                                                   gp_cache->group_size);
+            rank_info = DYN_ARRAY_GET_ELT(&(gp_cache->ranks), rank, peer_cache_entry_t);
             assert(rank_info);
-            ptr = DYN_ARRAY_GET_ELT(&(sp_data->ranks), idx, peer_cache_entry_t *);
+            ptr = DYN_ARRAY_GET_ELT(&(sp_data->ranks), *idx, peer_cache_entry_t *);
             assert(ptr);
             (*ptr) = rank_info;
-            idx++;
+            (*idx)++;
+            word &= word - 1;
         }
-        i++;
     }
-    assert(idx == sp_data->n_ranks);
+    if (*slot < nslots)
+        return false;
+    assert(*idx == sp_data->n_ranks);
+    *slot = 0;
+    *idx = 0;
+    return true;
 }
 
+/**
+ * @brief Populate the contiguous and ordered list of SPs associated to a host and merge the
+ * bitsets of the ranks of these SPs, one word at a time, to get the ranks running on the host.
+ */
 static void
-populate_host_sps(group_cache_t *gp_cache, host_cache_data_t *host_data)
+populate_host_sps(offloading_engine_t *engine, group_cache_t *gp_cache, host_cache_data_t *host_data)
 {
-    size_t i = 0, idx = 0;
+    size_t idx = 0;
     DYN_ARRAY_ALLOC(&(host_data->sps),
                     gp_cache->group_size,
                     sp_cache_data_t *);
     host_data->sps_initialized = true;
-    while (idx < host_data->num_sps)
-    {
-        if (GROUP_CACHE_BITSET_TEST(host_data->sps_bitset, i))
-        {
-            sp_cache_data_t **ptr = NULL, *sp_info = NULL;
-            sp_info = GET_GROUP_SP_HASH_ENTRY(gp_cache, i);
-            assert(sp_info);
-            ptr = DYN_ARRAY_GET_ELT(&(host_data->sps), idx, sp_cache_data_t *);
-            assert(ptr);
-            sp_info->lid = idx;
-            (*ptr) = sp_info;
-            idx++;
-        }
-        i++;
-    }
+    memset(host_data->ranks_bitset, 0, GROUP_CACHE_BITSET_NSLOTS(gp_cache->group_size) * sizeof(group_cache_bitset_t));
+    GROUP_CACHE_BITSET_FOREACH(host_data->sps_bitset, GROUP_CACHE_SPS_BITSET_SIZE(engine, gp_cache), sp_gid, {
+        sp_cache_data_t **ptr = NULL, *sp_info = NULL;
+        sp_info = GET_GROUP_SP_HASH_ENTRY(gp_cache, sp_gid);
+        assert(sp_info);
+        ptr = DYN_ARRAY_GET_ELT(&(host_data->sps), idx, sp_cache_data_t *);
+        assert(ptr);
+        sp_info->lid = idx;
+        (*ptr) = sp_info;
+        idx++;
+        // A rank can be associated to several SPs of the host
+        GROUP_CACHE_BITSET_OR(host_data->ranks_bitset, sp_info->ranks_bitset, gp_cache->group_size);
+    });
     assert(idx == host_data->num_sps);
+    host_data->num_ranks = GROUP_CACHE_BITSET_COUNT(host_data->ranks_bitset, gp_cache->group_size);
 }
 
+/**
+ * @brief Build the lookup tables of a group, resuming from where the previous call stopped.
+ *
+ * @param[in] engine Associated engine
+ * @param[in] gp_cache Target group cache
+ * @param[in] deadline Time (see monotonic_time_us()) after which the function must return, 0 if not bounded
+ * @param[out] done Set to true when all the lookup tables are populated
+ * @return dpu_offload_status_t
+ */
 static dpu_offload_status_t
-do_populate_group_cache_lookup_table(offloading_engine_t *engine, group_cache_t *gp_cache)
+build_group_cache_lookup_table(offloading_engine_t *engine, group_cache_t *gp_cache, uint64_t deadline, bool *done)
 {
-    size_t i, idx = 0;
+    size_t i;
+    size_t max_slots = deadline == 0 ? SIZE_MAX : LOOKUP_TABLES_BUILD_CHECK_SLOTS;
+    khiter_t *iter = &(gp_cache->lookup_tables_build.iter);
 
     assert(engine);
     assert(gp_cache);
+    assert(done);
 
+    *done = gp_cache->lookup_tables_populated;
     if (gp_cache->lookup_tables_populated)
         return DO_SUCCESS;
 
-    DBG("Creating the contiguous and ordered list of SPs involved in the group");
-    assert(gp_cache->n_sps);
-    if (gp_cache->sp_array_initialized == false)
-    {
-        DYN_ARRAY_ALLOC(&(gp_cache->sps),
-                        gp_cache->n_sps,
-                        remote_service_proc_info_t *);
-        gp_cache->sp_array_initialized = true;
-    }
-
-    i = 0;
-    while (i < gp_cache->n_sps)
+    switch (gp_cache->lookup_tables_build.phase)
     {
-        if (GROUP_CACHE_BITSET_TEST(gp_cache->sps_bitset, idx))
+    case LOOKUP_TABLES_BUILD_SPS:
+        DBG("Creating the contiguous and ordered list of SPs involved in the group");
+        assert(gp_cache->n_sps);
+        if (gp_cache->sp_array_initialized == false)
         {
+            DYN_ARRAY_ALLOC(&(gp_cache->sps),
+                            gp_cache->n_sps,
+                            remote_service_proc_info_t *);
+            gp_cache->sp_array_initialized = true;
+        }
+
+        i = 0;
+        GROUP_CACHE_BITSET_FOREACH(gp_cache->sps_bitset, GROUP_CACHE_SPS_BITSET_SIZE(engine, gp_cache), sp_gid, {
             remote_service_proc_info_t *sp_data = NULL, **ptr = NULL;
             sp_data = DYN_ARRAY_GET_ELT(GET_ENGINE_LIST_SERVICE_PROCS(engine),
-                                        idx,
+                                        sp_gid,
                                         remote_service_proc_info_t);
             assert(sp_data);
             ptr = DYN_ARRAY_GET_ELT(&(gp_cache->sps),
@@ -1263,38 +1723,48 @@ do_populate_group_cache_lookup_table(offloading_engine_t *engine, group_cache_t
                                     remote_service_proc_info_t *);
             *ptr = sp_data;
             i++;
+        });
+        assert(i == gp_cache->n_sps);
+        assert(kh_size(gp_cache->sps_hash) == gp_cache->n_sps);
+        DBG("Creating the contiguous and ordered list of ranks associated with each SP");
+        gp_cache->lookup_tables_build.phase = LOOKUP_TABLES_BUILD_SP_RANKS;
+        gp_cache->lookup_tables_build.slot = 0;
+        gp_cache->lookup_tables_build.idx = 0;
+        *iter = kh_begin(gp_cache->sps_hash);
+        /* fall through */
+    case LOOKUP_TABLES_BUILD_SP_RANKS:
+        while (*iter != kh_end(gp_cache->sps_hash))
+        {
+            if (kh_exist(gp_cache->sps_hash, *iter))
+            {
+                sp_cache_data_t *sp_value = kh_value(gp_cache->sps_hash, *iter);
+                if (!populate_sp_ranks(engine, gp_cache, sp_value, max_slots))
+                {
+                    if (LOOKUP_TABLES_BUILD_DEADLINE_PASSED(deadline))
+                        return DO_SUCCESS;
+                    continue;
+                }
+            }
+            (*iter)++;
+            if (LOOKUP_TABLES_BUILD_DEADLINE_PASSED(deadline))
+                return DO_SUCCESS;
         }
-        idx++;
-    }
-
-    DBG("Creating the contiguous and ordered list of ranks associated with each SP");
-    assert(kh_size(gp_cache->sps_hash) == gp_cache->n_sps);
-    if (kh_size(gp_cache->sps_hash) != 0)
-    {
-        uint64_t sp_key;
-        sp_cache_data_t *sp_value = NULL;
-        kh_foreach(gp_cache->sps_hash, sp_key, sp_value, {
-            populate_sp_ranks(engine, gp_cache, sp_value);
-        })
-    }
-
-    DBG("Creating the contiguous and ordered list of hosts involved in the group");
-    if (gp_cache->host_array_initialized == false)
-    {
-        DYN_ARRAY_ALLOC(&(gp_cache->hosts),
-                        gp_cache->n_hosts,
-                        host_info_t *);
-        gp_cache->host_array_initialized = true;
-    }
-    i = 0;
-    idx = 0;
-    while (i < gp_cache->n_hosts)
-    {
-        if (GROUP_CACHE_BITSET_TEST(gp_cache->hosts_bitset, idx))
+        gp_cache->lookup_tables_build.phase = LOOKUP_TABLES_BUILD_HOSTS;
+        /* fall through */
+    case LOOKUP_TABLES_BUILD_HOSTS:
+        DBG("Creating the contiguous and ordered list of hosts involved in the group");
+        if (gp_cache->host_array_initialized == false)
         {
+            DYN_ARRAY_ALLOC(&(gp_cache->hosts),
+                            gp_cache->n_hosts,
+                            host_info_t *);
+            gp_cache->host_array_initialized = true;
+        }
+        i = 0;
+        GROUP_CACHE_BITSET_FOREACH(gp_cache->hosts_bitset, engine->config->num_hosts, host_idx, {
             host_info_t *info = NULL, **ptr = NULL;
             info = DYN_ARRAY_GET_ELT(&(engine->config->hosts_config),
-                                     idx,
+                                     host_idx,
                                      host_info_t);
             assert(info);
             ptr = DYN_ARRAY_GET_ELT(&(gp_cache->hosts),
@@ -1302,21 +1772,101 @@ do_populate_group_cache_lookup_table(offloading_engine_t *engine, group_cache_t
                                     host_info_t *);
             *ptr = info;
             i++;
+        });
+        assert(i == gp_cache->n_hosts);
+        DBG("Handling data of SPs in the context of hosts");
+        gp_cache->lookup_tables_build.phase = LOOKUP_TABLES_BUILD_HOST_SPS;
+        *iter = kh_begin(gp_cache->hosts_hash);
+        /* fall through */
+    case LOOKUP_TABLES_BUILD_HOST_SPS:
+        while (*iter != kh_end(gp_cache->hosts_hash))
+        {
+            if (kh_exist(gp_cache->hosts_hash, *iter))
+                populate_host_sps(engine, gp_cache, kh_value(gp_cache->hosts_hash, *iter));
+            (*iter)++;
+            if (LOOKUP_TABLES_BUILD_DEADLINE_PASSED(deadline) && *iter != kh_end(gp_cache->hosts_hash))
+                return DO_SUCCESS;
         }
-        idx++;
+        gp_cache->lookup_tables_build.phase = LOOKUP_TABLES_BUILD_DONE;
+        break;
+    default:
+        ERR_MSG("invalid phase for the construction of the lookup tables: %d", gp_cache->lookup_tables_build.phase);
+        return DO_ERROR;
     }
 
-    DBG("Handling data of SPs in the context of hosts");
-    if (kh_size(gp_cache->hosts_hash) != 0)
+    gp_cache->lookup_tables_populated = true;
+    GROUP_CACHE_CANCEL_LOOKUP_TABLES_BUILD(gp_cache);
+    group_cache_update_footprint(&(engine->procs_cache), gp_cache);
+    group_cache_record_milestone(engine, gp_cache, GROUP_CACHE_MILESTONE_LOOKUP_TABLES);
+    *done = true;
+    return DO_SUCCESS;
+}
+
+/**
+ * @brief Release the lookup tables of a group, e.g., to bring the memory footprint of the cache
+ * below the memory budget, as well as the SP objects kept from the previous version of the group.
+ * The tables are rebuilt from the bitsets and hashes of the group the next time they are needed.
+ * The tables of groups for which the construction is in progress are left untouched.
+ *
+ * @param[in] cache The cache of the group
+ * @param[in] gp_cache Target group cache
+ */
+static void
+group_cache_release_lookup_tables(cache_t *cache, group_cache_t *gp_cache)
+{
+    sp_cache_data_t *sp_data = NULL;
+    host_cache_data_t *host_data = NULL;
+
+    if (!ucs_list_is_empty(&(gp_cache->recycled_sps)))
     {
-        uint64_t host_key;
-        host_cache_data_t *host_value = NULL;
-        kh_foreach(gp_cache->hosts_hash, host_key, host_value, {
-            populate_host_sps(gp_cache, host_value);
-        })
+        GROUP_CACHE_RELEASE_RECYCLED_SPS(cache->engine, gp_cache);
+        group_cache_update_footprint(cache, gp_cache);
     }
+    if (!gp_cache->lookup_tables_populated || gp_cache->lookup_tables_build.pending)
+        return;
 
-    gp_cache->lookup_tables_populated = true;
+    DBG("Releasing the lookup tables of group 0x%x", gp_cache->group_uid);
+    kh_foreach_value(gp_cache->sps_hash, sp_data, {
+        if (sp_data->ranks_initialized)
+        {
+            DYN_ARRAY_FREE(&(sp_data->ranks));
+            sp_data->ranks_initialized = false;
+        }
+    })
+    kh_foreach_value(gp_cache->hosts_hash, host_data, {
+        if (host_data->sps_initialized)
+        {
+            DYN_ARRAY_FREE(&(host_data->sps));
+            host_data->sps_initialized = false;
+        }
+    })
+    if (gp_cache->sp_array_initialized)
+    {
+        DYN_ARRAY_FREE(&(gp_cache->sps));
+        gp_cache->sp_array_initialized = false;
+    }
+    if (gp_cache->host_array_initialized)
+    {
+        DYN_ARRAY_FREE(&(gp_cache->hosts));
+        gp_cache->host_array_initialized = false;
+    }
+    gp_cache->lookup_tables_populated = false;
+    gp_cache->lookup_tables_build.phase = LOOKUP_TABLES_BUILD_SPS;
+    gp_cache->lookup_tables_build.iter = 0;
+    gp_cache->lookup_tables_build.slot = 0;
+    gp_cache->lookup_tables_build.idx = 0;
+    group_cache_update_footprint(cache, gp_cache);
+}
+
+static dpu_offload_status_t
+do_populate_group_cache_lookup_table(offloading_engine_t *engine, group_cache_t *gp_cache)
+{
+    bool done = false;
+    dpu_offload_status_t rc;
+    // Complete the construction in a single step, including when slices were already executed
+    rc = build_group_cache_lookup_table(engine, gp_cache, 0, &done);
+    CHECK_ERR_RETURN((rc), DO_ERROR, "build_group_cache_lookup_table() failed");
+    assert(done);
     return DO_SUCCESS;
 }
 
@@ -1329,6 +1879,51 @@ populate_group_cache_lookup_table(offloading_engine_t *engine,
     return do_populate_group_cache_lookup_table(engine, gp_cache);
 }
 
+dpu_offload_status_t
+start_group_cache_lookup_table_build(offloading_engine_t *engine,
+                                     group_cache_t *gp_cache)
+{
+    bool done = false;
+    dpu_offload_status_t rc;
+    uint64_t budget = engine->settings.lookup_tables_build_budget;
+    assert(gp_cache);
+    assert(group_cache_populated(engine, gp_cache->group_uid));
+    if (budget == 0)
+        return do_populate_group_cache_lookup_table(engine, gp_cache);
+
+    rc = build_group_cache_lookup_table(engine, gp_cache, monotonic_time_us() + budget, &done);
+    CHECK_ERR_RETURN((rc), DO_ERROR, "build_group_cache_lookup_table() failed");
+    if (!done && !gp_cache->lookup_tables_build.pending)
+    {
+        DBG("Construction of the lookup tables of group 0x%x will complete during progress", gp_cache->group_uid);
+        ucs_list_add_tail(&(engine->procs_cache.pending_lookup_tables), &(gp_cache->lookup_tables_build.item));
+        gp_cache->lookup_tables_build.pending = true;
+    }
+    return DO_SUCCESS;
+}
+
+dpu_offload_status_t group_cache_lookup_tables_progress(offloading_engine_t *engine)
+{
+    uint64_t deadline;
+    group_cache_t *gp_cache = NULL, *next = NULL;
+    assert(engine);
+    if (ucs_list_is_empty(&(engine->procs_cache.pending_lookup_tables)))
+        return DO_SUCCESS;
+
+    deadline = monotonic_time_us() + engine->settings.lookup_tables_build_budget;
+    ucs_list_for_each_safe(gp_cache, next, &(engine->procs_cache.pending_lookup_tables), lookup_tables_build.item)
+    {
+        bool done = false;
+        dpu_offload_status_t rc;
+        rc = build_group_cache_lookup_table(engine, gp_cache, deadline, &done);
+        CHECK_ERR_RETURN((rc), DO_ERROR, "build_group_cache_lookup_table() failed");
+        if (!done)
+            break;
+        DBG("Lookup tables of group 0x%x are now populated", gp_cache->group_uid);
+    }
+    return DO_SUCCESS;
+}
+
 dpu_offload_status_t
 update_topology_data(offloading_engine_t *engine, group_cache_t *gp_cache, int64_t group_rank, uint64_t sp_gid, host_uid_t host_uid)
 {
@@ -1358,25 +1953,36 @@ update_topology_data(offloading_engine_t *engine, group_cache_t *gp_cache, int64
         DBG("group cache does not have SP %" PRIu64 ", adding SP to hash for the group (0x%x)",
             sp_gid, gp_cache->group_uid);
         gp_cache->n_sps++;
-        // Add the SP to the hash using the global SP id as key
-        DYN_LIST_GET(engine->free_sp_cache_hash_obj,
-                     sp_cache_data_t,
-                     item,
-                     sp_data);
+        // Add the SP to the hash using the global SP id as key, reusing first the SP
+        // objects of the previous version of the group, which come with their list of ranks
+        if (!ucs_list_is_empty(&(gp_cache->recycled_sps)))
+        {
+            sp_data = ucs_list_extract_head(&(gp_cache->recycled_sps), sp_cache_data_t, item);
+        }
+        else
+        {
+            DYN_LIST_GET(engine->free_sp_cache_hash_obj,
+                         sp_cache_data_t,
+                         item,
+                         sp_data);
+            sp_data->ranks_initialized = false;
+        }
         RESET_SP_CACHE_DATA(sp_data);
-        GROUP_CACHE_BITSET_CREATE(sp_data->ranks_bitset, gp_cache->group_size);
+        GROUP_CACHE_BITSET_POOL_GET(&(engine->procs_cache), sp_data->ranks_bitset, gp_cache->group_size);
         sp_data->gid = sp_gid;
         sp_data->n_ranks = 1;
         sp_data->gp_uid = gp_cache->group_uid;
         sp_data->host_uid = host_uid;
         // If the sps bitset is not initialized, initialize it right now
-        GROUP_CACHE_BITSET_CREATE(gp_cache->sps_bitset, gp_cache->group_size);
+        GROUP_CACHE_BITSET_POOL_GET(&(engine->procs_cache),
+                                    gp_cache->sps_bitset,
+                                    GROUP_CACHE_SPS_BITSET_SIZE(engine, gp_cache));
         ADD_GROUP_SP_HASH_ENTRY(gp_cache, sp_data);
         GROUP_CACHE_BITSET_SET(gp_cache->sps_bitset, sp_gid);
     }
-    else
+    else if (!GROUP_CACHE_BITSET_TEST(sp_data->ranks_bitset, group_rank))
     {
-        // The SP is already in the hash
+        // The SP is already in the hash and the rank not associated to it yet
         sp_data->n_ranks++;
         DBG("cache entry has SP %" PRIu64 ", updating SP hash for the group (0x%x), # of ranks = %ld",
             sp_gid, gp_cache->group_uid, sp_data->n_ranks);
@@ -1403,23 +2009,23 @@ update_topology_data(offloading_engine_t *engine, group_cache_t *gp_cache, int64
         assert(host_data);
         RESET_HOST_CACHE_DATA(host_data);
         host_data->uid = host_uid;
-        host_data->num_ranks = 1;
         host_data->num_sps = 1;
-        GROUP_CACHE_BITSET_CREATE(host_data->sps_bitset, gp_cache->group_size);
+        GROUP_CACHE_BITSET_POOL_GET(&(engine->procs_cache), host_data->sps_bitset, GROUP_CACHE_SPS_BITSET_SIZE(engine, gp_cache));
         GROUP_CACHE_BITSET_SET(host_data->sps_bitset, sp_gid);
-        GROUP_CACHE_BITSET_CREATE(host_data->ranks_bitset, gp_cache->group_size);
+        GROUP_CACHE_BITSET_POOL_GET(&(engine->procs_cache), host_data->ranks_bitset, gp_cache->group_size);
         ADD_GROUP_HOST_HASH_ENTRY(gp_cache, host_data);
         host_info = LOOKUP_HOST_CONFIG(engine, host_uid);
         assert(host_info);
         host_data->config_idx = host_info->idx;
-        GROUP_CACHE_BITSET_CREATE(gp_cache->hosts_bitset, engine->config->num_hosts);
+        GROUP_CACHE_BITSET_POOL_GET(&(engine->procs_cache),
+                                    gp_cache->hosts_bitset,
+                                    engine->config->num_hosts);
         GROUP_CACHE_BITSET_SET(gp_cache->hosts_bitset,
                                host_info->idx);
     }
     else
     {
         // The host is already in the hash
-        host_data->num_ranks++;
         if (!GROUP_CACHE_BITSET_TEST(host_data->sps_bitset, sp_gid))
         {
             // The SP is not known yet as being involved in the group
@@ -1427,8 +2033,8 @@ update_topology_data(offloading_engine_t *engine, group_cache_t *gp_cache, int64
             GROUP_CACHE_BITSET_SET(host_data->sps_bitset, sp_gid);
         }
     }
-    // Mark the rank as being part of the group and running on the host
-    GROUP_CACHE_BITSET_SET(host_data->ranks_bitset, group_rank);
+    // The ranks running on the host are the ones of its SPs, the bitsets of the SPs are merged
+    // when the lookup tables are populated (see populate_host_sps())
 
     return DO_SUCCESS;
 }
@@ -1451,6 +2057,7 @@ host_add_local_rank_to_cache(offloading_engine_t *engine, rank_info_t *rank_info
         assert(rank_info->group_seq_num);
         gp_cache->persistent.num = rank_info->group_seq_num;
     }
+    PREPARE_PEER_CACHE_ENTRY(cache_entry);
     cache_entry->shadow_service_procs[cache_entry->num_shadow_service_procs] = engine->config->local_service_proc.info.global_id;
     cache_entry->peer.proc_info.group_uid = rank_info->group_uid;
     cache_entry->peer.proc_info.group_rank = rank_info->group_rank;
@@ -1460,6 +2067,7 @@ host_add_local_rank_to_cache(offloading_engine_t *engine, rank_info_t *rank_info
     cache_entry->num_shadow_service_procs++;
     cache_entry->set = true;
     gp_cache->num_local_entries++;
+    group_cache_record_milestone(engine, gp_cache, GROUP_CACHE_MILESTONE_FIRST_LOCAL_RANK);
 
     ret = update_topology_data(engine, gp_cache, rank_info->group_rank, engine->config->local_service_proc.info.global_id, rank_info->host_info);
     CHECK_ERR_RETURN((ret != DO_SUCCESS), DO_ERROR, "update_topology_data() failed");
@@ -1499,25 +2107,19 @@ do_get_cache_entry_by_group_rank(offloading_engine_t *engine,
         return DO_SUCCESS;
     }
 
-#if !NDEBUG
-    // With the current implementation, it should always be in the cache
-    WARN_MSG("rank %" PRId64 " from group 0x%x is not in the cache", rank, gp_uid);
-    display_group_cache(&(engine->procs_cache), gp_uid);
-    assert(0);
-#endif
-
     // If the element is not in the cache, we send a request to the service process to get the data.
-    // At the moment we assume by design that the cache is fully populated early on so we should never
-    // face this situation. We keep the code in case we relax the assumptions later so we won't have
-    // to start from scratch.
-    abort();
-
-    // The cache does not have the data. We sent a request to get the data.
-    // The caller is in charge of calling the function after completion to actually get the data
-    rank_info_t rank_data;
-    RESET_RANK_INFO(&rank_data);
-    rank_data.group_uid = gp_uid;
-    rank_data.group_rank = rank;
+    // By design the cache is fully populated early on so this should be rare. Requests are coalesced:
+    // concurrent waiters for the same entry share the request already in flight for the entry and a
+    // single request is sent for all the missing entries of the block the rank belongs to.
+    DBG("rank %" PRId64 " from group 0x%x is not in the cache, requesting it", rank, gp_uid);
+    bool request_in_flight;
+    cache_entries_request_t request;
+    group_cache_t *gp_cache = GET_GROUP_CACHE(&(engine->procs_cache), gp_uid);
+    assert(gp_cache);
+    request.gp_uid = gp_uid;
+    request.group_size = gp_cache->group_size > 0 ? gp_cache->group_size : GROUP_SIZE_UNKNOWN;
+    request.rank_start = rank;
+    request.num_ranks = 1;
 
     // Create the local event so we can know when the cache entry has been received
     dpu_offload_event_t *cache_entry_updated_ev;
@@ -1530,6 +2132,8 @@ do_get_cache_entry_by_group_rank(offloading_engine_t *engine,
         cache_entry->events_initialized = true;
     }
     EVENT_HDR_TYPE(cache_entry_updated_ev) = META_EVENT_TYPE;
+    // If events are already queued on the entry, a request is already in flight for it
+    request_in_flight = !SIMPLE_LIST_IS_EMPTY(&(cache_entry->events));
     // We just queue a local event on the list for the cache entry to track what is being done in the
     // context of that entry
     SIMPLE_LIST_PREPEND(&(cache_entry->events), &(cache_entry_updated_ev->item));
@@ -1543,11 +2147,10 @@ do_get_cache_entry_by_group_rank(offloading_engine_t *engine,
     }
     if (cb != NULL)
     {
-        // If the calling function specified a callback, the event needs to be hidden from the
-        // caller and the callback will be invoked upon completion. So we need to put the event
-        // on the list of ongoing events. Make sure to never return the event to the caller to
-        // prevent the case where the event could be put on two different lists (which leads
-        // to memory corruptions).
+        // If the calling function specified a callback, the event is hidden from the caller:
+        // it stays on the list of the cache entry only, which is how it is tracked, and it is
+        // completed, which invokes the callback, and returned when the entry is received.
+        // The callback is in charge of returning the request object.
         cache_entry_request_t *request_data;
         DYN_LIST_GET(engine->free_cache_entry_requests, cache_entry_request_t, item, request_data);
         assert(request_data);
@@ -1557,8 +2160,39 @@ do_get_cache_entry_by_group_rank(offloading_engine_t *engine,
         request_data->offload_engine = engine;
         cache_entry_updated_ev->ctx.completion_cb = cb;
         cache_entry_updated_ev->ctx.completion_cb_ctx = (void *)request_data;
-        assert(0); // FIXME: events cannot be on two lists
-        // ucs_list_add_tail(&(engine->self_econtext->ongoing_events), &(cache_entry_updated_ev->item));
+    }
+
+    if (request_in_flight)
+    {
+        DBG("A request for gp/rank 0x%x/%" PRId64 " is already in flight", gp_uid, rank);
+        return DO_SUCCESS;
+    }
+
+    if (gp_cache->group_size > 0)
+    {
+        // Prefetch the entries of all the ranks of the block that are still missing,
+        // unless a request for the block is already in flight
+        int64_t first, last;
+        size_t block = rank / CACHE_ENTRIES_REQUEST_BLOCK_SIZE;
+        size_t n_blocks = (gp_cache->group_size + CACHE_ENTRIES_REQUEST_BLOCK_SIZE - 1) / CACHE_ENTRIES_REQUEST_BLOCK_SIZE;
+        GROUP_CACHE_BITSET_POOL_GET(&(engine->procs_cache), gp_cache->requested_blocks, n_blocks);
+        CHECK_ERR_RETURN((gp_cache->requested_blocks == NULL), DO_ERROR, "unable to allocate the bitset of requested blocks");
+        if (GROUP_CACHE_BITSET_TEST(gp_cache->requested_blocks, block))
+        {
+            DBG("A request for the block of gp/rank 0x%x/%" PRId64 " is already in flight", gp_uid, rank);
+            return DO_SUCCESS;
+        }
+        GROUP_CACHE_BITSET_SET(gp_cache->requested_blocks, block);
+        first = block * CACHE_ENTRIES_REQUEST_BLOCK_SIZE;
+        last = first + CACHE_ENTRIES_REQUEST_BLOCK_SIZE - 1;
+        if (last >= gp_cache->group_size)
+            last = gp_cache->group_size - 1;
+        while (first < rank && is_in_cache(&(engine->procs_cache), gp_uid, first, gp_cache->group_size))
+            first++;
+        while (last > rank && is_in_cache(&(engine->procs_cache), gp_uid, last, gp_cache->group_size))
+            last--;
+        request.rank_start = first;
+        request.num_ranks = last - first + 1;
     }
 
     if (engine->on_dpu == true)
@@ -1599,7 +2233,7 @@ do_get_cache_entry_by_group_rank(offloading_engine_t *engine,
                 rc = event_get(econtext->event_channels, NULL, &subev);
                 CHECK_ERR_RETURN((rc), DO_ERROR, "event_get() failed");
                 subev->is_subevent = true;
-                rc = do_send_cache_entry_request(econtext, dpu_ep, i, &rank_data, subev);
+                rc = do_send_cache_entry_request(econtext, dpu_ep, i, &request, subev);
                 CHECK_ERR_RETURN((rc), DO_ERROR, "send_cache_entry_request() failed");
                 DBG("Sub-event for sending cache to DPU %ld: %p", global_sp_id, subev);
                 if (subev != NULL)
@@ -1621,9 +2255,15 @@ do_get_cache_entry_by_group_rank(offloading_engine_t *engine,
     else
     {
         // If we are on the host, we need to send a request to our first shadow DPU
-        DBG("Sending request for cache entry...");
+        dpu_offload_event_t *req_ev;
         execution_context_t *econtext = engine->client;
-        return send_cache_entry_request(econtext, GET_SERVER_EP(econtext), econtext->client->server_id, &rank_data, ev);
+        DBG("Sending request for cache entries...");
+        rc = send_cache_entry_request(econtext, GET_SERVER_EP(econtext), econtext->client->server_id, &request, &req_ev);
+        CHECK_ERR_RETURN((rc), DO_ERROR, "send_cache_entry_request() failed");
+        if (!event_completed(req_ev))
+            QUEUE_EVENT(req_ev);
+        else
+            event_return(&req_ev);
     }
     return DO_SUCCESS;
 }
@@ -1698,3 +2338,492 @@ bool on_same_sp(offloading_engine_t *engine,
     
     return false;
 }
+
+// Distance, in number of ranks, used to prefetch cache entries when querying the cache for a batch of ranks
+#define BATCH_QUERY_PREFETCH_DISTANCE (8)
+
+// Rank queried at index _i of a batch; when the list of ranks is NULL, ranks 0 to n-1 are queried
+#define BATCH_QUERY_RANK(_ranks, _i) ((_ranks) == NULL ? (int64_t)(_i) : (_ranks)[_i])
+
+// Get the cache entry of a rank without growing the array of ranks; NULL if the entry is not set
+#define BATCH_QUERY_GET_ENTRY(_gp_cache, _rank) ({                                            \
+    peer_cache_entry_t *_batch_e = NULL;                                                      \
+    if ((_rank) >= 0 && (size_t)(_rank) < (_gp_cache)->ranks.capacity)                        \
+    {                                                                                         \
+        _batch_e = &(((peer_cache_entry_t *)(_gp_cache)->ranks.base)[(_rank)]);               \
+        if (!_batch_e->set)                                                                   \
+            _batch_e = NULL;                                                                  \
+    }                                                                                         \
+    _batch_e;                                                                                 \
+})
+
+#define BATCH_QUERY_PREFETCH(_gp_cache, _ranks, _i, _n)                                       \
+    do                                                                                        \
+    {                                                                                         \
+        if ((_i) + BATCH_QUERY_PREFETCH_DISTANCE < (_n))                                      \
+        {                                                                                     \
+            int64_t _pf_rank = BATCH_QUERY_RANK(_ranks, (_i) + BATCH_QUERY_PREFETCH_DISTANCE); \
+            if (_pf_rank >= 0 && (size_t)_pf_rank < (_gp_cache)->ranks.capacity)              \
+                __builtin_prefetch(&(((peer_cache_entry_t *)(_gp_cache)->ranks.base)[_pf_rank]), 0, 1); \
+        }                                                                                     \
+    } while (0)
+
+static group_cache_t *get_group_cache_for_batch_query(offloading_engine_t *engine, group_uid_t gp_uid)
+{
+    group_cache_t *gp_cache = NULL;
+    assert(engine);
+    gp_cache = GET_GROUP_CACHE(&(engine->procs_cache), gp_uid);
+    if (gp_cache == NULL || !gp_cache->initialized || !gp_cache->rank_array_initialized)
+        return NULL;
+    return gp_cache;
+}
+
+dpu_offload_status_t get_sp_ids_by_group_ranks(offloading_engine_t *engine,
+                                               group_uid_t gp_uid,
+                                               const int64_t *ranks,
+                                               size_t n_ranks,
+                                               int64_t sp_idx,
+                                               int64_t *sp_ids,
+                                               size_t *n_missing)
+{
+    group_cache_t *gp_cache = NULL;
+    size_t i, missing = 0;
+
+    assert(sp_ids);
+    CHECK_ERR_RETURN((sp_idx < 0 || sp_idx >= MAX_SHADOW_SERVICE_PROCS), DO_ERROR, "invalid SP index: %" PRId64, sp_idx);
+    gp_cache = get_group_cache_for_batch_query(engine, gp_uid);
+    CHECK_ERR_RETURN((gp_cache == NULL), DO_ERROR, "group 0x%x is not in the cache", gp_uid);
+
+    for (i = 0; i < n_ranks; i++)
+    {
+        peer_cache_entry_t *e = NULL;
+        BATCH_QUERY_PREFETCH(gp_cache, ranks, i, n_ranks);
+        e = BATCH_QUERY_GET_ENTRY(gp_cache, BATCH_QUERY_RANK(ranks, i));
+        if (e == NULL || sp_idx >= (int64_t)e->num_shadow_service_procs)
+        {
+            sp_ids[i] = -1;
+            missing++;
+            continue;
+        }
+        sp_ids[i] = (int64_t)e->shadow_service_procs[sp_idx];
+    }
+
+    if (n_missing != NULL)
+        *n_missing = missing;
+    return DO_SUCCESS;
+}
+
+dpu_offload_status_t get_group_ranks_host(offloading_engine_t *engine,
+                                          group_uid_t gp_uid,
+                                          const int64_t *ranks,
+                                          size_t n_ranks,
+                                          uint64_t *host_ids,
+                                          size_t *n_missing)
+{
+    group_cache_t *gp_cache = NULL;
+    size_t i, missing = 0;
+
+    assert(host_ids);
+    gp_cache = get_group_cache_for_batch_query(engine, gp_uid);
+    CHECK_ERR_RETURN((gp_cache == NULL), DO_ERROR, "group 0x%x is not in the cache", gp_uid);
+
+    for (i = 0; i < n_ranks; i++)
+    {
+        peer_cache_entry_t *e = NULL;
+        BATCH_QUERY_PREFETCH(gp_cache, ranks, i, n_ranks);
+        e = BATCH_QUERY_GET_ENTRY(gp_cache, BATCH_QUERY_RANK(ranks, i));
+        if (e == NULL)
+        {
+            host_ids[i] = UINT64_MAX;
+            missing++;
+            continue;
+        }
+        host_ids[i] = e->peer.host_info;
+    }
+
+    if (n_missing != NULL)
+        *n_missing = missing;
+    return DO_SUCCESS;
+}
+
+dpu_offload_status_t get_clients_by_group_ranks(execution_context_t *econtext,
+                                                group_uid_t gp_uid,
+                                                const int64_t *ranks,
+                                                size_t n_ranks,
+                                                dest_client_t *clients,
+                                                size_t *n_missing)
+{
+    group_cache_t *gp_cache = NULL;
+    size_t i, missing = 0;
+
+    assert(econtext);
+    assert(clients);
+    CHECK_ERR_RETURN((econtext->type != CONTEXT_SERVER), DO_ERROR, "clients can only be looked up from a server");
+    gp_cache = get_group_cache_for_batch_query(econtext->engine, gp_uid);
+    CHECK_ERR_RETURN((gp_cache == NULL), DO_ERROR, "group 0x%x is not in the cache", gp_uid);
+
+    for (i = 0; i < n_ranks; i++)
+    {
+        peer_cache_entry_t *e = NULL;
+        BATCH_QUERY_PREFETCH(gp_cache, ranks, i, n_ranks);
+        e = BATCH_QUERY_GET_ENTRY(gp_cache, BATCH_QUERY_RANK(ranks, i));
+        if (e != NULL && e->ep == NULL && e->peer.addr_len > 0)
+        {
+            // Get the endpoint from the engine's pool, same as GET_CLIENT_BY_RANK
+            e->pooled_ep = ep_pool_get(econtext->engine, e->peer.addr, e->peer.addr_len);
+            if (e->pooled_ep != NULL)
+                e->ep = e->pooled_ep->ep;
+        }
+        if (e == NULL || e->ep == NULL)
+        {
+            clients[i].ep = NULL;
+            clients[i].id = UINT64_MAX;
+            missing++;
+            continue;
+        }
+        clients[i].ep = e->ep;
+        clients[i].id = e->client_id;
+    }
+
+    if (n_missing != NULL)
+        *n_missing = missing;
+    return DO_SUCCESS;
+}
+
+static size_t revoke_msg_pool_class(size_t data_size)
+{
+    size_t c = 0;
+    size_t capacity = GROUP_REVOKE_MSG_POOL_MIN_CAPACITY;
+    while (capacity < data_size && c < GROUP_REVOKE_MSG_POOL_NUM_CLASSES)
+    {
+        capacity = capacity << 1;
+        c++;
+    }
+    return c;
+}
+
+group_revoke_msg_from_sp_t *group_revoke_msg_get(group_revoke_msg_pool_t *pool, size_t data_size)
+{
+    group_revoke_msg_from_sp_t *msg = NULL;
+    size_t c, capacity;
+    assert(pool);
+
+    c = revoke_msg_pool_class(data_size);
+    if (c < GROUP_REVOKE_MSG_POOL_NUM_CLASSES)
+    {
+        capacity = GROUP_REVOKE_MSG_POOL_MIN_CAPACITY << c;
+        if (!ucs_list_is_empty(&(pool->free_msgs[c])))
+        {
+            msg = ucs_list_extract_head(&(pool->free_msgs[c]), group_revoke_msg_from_sp_t, item);
+            assert(msg->capacity == capacity);
+        }
+    }
+    else
+    {
+        // Too big to be cached, allocated for the exact size
+        capacity = data_size;
+    }
+
+    if (msg == NULL)
+    {
+        msg = DPU_OFFLOAD_MALLOC(GROUP_REVOKE_MSG_FROM_SP_SIZE(capacity));
+        if (msg == NULL)
+            return NULL;
+        msg->capacity = capacity;
+    }
+    msg->data_size = data_size;
+    pool->num_used++;
+    return msg;
+}
+
+void group_revoke_msg_return(group_revoke_msg_pool_t *pool, group_revoke_msg_from_sp_t *msg)
+{
+    size_t c;
+    assert(pool);
+    assert(msg);
+    assert(pool->num_used > 0);
+    pool->num_used--;
+    c = revoke_msg_pool_class(msg->capacity);
+    if (c >= GROUP_REVOKE_MSG_POOL_NUM_CLASSES)
+    {
+        free(msg);
+        return;
+    }
+    assert(msg->capacity == GROUP_REVOKE_MSG_POOL_MIN_CAPACITY << c);
+    ucs_list_add_head(&(pool->free_msgs[c]), &(msg->item));
+}
+
+void group_revoke_msg_pool_fini(group_revoke_msg_pool_t *pool)
+{
+    size_t c;
+    assert(pool);
+    if (pool->num_used > 0)
+        WARN_MSG("%ld revoke message(s) from SPs are still in use", pool->num_used);
+    for (c = 0; c < GROUP_REVOKE_MSG_POOL_NUM_CLASSES; c++)
+    {
+        group_revoke_msg_from_sp_t *msg = NULL, *next_msg = NULL;
+        ucs_list_for_each_safe(msg, next_msg, &(pool->free_msgs[c]), item)
+        {
+            ucs_list_del(&(msg->item));
+            free(msg);
+        }
+    }
+}
+
+size_t group_revoke_msg_encoded_size(group_cache_t *gp_cache, group_revoke_encoding_t *encoding)
+{
+    size_t bitmap_size, ranges_size, n_ranges = 0;
+    int64_t prev_rank = -2;
+    assert(gp_cache);
+    assert(encoding);
+
+    if (gp_cache->revokes.ranks == NULL || gp_cache->group_size <= 0)
+    {
+        *encoding = GROUP_REVOKE_ENCODING_RANGES;
+        return 0;
+    }
+
+    // Count the runs of contiguous ranks
+    GROUP_CACHE_BITSET_FOREACH(gp_cache->revokes.ranks, gp_cache->group_size, rank, {
+        if ((int64_t)rank != prev_rank + 1)
+            n_ranges++;
+        prev_rank = rank;
+    });
+    ranges_size = n_ranges * sizeof(group_revoke_range_t);
+    bitmap_size = GROUP_CACHE_BITSET_NSLOTS(gp_cache->group_size) * sizeof(group_cache_bitset_t);
+    if (ranges_size <= bitmap_size)
+    {
+        *encoding = GROUP_REVOKE_ENCODING_RANGES;
+        return ranges_size;
+    }
+    *encoding = GROUP_REVOKE_ENCODING_BITMAP;
+    return bitmap_size;
+}
+
+void group_revoke_msg_encode(group_cache_t *gp_cache, group_revoke_encoding_t encoding, group_revoke_msg_from_sp_t *msg)
+{
+    assert(gp_cache);
+    assert(msg);
+    msg->encoding = encoding;
+    msg->num_ranks = 0;
+    if (msg->data_size == 0)
+        return;
+
+    assert(gp_cache->revokes.ranks);
+    if (encoding == GROUP_REVOKE_ENCODING_BITMAP)
+    {
+        assert(msg->data_size == GROUP_CACHE_BITSET_NSLOTS(gp_cache->group_size) * sizeof(group_cache_bitset_t));
+        memcpy(msg->data, gp_cache->revokes.ranks, msg->data_size);
+        msg->num_ranks = GROUP_CACHE_BITSET_COUNT(gp_cache->revokes.ranks, gp_cache->group_size);
+    }
+    else
+    {
+        group_revoke_range_t *ranges = (group_revoke_range_t *)msg->data;
+        group_revoke_range_t *cur = NULL;
+        size_t n_ranges = 0;
+        GROUP_CACHE_BITSET_FOREACH(gp_cache->revokes.ranks, gp_cache->group_size, rank, {
+            if (cur != NULL && cur->start + cur->num == rank)
+            {
+                cur->num++;
+                continue;
+            }
+            assert((n_ranges + 1) * sizeof(group_revoke_range_t) <= msg->data_size);
+            cur = &(ranges[n_ranges]);
+            cur->start = rank;
+            cur->num = 1;
+            n_ranges++;
+        });
+        assert(n_ranges * sizeof(group_revoke_range_t) == msg->data_size);
+        msg->num_ranks = GROUP_CACHE_BITSET_COUNT(gp_cache->revokes.ranks, gp_cache->group_size);
+    }
+}
+
+size_t group_revoke_msg_apply(group_cache_t *gp_cache, group_revoke_msg_from_sp_t *msg)
+{
+    size_t new_revokes = 0;
+    assert(gp_cache);
+    assert(msg);
+    assert(gp_cache->revokes.ranks);
+    assert(msg->group_size == (size_t)gp_cache->group_size);
+
+    if (msg->encoding == GROUP_REVOKE_ENCODING_BITMAP)
+    {
+        assert(msg->data_size == GROUP_CACHE_BITSET_NSLOTS(gp_cache->group_size) * sizeof(group_cache_bitset_t));
+        new_revokes = GROUP_CACHE_BITSET_OR_COUNT_NEW(gp_cache->revokes.ranks,
+                                                      (group_cache_bitset_t *)msg->data,
+                                                      gp_cache->group_size);
+    }
+    else
+    {
+        group_revoke_range_t *ranges = (group_revoke_range_t *)msg->data;
+        size_t n_ranges = msg->data_size / sizeof(group_revoke_range_t);
+        size_t r;
+        for (r = 0; r < n_ranges; r++)
+        {
+            assert(ranges[r].start + ranges[r].num <= (uint64_t)gp_cache->group_size);
+            new_revokes += GROUP_CACHE_BITSET_SET_RANGE_COUNT_NEW(gp_cache->revokes.ranks,
+                                                                  ranges[r].start,
+                                                                  ranges[r].num);
+        }
+    }
+    DBG("%ld new rank(s) marked as revoking group 0x%x (seq num: %ld, encoding: %d, ranks in message: %ld)",
+        new_revokes, gp_cache->group_uid, msg->gp_seq_num, msg->encoding, msg->num_ranks);
+    return new_revokes;
+}
+
+/*************************************/
+/* Milestones of the group caches    */
+/*************************************/
+
+static const char *group_cache_milestone_names[GROUP_CACHE_NUM_MILESTONES] = {
+    "add_deferred",
+    "first_local_rank",
+    "local_ranks_complete",
+    "bcast_posted",
+    "first_remote_entries",
+    "cache_complete",
+    "sent_to_host",
+    "lookup_tables",
+    "revoked",
+};
+
+const char *group_cache_milestone_to_str(group_cache_milestone_t milestone)
+{
+    if (milestone >= GROUP_CACHE_NUM_MILESTONES)
+        return "unknown";
+    return group_cache_milestone_names[milestone];
+}
+
+static void update_milestone_stats(cache_t *cache, group_cache_t *gp_cache, group_cache_milestone_t milestone, uint64_t latency)
+{
+    size_t bucket = 0;
+    group_cache_milestone_stats_t *stats = &(cache->milestone_stats[milestone]);
+    if (latency > 0)
+        bucket = 64 - __builtin_clzll(latency);
+    if (bucket >= GROUP_CACHE_MILESTONE_HIST_BUCKETS)
+        bucket = GROUP_CACHE_MILESTONE_HIST_BUCKETS - 1;
+    stats->hist[bucket]++;
+    stats->count++;
+    stats->sum += latency;
+    if (stats->count == 1 || latency > stats->max)
+    {
+        stats->max = latency;
+        stats->max_gp_uid = gp_cache->persistent.uid;
+        stats->max_gp_seq_num = gp_cache->persistent.num;
+    }
+}
+
+void group_cache_record_milestone(offloading_engine_t *engine, group_cache_t *gp_cache, group_cache_milestone_t milestone)
+{
+    uint64_t now;
+    assert(engine);
+    assert(gp_cache);
+    assert(milestone < GROUP_CACHE_NUM_MILESTONES);
+
+    if (milestone == GROUP_CACHE_MILESTONE_ADD_DEFERRED)
+    {
+        // The add belongs to the next version of the group, which starts once the current
+        // one is revoked. We only save the time and it is added to the timeline of the next
+        // version when it starts.
+        if (gp_cache->persistent.add_deferred_ts == 0)
+            gp_cache->persistent.add_deferred_ts = monotonic_time_us();
+        return;
+    }
+
+    if (milestone != GROUP_CACHE_MILESTONE_REVOKED && gp_cache->timeline.ts[GROUP_CACHE_MILESTONE_REVOKED] != 0)
+    {
+        // First milestone of a new version of the group, the timeline of the revoked
+        // version was kept until now
+        memset(&(gp_cache->timeline), 0, sizeof(gp_cache->timeline));
+    }
+
+    if (gp_cache->timeline.ts[milestone] != 0)
+        return;
+
+    now = monotonic_time_us();
+    if (gp_cache->timeline.start == 0)
+    {
+        gp_cache->timeline.start = now;
+        if (gp_cache->persistent.add_deferred_ts != 0)
+        {
+            // The creation of this version of the group waited for the revoke of the previous one
+            gp_cache->timeline.start = gp_cache->persistent.add_deferred_ts;
+            gp_cache->timeline.ts[GROUP_CACHE_MILESTONE_ADD_DEFERRED] = gp_cache->persistent.add_deferred_ts;
+            update_milestone_stats(&(engine->procs_cache), gp_cache, GROUP_CACHE_MILESTONE_ADD_DEFERRED, 0);
+            gp_cache->persistent.add_deferred_ts = 0;
+        }
+    }
+    gp_cache->timeline.ts[milestone] = now;
+    update_milestone_stats(&(engine->procs_cache), gp_cache, milestone, now - gp_cache->timeline.start);
+}
+
+dpu_offload_status_t get_group_cache_timeline(offloading_engine_t *engine, group_uid_t gp_uid, uint64_t *timestamps)
+{
+    khiter_t k;
+    group_cache_t *gp_cache = NULL;
+    assert(engine);
+    assert(timestamps);
+    k = kh_get(group_hash_t, engine->procs_cache.data, gp_uid);
+    if (k == kh_end(engine->procs_cache.data))
+        return DO_NOT_APPLICABLE;
+    gp_cache = kh_value(engine->procs_cache.data, k);
+    memcpy(timestamps, gp_cache->timeline.ts, GROUP_CACHE_NUM_MILESTONES * sizeof(uint64_t));
+    return DO_SUCCESS;
+}
+
+void group_cache_timelines_dump(offloading_engine_t *engine, FILE *stream)
+{
+    size_t m, b;
+    group_uid_t gp_uid;
+    group_cache_t *gp_cache = NULL;
+    char id[64];
+    assert(engine);
+    assert(stream);
+
+    if (engine->on_dpu)
+        snprintf(id, sizeof(id), "SP %" PRIu64, engine->config->local_service_proc.info.global_id);
+    else
+        snprintf(id, sizeof(id), "host 0x%" PRIx64, engine->host_id);
+
+    fprintf(stream, "[%s] Group cache milestones, latency since the beginning of the group creation:\n", id);
+    for (m = 0; m < GROUP_CACHE_NUM_MILESTONES; m++)
+    {
+        group_cache_milestone_stats_t *stats = &(engine->procs_cache.milestone_stats[m]);
+        if (stats->count == 0)
+            continue;
+        fprintf(stream, "[%s]   %-20s count: %" PRIu64 ", avg: %" PRIu64 " us, max: %" PRIu64 " us (group 0x%x, seq num: %" PRIu64 ")\n",
+                id,
+                group_cache_milestone_to_str(m),
+                stats->count,
+                stats->sum / stats->count,
+                stats->max,
+                stats->max_gp_uid,
+                stats->max_gp_seq_num);
+        for (b = 0; b < GROUP_CACHE_MILESTONE_HIST_BUCKETS; b++)
+        {
+            if (stats->hist[b] == 0)
+                continue;
+            fprintf(stream, "[%s]     [%" PRIu64 ", %" PRIu64 ") us: %" PRIu64 "\n",
+                    id,
+                    b == 0 ? 0 : (uint64_t)1 << (b - 1),
+                    (uint64_t)1 << b,
+                    stats->hist[b]);
+        }
+    }
+
+    if (engine->procs_cache.data == NULL || kh_size(engine->procs_cache.data) == 0)
+        return;
+    fprintf(stream, "[%s] Timelines of the current version of the groups:\n", id);
+    kh_foreach(engine->procs_cache.data, gp_uid, gp_cache, {
+        if (gp_cache->timeline.start == 0)
+            continue;
+        fprintf(stream, "[%s]   group 0x%x (seq num: %" PRIu64 "):", id, gp_uid, gp_cache->persistent.num);
+        for (m = 0; m < GROUP_CACHE_NUM_MILESTONES; m++)
+        {
+            if (gp_cache->timeline.ts[m] == 0)
+                continue;
+            fprintf(stream, " %s=+%" PRIu64 "us", group_cache_milestone_to_str(m), gp_cache->timeline.ts[m] - gp_cache->timeline.start);
+        }
+        fprintf(stream, "\n");
+    });
+}
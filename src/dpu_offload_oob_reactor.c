@@ -0,0 +1,461 @@
+//
+// Copyright (c) 2023, NVIDIA CORPORATION. All rights reserved.
+//
+// See LICENSE.txt for license information
+//
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <inttypes.h>
+#include <unistd.h>
+#include <errno.h>
+#include <assert.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+
+#include "dpu_offload_types.h"
+#include "dpu_offload_debug.h"
+
+/*
+ * The OOB connections of all the servers of an engine are accepted by a single
+ * reactor thread. Listening and accepted sockets are non-blocking, so a slow
+ * client never prevents other clients from connecting. Once a client is accepted,
+ * its frame is received as the socket becomes ready; the server's frame is then
+ * prepared, so a client presenting a resume token gets its slot back, and sent;
+ * the socket is closed once the exchange completes.
+ * The endpoint to the client is then created when progressing the execution
+ * context.
+ */
+
+#define OOB_REACTOR_MAX_EVENTS (64)
+
+// Implemented in dpu_offload_service_daemon.c
+extern dpu_offload_status_t oob_server_listen(execution_context_t *econtext);
+extern dpu_offload_status_t oob_server_handshake_start(execution_context_t *econtext, oob_reactor_handle_t *conn);
+extern dpu_offload_status_t oob_server_handshake_reply(execution_context_t *econtext, oob_reactor_handle_t *conn);
+extern void oob_server_handshake_done(execution_context_t *econtext, oob_reactor_handle_t *conn);
+extern void oob_server_handshake_abort(execution_context_t *econtext, oob_reactor_handle_t *conn);
+
+// This function assumes the reactor is locked before it is invoked
+static void oob_reactor_close(oob_reactor_t *reactor, oob_reactor_handle_t *handle)
+{
+    if (handle->fd == -1)
+        return;
+    epoll_ctl(reactor->epfd, EPOLL_CTL_DEL, handle->fd, NULL);
+    close(handle->fd);
+    handle->fd = -1;
+    if (handle->frame != NULL)
+    {
+        free(handle->frame);
+        handle->frame = NULL;
+    }
+    if (handle->peer_addr != NULL)
+    {
+        free(handle->peer_addr);
+        handle->peer_addr = NULL;
+    }
+    switch (handle->type)
+    {
+    case OOB_REACTOR_LISTENER:
+        ucs_list_del(&(handle->item));
+        reactor->num_listeners--;
+        break;
+    case OOB_REACTOR_CONN:
+        ucs_list_del(&(handle->item));
+        reactor->num_conns--;
+        break;
+    default:
+        break;
+    }
+    // The reactor thread may have an event referencing the handle, it is freed
+    // once the thread is done with the current batch of events.
+    ucs_list_add_tail(&(reactor->closed), &(handle->item));
+}
+
+// This function assumes the reactor is locked before it is invoked
+static void oob_reactor_free_closed(oob_reactor_t *reactor)
+{
+    while (!ucs_list_is_empty(&(reactor->closed)))
+    {
+        oob_reactor_handle_t *handle = ucs_list_extract_head(&(reactor->closed), oob_reactor_handle_t, item);
+        free(handle);
+    }
+}
+
+/**
+ * @brief Send as much of the server's frame as the socket accepts.
+ *
+ * @return 1 when the entire frame is sent, 0 when the rest of the frame must be sent later, -1 on error
+ */
+static int oob_reactor_conn_send(oob_reactor_handle_t *conn)
+{
+    while (conn->frame_offset < conn->frame_len)
+    {
+        ssize_t n = send(conn->fd,
+                         (char *)conn->frame + conn->frame_offset,
+                         conn->frame_len - conn->frame_offset,
+                         MSG_NOSIGNAL);
+        if (n == -1)
+        {
+            if (errno == EINTR)
+                continue;
+            if (errno == EAGAIN || errno == EWOULDBLOCK)
+                return 0;
+            ERR_MSG("send() failed: %s", strerror(errno));
+            return -1;
+        }
+        conn->frame_offset += n;
+    }
+    return 1;
+}
+
+/**
+ * @brief Receive as much of the client's frame as available on the socket.
+ *
+ * @return 1 when the entire frame is received, 0 when more data is expected, -1 on error
+ */
+static int oob_reactor_conn_recv(oob_reactor_handle_t *conn)
+{
+    const size_t hdr_len = sizeof(oob_client_hello_t);
+    while (true)
+    {
+        void *buf;
+        size_t len;
+        ssize_t n;
+        if (conn->recv_offset < hdr_len)
+        {
+            buf = (char *)&(conn->hello) + conn->recv_offset;
+            len = hdr_len - conn->recv_offset;
+        }
+        else
+        {
+            size_t addr_offset = conn->recv_offset - hdr_len;
+            if (conn->peer_addr == NULL)
+            {
+                CHECK_ERR_RETURN((conn->hello.addr_len == 0 || conn->hello.addr_len > MAX_ADDR_LEN),
+                                 -1,
+                                 "invalid address length from %s (%" PRIu64 ")",
+                                 conn->peer_addr_str,
+                                 conn->hello.addr_len);
+                CHECK_ERR_RETURN((conn->hello.frame_len != hdr_len + conn->hello.addr_len),
+                                 -1,
+                                 "invalid frame length from %s (%" PRIu64 ")",
+                                 conn->peer_addr_str,
+                                 conn->hello.frame_len);
+                conn->peer_addr = malloc(conn->hello.addr_len);
+                CHECK_ERR_RETURN((conn->peer_addr == NULL), -1, "unable to allocate memory for the client's address");
+            }
+            if (addr_offset == conn->hello.addr_len)
+                return 1;
+            buf = (char *)conn->peer_addr + addr_offset;
+            len = conn->hello.addr_len - addr_offset;
+        }
+        n = recv(conn->fd, buf, len, 0);
+        if (n == 0)
+        {
+            ERR_MSG("connection closed by %s", conn->peer_addr_str);
+            return -1;
+        }
+        if (n == -1)
+        {
+            if (errno == EINTR)
+                continue;
+            if (errno == EAGAIN || errno == EWOULDBLOCK)
+                return 0;
+            ERR_MSG("recv() failed: %s", strerror(errno));
+            return -1;
+        }
+        conn->recv_offset += n;
+    }
+}
+
+// This function assumes the reactor is locked before it is invoked
+static void oob_reactor_conn_progress(oob_reactor_t *reactor, oob_reactor_handle_t *conn)
+{
+    execution_context_t *econtext = conn->econtext;
+    uint32_t events;
+    int sent, received;
+
+    received = oob_reactor_conn_recv(conn);
+    if (received == 1 && conn->frame == NULL && oob_server_handshake_reply(econtext, conn) != DO_SUCCESS)
+    {
+        ERR_MSG("oob_server_handshake_reply() failed");
+        received = -1;
+    }
+    sent = (received == 1) ? oob_reactor_conn_send(conn) : 0;
+    if (sent == -1 || received == -1)
+    {
+        ERR_MSG("handshake with client #%" PRIu64 " (%s) failed", conn->client_id, conn->peer_addr_str);
+        oob_server_handshake_abort(econtext, conn);
+        oob_reactor_close(reactor, conn);
+        return;
+    }
+    if (sent == 1 && received == 1)
+    {
+        oob_server_handshake_done(econtext, conn);
+        oob_reactor_close(reactor, conn);
+        return;
+    }
+
+    // Wait for the socket to be ready for what is left to do
+    events = (received == 1) ? EPOLLOUT : EPOLLIN;
+    if (events != conn->events)
+    {
+        struct epoll_event ev = {0};
+        ev.events = events;
+        ev.data.ptr = conn;
+        if (epoll_ctl(reactor->epfd, conn->events == 0 ? EPOLL_CTL_ADD : EPOLL_CTL_MOD, conn->fd, &ev) == -1)
+        {
+            ERR_MSG("epoll_ctl() failed: %s", strerror(errno));
+            oob_server_handshake_abort(econtext, conn);
+            oob_reactor_close(reactor, conn);
+            return;
+        }
+        conn->events = events;
+    }
+}
+
+// This function assumes the reactor is locked before it is invoked
+static void oob_reactor_accept(oob_reactor_t *reactor, oob_reactor_handle_t *listener)
+{
+    while (true)
+    {
+        int fd, optval = 1;
+        struct sockaddr_in addr;
+        socklen_t addr_len = sizeof(addr);
+        oob_reactor_handle_t *conn;
+
+        fd = accept4(listener->fd, (struct sockaddr *)&addr, &addr_len, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (fd == -1)
+        {
+            if (errno == EINTR || errno == ECONNABORTED)
+                continue;
+            if (errno != EAGAIN && errno != EWOULDBLOCK)
+                ERR_MSG("accept4() failed: %s", strerror(errno));
+            return;
+        }
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &optval, sizeof(optval));
+
+        conn = calloc(1, sizeof(oob_reactor_handle_t));
+        if (conn == NULL)
+        {
+            ERR_MSG("unable to allocate connection handle");
+            close(fd);
+            continue;
+        }
+        conn->type = OOB_REACTOR_CONN;
+        conn->fd = fd;
+        conn->econtext = listener->econtext;
+        inet_ntop(AF_INET, &(addr.sin_addr), conn->peer_addr_str, INET_ADDRSTRLEN);
+        DBG("Connection accepted from %s on fd=%d", conn->peer_addr_str, fd);
+        if (oob_server_handshake_start(conn->econtext, conn) != DO_SUCCESS)
+        {
+            ERR_MSG("oob_server_handshake_start() failed");
+            close(fd);
+            free(conn);
+            continue;
+        }
+        ucs_list_add_tail(&(reactor->conns), &(conn->item));
+        reactor->num_conns++;
+
+        // The client sends its frame right after connecting, it may already be there
+        oob_reactor_conn_progress(reactor, conn);
+    }
+}
+
+static void *oob_reactor_thread(void *arg)
+{
+    offloading_engine_t *engine = (offloading_engine_t *)arg;
+    oob_reactor_t *reactor = &(engine->oob_reactor);
+    struct epoll_event events[OOB_REACTOR_MAX_EVENTS];
+
+    while (true)
+    {
+        int i, n;
+        n = epoll_wait(reactor->epfd, events, OOB_REACTOR_MAX_EVENTS, -1);
+        if (n == -1)
+        {
+            if (errno == EINTR)
+                continue;
+            ERR_MSG("epoll_wait() failed: %s", strerror(errno));
+            break;
+        }
+
+        pthread_mutex_lock(&(reactor->mutex));
+        if (!reactor->running)
+        {
+            pthread_mutex_unlock(&(reactor->mutex));
+            break;
+        }
+        for (i = 0; i < n; i++)
+        {
+            oob_reactor_handle_t *handle = (oob_reactor_handle_t *)events[i].data.ptr;
+            if (handle->fd == -1)
+            {
+                // Closed while handling a previous event of the batch
+                continue;
+            }
+            switch (handle->type)
+            {
+            case OOB_REACTOR_WAKEUP:
+            {
+                uint64_t val;
+                if (read(handle->fd, &val, sizeof(val)) == -1 && errno != EAGAIN)
+                    ERR_MSG("read() failed: %s", strerror(errno));
+                break;
+            }
+            case OOB_REACTOR_LISTENER:
+                oob_reactor_accept(reactor, handle);
+                break;
+            case OOB_REACTOR_CONN:
+                oob_reactor_conn_progress(reactor, handle);
+                break;
+            default:
+                ERR_MSG("invalid handle type (%d)", handle->type);
+            }
+        }
+        oob_reactor_free_closed(reactor);
+        pthread_mutex_unlock(&(reactor->mutex));
+    }
+
+    pthread_exit(NULL);
+}
+
+// This function assumes the reactor is locked before it is invoked
+static dpu_offload_status_t oob_reactor_start(offloading_engine_t *engine)
+{
+    int rc;
+    struct epoll_event ev = {0};
+    oob_reactor_t *reactor = &(engine->oob_reactor);
+
+    reactor->epfd = epoll_create1(EPOLL_CLOEXEC);
+    CHECK_ERR_RETURN((reactor->epfd == -1), DO_ERROR, "epoll_create1() failed: %s", strerror(errno));
+    reactor->wakeup_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    CHECK_ERR_GOTO((reactor->wakeup_fd == -1), error_out, "eventfd() failed: %s", strerror(errno));
+    memset(&(reactor->wakeup), 0, sizeof(reactor->wakeup));
+    reactor->wakeup.type = OOB_REACTOR_WAKEUP;
+    reactor->wakeup.fd = reactor->wakeup_fd;
+    ev.events = EPOLLIN;
+    ev.data.ptr = &(reactor->wakeup);
+    rc = epoll_ctl(reactor->epfd, EPOLL_CTL_ADD, reactor->wakeup_fd, &ev);
+    CHECK_ERR_GOTO((rc == -1), error_out, "epoll_ctl() failed: %s", strerror(errno));
+
+    reactor->running = true;
+    rc = pthread_create(&(reactor->tid), NULL, &oob_reactor_thread, engine);
+    CHECK_ERR_GOTO((rc), error_out, "unable to start the OOB reactor thread");
+    DBG("OOB reactor started (engine: %p)", engine);
+    return DO_SUCCESS;
+error_out:
+    reactor->running = false;
+    if (reactor->wakeup_fd != -1)
+    {
+        close(reactor->wakeup_fd);
+        reactor->wakeup_fd = -1;
+    }
+    close(reactor->epfd);
+    reactor->epfd = -1;
+    return DO_ERROR;
+}
+
+dpu_offload_status_t oob_reactor_add_server(offloading_engine_t *engine, execution_context_t *econtext)
+{
+    dpu_offload_status_t rc;
+    struct epoll_event ev = {0};
+    oob_reactor_handle_t *listener;
+    oob_reactor_t *reactor = &(engine->oob_reactor);
+
+    rc = oob_server_listen(econtext);
+    CHECK_ERR_RETURN((rc), DO_ERROR, "oob_server_listen() failed");
+    listener = calloc(1, sizeof(oob_reactor_handle_t));
+    CHECK_ERR_RETURN((listener == NULL), DO_ERROR, "unable to allocate listener handle");
+    listener->type = OOB_REACTOR_LISTENER;
+    listener->fd = econtext->server->conn_data.oob.listenfd;
+    listener->econtext = econtext;
+
+    pthread_mutex_lock(&(reactor->mutex));
+    if (!reactor->running)
+    {
+        rc = oob_reactor_start(engine);
+        CHECK_ERR_GOTO((rc), error_out, "oob_reactor_start() failed");
+    }
+    ev.events = EPOLLIN;
+    ev.data.ptr = listener;
+    CHECK_ERR_GOTO((epoll_ctl(reactor->epfd, EPOLL_CTL_ADD, listener->fd, &ev) == -1),
+                   error_out,
+                   "epoll_ctl() failed: %s",
+                   strerror(errno));
+    ucs_list_add_tail(&(reactor->listeners), &(listener->item));
+    reactor->num_listeners++;
+    econtext->server->conn_data.oob.listener = listener;
+    pthread_mutex_unlock(&(reactor->mutex));
+    return DO_SUCCESS;
+error_out:
+    pthread_mutex_unlock(&(reactor->mutex));
+    close(listener->fd);
+    econtext->server->conn_data.oob.listenfd = -1;
+    free(listener);
+    return DO_ERROR;
+}
+
+void oob_reactor_remove_server(offloading_engine_t *engine, execution_context_t *econtext)
+{
+    oob_reactor_handle_t *conn, *tmp;
+    oob_reactor_t *reactor = &(engine->oob_reactor);
+
+    pthread_mutex_lock(&(reactor->mutex));
+    if (econtext->server->conn_data.oob.listener != NULL)
+    {
+        oob_reactor_close(reactor, econtext->server->conn_data.oob.listener);
+        econtext->server->conn_data.oob.listener = NULL;
+        econtext->server->conn_data.oob.listenfd = -1;
+    }
+    ucs_list_for_each_safe(conn, tmp, &(reactor->conns), item)
+    {
+        if (conn->econtext != econtext)
+            continue;
+        oob_server_handshake_abort(econtext, conn);
+        oob_reactor_close(reactor, conn);
+    }
+    if (!reactor->running)
+        oob_reactor_free_closed(reactor);
+    pthread_mutex_unlock(&(reactor->mutex));
+}
+
+void oob_reactor_fini(offloading_engine_t *engine)
+{
+    oob_reactor_handle_t *handle, *tmp;
+    oob_reactor_t *reactor = &(engine->oob_reactor);
+    uint64_t val = 1;
+
+    if (reactor->epfd == -1)
+        return;
+
+    pthread_mutex_lock(&(reactor->mutex));
+    reactor->running = false;
+    pthread_mutex_unlock(&(reactor->mutex));
+    if (write(reactor->wakeup_fd, &val, sizeof(val)) == -1)
+        ERR_MSG("write() failed: %s", strerror(errno));
+    pthread_join(reactor->tid, NULL);
+
+    DBG("Stopping OOB reactor (%ld listeners, %ld handshakes in progress)", reactor->num_listeners, reactor->num_conns);
+    ucs_list_for_each_safe(handle, tmp, &(reactor->conns), item)
+    {
+        oob_server_handshake_abort(handle->econtext, handle);
+        oob_reactor_close(reactor, handle);
+    }
+    ucs_list_for_each_safe(handle, tmp, &(reactor->listeners), item)
+    {
+        handle->econtext->server->conn_data.oob.listener = NULL;
+        handle->econtext->server->conn_data.oob.listenfd = -1;
+        oob_reactor_close(reactor, handle);
+    }
+    oob_reactor_free_closed(reactor);
+    close(reactor->wakeup_fd);
+    reactor->wakeup_fd = -1;
+    close(reactor->epfd);
+    reactor->epfd = -1;
+}
@@ -6,100 +6,1086 @@
 // See LICENSE.txt for license information
 //
 
+#include <string.h>
+#include <time.h>
+
 #include "dpu_offload_types.h"
 #include "dpu_offload_event_channels.h"
+#include "dpu_offload_mem_mgt.h"
 #include "dpu_offload_debug.h"
+#include "dpu_offload_service_daemon.h"
+#include "dpu_offload_ops.h"
+
+static offload_op_t *lookup_op_by_alg_id(offloading_engine_t *engine, uint64_t alg_id)
+{
+    size_t i;
+    for (i = 0; i < engine->num_registered_ops; i++)
+    {
+        offload_op_t **op = DYN_ARRAY_GET_ELT(&(engine->registered_ops), i, offload_op_t *);
+        if ((*op)->alg_id == alg_id)
+            return *op;
+    }
+    return NULL;
+}
+
+static op_desc_t *lookup_active_op(execution_context_t *econtext, bool executor, uint64_t origin_id, uint64_t id, int64_t gp_uid, int64_t group_rank)
+{
+    op_desc_t *cur_op;
+    ucs_list_for_each(cur_op, &(econtext->active_ops), item)
+    {
+        if (cur_op->executor == executor &&
+            cur_op->id == id &&
+            (int64_t)cur_op->gp_uid == gp_uid &&
+            cur_op->group_rank == group_rank &&
+            (!executor || cur_op->origin_id == origin_id))
+            return cur_op;
+    }
+    return NULL;
+}
+
+/**
+ * @brief Get the scheduling queue of a group, created with the default weight the first time.
+ */
+static op_queue_t *op_queue_get(offloading_engine_t *engine, group_uid_t gp_uid)
+{
+    op_queue_t *queue;
+    khiter_t k;
+    int ret;
+
+    k = kh_get(op_queue_hash_t, engine->ops_sched.queues, gp_uid);
+    if (k != kh_end(engine->ops_sched.queues))
+        return kh_value(engine->ops_sched.queues, k);
+
+    queue = DPU_OFFLOAD_MALLOC(sizeof(op_queue_t));
+    if (queue == NULL)
+        return NULL;
+    memset(queue, 0, sizeof(op_queue_t));
+    queue->gp_uid = gp_uid;
+    queue->weight = engine->settings.op_queue_weight;
+    queue->credits = queue->weight;
+    k = kh_put(op_queue_hash_t, engine->ops_sched.queues, gp_uid, &ret);
+    if (ret == -1)
+    {
+        free(queue);
+        return NULL;
+    }
+    kh_value(engine->ops_sched.queues, k) = queue;
+    return queue;
+}
+
+// Give all the queues their progress slots for a new round
+static void op_queues_refill(offloading_engine_t *engine)
+{
+    op_queue_t *queue;
+    kh_foreach_value(engine->ops_sched.queues, queue, {
+        queue->credits = queue->weight;
+    })
+}
+
+static uint64_t op_final_key(uint64_t alg_id, uint64_t id, int64_t gp_uid, int64_t group_rank)
+{
+    uint64_t tuple[4] = {alg_id, id, (uint64_t)gp_uid, (uint64_t)group_rank};
+    return HASH64_FROM_STRING((const unsigned char *)tuple, sizeof(tuple));
+}
+
+static op_final_t *op_final_lookup(offloading_engine_t *engine, uint64_t alg_id, uint64_t id, int64_t gp_uid, int64_t group_rank)
+{
+    op_final_t *final_op;
+    khiter_t k = kh_get(op_final_hash_t, engine->final_ops_hash, op_final_key(alg_id, id, gp_uid, group_rank));
+    if (k == kh_end(engine->final_ops_hash))
+        return NULL;
+    for (final_op = kh_value(engine->final_ops_hash, k); final_op != NULL; final_op = final_op->next)
+    {
+        if (final_op->alg_id == alg_id && final_op->id == id && final_op->gp_uid == gp_uid && final_op->group_rank == group_rank)
+            return final_op;
+    }
+    return NULL;
+}
+
+// Forget an operation that reached a final state
+static void op_final_remove(offloading_engine_t *engine, op_final_t *final_op)
+{
+    khiter_t k = kh_get(op_final_hash_t, engine->final_ops_hash, final_op->key);
+    assert(k != kh_end(engine->final_ops_hash));
+    if (kh_value(engine->final_ops_hash, k) == final_op)
+    {
+        if (final_op->next == NULL)
+            kh_del(op_final_hash_t, engine->final_ops_hash, k);
+        else
+            kh_value(engine->final_ops_hash, k) = final_op->next;
+    }
+    else
+    {
+        op_final_t *prev = kh_value(engine->final_ops_hash, k);
+        while (prev->next != final_op)
+        {
+            assert(prev->next);
+            prev = prev->next;
+        }
+        prev->next = final_op->next;
+    }
+    ucs_list_del(&(final_op->item));
+    free(final_op);
+}
+
+/**
+ * @brief Make an operation instantiated on the executing process active in its scheduling queue.
+ */
+static dpu_offload_status_t op_sched_add(execution_context_t *econtext, op_desc_t *op_desc)
+{
+    op_desc->queue = op_queue_get(econtext->engine, op_desc->gp_uid);
+    CHECK_ERR_RETURN((op_desc->queue == NULL), DO_ERROR, "unable to get the queue of group 0x%x", op_desc->gp_uid);
+    op_desc->queue->num_active++;
+    op_desc->queue->stats.num_ops++;
+    ucs_list_add_tail(&(econtext->active_ops), &(op_desc->item));
+    if (op_desc->gp_uid != INT_MAX)
+    {
+        // The ID of an operation that completed is reused, its messages are not late anymore
+        op_final_t *final_op = op_final_lookup(econtext->engine,
+                                               op_desc->op_definition->alg_id,
+                                               op_desc->id,
+                                               (int64_t)op_desc->gp_uid,
+                                               op_desc->group_rank);
+        if (final_op != NULL)
+            op_final_remove(econtext->engine, final_op);
+    }
+    return DO_SUCCESS;
+}
+
+// Account for an operation that reached a final state on the executing process
+static void op_sched_remove(offloading_engine_t *engine, op_desc_t *op_desc)
+{
+    op_queue_t *queue = op_desc->queue;
+
+    // Transfers the operation did not report as completed, e.g., when it failed
+    assert(engine->ops_sched.num_rma >= op_desc->num_rma);
+    engine->ops_sched.num_rma -= op_desc->num_rma;
+    op_desc->num_rma = 0;
+    if (queue == NULL)
+        return;
+    queue->num_active--;
+    switch (op_desc->state)
+    {
+    case OP_STATE_COMPLETED:
+        queue->stats.num_completed++;
+        break;
+    case OP_STATE_CANCELED:
+        queue->stats.num_canceled++;
+        break;
+    default:
+        queue->stats.num_failed++;
+        break;
+    }
+}
+
+/**
+ * @brief Get the endpoint and ID to use to notify the peer of an execution context. For servers,
+ * the peer is the client with the given ID.
+ */
+static dpu_offload_status_t get_op_peer(execution_context_t *econtext, uint64_t client_id, ucp_ep_h *ep, uint64_t *dest_id)
+{
+    switch (econtext->type)
+    {
+    case CONTEXT_CLIENT:
+        *ep = GET_SERVER_EP(econtext);
+        *dest_id = econtext->client->server_id;
+        break;
+    case CONTEXT_SERVER:
+        *ep = GET_CLIENT_EP(econtext, client_id);
+        *dest_id = client_id;
+        if (*ep == NULL)
+            return DO_NOT_APPLICABLE;
+        break;
+    case CONTEXT_SELF:
+        *ep = NULL;
+        *dest_id = 0;
+        break;
+    default:
+        return DO_ERROR;
+    }
+    return DO_SUCCESS;
+}
+
+static dpu_offload_status_t op_emit(execution_context_t *econtext, uint64_t client_id, uint64_t type, void *payload, size_t payload_size)
+{
+    dpu_offload_event_info_t ev_info;
+    dpu_offload_event_t *ev = NULL;
+    dpu_offload_status_t rc;
+    uint64_t dest_id;
+    ucp_ep_h ep;
+    int ret;
+
+    rc = get_op_peer(econtext, client_id, &ep, &dest_id);
+    if (rc != DO_SUCCESS)
+        return rc;
+
+    RESET_EVENT_INFO(&ev_info);
+    ev_info.payload_size = payload_size;
+    rc = event_get(econtext->event_channels, &ev_info, &ev);
+    CHECK_ERR_RETURN((rc), DO_ERROR, "event_get() failed");
+    memcpy(ev->payload, payload, payload_size);
+    ret = event_channel_emit(&ev, type, ep, dest_id, NULL);
+    CHECK_ERR_RETURN((ret != EVENT_DONE && ret != EVENT_INPROGRESS), DO_ERROR, "event_channel_emit() failed");
+    return DO_SUCCESS;
+}
 
 dpu_offload_status_t register_new_op(offloading_engine_t *engine, offload_op_t *op, uint64_t *op_id)
 {
+    offload_op_t **slot;
+    offload_op_t *new_op;
     CHECK_ERR_RETURN((engine == NULL), DO_ERROR, "engine is undefined");
     CHECK_ERR_RETURN((op == NULL), DO_ERROR, "operation is undefined");
     CHECK_ERR_RETURN((op_id == NULL), DO_ERROR, "op id is undefined");
+    CHECK_ERR_RETURN((lookup_op_by_alg_id(engine, op->alg_id) != NULL),
+                     DO_ERROR,
+                     "an operation is already registered for algorithm %" PRIu64, op->alg_id);
 
-    int slot = engine->num_registered_ops;
-    engine->registered_ops[slot].alg_id = op->alg_id;
-    engine->registered_ops[slot].alg_data = op->alg_data;
-    engine->registered_ops[slot].op_complete = op->op_complete;
-    engine->registered_ops[slot].op_fini = op->op_fini;
-    engine->registered_ops[slot].op_init = op->op_init;
-    engine->registered_ops[slot].op_progress = op->op_progress;
+    // Descriptors point at the registration so it is allocated separately from the array, which may grow
+    new_op = DPU_OFFLOAD_MALLOC(sizeof(offload_op_t));
+    CHECK_ERR_RETURN((new_op == NULL), DO_ERROR, "unable to allocate operation");
+    memcpy(new_op, op, sizeof(offload_op_t));
+    slot = DYN_ARRAY_GET_ELT(&(engine->registered_ops), engine->num_registered_ops, offload_op_t *);
+    *slot = new_op;
+    *op_id = (uint64_t)engine->num_registered_ops;
     engine->num_registered_ops++;
-    *op_id = (uint64_t)slot;
     return DO_SUCCESS;
 }
 
+dpu_offload_status_t get_op_id_by_alg_id(offloading_engine_t *engine, uint64_t alg_id, uint64_t *op_id)
+{
+    size_t i;
+    CHECK_ERR_RETURN((engine == NULL), DO_ERROR, "engine is undefined");
+    CHECK_ERR_RETURN((op_id == NULL), DO_ERROR, "op id is undefined");
+    for (i = 0; i < engine->num_registered_ops; i++)
+    {
+        offload_op_t **op = DYN_ARRAY_GET_ELT(&(engine->registered_ops), i, offload_op_t *);
+        if ((*op)->alg_id == alg_id)
+        {
+            *op_id = (uint64_t)i;
+            return DO_SUCCESS;
+        }
+    }
+    return DO_NOT_APPLICABLE;
+}
+
 dpu_offload_status_t op_desc_get(offloading_engine_t *engine, const uint64_t id, uint64_t op_id, op_desc_t **desc)
 {
+    offload_op_t **op;
+    op_desc_t *d;
     CHECK_ERR_RETURN((engine == NULL), DO_ERROR, "engine is undefined");
     CHECK_ERR_RETURN((op_id >= engine->num_registered_ops), DO_ERROR, "invalid operation id");
     CHECK_ERR_RETURN((desc == NULL), DO_ERROR, "invalid operation descriptor handle");
 
-    op_desc_t *d;
+    op = DYN_ARRAY_GET_ELT(&(engine->registered_ops), op_id, offload_op_t *);
     DYN_LIST_GET(engine->free_op_descs, op_desc_t, item, d);
+    CHECK_ERR_RETURN((d == NULL), DO_ERROR, "unable to get a free operation descriptor");
+    RESET_OP_DESC(d);
     d->id = id;
+    d->op_definition = *op;
     *desc = d;
     return DO_SUCCESS;
 }
 
+dpu_offload_status_t op_desc_add_buffer(op_desc_t *desc, op_buffer_type_t type, void *addr, size_t len)
+{
+    CHECK_ERR_RETURN((desc == NULL), DO_ERROR, "undefined operation descriptor");
+    CHECK_ERR_RETURN((desc->state != OP_STATE_INIT), DO_ERROR, "operation %" PRIu64 " is already submitted", desc->id);
+    if (type == OP_BUFFER_INPUT)
+    {
+        CHECK_ERR_RETURN((desc->num_inputs >= OP_MAX_BUFFERS), DO_ERROR, "too many input buffers");
+        desc->inputs[desc->num_inputs].addr = (uint64_t)(uintptr_t)addr;
+        desc->inputs[desc->num_inputs].len = (uint64_t)len;
+        desc->num_inputs++;
+    }
+    else
+    {
+        CHECK_ERR_RETURN((desc->num_outputs >= OP_MAX_BUFFERS), DO_ERROR, "too many output buffers");
+        desc->outputs[desc->num_outputs].addr = (uint64_t)(uintptr_t)addr;
+        desc->outputs[desc->num_outputs].len = (uint64_t)len;
+        desc->num_outputs++;
+    }
+    return DO_SUCCESS;
+}
+
 dpu_offload_status_t op_desc_submit(execution_context_t *econtext, op_desc_t *desc)
 {
-    CHECK_ERR_RETURN((econtext == NULL), DO_ERROR, "undefined execution context");
+    dpu_offload_event_info_t ev_info;
+    dpu_offload_event_t *start_ev = NULL;
+    op_start_msg_t *msg;
+    op_buffer_t *buffers;
+    dpu_offload_status_t rc;
+    uint64_t dest_id;
+    ucp_ep_h peer_ep;
+    int ret;
 
-    // Note: no need to register an notification handler for operation completion, we get one by default
+    CHECK_ERR_RETURN((econtext == NULL), DO_ERROR, "undefined execution context");
+    CHECK_ERR_RETURN((desc == NULL), DO_ERROR, "undefined operation descriptor");
+    CHECK_ERR_RETURN((desc->state != OP_STATE_INIT), DO_ERROR, "operation %" PRIu64 " is already submitted", desc->id);
+    // fixme: at the moment only clients can start an offload op on the DPU, so client->server
+    CHECK_ERR_RETURN((econtext->type == CONTEXT_SERVER), DO_ERROR, "operations cannot be submitted from a server");
+    rc = get_op_peer(econtext, UINT64_MAX, &peer_ep, &dest_id);
+    CHECK_ERR_RETURN((rc != DO_SUCCESS), DO_ERROR, "unable to get the peer to submit operation %" PRIu64 " to", desc->id);
 
-    // Send the submit command to the DPU
-    dpu_offload_event_t *start_ev;
-    int rc = event_get(econtext->event_channels, NULL, &start_ev);
-    CHECK_ERR_RETURN((rc != 0 || start_ev == NULL), DO_ERROR, "unable to get event to start the operation");
+    // The start notification is built directly in the payload of the event
+    RESET_EVENT_INFO(&ev_info);
+    ev_info.payload_size = sizeof(op_start_msg_t) + (desc->num_inputs + desc->num_outputs) * sizeof(op_buffer_t) + desc->args_len;
+    rc = event_get(econtext->event_channels, &ev_info, &start_ev);
+    CHECK_ERR_RETURN((rc != DO_SUCCESS || start_ev == NULL), DO_ERROR, "unable to get event to start the operation");
+    msg = (op_start_msg_t *)start_ev->payload;
+    msg->alg_id = desc->op_definition->alg_id;
+    msg->id = desc->id;
+    msg->gp_uid = (int64_t)desc->gp_uid;
+    msg->group_rank = desc->group_rank;
+    msg->num_inputs = desc->num_inputs;
+    msg->num_outputs = desc->num_outputs;
+    msg->args_len = desc->args_len;
+    msg->priority = (uint64_t)desc->priority;
+    buffers = (op_buffer_t *)(msg + 1);
+    memcpy(buffers, desc->inputs, desc->num_inputs * sizeof(op_buffer_t));
+    memcpy(&(buffers[desc->num_inputs]), desc->outputs, desc->num_outputs * sizeof(op_buffer_t));
+    if (desc->args_len > 0)
+        memcpy(&(buffers[desc->num_inputs + desc->num_outputs]), desc->args, desc->args_len);
 
     // Add the descriptor to the local list of active operations.
     // The list is used by the notification handler so it needs to happen before
-    // the event is emited.
+    // the event is emited, self notifications being delivered right away.
+    desc->econtext = econtext;
+    desc->executor = false;
+    desc->state = OP_STATE_SUBMITTED;
     ucs_list_add_tail(&(econtext->active_ops), &(desc->item));
 
-    // Everything is now all set, emit the event associated to the notification
-    void *ev_data = &(desc->id);
-    size_t ev_data_len = sizeof(desc->id);
-    ucp_ep_h peer_ep;
-    uint64_t dest_id;
-    if (econtext->type == CONTEXT_CLIENT)
+    ret = event_channel_emit(&start_ev, AM_OP_START_MSG_ID, peer_ep, dest_id, desc);
+    if (ret != EVENT_DONE && ret != EVENT_INPROGRESS)
     {
-        peer_ep = GET_SERVER_EP(econtext);
-        dest_id = econtext->client->server_id;
+        ERR_MSG("unable to emit the start notification of operation %" PRIu64, desc->id);
+        event_return(&start_ev);
+        ucs_list_del(&(desc->item));
+        desc->state = OP_STATE_INIT;
+        return DO_ERROR;
     }
-    else
+    return DO_SUCCESS;
+}
+
+dpu_offload_status_t op_desc_cancel(execution_context_t *econtext, op_desc_t *desc)
+{
+    op_cancel_msg_t msg;
+    dpu_offload_status_t rc;
+
+    CHECK_ERR_RETURN((econtext == NULL), DO_ERROR, "undefined execution context");
+    CHECK_ERR_RETURN((desc == NULL), DO_ERROR, "undefined operation descriptor");
+    CHECK_ERR_RETURN((desc->executor), DO_ERROR, "operations can only be canceled by the process that submitted them");
+
+    if (OP_STATE_IS_FINAL(desc->state) || desc->cancel_requested)
+        return DO_SUCCESS;
+    if (desc->state == OP_STATE_INIT)
     {
-        // fixme: at the moment only clients can start a offload op on the DPU, so client->server
-        peer_ep = NULL;
-        dest_id = UINT64_MAX;
+        desc->state = OP_STATE_CANCELED;
+        desc->completed = true;
+        return DO_SUCCESS;
     }
-    rc = event_channel_emit_with_payload(&start_ev, AM_OP_START_MSG_ID, peer_ep, dest_id, desc, ev_data, ev_data_len);
-    CHECK_ERR_GOTO((rc != EVENT_DONE && rc != EVENT_INPROGRESS), error_out, "event_channel_emit_with_payload() failed");
 
+    // The descriptor reaches its final state when the completion notification is received, the
+    // operation may still complete normally if it cannot be interrupted.
+    msg.id = desc->id;
+    msg.gp_uid = (int64_t)desc->gp_uid;
+    msg.group_rank = desc->group_rank;
+    rc = op_emit(econtext, UINT64_MAX, AM_OP_CANCEL_MSG_ID, &msg, sizeof(msg));
+    CHECK_ERR_RETURN((rc != DO_SUCCESS), DO_ERROR, "unable to emit the cancel notification of operation %" PRIu64, desc->id);
+    desc->cancel_requested = true;
     return DO_SUCCESS;
-
-error_out:
-    fprintf(stderr, "%s l.%d returning event\n", __FILE__, __LINE__);
-    event_return(&start_ev);
-    return DO_ERROR;
 }
 
 dpu_offload_status_t op_desc_return(offloading_engine_t *engine, op_desc_t **desc)
 {
+    CHECK_ERR_RETURN((engine == NULL), DO_ERROR, "engine is undefined");
+    CHECK_ERR_RETURN((desc == NULL || *desc == NULL), DO_ERROR, "undefined operation descriptor");
+    CHECK_ERR_RETURN(((*desc)->state != OP_STATE_INIT && !OP_STATE_IS_FINAL((*desc)->state)),
+                     DO_ERROR,
+                     "operation %" PRIu64 " is still active",
+                     (*desc)->id);
+    if ((*desc)->executor && (*desc)->args != NULL)
+        free((*desc)->args);
+    RESET_OP_DESC(*desc);
     DYN_LIST_RETURN(engine->free_op_descs, (*desc), item);
     *desc = NULL;
     return DO_SUCCESS;
 }
 
+dpu_offload_status_t handle_op_start_msg(execution_context_t *econtext, uint64_t origin_id, void *data, size_t data_len)
+{
+    op_start_msg_t *msg = (op_start_msg_t *)data;
+    op_buffer_t *buffers;
+    offload_op_t *op_cfg;
+    op_desc_t *op_desc;
+
+    CHECK_ERR_RETURN((data_len < sizeof(op_start_msg_t)), DO_ERROR, "invalid start notification");
+    CHECK_ERR_RETURN((msg->num_inputs > OP_MAX_BUFFERS || msg->num_outputs > OP_MAX_BUFFERS || msg->priority >= OP_NUM_PRIORITIES ||
+                      data_len != sizeof(op_start_msg_t) + (msg->num_inputs + msg->num_outputs) * sizeof(op_buffer_t) + msg->args_len),
+                     DO_ERROR,
+                     "invalid start notification for operation %" PRIu64, msg->id);
+
+    // Find the operation in the list of registered operations
+    op_cfg = lookup_op_by_alg_id(econtext->engine, msg->alg_id);
+    CHECK_ERR_RETURN((op_cfg == NULL), DO_ERROR, "unable to find a matching registered function for algorithm %" PRIu64, msg->alg_id);
+
+    // Instantiate the operation, it is started the next time the execution context is progressed
+    DYN_LIST_GET(econtext->engine->free_op_descs, op_desc_t, item, op_desc);
+    CHECK_ERR_RETURN((op_desc == NULL), DO_ERROR, "unable to get a free operation descriptor");
+    RESET_OP_DESC(op_desc);
+    op_desc->id = msg->id;
+    op_desc->op_definition = op_cfg;
+    op_desc->econtext = econtext;
+    op_desc->executor = true;
+    op_desc->origin_id = origin_id;
+    op_desc->gp_uid = (group_uid_t)msg->gp_uid;
+    op_desc->group_rank = msg->group_rank;
+    op_desc->priority = (op_priority_t)msg->priority;
+    op_desc->num_inputs = msg->num_inputs;
+    op_desc->num_outputs = msg->num_outputs;
+    buffers = (op_buffer_t *)(msg + 1);
+    memcpy(op_desc->inputs, buffers, msg->num_inputs * sizeof(op_buffer_t));
+    memcpy(op_desc->outputs, &(buffers[msg->num_inputs]), msg->num_outputs * sizeof(op_buffer_t));
+    if (msg->args_len > 0)
+    {
+        op_desc->args = DPU_OFFLOAD_MALLOC(msg->args_len);
+        if (op_desc->args == NULL)
+        {
+            ERR_MSG("unable to allocate the arguments of operation %" PRIu64, msg->id);
+            DYN_LIST_RETURN(econtext->engine->free_op_descs, op_desc, item);
+            return DO_ERROR;
+        }
+        memcpy(op_desc->args, &(buffers[msg->num_inputs + msg->num_outputs]), msg->args_len);
+        op_desc->args_len = msg->args_len;
+    }
+    op_desc->state = OP_STATE_SUBMITTED;
+    if (op_sched_add(econtext, op_desc) != DO_SUCCESS)
+    {
+        if (op_desc->args != NULL)
+            free(op_desc->args);
+        DYN_LIST_RETURN(econtext->engine->free_op_descs, op_desc, item);
+        return DO_ERROR;
+    }
+    return DO_SUCCESS;
+}
+
+dpu_offload_status_t handle_op_cancel_msg(execution_context_t *econtext, uint64_t origin_id, void *data, size_t data_len)
+{
+    op_cancel_msg_t *msg = (op_cancel_msg_t *)data;
+    op_desc_t *op;
+
+    CHECK_ERR_RETURN((data_len != sizeof(op_cancel_msg_t)), DO_ERROR, "invalid cancel notification");
+    op = lookup_active_op(econtext, true, origin_id, msg->id, msg->gp_uid, msg->group_rank);
+    if (op == NULL)
+    {
+        // The operation completed in the meantime, its completion notification is on its way
+        DBG("Cancel request for operation %" PRIu64 " that is not active, ignoring it", msg->id);
+        return DO_SUCCESS;
+    }
+    op->cancel_requested = true;
+    return DO_SUCCESS;
+}
+
+dpu_offload_status_t handle_op_completion_msg(execution_context_t *econtext, void *data, size_t data_len)
+{
+    op_completion_msg_t *msg = (op_completion_msg_t *)data;
+    op_desc_t *op;
+
+    CHECK_ERR_RETURN((data_len != sizeof(op_completion_msg_t)), DO_ERROR, "invalid completion notification");
+    op = lookup_active_op(econtext, false, UINT64_MAX, msg->id, msg->gp_uid, msg->group_rank);
+    if (op == NULL)
+    {
+        // E.g., the client resumed the slot of a previous process that submitted the operation
+        DBG("Completion of unknown operation %" PRIu64 ", dropping it", msg->id);
+        return DO_SUCCESS;
+    }
+
+    ucs_list_del(&(op->item));
+    op->state = (op_state_t)msg->state;
+    op->status = (dpu_offload_status_t)msg->status;
+    op->completed = true;
+    if (op->op_definition->op_complete != NULL)
+        op->op_definition->op_complete(op);
+    if (op->completion_cb != NULL)
+        op->completion_cb(op, op->completion_ctx);
+    return DO_SUCCESS;
+}
+
+static op_pending_msg_t *op_pending_msg_create(op_sp_msg_hdr_t *hdr, void *data)
+{
+    op_pending_msg_t *msg = DPU_OFFLOAD_MALLOC(sizeof(op_pending_msg_t) + hdr->len);
+    if (msg == NULL)
+        return NULL;
+    memcpy(&(msg->hdr), hdr, sizeof(op_sp_msg_hdr_t));
+    msg->ts = monotonic_time_us();
+    msg->data = (void *)(msg + 1);
+    if (hdr->len > 0)
+        memcpy(msg->data, data, hdr->len);
+    return msg;
+}
+
+dpu_offload_status_t op_send_to_sp(op_desc_t *desc, uint64_t sp_gid, int64_t dst_rank, void *data, size_t len)
+{
+    offloading_engine_t *engine;
+    op_sp_msg_hdr_t *hdr;
+    dpu_offload_status_t rc;
+
+    CHECK_ERR_RETURN((desc == NULL || desc->econtext == NULL), DO_ERROR, "undefined operation descriptor");
+    engine = desc->econtext->engine;
+    CHECK_ERR_RETURN((!engine->on_dpu), DO_ERROR, "not on a service process");
+
+    if (sp_gid == engine->config->local_service_proc.info.global_id)
+    {
+        // Operation of a rank associated to the local service process, no need to go through the network
+        op_sp_msg_hdr_t local_hdr = {
+            .alg_id = desc->op_definition->alg_id,
+            .id = desc->id,
+            .gp_uid = (int64_t)desc->gp_uid,
+            .dst_rank = dst_rank,
+            .len = (uint64_t)len,
+        };
+        op_pending_msg_t *msg = op_pending_msg_create(&local_hdr, data);
+        CHECK_ERR_RETURN((msg == NULL), DO_ERROR, "unable to allocate message");
+        ucs_list_add_tail(&(engine->pending_op_msgs), &(msg->item));
+        return DO_SUCCESS;
+    }
+
+    hdr = DPU_OFFLOAD_MALLOC(sizeof(op_sp_msg_hdr_t) + len);
+    CHECK_ERR_RETURN((hdr == NULL), DO_ERROR, "unable to allocate message");
+    hdr->alg_id = desc->op_definition->alg_id;
+    hdr->id = desc->id;
+    hdr->gp_uid = (int64_t)desc->gp_uid;
+    hdr->dst_rank = dst_rank;
+    hdr->len = (uint64_t)len;
+    if (len > 0)
+        memcpy(hdr + 1, data, len);
+    rc = send_notif_to_sp(engine, sp_gid, AM_OP_SP_MSG_ID, hdr, sizeof(op_sp_msg_hdr_t) + len);
+    free(hdr);
+    CHECK_ERR_RETURN((rc != DO_SUCCESS), DO_ERROR, "send_notif_to_sp() failed");
+    return DO_SUCCESS;
+}
+
+dpu_offload_status_t handle_op_sp_msg(offloading_engine_t *engine, void *data, size_t data_len)
+{
+    op_sp_msg_hdr_t *hdr = (op_sp_msg_hdr_t *)data;
+    op_pending_msg_t *msg;
+
+    CHECK_ERR_RETURN((data_len < sizeof(op_sp_msg_hdr_t) || data_len != sizeof(op_sp_msg_hdr_t) + hdr->len),
+                     DO_ERROR,
+                     "invalid operation message");
+    // The operation may be executed by any server of the engine and not be started yet, the message is
+    // delivered while progressing the active operations
+    msg = op_pending_msg_create(hdr, hdr + 1);
+    CHECK_ERR_RETURN((msg == NULL), DO_ERROR, "unable to allocate message");
+    ucs_list_add_tail(&(engine->pending_op_msgs), &(msg->item));
+    return DO_SUCCESS;
+}
+
+void op_pending_msgs_fini(offloading_engine_t *engine)
+{
+    op_pending_msg_t *msg, *next_msg;
+    op_final_t *final_op, *next_final_op;
+    ucs_list_for_each_safe(msg, next_msg, &(engine->pending_op_msgs), item)
+    {
+        ucs_list_del(&(msg->item));
+        free(msg);
+    }
+    ucs_list_for_each_safe(final_op, next_final_op, &(engine->final_ops), item)
+    {
+        ucs_list_del(&(final_op->item));
+        free(final_op);
+    }
+    if (engine->final_ops_hash != NULL)
+    {
+        kh_destroy(op_final_hash_t, engine->final_ops_hash);
+        engine->final_ops_hash = NULL;
+    }
+}
+
+/**
+ * @brief Remember that a collective operation reached a final state: the messages pending for it are
+ * released and the ones received later are dropped, they would otherwise never be delivered or start
+ * the operation again when it is implicit.
+ */
+static void op_final_add(offloading_engine_t *engine, op_desc_t *op)
+{
+    op_pending_msg_t *msg, *next_msg;
+    op_final_t *final_op;
+    uint64_t alg_id = op->op_definition->alg_id;
+
+    if (op->gp_uid == INT_MAX)
+        return; // Not a collective, no message can be sent to it
+    ucs_list_for_each_safe(msg, next_msg, &(engine->pending_op_msgs), item)
+    {
+        if (msg->hdr.alg_id == alg_id &&
+            msg->hdr.id == op->id &&
+            msg->hdr.gp_uid == (int64_t)op->gp_uid &&
+            msg->hdr.dst_rank == op->group_rank)
+        {
+            DBG("Dropping a message of operation %" PRIu64 " that reached a final state", op->id);
+            ucs_list_del(&(msg->item));
+            free(msg);
+        }
+    }
+
+    final_op = op_final_lookup(engine, alg_id, op->id, (int64_t)op->gp_uid, op->group_rank);
+    if (final_op == NULL)
+    {
+        khiter_t k;
+        int ret;
+        final_op = DPU_OFFLOAD_MALLOC(sizeof(op_final_t));
+        if (final_op == NULL)
+        {
+            WARN_MSG("unable to allocate memory, late messages of operation %" PRIu64 " will be dropped once they time out", op->id);
+            return;
+        }
+        final_op->alg_id = alg_id;
+        final_op->id = op->id;
+        final_op->gp_uid = (int64_t)op->gp_uid;
+        final_op->group_rank = op->group_rank;
+        final_op->key = op_final_key(alg_id, op->id, final_op->gp_uid, final_op->group_rank);
+        final_op->next = NULL;
+        k = kh_put(op_final_hash_t, engine->final_ops_hash, final_op->key, &ret);
+        if (ret == -1)
+        {
+            free(final_op);
+            WARN_MSG("unable to allocate memory, late messages of operation %" PRIu64 " will be dropped once they time out", op->id);
+            return;
+        }
+        if (ret == 0)
+        {
+            // Hash collision, chain the new record
+            final_op->next = kh_value(engine->final_ops_hash, k);
+        }
+        kh_value(engine->final_ops_hash, k) = final_op;
+    }
+    else
+        ucs_list_del(&(final_op->item));
+    // The list is sorted by time so the records expire from its head
+    final_op->ts = monotonic_time_us();
+    ucs_list_add_tail(&(engine->final_ops), &(final_op->item));
+}
+
+// Forget the operations that reached a final state longer than MIMOSA_OP_MSG_TIMEOUT ago
+static void op_final_expire(offloading_engine_t *engine, uint64_t now)
+{
+    op_final_t *final_op, *next_final_op;
+    uint64_t timeout = engine->settings.op_msg_timeout * 1000;
+
+    if (timeout == 0)
+        return;
+    ucs_list_for_each_safe(final_op, next_final_op, &(engine->final_ops), item)
+    {
+        if (now - final_op->ts < timeout)
+            break;
+        op_final_remove(engine, final_op);
+    }
+}
+
+/**
+ * @brief Instantiate an implicit operation on the self execution context for a message that does not
+ * match any active operation. The message stays pending until the operation is running.
+ */
+static void start_implicit_op(execution_context_t *econtext, op_pending_msg_t *msg)
+{
+    offload_op_t *op_cfg;
+    op_desc_t *op_desc;
+
+    if (econtext != econtext->engine->self_econtext)
+        return;
+    op_cfg = lookup_op_by_alg_id(econtext->engine, msg->hdr.alg_id);
+    if (op_cfg == NULL || !op_cfg->implicit)
+        return;
+
+    DYN_LIST_GET(econtext->engine->free_op_descs, op_desc_t, item, op_desc);
+    if (op_desc == NULL)
+    {
+        ERR_MSG("unable to get a free operation descriptor");
+        return;
+    }
+    RESET_OP_DESC(op_desc);
+    op_desc->id = msg->hdr.id;
+    op_desc->op_definition = op_cfg;
+    op_desc->econtext = econtext;
+    op_desc->executor = true;
+    op_desc->implicit = true;
+    op_desc->gp_uid = (group_uid_t)msg->hdr.gp_uid;
+    op_desc->group_rank = msg->hdr.dst_rank;
+    op_desc->state = OP_STATE_SUBMITTED;
+    if (op_sched_add(econtext, op_desc) != DO_SUCCESS)
+        DYN_LIST_RETURN(econtext->engine->free_op_descs, op_desc, item);
+}
+
+static void deliver_pending_op_msgs(execution_context_t *econtext)
+{
+    offloading_engine_t *engine = econtext->engine;
+    uint64_t timeout = engine->settings.op_msg_timeout * 1000;
+    uint64_t now = monotonic_time_us();
+    op_pending_msg_t *msg, *next_msg;
+
+    ucs_list_for_each_safe(msg, next_msg, &(engine->pending_op_msgs), item)
+    {
+        op_desc_t *op;
+        ucs_list_for_each(op, &(econtext->active_ops), item)
+        {
+            if (op->executor &&
+                op->id == msg->hdr.id &&
+                op->op_definition->alg_id == msg->hdr.alg_id &&
+                (int64_t)op->gp_uid == msg->hdr.gp_uid &&
+                op->group_rank == msg->hdr.dst_rank)
+                break;
+        }
+        if (&(op->item) == &(econtext->active_ops))
+        {
+            if (op_final_lookup(engine, msg->hdr.alg_id, msg->hdr.id, msg->hdr.gp_uid, msg->hdr.dst_rank) != NULL)
+            {
+                // Late message, e.g., of an operation that was canceled or failed
+                DBG("Dropping a message of operation %" PRIu64 " that reached a final state", msg->hdr.id);
+                ucs_list_del(&(msg->item));
+                free(msg);
+                continue;
+            }
+            if (timeout > 0 && now - msg->ts >= timeout)
+            {
+                WARN_MSG("no operation %" PRIu64 " for rank %" PRId64 " of group 0x%x after %" PRIu64 "ms, dropping its message",
+                         msg->hdr.id, msg->hdr.dst_rank, (group_uid_t)msg->hdr.gp_uid, engine->settings.op_msg_timeout);
+                ucs_list_del(&(msg->item));
+                free(msg);
+                continue;
+            }
+            // Not for an operation of this execution context, unless it is started by the message
+            start_implicit_op(econtext, msg);
+            continue;
+        }
+        if (op->state != OP_STATE_RUNNING)
+            continue; // Not started yet
+
+        ucs_list_del(&(msg->item));
+        if (op->op_definition->op_recv != NULL)
+        {
+            dpu_offload_status_t rc = op->op_definition->op_recv(op, msg->data, msg->hdr.len);
+            if (rc != DO_SUCCESS)
+            {
+                ERR_MSG("operation %" PRIu64 " failed to handle a message", op->id);
+                op->state = OP_STATE_FAILED;
+                op->status = rc;
+            }
+        }
+        free(msg);
+    }
+}
+
+/**
+ * @brief Move an operation executed by the local process forward in its state machine.
+ *
+ * @return true if the operation reached a final state
+ */
+static bool progress_op(execution_context_t *econtext, op_desc_t *op)
+{
+    offload_op_t *def = op->op_definition;
+    dpu_offload_status_t rc;
+    bool done = false;
+
+    if (op->state == OP_STATE_FAILED)
+        return true; // A message of the operation could not be handled
+
+    // Operations of a client that disconnected since are canceled, nobody is waiting for them anymore
+    if (econtext->type == CONTEXT_SERVER && GET_CLIENT_INFO(econtext, op->origin_id) == NULL)
+        op->cancel_requested = true;
+
+    if (op->state == OP_STATE_SUBMITTED)
+    {
+        if (op->cancel_requested)
+        {
+            op->state = OP_STATE_CANCELED;
+            return true;
+        }
+        if (def->op_init != NULL)
+        {
+            rc = def->op_init(op);
+            if (rc != DO_SUCCESS)
+            {
+                ERR_MSG("initialization of operation %" PRIu64 " (algorithm %" PRIu64 ") failed", op->id, def->alg_id);
+                op->state = OP_STATE_FAILED;
+                op->status = rc;
+                return true;
+            }
+        }
+        op->started = true;
+        op->state = OP_STATE_RUNNING;
+    }
+
+    assert(op->state == OP_STATE_RUNNING);
+    if (op->cancel_requested && def->op_cancel != NULL)
+    {
+        rc = def->op_cancel(op);
+        if (rc == DO_SUCCESS)
+        {
+            op->state = OP_STATE_CANCELED;
+            return true;
+        }
+        if (rc != DO_NOT_APPLICABLE)
+        {
+            op->state = OP_STATE_FAILED;
+            op->status = rc;
+            return true;
+        }
+        // The operation cannot be interrupted, it completes normally
+        op->cancel_requested = false;
+    }
+
+    if (def->op_progress == NULL)
+    {
+        op->state = OP_STATE_COMPLETED;
+        return true;
+    }
+    rc = def->op_progress(op, &done);
+    if (rc != DO_SUCCESS)
+    {
+        ERR_MSG("operation %" PRIu64 " (algorithm %" PRIu64 ") failed", op->id, def->alg_id);
+        op->state = OP_STATE_FAILED;
+        op->status = rc;
+        return true;
+    }
+    if (done)
+        op->state = OP_STATE_COMPLETED;
+    return done;
+}
+
+/**
+ * @brief Progress the operations of a given priority executed on an execution context, each of them at
+ * most once. Progressing an operation uses a slot of its queue and the slots are refilled once the
+ * operations left all belong to queues without slots, so queues progress operations in proportion to
+ * their weight. Operations that are progressed and not done move to the end of the list so the next
+ * progress call starts with the ones that were not progressed when the time budget is exhausted.
+ *
+ * @return false if the time budget is exhausted
+ */
+static bool progress_ops_by_priority(execution_context_t *econtext, op_priority_t priority, uint64_t deadline, ucs_list_link_t *done_ops)
+{
+    offloading_engine_t *engine = econtext->engine;
+    uint64_t seq = engine->ops_sched.seq;
+    op_desc_t *cur_op, *next_op;
+    bool waiting;
+
+    do
+    {
+        waiting = false;
+        ucs_list_for_each_safe(cur_op, next_op, &(econtext->active_ops), item)
+        {
+            uint64_t start;
+            bool done;
+
+            if (!cur_op->executor || cur_op->priority != priority || cur_op->sched_seq == seq)
+                continue; // Executed remotely, of another priority or already progressed
+            assert(cur_op->queue);
+            if (cur_op->queue->credits == 0)
+            {
+                waiting = true;
+                continue;
+            }
+            start = monotonic_time_ns();
+            if (deadline != 0 && start >= deadline)
+                return false;
+            cur_op->queue->credits--;
+            cur_op->sched_seq = seq;
+            done = progress_op(econtext, cur_op);
+            cur_op->queue->stats.num_progress++;
+            cur_op->queue->stats.progress_time += monotonic_time_ns() - start;
+            ucs_list_del(&(cur_op->item));
+            ucs_list_add_tail(done ? done_ops : &(econtext->active_ops), &(cur_op->item));
+        }
+        // The operations left wait for queues that used all their slots, start a new round
+        if (waiting)
+            op_queues_refill(engine);
+    } while (waiting);
+    return true;
+}
+
 // This is function assumes the execution context is properly locked before it is invoked
 dpu_offload_status_t progress_active_ops(execution_context_t *econtext)
 {
     CHECK_ERR_RETURN((econtext == NULL), DO_ERROR, "undefined execution context");
+    offloading_engine_t *engine = econtext->engine;
     op_desc_t *cur_op, *next_op;
-    ucs_list_for_each_safe(cur_op, next_op, &(econtext->active_ops), item)
+    ucs_list_link_t done_ops;
+    dpu_offload_status_t rc = DO_SUCCESS;
+    uint64_t deadline = 0;
+    int priority;
+
+    // Operations reaching a final state are moved to a separate list before notifying the submitter:
+    // self notifications are delivered right away and would modify the list while it is traversed.
+    ucs_list_head_init(&done_ops);
+    if (!ucs_list_is_empty(&(engine->final_ops)))
+        op_final_expire(engine, monotonic_time_us());
+    if (!ucs_list_is_empty(&(engine->pending_op_msgs)))
+        deliver_pending_op_msgs(econtext);
+    if (ucs_list_is_empty(&(econtext->active_ops)))
+        return DO_SUCCESS;
+
+    engine->ops_sched.seq++;
+    if (engine->settings.ops_progress_budget > 0)
+        deadline = monotonic_time_ns() + engine->settings.ops_progress_budget * 1000;
+    for (priority = OP_NUM_PRIORITIES - 1; priority >= 0; priority--)
+    {
+        if (!progress_ops_by_priority(econtext, (op_priority_t)priority, deadline, &done_ops))
+        {
+            ucs_list_for_each(cur_op, &(econtext->active_ops), item)
+            {
+                if (cur_op->executor && cur_op->sched_seq != engine->ops_sched.seq)
+                    cur_op->queue->stats.num_deferred++;
+            }
+            break;
+        }
+    }
+
+    ucs_list_for_each_safe(cur_op, next_op, &done_ops, item)
+    {
+        op_completion_msg_t msg;
+        dpu_offload_status_t ret;
+
+        ucs_list_del(&(cur_op->item));
+        msg.id = cur_op->id;
+        msg.gp_uid = (int64_t)cur_op->gp_uid;
+        msg.group_rank = cur_op->group_rank;
+        msg.state = (uint64_t)cur_op->state;
+        msg.status = (int64_t)cur_op->status;
+        // Implicit operations were not submitted by anyone, nobody is waiting for them
+        ret = cur_op->implicit ? DO_SUCCESS : op_emit(econtext, cur_op->origin_id, AM_OP_COMPLETION_MSG_ID, &msg, sizeof(msg));
+        if (ret == DO_NOT_APPLICABLE)
+            DBG("Client %" PRIu64 " of operation %" PRIu64 " is gone, dropping its completion", cur_op->origin_id, cur_op->id);
+        else if (ret != DO_SUCCESS)
+        {
+            ERR_MSG("unable to notify the completion of operation %" PRIu64, cur_op->id);
+            rc = DO_ERROR;
+        }
+        if (cur_op->started && cur_op->op_definition->op_fini != NULL)
+            cur_op->op_definition->op_fini(cur_op);
+        op_final_add(engine, cur_op);
+        op_sched_remove(engine, cur_op);
+        op_desc_return(engine, &cur_op);
+    }
+    return rc;
+}
+
+bool op_rma_acquire(op_desc_t *desc)
+{
+    offloading_engine_t *engine = desc->econtext->engine;
+    if (engine->settings.ops_max_rma > 0 && engine->ops_sched.num_rma >= engine->settings.ops_max_rma)
     {
-        if (cur_op->op_definition->op_progress != NULL)
-            cur_op->op_definition->op_progress();
+        if (desc->queue != NULL)
+            desc->queue->stats.num_rma_throttled++;
+        return false;
     }
+    engine->ops_sched.num_rma++;
+    desc->num_rma++;
+    if (desc->queue != NULL)
+        desc->queue->stats.num_rma++;
+    return true;
+}
+
+void op_rma_release(op_desc_t *desc)
+{
+    offloading_engine_t *engine = desc->econtext->engine;
+    assert(desc->num_rma > 0);
+    assert(engine->ops_sched.num_rma > 0);
+    desc->num_rma--;
+    engine->ops_sched.num_rma--;
+}
+
+dpu_offload_status_t op_queue_set_weight(offloading_engine_t *engine, group_uid_t gp_uid, uint64_t weight)
+{
+    op_queue_t *queue;
+    CHECK_ERR_RETURN((engine == NULL), DO_ERROR, "engine is undefined");
+    CHECK_ERR_RETURN((weight == 0), DO_ERROR, "invalid weight");
+    queue = op_queue_get(engine, gp_uid);
+    CHECK_ERR_RETURN((queue == NULL), DO_ERROR, "unable to get the queue of group 0x%x", gp_uid);
+    queue->weight = weight;
+    // Idle queues start with their new weight, the others get it with their next round
+    if (queue->num_active == 0 || queue->credits > weight)
+        queue->credits = weight;
     return DO_SUCCESS;
 }
+
+dpu_offload_status_t op_queue_get_stats(offloading_engine_t *engine, group_uid_t gp_uid, op_queue_stats_t *stats)
+{
+    khiter_t k;
+    CHECK_ERR_RETURN((engine == NULL), DO_ERROR, "engine is undefined");
+    CHECK_ERR_RETURN((stats == NULL), DO_ERROR, "undefined statistics");
+    k = kh_get(op_queue_hash_t, engine->ops_sched.queues, gp_uid);
+    if (k == kh_end(engine->ops_sched.queues))
+        return DO_NOT_APPLICABLE;
+    memcpy(stats, &(kh_value(engine->ops_sched.queues, k)->stats), sizeof(op_queue_stats_t));
+    return DO_SUCCESS;
+}
+
+void op_queues_dump(offloading_engine_t *engine, FILE *stream)
+{
+    op_queue_t *queue;
+    char id[64];
+
+    if (engine->ops_sched.queues == NULL || kh_size(engine->ops_sched.queues) == 0)
+        return;
+    if (engine->on_dpu)
+        snprintf(id, sizeof(id), "SP %" PRIu64, engine->config->local_service_proc.info.global_id);
+    else
+        snprintf(id, sizeof(id), "host 0x%" PRIx64, engine->host_id);
+
+    fprintf(stream, "[%s] Queues of operations (job %" PRIu64 "):\n", id, engine->num_jobs);
+    kh_foreach_value(engine->ops_sched.queues, queue, {
+        op_queue_stats_t *stats = &(queue->stats);
+        fprintf(stream, "[%s]   group 0x%x (weight: %" PRIu64 "): ops: %" PRIu64 " (completed: %" PRIu64 ", canceled: %" PRIu64 ", failed: %" PRIu64 "), "
+                        "progress: %" PRIu64 " (avg: %" PRIu64 " ns), deferred: %" PRIu64 ", RMA: %" PRIu64 " (throttled: %" PRIu64 ")\n",
+                id,
+                queue->gp_uid,
+                queue->weight,
+                stats->num_ops,
+                stats->num_completed,
+                stats->num_canceled,
+                stats->num_failed,
+                stats->num_progress,
+                stats->num_progress == 0 ? 0 : stats->progress_time / stats->num_progress,
+                stats->num_deferred,
+                stats->num_rma,
+                stats->num_rma_throttled);
+    })
+}
+
+void op_queues_reset(offloading_engine_t *engine)
+{
+    op_queue_t *queue;
+    khiter_t k;
+
+    if (engine->ops_sched.queues == NULL)
+        return;
+    if (engine->settings.dump_op_queue_stats)
+        op_queues_dump(engine, stderr);
+    for (k = kh_begin(engine->ops_sched.queues); k != kh_end(engine->ops_sched.queues); k++)
+    {
+        if (!kh_exist(engine->ops_sched.queues, k))
+            continue;
+        queue = kh_value(engine->ops_sched.queues, k);
+        if (queue->num_active > 0)
+        {
+            // Operations still being finalized point at their queue, only restart its statistics
+            memset(&(queue->stats), 0, sizeof(op_queue_stats_t));
+            continue;
+        }
+        free(queue);
+        kh_del(op_queue_hash_t, engine->ops_sched.queues, k);
+    }
+}
+
+void op_queues_fini(offloading_engine_t *engine)
+{
+    op_queue_t *queue;
+
+    if (engine->ops_sched.queues == NULL)
+        return;
+    if (engine->settings.dump_op_queue_stats)
+        op_queues_dump(engine, stderr);
+    kh_foreach_value(engine->ops_sched.queues, queue, {
+        free(queue);
+    })
+    kh_destroy(op_queue_hash_t, engine->ops_sched.queues);
+    engine->ops_sched.queues = NULL;
+}
@@ -0,0 +1,108 @@
+//
+// Copyright (c) 2023, NVIDIA CORPORATION. All rights reserved.
+//
+// See LICENSE.txt for license information
+//
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+
+#include "dpu_offload_types.h"
+#include "dpu_offload_collectives.h"
+
+/*
+ * Reduction kernels used by the offloaded reductions. They rely on the vector extensions of the
+ * compiler so the same code is turned into SSE/AVX instructions on the host and NEON instructions on
+ * the DPU, without depending on a specific instruction set. Buffers do not need to be aligned: vectors
+ * are loaded and stored with memcpy(), which the compiler turns into unaligned vector accesses.
+ */
+
+// Size of the vectors, a NEON or SSE register: wider vectors are split into several operations,
+// which is especially slow for min and max, when the target does not support them
+#define REDUCE_VEC_BYTES (16)
+
+#define REDUCE_SUM(_a, _b) ((_a) + (_b))
+#define REDUCE_PROD(_a, _b) ((_a) * (_b))
+#define REDUCE_MIN(_a, _b) ((_a) < (_b) ? (_a) : (_b))
+#define REDUCE_MAX(_a, _b) ((_a) > (_b) ? (_a) : (_b))
+
+/*
+ * The conditional operator cannot be applied to vectors in C, min and max select the elements with
+ * the mask resulting from the comparison, reinterpreting the vectors as integers of the same width.
+ */
+#define REDUCE_VEC_SUM(_a, _b) REDUCE_SUM(_a, _b)
+#define REDUCE_VEC_PROD(_a, _b) REDUCE_PROD(_a, _b)
+#define REDUCE_VEC_SELECT(_mask, _a, _b) ((vec_t)((((mask_t)(_a)) & (_mask)) | (((mask_t)(_b)) & ~(_mask))))
+#define REDUCE_VEC_MIN(_a, _b) REDUCE_VEC_SELECT((mask_t)((_a) < (_b)), _a, _b)
+#define REDUCE_VEC_MAX(_a, _b) REDUCE_VEC_SELECT((mask_t)((_a) > (_b)), _a, _b)
+
+#define REDUCE_KERNEL(_op, _type, _int_type)                                                   \
+    static void reduce_##_op##_##_type(void *inout, const void *in, size_t count)              \
+    {                                                                                          \
+        typedef _type vec_t __attribute__((vector_size(REDUCE_VEC_BYTES)));                    \
+        typedef _int_type mask_t __attribute__((vector_size(REDUCE_VEC_BYTES), unused));       \
+        const size_t n_per_vec = REDUCE_VEC_BYTES / sizeof(_type);                             \
+        _type *dst = (_type *)inout;                                                           \
+        const _type *src = (const _type *)in;                                                  \
+        size_t i = 0;                                                                          \
+        for (; i + n_per_vec <= count; i += n_per_vec)                                         \
+        {                                                                                      \
+            vec_t a, b;                                                                        \
+            memcpy(&a, &dst[i], sizeof(vec_t));                                                \
+            memcpy(&b, &src[i], sizeof(vec_t));                                                \
+            a = REDUCE_VEC_##_op(a, b);                                                        \
+            memcpy(&dst[i], &a, sizeof(vec_t));                                                \
+        }                                                                                      \
+        for (; i < count; i++)                                                                 \
+            dst[i] = REDUCE_##_op(dst[i], src[i]);                                             \
+    }
+
+#define REDUCE_KERNELS(_type, _int_type)     \
+    REDUCE_KERNEL(SUM, _type, _int_type)     \
+    REDUCE_KERNEL(PROD, _type, _int_type)    \
+    REDUCE_KERNEL(MIN, _type, _int_type)     \
+    REDUCE_KERNEL(MAX, _type, _int_type)
+
+REDUCE_KERNELS(int32_t, int32_t)
+REDUCE_KERNELS(int64_t, int64_t)
+REDUCE_KERNELS(float, int32_t)
+REDUCE_KERNELS(double, int64_t)
+
+typedef void (*reduce_kernel_fn)(void *inout, const void *in, size_t count);
+
+#define REDUCE_KERNELS_ROW(_op) \
+    {reduce_##_op##_int32_t, reduce_##_op##_int64_t, reduce_##_op##_float, reduce_##_op##_double}
+
+// Indexed by reduce_op_t and reduce_dt_t
+static const reduce_kernel_fn reduce_kernels[REDUCE_OP_LAST][REDUCE_DT_LAST] = {
+    REDUCE_KERNELS_ROW(SUM),
+    REDUCE_KERNELS_ROW(PROD),
+    REDUCE_KERNELS_ROW(MIN),
+    REDUCE_KERNELS_ROW(MAX),
+};
+
+size_t reduce_dt_size(reduce_dt_t dt)
+{
+    switch (dt)
+    {
+    case REDUCE_DT_INT32:
+        return sizeof(int32_t);
+    case REDUCE_DT_INT64:
+        return sizeof(int64_t);
+    case REDUCE_DT_FLOAT:
+        return sizeof(float);
+    case REDUCE_DT_DOUBLE:
+        return sizeof(double);
+    default:
+        return 0;
+    }
+}
+
+dpu_offload_status_t reduce_kernel(reduce_op_t op, reduce_dt_t dt, void *inout, const void *in, size_t count)
+{
+    if (op < 0 || op >= REDUCE_OP_LAST || dt < 0 || dt >= REDUCE_DT_LAST)
+        return DO_ERROR;
+    reduce_kernels[op][dt](inout, in, count);
+    return DO_SUCCESS;
+}
@@ -0,0 +1,570 @@
+//
+// Copyright (c) 2023, NVIDIA CORPORATION. All rights reserved.
+//
+// See LICENSE.txt for license information
+//
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <inttypes.h>
+#include <unistd.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <assert.h>
+#include <time.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "dpu_offload_types.h"
+#include "dpu_offload_debug.h"
+#include "dpu_offload_utils.h"
+#include "dpu_offload_mem_mgt.h"
+
+/*
+ * The rendezvous backends let clients get the worker address of their server without
+ * a socket connection (see MIMOSA_RENDEZVOUS). The record of a server is named after
+ * the address and port clients are configured with:
+ * - file backend: <dir>/mimosa-rdv-<addr>-<port>, written to a temporary file that is then
+ *   renamed so a client never sees a partially written record; the directory can be on a
+ *   shared filesystem;
+ * - shm backend: the POSIX shared memory segment /<prefix>-<addr>-<port>, only visible to
+ *   the clients running on the same node as the server.
+ * Clients poll for the record of their server with the same deadline and backoff as OOB
+ * connections, so servers and clients can be started in any order. The identifier of a
+ * client is then obtained with a single hello/welcome exchange of active messages.
+ */
+
+#define RENDEZVOUS_MAGIC (0x4D494D4F53415244ULL) // "MIMOSARD"
+
+// Implemented in dpu_offload_service_daemon.c
+extern dpu_offload_status_t oob_client_create_server_ep(execution_context_t *econtext);
+extern void rendezvous_server_hello(execution_context_t *econtext, rendezvous_hello_t *hello, void *peer_addr);
+
+static dpu_offload_status_t rendezvous_get_name(offloading_engine_t *engine, conn_params_t *conn_params, char *name, size_t len)
+{
+    char *path = engine->config->rendezvous.path;
+    int n;
+
+    CHECK_ERR_RETURN((conn_params->addr_str == NULL), DO_ERROR, "the address of the server is required by rendezvous backends");
+    switch (RENDEZVOUS_BACKEND(engine))
+    {
+    case RENDEZVOUS_FILE:
+        n = snprintf(name, len, "%s/mimosa-rdv-%s-%d",
+                     path != NULL ? path : DEFAULT_RENDEZVOUS_DIR,
+                     conn_params->addr_str,
+                     conn_params->port);
+        break;
+    case RENDEZVOUS_SHM:
+        n = snprintf(name, len, "/%s-%s-%d",
+                     path != NULL ? path : DEFAULT_RENDEZVOUS_SHM_PREFIX,
+                     conn_params->addr_str,
+                     conn_params->port);
+        break;
+    default:
+        ERR_MSG("invalid rendezvous backend (%d)", RENDEZVOUS_BACKEND(engine));
+        return DO_ERROR;
+    }
+    CHECK_ERR_RETURN((n < 0 || (size_t)n >= len), DO_ERROR, "rendezvous record name is too long");
+    return DO_SUCCESS;
+}
+
+static dpu_offload_status_t rendezvous_set_am_handler(ucp_worker_h worker, unsigned id, ucp_am_recv_callback_t cb, offloading_engine_t *engine)
+{
+    ucp_am_handler_param_t am_param = {0};
+    CHECK_ERR_RETURN((worker == NULL), DO_ERROR, "undefined worker");
+    am_param.field_mask = UCP_AM_HANDLER_PARAM_FIELD_ID |
+                          UCP_AM_HANDLER_PARAM_FIELD_CB |
+                          UCP_AM_HANDLER_PARAM_FIELD_ARG |
+                          UCP_AM_HANDLER_PARAM_FIELD_FLAGS;
+    am_param.id = id;
+    am_param.cb = cb;
+    am_param.arg = engine;
+    am_param.flags = UCP_AM_FLAG_WHOLE_MSG;
+    ucs_status_t status = ucp_worker_set_am_recv_handler(worker, &am_param);
+    CHECK_ERR_RETURN((status != UCS_OK), DO_ERROR, "unable to set AM handler %u: %s", id, ucs_status_string(status));
+    return DO_SUCCESS;
+}
+
+/**
+ * @brief Handler of the hello active messages. The handler is invoked while progressing the
+ * worker, possibly with the engine locked, so the hello is only queued and then handled when
+ * progressing the server's execution context.
+ */
+static ucs_status_t rendezvous_hello_cb(void *arg, const void *header, size_t header_length,
+                                        void *data, size_t length,
+                                        const ucp_am_recv_param_t *param)
+{
+    offloading_engine_t *engine = (offloading_engine_t *)arg;
+    const rendezvous_hello_t *hello = (const rendezvous_hello_t *)header;
+    rendezvous_pending_hello_t *pending;
+
+    if (engine == NULL || header == NULL || header_length != sizeof(rendezvous_hello_t))
+    {
+        ERR_MSG("invalid hello, dropping it");
+        return UCS_OK;
+    }
+    // Clients send their hello with the eager protocol so their address is available right away
+    if ((param->recv_attr & UCP_AM_RECV_ATTR_FLAG_RNDV) || hello->addr_len == 0 || length != hello->addr_len)
+    {
+        ERR_MSG("invalid hello payload (%ld bytes), dropping it", length);
+        return UCS_OK;
+    }
+
+    pending = DPU_OFFLOAD_MALLOC(sizeof(rendezvous_pending_hello_t));
+    CHECK_ERR_RETURN((pending == NULL), UCS_OK, "unable to allocate pending hello");
+    pending->peer_addr = DPU_OFFLOAD_MALLOC(length);
+    if (pending->peer_addr == NULL)
+    {
+        ERR_MSG("unable to allocate %ld bytes for the client's address", length);
+        free(pending);
+        return UCS_OK;
+    }
+    memcpy(&(pending->hello), hello, sizeof(rendezvous_hello_t));
+    memcpy(pending->peer_addr, data, length);
+    pthread_mutex_lock(&(engine->rendezvous.mutex));
+    ucs_list_add_tail(&(engine->rendezvous.hellos), &(pending->item));
+    pthread_mutex_unlock(&(engine->rendezvous.mutex));
+    DBG("Hello queued for server %p (token: 0x%" PRIx64 ")", (void *)(uintptr_t)hello->server_key, hello->token);
+    return UCS_OK;
+}
+
+/**
+ * @brief Handler of the welcome active messages. The client is looked up in the list of
+ * clients waiting for a welcome, it is not locked since its execution context may be
+ * locked while progressing the worker.
+ */
+static ucs_status_t rendezvous_welcome_cb(void *arg, const void *header, size_t header_length,
+                                          void *data, size_t length,
+                                          const ucp_am_recv_param_t *param)
+{
+    offloading_engine_t *engine = (offloading_engine_t *)arg;
+    const rendezvous_welcome_t *welcome = (const rendezvous_welcome_t *)header;
+    dpu_offload_client_t *client, *tmp;
+
+    if (engine == NULL || header == NULL || header_length != sizeof(rendezvous_welcome_t))
+    {
+        ERR_MSG("invalid welcome, dropping it");
+        return UCS_OK;
+    }
+
+    pthread_mutex_lock(&(engine->rendezvous.mutex));
+    ucs_list_for_each_safe(client, tmp, &(engine->rendezvous.clients), conn_data.oob.rdv.item)
+    {
+        if ((uint64_t)(uintptr_t)client->econtext != welcome->token)
+            continue;
+        ucs_list_del(&(client->conn_data.oob.rdv.item));
+        client->conn_data.oob.rdv.queued = false;
+        client->id = welcome->client_id;
+        client->resume_token = welcome->resume_token;
+        client->bootstrapping.phase = OOB_CONNECT_DONE;
+        TRACE_END(TRACE_PHASE_OOB_HANDSHAKE, client->econtext, TRACE_NO_PEER);
+        DBG("Welcome received (client ID: %" PRIu64 ", server ID: %" PRIu64 ")", client->id, client->server_id);
+        break;
+    }
+    pthread_mutex_unlock(&(engine->rendezvous.mutex));
+    return UCS_OK;
+}
+
+dpu_offload_status_t rendezvous_server_publish(execution_context_t *econtext)
+{
+    char name[PATH_MAX];
+    char tmp_name[PATH_MAX + 32];
+    rendezvous_record_t record;
+    dpu_offload_server_t *server = econtext->server;
+    offloading_engine_t *engine = econtext->engine;
+    void *map = NULL;
+    size_t map_len;
+    FILE *f = NULL;
+    int fd = -1;
+    int ret;
+    dpu_offload_status_t rc;
+
+    rc = rendezvous_set_am_handler(GET_WORKER(econtext), AM_RDV_HELLO_MSG_ID, rendezvous_hello_cb, engine);
+    CHECK_ERR_RETURN((rc), DO_ERROR, "rendezvous_set_am_handler() failed");
+
+    ECONTEXT_LOCK(econtext);
+    tmp_name[0] = '\0';
+    rc = rendezvous_get_name(engine, &(server->conn_params), name, sizeof(name));
+    CHECK_ERR_GOTO((rc), error_out, "rendezvous_get_name() failed");
+
+    memset(&record, 0, sizeof(record));
+    record.magic = RENDEZVOUS_MAGIC;
+    record.server_key = (uint64_t)(uintptr_t)econtext;
+    record.server_id = server->id;
+    record.server_global_id = UINT64_MAX;
+    if (engine->on_dpu)
+        record.server_global_id = engine->config->local_service_proc.info.global_id;
+    record.addr_len = server->conn_data.oob.local_addr_len;
+    map_len = sizeof(record) + record.addr_len;
+
+    switch (RENDEZVOUS_BACKEND(engine))
+    {
+    case RENDEZVOUS_FILE:
+    {
+        record.ready = 1;
+        snprintf(tmp_name, sizeof(tmp_name), "%s.%d.tmp", name, getpid());
+        f = fopen(tmp_name, "w");
+        CHECK_ERR_GOTO((f == NULL), error_out, "unable to open %s: %s", tmp_name, strerror(errno));
+        CHECK_ERR_GOTO((fwrite(&record, sizeof(record), 1, f) != 1), error_out, "unable to write rendezvous record");
+        CHECK_ERR_GOTO((fwrite(server->conn_data.oob.local_addr, record.addr_len, 1, f) != 1),
+                       error_out,
+                       "unable to write the server's address");
+        ret = fclose(f);
+        f = NULL;
+        CHECK_ERR_GOTO((ret != 0), error_out, "fclose() failed: %s", strerror(errno));
+        CHECK_ERR_GOTO((rename(tmp_name, name) != 0), error_out, "rename() failed: %s", strerror(errno));
+        break;
+    }
+    case RENDEZVOUS_SHM:
+    {
+        // A server that was not finalized may have left its segment behind
+        shm_unlink(name);
+        fd = shm_open(name, O_CREAT | O_EXCL | O_RDWR, 0600);
+        CHECK_ERR_GOTO((fd == -1), error_out, "shm_open() of %s failed: %s", name, strerror(errno));
+        CHECK_ERR_GOTO((ftruncate(fd, map_len) != 0), error_out, "ftruncate() failed: %s", strerror(errno));
+        map = mmap(NULL, map_len, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        CHECK_ERR_GOTO((map == MAP_FAILED), error_out, "mmap() of %s failed: %s", name, strerror(errno));
+        close(fd);
+        fd = -1;
+        memcpy(map, &record, sizeof(record));
+        memcpy(BUFF_AT(map, sizeof(record)), server->conn_data.oob.local_addr, record.addr_len);
+        __atomic_store_n(&(((rendezvous_record_t *)map)->ready), 1, __ATOMIC_RELEASE);
+        server->conn_data.oob.rdv.map = map;
+        server->conn_data.oob.rdv.map_len = map_len;
+        break;
+    }
+    default:
+        ERR_MSG("invalid rendezvous backend (%d)", RENDEZVOUS_BACKEND(engine));
+        goto error_out;
+    }
+
+    server->conn_data.oob.rdv.published = true;
+    DBG("Server %" PRIu64 " published its address in %s (econtext: %p, scope_id: %d)",
+        server->id, name, econtext, econtext->scope_id);
+    ECONTEXT_UNLOCK(econtext);
+    return DO_SUCCESS;
+
+error_out:
+    if (f != NULL)
+        fclose(f);
+    if (tmp_name[0] != '\0')
+        unlink(tmp_name);
+    if (fd != -1)
+    {
+        close(fd);
+        shm_unlink(name);
+    }
+    ECONTEXT_UNLOCK(econtext);
+    return DO_ERROR;
+}
+
+void rendezvous_server_unpublish(execution_context_t *econtext)
+{
+    char name[PATH_MAX];
+    rendezvous_pending_hello_t *pending, *tmp;
+    dpu_offload_server_t *server = econtext->server;
+    offloading_engine_t *engine = econtext->engine;
+
+    if (!server->conn_data.oob.rdv.published)
+        return;
+
+    if (server->conn_data.oob.rdv.map != NULL)
+    {
+        munmap(server->conn_data.oob.rdv.map, server->conn_data.oob.rdv.map_len);
+        server->conn_data.oob.rdv.map = NULL;
+    }
+    if (rendezvous_get_name(engine, &(server->conn_params), name, sizeof(name)) == DO_SUCCESS)
+    {
+        if (RENDEZVOUS_BACKEND(engine) == RENDEZVOUS_FILE)
+            unlink(name);
+        else
+            shm_unlink(name);
+    }
+    server->conn_data.oob.rdv.published = false;
+
+    pthread_mutex_lock(&(engine->rendezvous.mutex));
+    ucs_list_for_each_safe(pending, tmp, &(engine->rendezvous.hellos), item)
+    {
+        if (pending->hello.server_key != (uint64_t)(uintptr_t)econtext)
+            continue;
+        ucs_list_del(&(pending->item));
+        free(pending->peer_addr);
+        free(pending);
+    }
+    pthread_mutex_unlock(&(engine->rendezvous.mutex));
+}
+
+void rendezvous_server_progress(execution_context_t *econtext)
+{
+    rendezvous_pending_hello_t *pending, *tmp;
+    offloading_engine_t *engine = econtext->engine;
+    ucs_list_link_t hellos;
+
+    if (!econtext->server->conn_data.oob.rdv.published)
+        return;
+
+    ucs_list_head_init(&hellos);
+    pthread_mutex_lock(&(engine->rendezvous.mutex));
+    ucs_list_for_each_safe(pending, tmp, &(engine->rendezvous.hellos), item)
+    {
+        if (pending->hello.server_key != (uint64_t)(uintptr_t)econtext)
+            continue;
+        ucs_list_del(&(pending->item));
+        ucs_list_add_tail(&hellos, &(pending->item));
+    }
+    pthread_mutex_unlock(&(engine->rendezvous.mutex));
+
+    ucs_list_for_each_safe(pending, tmp, &hellos, item)
+    {
+        ucs_list_del(&(pending->item));
+        // The client's address is now owned by the client's data
+        rendezvous_server_hello(econtext, &(pending->hello), pending->peer_addr);
+        free(pending);
+    }
+}
+
+dpu_offload_status_t rendezvous_server_welcome(execution_context_t *econtext, peer_info_t *client_info)
+{
+    ucp_request_param_t params = {0};
+    ucs_status_ptr_t req;
+
+    if (client_info->rdv_welcome.token == 0)
+        return DO_SUCCESS;
+
+    params.op_attr_mask = UCP_OP_ATTR_FIELD_FLAGS;
+    params.flags = UCP_AM_SEND_FLAG_EAGER | UCP_AM_SEND_FLAG_COPY_HEADER;
+    req = ucp_am_send_nbx(client_info->ep,
+                          AM_RDV_WELCOME_MSG_ID,
+                          &(client_info->rdv_welcome),
+                          sizeof(rendezvous_welcome_t),
+                          NULL,
+                          0,
+                          &params);
+    CHECK_ERR_RETURN((UCS_PTR_IS_ERR(req)), DO_ERROR, "ucp_am_send_nbx() failed: %s", ucs_status_string(UCS_PTR_STATUS(req)));
+    // The header was copied, the request completes on its own
+    if (req != NULL)
+        ucp_request_free(req);
+    DBG("Welcome sent to client #%" PRIu64 " (econtext: %p)", client_info->id, econtext);
+    return DO_SUCCESS;
+}
+
+/**
+ * @brief Look up the record of the client's server.
+ *
+ * @return DO_SUCCESS when the record was found, DO_NOT_APPLICABLE when the server did not
+ * publish it yet, DO_ERROR otherwise
+ */
+static dpu_offload_status_t rendezvous_lookup(execution_context_t *econtext)
+{
+    char name[PATH_MAX];
+    struct stat st;
+    void *map = NULL;
+    int fd;
+    rendezvous_record_t *record;
+    dpu_offload_client_t *client = econtext->client;
+    dpu_offload_status_t rc;
+
+    rc = rendezvous_get_name(econtext->engine, &(client->conn_params), name, sizeof(name));
+    CHECK_ERR_RETURN((rc), DO_ERROR, "rendezvous_get_name() failed");
+    if (RENDEZVOUS_BACKEND(econtext->engine) == RENDEZVOUS_FILE)
+        fd = open(name, O_RDONLY);
+    else
+        fd = shm_open(name, O_RDONLY, 0);
+    if (fd == -1)
+    {
+        CHECK_ERR_RETURN((errno != ENOENT), DO_ERROR, "unable to open %s: %s", name, strerror(errno));
+        return DO_NOT_APPLICABLE;
+    }
+
+    // The shared memory segment may not be sized yet
+    rc = DO_NOT_APPLICABLE;
+    if (fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(rendezvous_record_t))
+        goto out;
+    map = mmap(NULL, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    if (map == MAP_FAILED)
+    {
+        map = NULL;
+        ERR_MSG("mmap() of %s failed: %s", name, strerror(errno));
+        rc = DO_ERROR;
+        goto out;
+    }
+    record = (rendezvous_record_t *)map;
+    if (__atomic_load_n(&(record->ready), __ATOMIC_ACQUIRE) == 0)
+        goto out;
+    if (record->magic != RENDEZVOUS_MAGIC ||
+        record->addr_len == 0 ||
+        (size_t)st.st_size != sizeof(rendezvous_record_t) + record->addr_len)
+    {
+        ERR_MSG("invalid rendezvous record %s", name);
+        rc = DO_ERROR;
+        goto out;
+    }
+
+    client->conn_data.oob.peer_addr = DPU_OFFLOAD_MALLOC(record->addr_len);
+    if (client->conn_data.oob.peer_addr == NULL)
+    {
+        ERR_MSG("unable to allocate %" PRIu64 " bytes for the server's address", record->addr_len);
+        rc = DO_ERROR;
+        goto out;
+    }
+    memcpy(client->conn_data.oob.peer_addr, BUFF_AT(map, sizeof(rendezvous_record_t)), record->addr_len);
+    client->conn_data.oob.peer_addr_len = record->addr_len;
+    client->server_id = record->server_id;
+    client->server_global_id = record->server_global_id;
+    client->conn_data.oob.rdv.hello.server_key = record->server_key;
+    DBG("Found the record of server %" PRIu64 " in %s after %ld attempt(s)",
+        client->server_id, name, client->conn_data.oob.connect.num_attempts);
+    rc = DO_SUCCESS;
+
+out:
+    if (map != NULL)
+        munmap(map, st.st_size);
+    close(fd);
+    return rc;
+}
+
+// Create the endpoint to the server and send it our hello
+static dpu_offload_status_t rendezvous_send_hello(execution_context_t *econtext)
+{
+    dpu_offload_client_t *client = econtext->client;
+    rendezvous_hello_t *hello = &(client->conn_data.oob.rdv.hello);
+    ucp_request_param_t params = {0};
+    ucs_status_ptr_t req;
+
+    dpu_offload_status_t rc = oob_client_create_server_ep(econtext);
+    CHECK_ERR_RETURN((rc), DO_ERROR, "oob_client_create_server_ep() failed");
+
+    hello->token = (uint64_t)(uintptr_t)econtext;
+    COPY_RANK_INFO(&(econtext->rank), &(hello->rank_info));
+    hello->resume_token = client->resume_token;
+    hello->addr_len = client->conn_data.oob.local_addr_len;
+
+    // Wait for the welcome before sending the hello so it cannot be missed
+    pthread_mutex_lock(&(econtext->engine->rendezvous.mutex));
+    if (!client->conn_data.oob.rdv.queued)
+    {
+        ucs_list_add_tail(&(econtext->engine->rendezvous.clients), &(client->conn_data.oob.rdv.item));
+        client->conn_data.oob.rdv.queued = true;
+    }
+    pthread_mutex_unlock(&(econtext->engine->rendezvous.mutex));
+
+    params.op_attr_mask = UCP_OP_ATTR_FIELD_FLAGS;
+    params.flags = UCP_AM_SEND_FLAG_EAGER | UCP_AM_SEND_FLAG_COPY_HEADER;
+    req = ucp_am_send_nbx(client->server_ep,
+                          AM_RDV_HELLO_MSG_ID,
+                          hello,
+                          sizeof(rendezvous_hello_t),
+                          client->conn_data.oob.local_addr,
+                          client->conn_data.oob.local_addr_len,
+                          &params);
+    CHECK_ERR_RETURN((UCS_PTR_IS_ERR(req)), DO_ERROR, "ucp_am_send_nbx() failed: %s", ucs_status_string(UCS_PTR_STATUS(req)));
+    // Our address remains valid until the client is finalized, the request completes on its own
+    if (req != NULL)
+        ucp_request_free(req);
+    client->conn_data.oob.rdv.hello_sent = true;
+    DBG("Hello sent to server %" PRIu64 " (group/rank: 0x%x/%" PRId64 ")",
+        client->server_id, econtext->rank.group_uid, econtext->rank.group_rank);
+    return DO_SUCCESS;
+}
+
+dpu_offload_status_t rendezvous_client_connect(execution_context_t *econtext)
+{
+    dpu_offload_client_t *client = econtext->client;
+    offloading_engine_t *engine = econtext->engine;
+
+    dpu_offload_status_t rc = rendezvous_set_am_handler(GET_WORKER(econtext), AM_RDV_WELCOME_MSG_ID, rendezvous_welcome_cb, engine);
+    CHECK_ERR_RETURN((rc), DO_ERROR, "rendezvous_set_am_handler() failed");
+
+    DBG("Looking up the record of %s:%d", client->conn_params.addr_str, client->conn_params.port);
+    client->conn_data.oob.rdv.active = true;
+    client->conn_data.oob.rdv.hello_sent = false;
+    client->conn_data.oob.connect.start = monotonic_time_us();
+    client->conn_data.oob.connect.next_attempt = client->conn_data.oob.connect.start;
+    client->conn_data.oob.connect.backoff = engine->settings.connect_backoff_min > 0 ? engine->settings.connect_backoff_min : 1;
+    client->conn_data.oob.connect.num_attempts = 0;
+    client->conn_data.oob.connect.seed = (unsigned int)(getpid() ^ client->conn_data.oob.connect.start ^ (uintptr_t)client);
+    client->bootstrapping.phase = OOB_CONNECT_IN_PROGRESS;
+    TRACE_BEGIN(TRACE_PHASE_RENDEZVOUS_LOOKUP, econtext, TRACE_NO_PEER);
+    return DO_SUCCESS;
+}
+
+dpu_offload_status_t rendezvous_client_connect_progress(execution_context_t *econtext)
+{
+    dpu_offload_client_t *client = econtext->client;
+    offloading_engine_t *engine = econtext->engine;
+    uint64_t now = monotonic_time_us();
+    dpu_offload_status_t rc;
+
+    if (client->bootstrapping.phase != OOB_CONNECT_IN_PROGRESS)
+        return DO_SUCCESS;
+
+    if (!client->conn_data.oob.rdv.hello_sent && now >= client->conn_data.oob.connect.next_attempt)
+    {
+        client->conn_data.oob.connect.num_attempts++;
+        rc = rendezvous_lookup(econtext);
+        CHECK_ERR_RETURN((rc == DO_ERROR), DO_ERROR, "rendezvous_lookup() failed");
+        if (rc == DO_SUCCESS)
+        {
+            TRACE_END(TRACE_PHASE_RENDEZVOUS_LOOKUP, econtext, TRACE_NO_PEER);
+            // The hello and welcome play the role of the OOB handshake
+            TRACE_BEGIN(TRACE_PHASE_OOB_HANDSHAKE, econtext, TRACE_NO_PEER);
+            return rendezvous_send_hello(econtext);
+        }
+
+        // Not published yet, half of the delay is random so clients do not look up in lockstep
+        uint64_t backoff = client->conn_data.oob.connect.backoff;
+        client->conn_data.oob.connect.next_attempt = now + backoff / 2 + rand_r(&(client->conn_data.oob.connect.seed)) % (backoff / 2 + 1);
+        backoff *= 2;
+        if (backoff > engine->settings.connect_backoff_max)
+            backoff = engine->settings.connect_backoff_max;
+        client->conn_data.oob.connect.backoff = backoff;
+    }
+
+    uint64_t connect_timeout = CLIENT_CONNECT_TIMEOUT(econtext);
+    if (connect_timeout > 0 && now - client->conn_data.oob.connect.start >= connect_timeout * 1000)
+    {
+        ERR_MSG("unable to connect to %s:%d through rendezvous after %ld lookup(s) in %" PRIu64 " ms (%s)",
+                client->conn_params.addr_str,
+                client->conn_params.port,
+                client->conn_data.oob.connect.num_attempts,
+                connect_timeout,
+                client->conn_data.oob.rdv.hello_sent ? "no welcome" : "no record");
+        TRACE_END(client->conn_data.oob.rdv.hello_sent ? TRACE_PHASE_OOB_HANDSHAKE : TRACE_PHASE_RENDEZVOUS_LOOKUP, econtext, TRACE_NO_PEER);
+        rendezvous_client_fini(econtext);
+        return DO_ERROR;
+    }
+    return DO_SUCCESS;
+}
+
+void rendezvous_client_fini(execution_context_t *econtext)
+{
+    dpu_offload_client_t *client = econtext->client;
+
+    if (!client->conn_data.oob.rdv.active)
+        return;
+    pthread_mutex_lock(&(econtext->engine->rendezvous.mutex));
+    if (client->conn_data.oob.rdv.queued)
+    {
+        ucs_list_del(&(client->conn_data.oob.rdv.item));
+        client->conn_data.oob.rdv.queued = false;
+    }
+    pthread_mutex_unlock(&(econtext->engine->rendezvous.mutex));
+    client->conn_data.oob.rdv.active = false;
+    client->conn_data.oob.rdv.hello_sent = false;
+}
+
+void rendezvous_fini(offloading_engine_t *engine)
+{
+    rendezvous_pending_hello_t *pending, *tmp;
+
+    pthread_mutex_lock(&(engine->rendezvous.mutex));
+    ucs_list_for_each_safe(pending, tmp, &(engine->rendezvous.hellos), item)
+    {
+        ucs_list_del(&(pending->item));
+        free(pending->peer_addr);
+        free(pending);
+    }
+    pthread_mutex_unlock(&(engine->rendezvous.mutex));
+}
@@ -13,6 +13,11 @@
 #include <inttypes.h>
 #include <string.h>
 #include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <time.h>
+#include <limits.h>
+#include <sys/random.h>
 
 #include "dpu_offload_service_daemon.h"
 #include "dpu_offload_event_channels.h"
@@ -21,6 +26,7 @@
 #include "dpu_offload_debug.h"
 #include "dpu_offload_mem_mgt.h"
 #include "dpu_offload_ops.h"
+#include "dpu_offload_collectives.h"
 #include "dpu_offload_comms.h"
 
 static dpu_offload_status_t execution_context_init(offloading_engine_t *offload_engine, uint64_t type, execution_context_t **econtext);
@@ -103,138 +109,19 @@ struct oob_msg
 
 extern dpu_offload_status_t get_env_config(offloading_engine_t *engine, conn_params_t *params);
 
-static void oob_recv_addr_handler_2(void *request, ucs_status_t status, const ucp_tag_recv_info_t *tag_info, void *user_data)
-{
-    DBG("Bootstrapping message received\n");
-    am_req_t *ctx = (am_req_t *)user_data;
-    ctx->complete = 1;
-}
-
 /**
- * @brief Note: this function assumes the execution context is NOT locked before it is invoked.
- * This function is meant to be called by the main thread, NOT the connection thread.
+ * @brief Create the endpoint to a client that completed its OOB handshake.
+ * Note: this function assumes the execution context is locked before it is invoked.
  *
  * @param econtext
- * @param client_addr
+ * @param client_info
  * @return dpu_offload_status_t
  */
-static inline dpu_offload_status_t oob_server_ucx_client_connection_step1(execution_context_t *econtext, peer_info_t *client_info)
-{
-    CHECK_ERR_RETURN((econtext == NULL), DO_ERROR, "undefined execution context");
-    ECONTEXT_LOCK(econtext);
-
-    dpu_offload_server_t *server = econtext->server;
-    CHECK_ERR_GOTO((server == NULL), error_out, "server handle is undefined");
-
-    /* 1. Receive the address size */
-    ucp_tag_t ucp_tag, ucp_tag_mask;
-    DBG("Posting recv - Tag: %d, scope_id: %d, econtext: %p, peer_id: %ld",
-        econtext->server->conn_data.oob.tag,
-        econtext->scope_id,
-        econtext, client_info->id);
-    MAKE_RECV_TAG(ucp_tag,
-                  ucp_tag_mask,
-                  econtext->server->conn_data.oob.tag,
-                  client_info->id,
-                  econtext->server->id,
-                  econtext->scope_id,
-                  0);
-    ucp_request_param_t recv_param = {0};
-    recv_param.op_attr_mask = UCP_OP_ATTR_FIELD_CALLBACK |
-                              UCP_OP_ATTR_FIELD_DATATYPE |
-                              UCP_OP_ATTR_FIELD_USER_DATA;
-    recv_param.datatype = ucp_dt_make_contig(1);
-    recv_param.user_data = &(client_info->bootstrapping.addr_size_ctx);
-    recv_param.cb.recv = oob_recv_addr_handler_2;
-    assert(client_info->bootstrapping.addr_size_ctx.complete == false);
-    client_info->bootstrapping.addr_size_request = ucp_tag_recv_nbx(GET_WORKER(econtext),
-                                                                    &(client_info->peer_addr_len),
-                                                                    sizeof(size_t),
-                                                                    ucp_tag,
-                                                                    ucp_tag_mask,
-                                                                    &recv_param);
-    if (UCS_PTR_IS_ERR(client_info->bootstrapping.addr_size_request))
-    {
-        ERR_MSG("ucp_tag_recv_nbx() failed");
-        goto error_out;
-    }
-    if (client_info->bootstrapping.addr_size_request == NULL)
-    {
-        DBG("We received the address size right away, callback not invoked, dealing directly with it");
-        client_info->bootstrapping.addr_size_ctx.complete = true;
-    }
-    else
-    {
-        DBG("Reception of the address size still in progress (engine: %p)", econtext->engine);
-        assert(client_info->bootstrapping.addr_size_ctx.complete == false);
-    }
-    ECONTEXT_UNLOCK(econtext);
-    return DO_SUCCESS;
-error_out:
-    ECONTEXT_UNLOCK(econtext);
-    return DO_ERROR;
-}
-
-static inline dpu_offload_status_t oob_server_ucx_client_connection_step2(execution_context_t *econtext, peer_info_t *client_info)
+static dpu_offload_status_t oob_server_create_client_ep(execution_context_t *econtext, peer_info_t *client_info)
 {
-    // request_finalize(GET_WORKER(econtext), addr_size_request, &ctx);
-    DBG("Client address size: %ld", client_info->peer_addr_len);
-    assert(client_info->peer_addr_len > 0);
-    ECONTEXT_LOCK(econtext);
-
-    /* 2. Receive the address itself */
-
-    // Get the buffer ready for the receive
-    ucp_tag_t ucp_tag, ucp_tag_mask;
-    ucp_request_param_t recv_param = {0};
-    client_info->peer_addr = DPU_OFFLOAD_MALLOC(client_info->peer_addr_len);
-    CHECK_ERR_GOTO((client_info->peer_addr == NULL),
-                   error_out,
-                   "unable to allocate memory for peer address (%ld bytes)",
-                   client_info->peer_addr_len);
-    recv_param.op_attr_mask = UCP_OP_ATTR_FIELD_CALLBACK |
-                              UCP_OP_ATTR_FIELD_DATATYPE |
-                              UCP_OP_ATTR_FIELD_USER_DATA;
-    recv_param.datatype = ucp_dt_make_contig(1);
-    recv_param.user_data = &(client_info->bootstrapping.addr_ctx);
-    recv_param.cb.recv = oob_recv_addr_handler_2;
-    DBG("Tag: %d; scope_id: %d\n", econtext->server->conn_data.oob.tag, econtext->scope_id);
-    MAKE_RECV_TAG(ucp_tag,
-                  ucp_tag_mask,
-                  econtext->server->conn_data.oob.tag,
-                  client_info->id,
-                  econtext->server->id,
-                  econtext->scope_id,
-                  0);
-    client_info->bootstrapping.addr_request = ucp_tag_recv_nbx(GET_WORKER(econtext),
-                                                               client_info->peer_addr,
-                                                               client_info->peer_addr_len,
-                                                               ucp_tag,
-                                                               ucp_tag_mask,
-                                                               &recv_param);
-    if (UCS_PTR_IS_ERR(client_info->bootstrapping.addr_request))
-    {
-        ERR_MSG("ucp_tag_recv_nbx() failed");
-        goto error_out;
-    }
-    DBG("Recv for client's address successfully posted");
-    if (client_info->bootstrapping.addr_request == NULL)
-    {
-        DBG("We received the address right away, callback not invoked, dealing directly with it");
-        client_info->bootstrapping.addr_ctx.complete = true;
-    }
-    ECONTEXT_UNLOCK(econtext);
-    return DO_SUCCESS;
-error_out:
-    ECONTEXT_UNLOCK(econtext);
-    return DO_ERROR;
-}
-
-static inline dpu_offload_status_t oob_server_ucx_client_connection_step3(execution_context_t *econtext, peer_info_t *client_info)
-{
-    /* 3. Create the endpoint using the address we just received */
     assert(econtext->type > 0); // should not be unknown
     assert(econtext->type < CONTEXT_LIMIT_MAX);
+    assert(client_info->peer_addr != NULL);
     ucp_ep_params_t ep_params = {0};
     ep_params.field_mask = UCP_EP_PARAM_FIELD_REMOTE_ADDRESS |
                            UCP_EP_PARAM_FIELD_ERR_HANDLING_MODE |
@@ -244,52 +131,318 @@ static inline dpu_offload_status_t oob_server_ucx_client_connection_step3(execut
     ep_params.address = client_info->peer_addr;
     ep_params.user_data = &(client_info->ep_status);
     ucp_worker_h worker = GET_WORKER(econtext);
-    CHECK_ERR_GOTO((worker == NULL), error_out, "undefined worker");
+    CHECK_ERR_RETURN((worker == NULL), DO_ERROR, "undefined worker");
     ucp_ep_h client_ep;
+    TRACE_BEGIN(TRACE_PHASE_UCX_EP_CREATE, econtext, client_info->id);
     ucs_status_t status = ucp_ep_create(worker, &ep_params, &client_ep);
-    CHECK_ERR_GOTO((status != UCS_OK), error_out, "ucp_ep_create() failed: %s", ucs_status_string(status));
+    TRACE_END(TRACE_PHASE_UCX_EP_CREATE, econtext, client_info->id);
+    CHECK_ERR_RETURN((status != UCS_OK), DO_ERROR, "ucp_ep_create() failed: %s", ucs_status_string(status));
     client_info->ep = client_ep;
     DBG("endpoint %p successfully created", client_ep);
+    return DO_SUCCESS;
+}
+
+#define MAX_CACHE_ENTRIES_PER_PROC (8)
+
+static void init_client_slot(peer_info_t *client_info)
+{
+    client_info->bootstrapping.phase = BOOTSTRAP_NOT_INITIATED;
+#if USE_AM_IMPLEM
+    client_info->ctx.complete = false;
+#else
+    RESET_NOTIF_RECEPTION(&(client_info->notif_recv));
+    client_info->notif_recv.ctx.complete = true; // to make sure we can post the initial recv
+#endif
+    if (client_info->cache_entries.capacity == 0)
+        DYN_ARRAY_ALLOC(&(client_info->cache_entries), MAX_CACHE_ENTRIES_PER_PROC, peer_cache_entry_t *);
+}
 
-    // receive the rank/group data
-    ucp_tag_t ucp_tag, ucp_tag_mask;
-    ucp_request_param_t recv_param = {0};
-    recv_param.op_attr_mask = UCP_OP_ATTR_FIELD_CALLBACK |
-                              UCP_OP_ATTR_FIELD_DATATYPE |
-                              UCP_OP_ATTR_FIELD_USER_DATA;
-    recv_param.datatype = ucp_dt_make_contig(1);
-    recv_param.user_data = &(client_info->bootstrapping.rank_ctx);
-    recv_param.cb.recv = oob_recv_addr_handler_2;
-    MAKE_RECV_TAG(ucp_tag,
-                  ucp_tag_mask,
-                  econtext->server->conn_data.oob.tag,
-                  client_info->id,
-                  econtext->server->id,
-                  econtext->scope_id,
-                  0);
-    client_info->bootstrapping.rank_request = ucp_tag_recv_nbx(GET_WORKER(econtext),
-                                                               &(client_info->rank_data),
-                                                               sizeof(rank_info_t),
-                                                               ucp_tag,
-                                                               ucp_tag_mask,
-                                                               &recv_param);
-    if (UCS_PTR_IS_ERR(client_info->bootstrapping.rank_request))
-    {
-        ucs_status_t send_status = UCS_PTR_STATUS(client_info->bootstrapping.rank_request);
-        ERR_MSG("ucp_tag_recv_nbx() failed: %s", ucs_status_string(send_status));
-        goto error_out;
-    }
-    DBG("Receiving rank info (len=%ld, req=%p)", sizeof(rank_info_t), client_info->bootstrapping.rank_request);
-    if (client_info->bootstrapping.rank_request == NULL)
-    {
-        DBG("We received the rank info right away, callback not invoked, dealing directly with it");
-        client_info->bootstrapping.rank_ctx.complete = true;
+/**
+ * @brief Get a slot for a new client, a released slot is reused if any. The identifier of the
+ * client (see CLIENT_ID) is stored in the client's data.
+ * Note: this function assumes the execution context is locked before it is invoked.
+ *
+ * @param econtext
+ * @return peer_info_t* Client's data
+ */
+static peer_info_t *client_slot_alloc(execution_context_t *econtext)
+{
+    connected_clients_t *clients = &(econtext->server->connected_clients);
+    uint64_t slot;
+    if (clients->num_free_slots > 0)
+    {
+        uint64_t *free_slots = (uint64_t *)clients->free_slots.base;
+        clients->num_free_slots--;
+        slot = free_slots[clients->num_free_slots];
+    }
+    else
+    {
+        slot = clients->num_slots;
+        clients->num_slots++;
+    }
+    peer_info_t *client_info = DYN_ARRAY_GET_ELT(&(clients->clients), slot, peer_info_t);
+    assert(client_info);
+    assert(client_info->bootstrapping.phase == BOOTSTRAP_NOT_INITIATED);
+    init_client_slot(client_info);
+    client_info->id = CLIENT_ID(slot, client_info->generation);
+    return client_info;
+}
+
+/**
+ * @brief Return a slot so it can be used by a new client. The generation of the slot is
+ * incremented so the identifier of the previous client becomes stale.
+ * Note: this function assumes the execution context is locked before it is invoked.
+ *
+ * @param econtext
+ * @param slot
+ */
+static void client_slot_free(execution_context_t *econtext, uint64_t slot)
+{
+    connected_clients_t *clients = &(econtext->server->connected_clients);
+    peer_info_t *client_info = DYN_ARRAY_GET_ELT(&(clients->clients), slot, peer_info_t);
+    assert(client_info);
+    client_info->bootstrapping.phase = BOOTSTRAP_NOT_INITIATED;
+    client_info->generation++;
+    client_info->id = UINT64_MAX;
+    DYN_ARRAY_SET_ELT(&(clients->free_slots), clients->num_free_slots, uint64_t, &slot);
+    clients->num_free_slots++;
+}
+
+/**
+ * @brief Generate the token a client presents to get its slot back when it reconnects.
+ *
+ * @return uint64_t Token, never 0
+ */
+static uint64_t resume_token_generate(void)
+{
+    uint64_t token = 0;
+    while (token == 0)
+    {
+        if (getrandom(&token, sizeof(token), 0) != sizeof(token))
+            token = (monotonic_time_us() ^ ((uint64_t)getpid() << 32)) * 0x9E3779B97F4A7C15ULL;
+    }
+    return token;
+}
+
+/**
+ * @brief Close the endpoint to a client that disconnected and free its address. The endpoint
+ * is closed without waiting for the completion of the operation, UCX completes it in the background.
+ *
+ * @param client_info
+ */
+static void client_slot_close(peer_info_t *client_info)
+{
+    if (client_info->ep != NULL)
+    {
+        ucp_request_param_t param = {0};
+        void *close_req;
+        param.op_attr_mask = UCP_OP_ATTR_FIELD_FLAGS;
+        param.flags = UCP_EP_CLOSE_FLAG_FORCE;
+        close_req = ucp_ep_close_nbx(client_info->ep, &param);
+        if (UCS_PTR_IS_PTR(close_req))
+            ucp_request_free(close_req);
+        else if (UCS_PTR_STATUS(close_req) != UCS_OK)
+            ERR_MSG("failed to close ep %p", (void *)client_info->ep);
+        client_info->ep = NULL;
+    }
+    if (client_info->peer_addr != NULL)
+    {
+        free(client_info->peer_addr);
+        client_info->peer_addr = NULL;
+    }
+    if (client_info->peer_addr_str != NULL)
+    {
+        free(client_info->peer_addr_str);
+        client_info->peer_addr_str = NULL;
+    }
+    client_info->peer_addr_len = 0;
+    memset(&(client_info->rdv_welcome), 0, sizeof(client_info->rdv_welcome));
+}
+
+/**
+ * @brief Drop what a slot knows about its previous client and return it.
+ * Note: this function assumes the execution context is locked before it is invoked.
+ *
+ * @param econtext
+ * @param slot
+ */
+static void client_slot_reset(execution_context_t *econtext, uint64_t slot)
+{
+    peer_info_t *client_info = DYN_ARRAY_GET_ELT(&(econtext->server->connected_clients.clients), slot, peer_info_t);
+    assert(client_info);
+    RESET_RANK_INFO(&(client_info->rank_data));
+    client_info->resume_token = 0;
+    client_info->parked = false;
+    // The cache entries are owned by the group cache, only the references are dropped
+    memset(client_info->cache_entries.base, 0, client_info->cache_entries.capacity * client_info->cache_entries.type_size);
+    client_slot_free(econtext, slot);
+}
+
+/**
+ * @brief Release the resources of a client that disconnected and return its slot.
+ * Note: this function assumes the execution context is locked before it is invoked.
+ *
+ * @param econtext
+ * @param slot
+ */
+static void client_slot_release(execution_context_t *econtext, uint64_t slot)
+{
+    peer_info_t *client_info = DYN_ARRAY_GET_ELT(&(econtext->server->connected_clients.clients), slot, peer_info_t);
+    assert(client_info);
+    assert(client_info->bootstrapping.phase == DISCONNECTED);
+    client_slot_close(client_info);
+    client_slot_reset(econtext, slot);
+    econtext->server->connected_clients.num_disconnected_clients--;
+    DBG("Slot %" PRIu64 " released, now at generation %" PRIu32, slot, client_info->generation);
+}
+
+/**
+ * @brief Keep the slot of a client that disconnected so the client can get it back with its
+ * resume token (see MIMOSA_RESUME_TTL). The endpoint is closed since the next process presenting
+ * the token has a new worker address, but the identifier, group/rank and references to the cache
+ * entries are preserved.
+ * Note: this function assumes the execution context is locked before it is invoked.
+ *
+ * @param econtext
+ * @param slot
+ */
+static void client_slot_park(execution_context_t *econtext, uint64_t slot)
+{
+    connected_clients_t *clients = &(econtext->server->connected_clients);
+    peer_info_t *client_info = DYN_ARRAY_GET_ELT(&(clients->clients), slot, peer_info_t);
+    assert(client_info);
+    assert(client_info->bootstrapping.phase == DISCONNECTED);
+    assert(client_info->resume_token != 0);
+    client_slot_close(client_info);
+    client_info->bootstrapping.phase = BOOTSTRAP_NOT_INITIATED;
+    client_info->parked = true;
+    client_info->resume_deadline = monotonic_time_us() + econtext->engine->settings.resume_ttl * 1000;
+    if (clients->num_parked_clients == 0 || client_info->resume_deadline < clients->resume_expiry)
+        clients->resume_expiry = client_info->resume_deadline;
+    clients->num_disconnected_clients--;
+    clients->num_parked_clients++;
+    DBG("Slot %" PRIu64 " parked for client 0x%x/%" PRId64,
+        slot, client_info->rank_data.group_uid, client_info->rank_data.group_rank);
+}
+
+/**
+ * @brief Look up the parked slot of a client presenting a resume token. The client gets its
+ * previous identifier back.
+ * Note: this function assumes the execution context is locked before it is invoked.
+ *
+ * @param econtext
+ * @param resume_token Token presented by the client, 0 if none
+ * @param rank_info Group/rank of the client
+ * @return peer_info_t* Client's data, NULL if the client cannot resume
+ */
+static peer_info_t *client_slot_resume(execution_context_t *econtext, uint64_t resume_token, rank_info_t *rank_info)
+{
+    connected_clients_t *clients = &(econtext->server->connected_clients);
+    size_t slot;
+    if (resume_token == 0 || clients->num_parked_clients == 0)
+        return NULL;
+    for (slot = 0; slot < clients->num_slots; slot++)
+    {
+        peer_info_t *client_info = DYN_ARRAY_GET_ELT(&(clients->clients), slot, peer_info_t);
+        assert(client_info);
+        if (!client_info->parked || client_info->resume_token != resume_token)
+            continue;
+        if (client_info->rank_data.host_info != rank_info->host_info ||
+            client_info->rank_data.group_rank != rank_info->group_rank)
+        {
+            WARN_MSG("resume token of slot %" PRIu64 " presented by another client, ignoring it", slot);
+            return NULL;
+        }
+        client_info->parked = false;
+        clients->num_parked_clients--;
+        init_client_slot(client_info);
+        DBG("Client 0x%x/%" PRId64 " resumed as client #%" PRIu64,
+            rank_info->group_uid, rank_info->group_rank, client_info->id);
+        return client_info;
+    }
+    return NULL;
+}
+
+/**
+ * @brief Get the slot of a client that is connecting: its parked slot if it presents a valid
+ * resume token, a new slot otherwise. The client is given a new resume token when resuming
+ * is enabled.
+ * Note: this function assumes the execution context is locked before it is invoked.
+ *
+ * @param econtext
+ * @param resume_token Token presented by the client, 0 if none
+ * @param rank_info Group/rank of the client
+ * @return peer_info_t* Client's data
+ */
+static peer_info_t *client_slot_get(execution_context_t *econtext, uint64_t resume_token, rank_info_t *rank_info)
+{
+    peer_info_t *client_info = client_slot_resume(econtext, resume_token, rank_info);
+    if (client_info == NULL)
+        client_info = client_slot_alloc(econtext);
+    client_info->resume_token = 0;
+    // Only ranks resume, connections between service processes are re-established from scratch
+    if (econtext->engine->settings.resume_ttl > 0 && econtext->scope_id == SCOPE_HOST_DPU)
+        client_info->resume_token = resume_token_generate();
+    return client_info;
+}
+
+/**
+ * @brief Release the slots of the clients that disconnected, or park them if the clients can
+ * resume, and release the parked slots that expired. Once all the clients are gone, e.g., at
+ * the end of a job, the slots are compacted so the next clients get the lowest identifiers again.
+ * Note: this function assumes the execution context is locked before it is invoked.
+ *
+ * @param econtext
+ */
+static void client_slots_reclaim(execution_context_t *econtext)
+{
+    connected_clients_t *clients = &(econtext->server->connected_clients);
+    size_t slot;
+    for (slot = 0; slot < clients->num_slots && clients->num_disconnected_clients > 0; slot++)
+    {
+        peer_info_t *client_info = DYN_ARRAY_GET_ELT(&(clients->clients), slot, peer_info_t);
+        assert(client_info);
+        if (client_info->bootstrapping.phase != DISCONNECTED)
+            continue;
+        if (econtext->engine->settings.resume_ttl > 0 && client_info->resume_token != 0)
+            client_slot_park(econtext, slot);
+        else
+            client_slot_release(econtext, slot);
+    }
+
+    if (clients->num_parked_clients > 0 && monotonic_time_us() >= clients->resume_expiry)
+    {
+        uint64_t now = monotonic_time_us();
+        clients->resume_expiry = UINT64_MAX;
+        for (slot = 0; slot < clients->num_slots; slot++)
+        {
+            peer_info_t *client_info = DYN_ARRAY_GET_ELT(&(clients->clients), slot, peer_info_t);
+            assert(client_info);
+            if (!client_info->parked)
+                continue;
+            if (now >= client_info->resume_deadline)
+            {
+                client_slot_reset(econtext, slot);
+                clients->num_parked_clients--;
+                DBG("Parked slot %" PRIu64 " expired, now at generation %" PRIu32, slot, client_info->generation);
+            }
+            else if (client_info->resume_deadline < clients->resume_expiry)
+            {
+                clients->resume_expiry = client_info->resume_deadline;
+            }
+        }
+    }
+
+    if (clients->num_connected_clients == 0 &&
+        clients->num_ongoing_connections == 0 &&
+        clients->num_oob_handshakes == 0 &&
+        clients->num_disconnected_clients == 0 &&
+        clients->num_parked_clients == 0)
+    {
+        // The generations are preserved so identifiers from before the compaction remain stale
+        clients->num_slots = 0;
+        clients->num_free_slots = 0;
     }
-    ECONTEXT_UNLOCK(econtext);
-    return DO_SUCCESS;
-error_out:
-    ECONTEXT_UNLOCK(econtext);
-    return DO_ERROR;
 }
 
 dpu_offload_status_t set_sock_addr(char *addr, uint16_t port, struct sockaddr_storage *saddr)
@@ -343,119 +496,179 @@ dpu_offload_status_t set_sock_addr(char *addr, uint16_t port, struct sockaddr_st
 }
 
 /**
- * @brief Note: the function assumes the econtext is NOT locked before it is invoked
+ * @brief Initiate the connection of a client to its server. The connection is then established
+ * by oob_client_connect_progress(), which retries with an exponential backoff until the server
+ * accepts the connection or the deadline is reached (see MIMOSA_CONNECT_TIMEOUT).
+ * This function assumes the associated execution context is properly locked before it is invoked.
  *
- * @param econtext
- * @param client_addr
+ * @param client
+ * @param af Address family
  * @return dpu_offload_status_t
  */
-static dpu_offload_status_t oob_server_accept(execution_context_t *econtext, char *client_addr)
+dpu_offload_status_t oob_client_connect(dpu_offload_client_t *client, sa_family_t af)
 {
-    struct sockaddr_in servaddr;
-    int optval = 1;
-    int rc;
-    int accept_sock;
-    struct sockaddr_in addr;
-    socklen_t addr_len = sizeof(client_addr);
+    char service[8];
+    struct addrinfo hints;
+    int ret;
+    execution_context_t *econtext = (execution_context_t *)client->econtext;
 
-    ECONTEXT_LOCK(econtext);
-    uint16_t server_port = econtext->server->conn_params.port;
+    snprintf(service, sizeof(service), "%u", client->conn_params.port);
+    memset(&hints, 0, sizeof(hints));
+    hints.ai_flags = (client->conn_params.addr_str == NULL) ? AI_PASSIVE : 0;
+    hints.ai_family = af;
+    hints.ai_socktype = SOCK_STREAM;
 
-    if (econtext->server->conn_data.oob.listenfd == -1)
-    {
-        econtext->server->conn_data.oob.listenfd = socket(AF_INET, SOCK_STREAM, 0);
+    DBG("Connecting to %s:%" PRIu16, client->conn_params.addr_str, client->conn_params.port);
 
-        memset(&servaddr, 0, sizeof(servaddr));
-        servaddr.sin_family = AF_INET;
-        servaddr.sin_addr.s_addr = htonl(INADDR_ANY);
-        servaddr.sin_port = htons(server_port);
+    ret = getaddrinfo(client->conn_params.addr_str, service, &hints, &(client->conn_data.oob.connect.addrs));
+    CHECK_ERR_RETURN((ret != 0), DO_ERROR, "getaddrinfo() failed: %s", gai_strerror(ret));
+    CHECK_ERR_RETURN((client->conn_data.oob.connect.addrs == NULL), DO_ERROR, "no address for %s", client->conn_params.addr_str);
+    client->conn_data.oob.sock = -1;
+    client->conn_data.oob.connect.cur = client->conn_data.oob.connect.addrs;
+    client->conn_data.oob.connect.pending = false;
+    client->conn_data.oob.connect.start = monotonic_time_us();
+    client->conn_data.oob.connect.next_attempt = client->conn_data.oob.connect.start;
+    client->conn_data.oob.connect.backoff = econtext->engine->settings.connect_backoff_min > 0 ? econtext->engine->settings.connect_backoff_min : 1;
+    client->conn_data.oob.connect.num_attempts = 0;
+    client->conn_data.oob.connect.seed = (unsigned int)(getpid() ^ client->conn_data.oob.connect.start ^ (uintptr_t)client);
+    TRACE_BEGIN(TRACE_PHASE_OOB_CONNECT, econtext, TRACE_NO_PEER);
+    return DO_SUCCESS;
+}
 
-        setsockopt(econtext->server->conn_data.oob.listenfd, SOL_SOCKET, SO_REUSEADDR, &optval, sizeof(optval));
+static void oob_client_connect_fini(dpu_offload_client_t *client)
+{
+    if (client->conn_data.oob.connect.addrs != NULL)
+    {
+        freeaddrinfo(client->conn_data.oob.connect.addrs);
+        client->conn_data.oob.connect.addrs = NULL;
+        client->conn_data.oob.connect.cur = NULL;
+    }
+}
 
-        rc = bind(econtext->server->conn_data.oob.listenfd, (struct sockaddr *)&servaddr, sizeof(servaddr));
-        CHECK_ERR_GOTO((rc), error_out, "bind() failed on port %d: %s", server_port, strerror(errno));
-        rc = listen(econtext->server->conn_data.oob.listenfd, 1024);
-        CHECK_ERR_GOTO((rc), error_out, "listen() failed: %s", strerror(errno));
+// Close the socket of a failed attempt and schedule the next attempt
+static void oob_client_connect_retry(dpu_offload_client_t *client, uint64_t now)
+{
+    execution_context_t *econtext = (execution_context_t *)client->econtext;
+    uint64_t backoff = client->conn_data.oob.connect.backoff;
 
-        // fixme: debug when multi-connections are required
-        DBG("Listening for connections on port %" PRIu16 "... (server: %" PRIu64 ", econtext: %p, scope_id=%d)",
-            server_port, econtext->server->id, econtext, econtext->scope_id);
-    }
-    else
+    close(client->conn_data.oob.sock);
+    client->conn_data.oob.sock = -1;
+    client->conn_data.oob.connect.pending = false;
+    client->conn_data.oob.connect.cur = client->conn_data.oob.connect.cur->ai_next;
+    if (client->conn_data.oob.connect.cur != NULL)
     {
-        DBG("Already listening on socket %d", econtext->server->conn_data.oob.listenfd);
+        // Try the next address right away
+        return;
     }
-    ECONTEXT_UNLOCK(econtext);
-    accept_sock = accept(econtext->server->conn_data.oob.listenfd, (struct sockaddr *)&addr, &addr_len);
-    ECONTEXT_LOCK(econtext);
-    CHECK_ERR_GOTO((accept_sock == -1), error_out, "accept failed: %s", strerror(errno));
-    econtext->server->conn_data.oob.sock = accept_sock;
-    struct in_addr ipAddr = addr.sin_addr;
-    inet_ntop(AF_INET, &ipAddr, client_addr, INET_ADDRSTRLEN);
-    DBG("Connection accepted from %s on fd=%d", client_addr, econtext->server->conn_data.oob.sock);
-    ECONTEXT_UNLOCK(econtext);
-    return DO_SUCCESS;
 
-error_out:
-    ECONTEXT_UNLOCK(econtext);
-    return DO_ERROR;
+    // All the addresses were tried, wait before trying again. Half of the delay is random
+    // so clients started at the same time do not retry in lockstep.
+    client->conn_data.oob.connect.cur = client->conn_data.oob.connect.addrs;
+    client->conn_data.oob.connect.next_attempt = now + backoff / 2 + rand_r(&(client->conn_data.oob.connect.seed)) % (backoff / 2 + 1);
+    backoff *= 2;
+    if (backoff > econtext->engine->settings.connect_backoff_max)
+        backoff = econtext->engine->settings.connect_backoff_max;
+    client->conn_data.oob.connect.backoff = backoff;
 }
 
-// This function assumes the associated execution context is properly locked before it is invoked
-dpu_offload_status_t oob_client_connect(dpu_offload_client_t *client, sa_family_t af)
+/**
+ * @brief Make progress on the connection of a client to its server, without blocking.
+ * This function assumes the associated execution context is properly locked before it is invoked.
+ *
+ * @param[in] client
+ * @param[out] connected Set to true when the connection is established
+ * @return DO_ERROR if the connection could not be established before the deadline, DO_SUCCESS otherwise
+ */
+static dpu_offload_status_t oob_client_connect_progress(dpu_offload_client_t *client, bool *connected)
 {
-    char service[8];
-    struct addrinfo hints, *res, *t;
-    int ret;
-    int rc = 0;
-
-    snprintf(service, sizeof(service), "%u", client->conn_params.port);
-    memset(&hints, 0, sizeof(hints));
-    hints.ai_flags = (client->conn_params.addr_str == NULL) ? AI_PASSIVE : 0;
-    hints.ai_family = af;
-    hints.ai_socktype = SOCK_STREAM;
+    execution_context_t *econtext = (execution_context_t *)client->econtext;
+    uint64_t now = monotonic_time_us();
+    int rc;
 
-    DBG("Connecting to %s:%" PRIu16, client->conn_params.addr_str, client->conn_params.port);
+    *connected = false;
+    while (true)
+    {
+        if (client->conn_data.oob.connect.pending)
+        {
+            int err = 0;
+            socklen_t err_len = sizeof(err);
+            struct pollfd pfd = {.fd = client->conn_data.oob.sock, .events = POLLOUT};
+            rc = poll(&pfd, 1, 0);
+            if (rc == 0 || (rc == -1 && errno == EINTR))
+                break;
+            if (rc == -1 || getsockopt(client->conn_data.oob.sock, SOL_SOCKET, SO_ERROR, &err, &err_len) == -1)
+                err = errno;
+            if (err == 0)
+            {
+                // The bootstrapping frames are exchanged on a blocking socket
+                int flags = fcntl(client->conn_data.oob.sock, F_GETFL);
+                fcntl(client->conn_data.oob.sock, F_SETFL, flags & ~O_NONBLOCK);
+                client->conn_data.oob.connect.pending = false;
+                DBG("Connection established after %ld attempt(s), fd = %d",
+                    client->conn_data.oob.connect.num_attempts, client->conn_data.oob.sock);
+                oob_client_connect_fini(client);
+                TRACE_END(TRACE_PHASE_OOB_CONNECT, econtext, TRACE_NO_PEER);
+                *connected = true;
+                return DO_SUCCESS;
+            }
+            DBG("Connection attempt #%ld failed: %s", client->conn_data.oob.connect.num_attempts, strerror(err));
+            oob_client_connect_retry(client, now);
+            continue;
+        }
 
-    ret = getaddrinfo(client->conn_params.addr_str, service, &hints, &res);
-    CHECK_ERR_RETURN((ret < 0), DO_ERROR, "getaddrinfo() failed");
+        if (now < client->conn_data.oob.connect.next_attempt)
+            break;
 
-    for (t = res; t != NULL; t = t->ai_next)
-    {
-        client->conn_data.oob.sock = socket(t->ai_family, t->ai_socktype, t->ai_protocol);
-        if (client->conn_data.oob.sock < 0)
+        struct addrinfo *t = client->conn_data.oob.connect.cur;
+        client->conn_data.oob.connect.num_attempts++;
+        client->conn_data.oob.sock = socket(t->ai_family, t->ai_socktype | SOCK_NONBLOCK | SOCK_CLOEXEC, t->ai_protocol);
+        CHECK_ERR_RETURN((client->conn_data.oob.sock < 0), DO_ERROR, "socket() failed: %s", strerror(errno));
+        rc = connect(client->conn_data.oob.sock, t->ai_addr, t->ai_addrlen);
+        if (rc == 0 || errno == EINPROGRESS)
         {
+            // Completion is checked with poll(), which also reports immediate success
+            client->conn_data.oob.connect.pending = true;
             continue;
         }
+        DBG("Connection attempt #%ld failed: %s", client->conn_data.oob.connect.num_attempts, strerror(errno));
+        oob_client_connect_retry(client, now);
+    }
 
-        DBG("Connecting to server...");
-        do
+    uint64_t connect_timeout = CLIENT_CONNECT_TIMEOUT(econtext);
+    if (connect_timeout > 0 && now - client->conn_data.oob.connect.start >= connect_timeout * 1000)
+    {
+        ERR_MSG("unable to connect to %s:%" PRIu16 " after %ld attempt(s) in %" PRIu64 " ms",
+                client->conn_params.addr_str,
+                client->conn_params.port,
+                client->conn_data.oob.connect.num_attempts,
+                connect_timeout);
+        if (client->conn_data.oob.sock >= 0)
         {
-            rc = connect(client->conn_data.oob.sock, t->ai_addr, t->ai_addrlen);
-            if (rc == 0)
-            {
-                struct sockaddr_in conn_addr;
-                socklen_t conn_addr_len = sizeof(conn_addr);
-                memset(&conn_addr, 0, sizeof(conn_addr));
-                getsockname(client->conn_data.oob.sock, (struct sockaddr *)&conn_addr, &conn_addr_len);
-                char conn_ip[16];
-                inet_ntop(AF_INET, &(conn_addr.sin_addr), conn_ip, sizeof(conn_ip));
-                DBG("Connection established, fd = %d, addr=%s:%d", client->conn_data.oob.sock, conn_ip, ntohs(conn_addr.sin_port));
-                break;
-            }
-        } while (rc != 0);
-        CHECK_ERR_GOTO((rc != 0), err_close_sockfd, "Connection failed (rc: %d)", rc);
+            close(client->conn_data.oob.sock);
+            client->conn_data.oob.sock = -1;
+        }
+        client->conn_data.oob.connect.pending = false;
+        oob_client_connect_fini(client);
+        TRACE_END(TRACE_PHASE_OOB_CONNECT, econtext, TRACE_NO_PEER);
+        return DO_ERROR;
     }
+    return DO_SUCCESS;
+}
 
-    CHECK_ERR_GOTO((client->conn_data.oob.sock < 0), err_close_sockfd, "Unable to connect to server: invalid file descriptor (%d)", client->conn_data.oob.sock);
+// Block until the pending connection attempt completes or the next attempt is due
+static void oob_client_connect_wait(dpu_offload_client_t *client)
+{
+    if (client->conn_data.oob.connect.pending)
+    {
+        // Bounded so the deadline is checked regularly
+        struct pollfd pfd = {.fd = client->conn_data.oob.sock, .events = POLLOUT};
+        poll(&pfd, 1, 100);
+        return;
+    }
 
-out_free_res:
-    freeaddrinfo(res);
-    return rc;
-err_close_sockfd:
-    close(client->conn_data.oob.sock);
-    rc = DO_ERROR;
-    goto out_free_res;
+    uint64_t now = monotonic_time_us();
+    if (client->conn_data.oob.connect.next_attempt > now)
+        usleep(client->conn_data.oob.connect.next_attempt - now);
 }
 
 static void ep_close(ucp_worker_h ucp_worker, ucp_ep_h ep)
@@ -625,6 +838,9 @@ dpu_offload_status_t client_init_context(execution_context_t *econtext, init_par
         econtext->client->connected_cb = init_params->connected_cb;
     }
 
+    if (init_params != NULL)
+        econtext->client->async_connect = init_params->async_connect;
+
     switch (econtext->client->mode)
     {
     case UCX_LISTENER:
@@ -639,6 +855,11 @@ dpu_offload_status_t client_init_context(execution_context_t *econtext, init_par
         econtext->client->conn_data.oob.local_addr_len = 0;
         econtext->client->conn_data.oob.peer_addr_len = 0;
         econtext->client->conn_data.oob.sock = -1;
+        econtext->client->conn_data.oob.connect.addrs = NULL;
+        econtext->client->conn_data.oob.connect.cur = NULL;
+        econtext->client->conn_data.oob.rdv.active = false;
+        econtext->client->conn_data.oob.rdv.hello_sent = false;
+        econtext->client->conn_data.oob.rdv.queued = false;
 
         ucs_status_t status = ucp_worker_get_address(GET_WORKER(econtext),
                                                      &(econtext->client->conn_data.oob.local_addr),
@@ -700,172 +921,336 @@ static void oob_send_cb(void *request, ucs_status_t status, void *ctx)
 }
 #endif
 
-static void ucx_client_bootstrap_send_cb(void *request, ucs_status_t status, void *user_data)
+// Send an entire buffer on a blocking socket
+static dpu_offload_status_t oob_send_all(int sock, const void *buf, size_t len)
 {
-    am_req_t *ctx = (am_req_t *)user_data;
-    ctx->complete = 1;
-}
-
-static dpu_offload_status_t client_ucx_boostrap_step3(execution_context_t *econtext)
-{
-    ECONTEXT_LOCK(econtext);
-    DBG("Sent addr to server");
-    // We send our "rank", i.e., unique application ID
-    DBG("Sending my group/rank info (0x%x/%" PRId64 ", group seq num: %ld), len=%ld",
-        econtext->rank.group_uid, econtext->rank.group_rank, econtext->rank.group_seq_num, sizeof(econtext->rank));
-    ucp_request_param_t send_param = {0};
-    send_param.op_attr_mask = UCP_OP_ATTR_FIELD_CALLBACK |
-                              UCP_OP_ATTR_FIELD_DATATYPE |
-                              UCP_OP_ATTR_FIELD_USER_DATA;
-    send_param.cb.send = ucx_client_bootstrap_send_cb;
-    send_param.datatype = ucp_dt_make_contig(1);
-    send_param.user_data = &(econtext->client->bootstrapping.rank_ctx);
-    DBG("Tag: %d; scope_id: %d", econtext->client->conn_data.oob.tag, econtext->scope_id);
-    ucp_tag_t ucp_tag = MAKE_SEND_TAG(econtext->client->conn_data.oob.tag,
-                                      econtext->client->id,
-                                      econtext->client->server_id,
-                                      econtext->scope_id, 0);
-    econtext->client->bootstrapping.rank_request = ucp_tag_send_nbx(econtext->client->server_ep,
-                                                                    &(econtext->rank),
-                                                                    sizeof(rank_info_t),
-                                                                    ucp_tag,
-                                                                    &send_param);
-    if (UCS_PTR_IS_ERR(econtext->client->bootstrapping.rank_request))
-    {
-        ERR_MSG("ucp_tag_send_nbx() failed");
-        return DO_ERROR;
-    }
-    if (econtext->client->bootstrapping.rank_request == NULL)
+    size_t offset = 0;
+    while (offset < len)
     {
-        DBG("Send for rank info completed right away");
-        econtext->client->bootstrapping.rank_ctx.complete = true;
-        econtext->client->bootstrapping.phase = UCX_CONNECT_DONE;
+        ssize_t n = send(sock, (const char *)buf + offset, len - offset, MSG_NOSIGNAL);
+        if (n == -1 && errno == EINTR)
+            continue;
+        CHECK_ERR_RETURN((n <= 0), DO_ERROR, "send() failed: %s", strerror(errno));
+        offset += n;
     }
-    ECONTEXT_UNLOCK(econtext);
     return DO_SUCCESS;
 }
 
-static dpu_offload_state_t client_ucx_bootstrap_step2(execution_context_t *econtext)
+// Receive an entire buffer from a blocking socket
+static dpu_offload_status_t oob_recv_all(int sock, void *buf, size_t len)
 {
-    ECONTEXT_LOCK(econtext);
-    DBG("Sent addr size to server: %ld\n", econtext->client->conn_data.oob.local_addr_len);
-    /* 2. Send the address itself */
-    ucp_request_param_t send_param = {0};
-    send_param.op_attr_mask = UCP_OP_ATTR_FIELD_CALLBACK |
-                              UCP_OP_ATTR_FIELD_DATATYPE |
-                              UCP_OP_ATTR_FIELD_USER_DATA;
-    send_param.cb.send = ucx_client_bootstrap_send_cb;
-    send_param.datatype = ucp_dt_make_contig(1);
-    send_param.user_data = &(econtext->client->bootstrapping.addr_ctx);
-    DBG("Tag: %d; scope_id: %d\n", econtext->client->conn_data.oob.tag, econtext->scope_id);
-    ucp_tag_t ucp_tag = MAKE_SEND_TAG(econtext->client->conn_data.oob.tag,
-                                      econtext->client->id,
-                                      econtext->client->server_id,
-                                      econtext->scope_id,
-                                      0);
-    econtext->client->bootstrapping.addr_request = ucp_tag_send_nbx(econtext->client->server_ep,
-                                                                    econtext->client->conn_data.oob.local_addr,
-                                                                    econtext->client->conn_data.oob.local_addr_len,
-                                                                    ucp_tag,
-                                                                    &send_param);
-    if (UCS_PTR_IS_ERR(econtext->client->bootstrapping.addr_request))
-    {
-        ERR_MSG("ucp_tag_send_nbx() failed");
-        return DO_ERROR;
-    }
-    if (econtext->client->bootstrapping.addr_request == NULL)
+    size_t offset = 0;
+    while (offset < len)
     {
-        DBG("Send for address completed right away");
-        econtext->client->bootstrapping.addr_ctx.complete = true;
+        ssize_t n = recv(sock, (char *)buf + offset, len - offset, MSG_WAITALL);
+        if (n == -1 && errno == EINTR)
+            continue;
+        CHECK_ERR_RETURN((n == 0), DO_ERROR, "connection closed by server");
+        CHECK_ERR_RETURN((n < 0), DO_ERROR, "recv() failed: %s", strerror(errno));
+        offset += n;
     }
-    ECONTEXT_UNLOCK(econtext);
     return DO_SUCCESS;
 }
 
-static dpu_offload_status_t client_ucx_bootstrap_step1(execution_context_t *econtext)
+/**
+ * @brief Create the endpoint to the server once its worker address is known.
+ * This function assumes the execution context is locked before it is invoked.
+ *
+ * @param econtext
+ * @return dpu_offload_status_t
+ */
+dpu_offload_status_t oob_client_create_server_ep(execution_context_t *econtext)
 {
-    /* Establish the UCX level connection */
-    ECONTEXT_LOCK(econtext);
+    dpu_offload_client_t *client = econtext->client;
     assert(econtext->type > 0); // should not be unknown
     assert(econtext->type < CONTEXT_LIMIT_MAX);
+    assert(client->conn_data.oob.peer_addr != NULL);
     ucp_ep_params_t ep_params = {0};
     ep_params.field_mask = UCP_EP_PARAM_FIELD_REMOTE_ADDRESS |
                            UCP_EP_PARAM_FIELD_ERR_HANDLING_MODE |
                            UCP_EP_PARAM_FIELD_USER_DATA;
-    ep_params.address = econtext->client->conn_data.oob.peer_addr;
+    ep_params.address = client->conn_data.oob.peer_addr;
     ep_params.err_mode = err_handling_opt.ucp_err_mode;
     ep_params.err_handler.arg = econtext;
-    ep_params.user_data = &(econtext->client->server_ep_status);
-
-    ucs_status_t status = ucp_ep_create(GET_WORKER(econtext), &ep_params, &(econtext->client->server_ep));
-    CHECK_ERR_GOTO((status != UCS_OK), error_out, "ucp_ep_create() failed");
-    DBG("Endpoint %p successfully created", econtext->client->server_ep);
-
-    ucp_request_param_t send_param = {0};
-    send_param.op_attr_mask = UCP_OP_ATTR_FIELD_CALLBACK |
-                              UCP_OP_ATTR_FIELD_DATATYPE |
-                              UCP_OP_ATTR_FIELD_USER_DATA;
-    send_param.cb.send = ucx_client_bootstrap_send_cb;
-    send_param.datatype = ucp_dt_make_contig(1);
-    send_param.user_data = &(econtext->client->bootstrapping.addr_size_ctx);
-
-    /* 1. Send the address size */
-    ucp_tag_t ucp_tag = MAKE_SEND_TAG(econtext->client->conn_data.oob.tag,
-                                      econtext->client->id,
-                                      econtext->client->server_id,
-                                      econtext->scope_id,
-                                      0);
-    DBG("Tag: %d; scope_id: %d\n", econtext->client->conn_data.oob.tag, econtext->scope_id);
-    econtext->client->bootstrapping.addr_size_request = ucp_tag_send_nbx(econtext->client->server_ep, &(econtext->client->conn_data.oob.local_addr_len), sizeof(size_t), ucp_tag, &send_param);
-    if (UCS_PTR_IS_ERR(econtext->client->bootstrapping.addr_size_request))
-    {
-        ERR_MSG("ucp_tag_recv_nbx() failed");
-        goto error_out;
-    }
-    if (econtext->client->bootstrapping.addr_size_request == NULL)
-    {
-        DBG("Send for my address length completed right away");
-        econtext->client->bootstrapping.addr_size_ctx.complete = 1;
+    ep_params.user_data = &(client->server_ep_status);
+    TRACE_BEGIN(TRACE_PHASE_UCX_EP_CREATE, econtext, TRACE_NO_PEER);
+    ucs_status_t status = ucp_ep_create(GET_WORKER(econtext), &ep_params, &(client->server_ep));
+    TRACE_END(TRACE_PHASE_UCX_EP_CREATE, econtext, TRACE_NO_PEER);
+    CHECK_ERR_RETURN((status != UCS_OK), DO_ERROR, "ucp_ep_create() failed");
+    DBG("Endpoint %p successfully created", client->server_ep);
+    return DO_SUCCESS;
+}
+
+/**
+ * @brief Get the path of the file where a client keeps the resume token given by its server,
+ * one file per server and group rank (see MIMOSA_RESUME_DIR).
+ *
+ * @param econtext
+ * @param path Buffer where the path is stored
+ * @param len Size of the buffer
+ * @return true if the client can resume, false otherwise
+ */
+static bool resume_token_path(execution_context_t *econtext, char *path, size_t len)
+{
+    dpu_offload_client_t *client = econtext->client;
+    if (econtext->engine->settings.resume_dir == NULL ||
+        econtext->scope_id != SCOPE_HOST_DPU ||
+        econtext->rank.group_rank == INVALID_RANK ||
+        client->conn_params.addr_str == NULL)
+        return false;
+    snprintf(path, len, "%s/%s.%s.%" PRIu16 ".%" PRId64,
+             econtext->engine->settings.resume_dir,
+             RESUME_FILE_PREFIX,
+             client->conn_params.addr_str,
+             client->conn_params.port,
+             econtext->rank.group_rank);
+    return true;
+}
+
+/**
+ * @brief Load the resume token given by the server when we last connected to it, if any.
+ *
+ * @param econtext
+ */
+static void resume_token_load(execution_context_t *econtext)
+{
+    char path[PATH_MAX];
+    FILE *f;
+    econtext->client->resume_token = 0;
+    if (!resume_token_path(econtext, path, sizeof(path)))
+        return;
+    f = fopen(path, "r");
+    if (f == NULL)
+        return;
+    if (fscanf(f, "%" SCNx64, &(econtext->client->resume_token)) != 1)
+        econtext->client->resume_token = 0;
+    fclose(f);
+    DBG("Resume token %s from %s", econtext->client->resume_token != 0 ? "loaded" : "not found", path);
+}
+
+/**
+ * @brief Save the resume token the server gave us once connected so the next process with
+ * our group rank can get our slot back. The file is written atomically so a process starting
+ * while the token is updated never reads a partial token.
+ *
+ * @param econtext
+ */
+static void resume_token_save(execution_context_t *econtext)
+{
+    char path[PATH_MAX];
+    char tmp_path[PATH_MAX + 32];
+    FILE *f;
+    if (!resume_token_path(econtext, path, sizeof(path)))
+        return;
+    if (econtext->client->resume_token == 0)
+    {
+        // The server does not let clients resume, a previous token is useless
+        unlink(path);
+        return;
+    }
+    snprintf(tmp_path, sizeof(tmp_path), "%s.%d", path, (int)getpid());
+    f = fopen(tmp_path, "w");
+    if (f == NULL)
+    {
+        WARN_MSG("unable to save resume token in %s: %s", tmp_path, strerror(errno));
+        return;
     }
+    fprintf(f, "%" PRIx64 "\n", econtext->client->resume_token);
+    fclose(f);
+    if (rename(tmp_path, path) != 0)
+    {
+        WARN_MSG("unable to save resume token in %s: %s", path, strerror(errno));
+        unlink(tmp_path);
+    }
+}
+
+/**
+ * @brief Exchange the bootstrapping frames with the server once connected: our frame carries
+ * our group/rank and worker address, the server's frame its identifiers, our client ID and
+ * the server's worker address. The endpoint to the server is created right away, the server
+ * creates its endpoint to us when progressing its execution context.
+ * This function assumes the execution context is locked before it is invoked.
+ *
+ * @param econtext
+ * @return dpu_offload_status_t
+ */
+static dpu_offload_status_t oob_client_bootstrap(execution_context_t *econtext)
+{
+    dpu_offload_client_t *client = econtext->client;
+    void *frame = NULL;
+    int rc;
+
+    TRACE_BEGIN(TRACE_PHASE_OOB_HANDSHAKE, econtext, TRACE_NO_PEER);
+    /* 1. Send our frame */
+    oob_client_hello_t hello;
+    memset(&hello, 0, sizeof(hello));
+    hello.frame_len = sizeof(hello) + client->conn_data.oob.local_addr_len;
+    COPY_RANK_INFO(&(econtext->rank), &(hello.rank_info));
+    hello.resume_token = client->resume_token;
+    hello.addr_len = client->conn_data.oob.local_addr_len;
+    frame = DPU_OFFLOAD_MALLOC(hello.frame_len);
+    CHECK_ERR_GOTO((frame == NULL), error_out, "unable to allocate bootstrapping frame");
+    memcpy(frame, &hello, sizeof(hello));
+    memcpy((char *)frame + sizeof(hello), client->conn_data.oob.local_addr, client->conn_data.oob.local_addr_len);
+    DBG("Sending my group/rank info (0x%x/%" PRId64 ", group seq num: %ld) and address",
+        econtext->rank.group_uid, econtext->rank.group_rank, econtext->rank.group_seq_num);
+    rc = oob_send_all(client->conn_data.oob.sock, frame, hello.frame_len);
+    CHECK_ERR_GOTO((rc), error_out, "oob_send_all() failed");
+    free(frame);
+    frame = NULL;
+
+    /* 2. Receive the server's frame */
+    oob_server_hello_t server_hello;
+    rc = oob_recv_all(client->conn_data.oob.sock, &server_hello, sizeof(server_hello));
+    CHECK_ERR_GOTO((rc), error_out, "oob_recv_all() failed");
+    CHECK_ERR_GOTO((server_hello.addr_len == 0 || server_hello.frame_len != sizeof(server_hello) + server_hello.addr_len),
+                   error_out,
+                   "invalid frame from server (frame length: %" PRIu64 ", address length: %" PRIu64 ")",
+                   server_hello.frame_len,
+                   server_hello.addr_len);
+    client->server_id = server_hello.server_id;
+    client->server_global_id = server_hello.server_global_id;
+    client->id = server_hello.client_id;
+    client->resume_token = server_hello.resume_token;
+    client->conn_data.oob.peer_addr_len = server_hello.addr_len;
+    client->conn_data.oob.peer_addr = DPU_OFFLOAD_MALLOC(client->conn_data.oob.peer_addr_len);
+    CHECK_ERR_GOTO((client->conn_data.oob.peer_addr == NULL), error_out, "Unable to allocate memory");
+    rc = oob_recv_all(client->conn_data.oob.sock, client->conn_data.oob.peer_addr, client->conn_data.oob.peer_addr_len);
+    CHECK_ERR_GOTO((rc), error_out, "oob_recv_all() failed");
+    DBG("Received the server's frame (server ID: %" PRIu64 ", server global ID: %" PRIu64 ", client ID: %" PRIu64 ")",
+        client->server_id, client->server_global_id, client->id);
+
+    /* 3. Create the endpoint to the server */
+    rc = oob_client_create_server_ep(econtext);
+    CHECK_ERR_GOTO((rc), error_out, "oob_client_create_server_ep() failed");
+
+    // The connection completes when progressing the execution context
+    econtext->client->bootstrapping.phase = OOB_CONNECT_DONE;
+    TRACE_END(TRACE_PHASE_OOB_HANDSHAKE, econtext, TRACE_NO_PEER);
+    DBG("%s() done for econtext %p (engine: %p)", __func__, econtext, econtext->engine);
+    return DO_SUCCESS;
+
+error_out:
+    TRACE_END(TRACE_PHASE_OOB_HANDSHAKE, econtext, TRACE_NO_PEER);
+    if (frame != NULL)
+        free(frame);
+    return DO_ERROR;
+}
+
+/**
+ * @brief Connect to the server. Unless connections are asynchronous (see MIMOSA_ASYNC_CONNECT),
+ * the function blocks until the connection is established and the bootstrapping frames exchanged.
+ * Otherwise, the connection is established while progressing the execution context.
+ *
+ * @param econtext
+ * @return dpu_offload_status_t
+ */
+static dpu_offload_status_t oob_connect(execution_context_t *econtext)
+{
+    CHECK_ERR_RETURN((econtext == NULL), DO_ERROR, "undefined client handle");
+    ECONTEXT_LOCK(econtext);
+    dpu_offload_client_t *client = econtext->client;
+    bool connected = false;
+    CHECK_ERR_GOTO((client->conn_data.oob.local_addr == NULL), error_out, "undefined local address");
+    DBG("local address length: %lu", client->conn_data.oob.local_addr_len);
+    // Ends when the bootstrapping completes or fails, see progress_client_econtext()
+    TRACE_BEGIN(TRACE_PHASE_CLIENT_CONNECT, econtext, TRACE_NO_PEER);
+    resume_token_load(econtext);
+
+    if (RENDEZVOUS_BACKEND(econtext->engine) != RENDEZVOUS_OOB)
+    {
+        // The server's address is published, no socket connection is needed
+        int rc = rendezvous_client_connect(econtext);
+        CHECK_ERR_GOTO((rc), error_out, "rendezvous_client_connect() failed");
+        if (econtext->engine->settings.async_connect || client->async_connect)
+        {
+            ECONTEXT_UNLOCK(econtext);
+            return DO_SUCCESS;
+        }
+        while (client->bootstrapping.phase == OOB_CONNECT_IN_PROGRESS)
+        {
+            rc = rendezvous_client_connect_progress(econtext);
+            CHECK_ERR_GOTO((rc), error_out, "rendezvous_client_connect_progress() failed");
+            ucp_worker_progress(GET_WORKER(econtext));
+        }
+        ECONTEXT_UNLOCK(econtext);
+        return DO_SUCCESS;
+    }
+
+    int rc = oob_client_connect(client, ai_family);
+    CHECK_ERR_GOTO((rc), error_out, "oob_client_connect() failed");
+    if (econtext->engine->settings.async_connect || client->async_connect)
+    {
+        client->bootstrapping.phase = OOB_CONNECT_IN_PROGRESS;
+        ECONTEXT_UNLOCK(econtext);
+        return DO_SUCCESS;
+    }
+
+    while (true)
+    {
+        rc = oob_client_connect_progress(client, &connected);
+        CHECK_ERR_GOTO((rc), error_out, "oob_client_connect_progress() failed");
+        if (connected)
+            break;
+        oob_client_connect_wait(client);
+    }
+    rc = oob_client_bootstrap(econtext);
+    CHECK_ERR_GOTO((rc), error_out, "oob_client_bootstrap() failed");
     ECONTEXT_UNLOCK(econtext);
     return DO_SUCCESS;
+
 error_out:
+    TRACE_END(TRACE_PHASE_CLIENT_CONNECT, econtext, TRACE_NO_PEER);
     ECONTEXT_UNLOCK(econtext);
     return DO_ERROR;
 }
 
-static dpu_offload_status_t oob_connect(execution_context_t *econtext)
+/**
+ * @brief Restart the connection of a client that could not connect to its server, i.e., a
+ * client in the DISCONNECTED phase before its bootstrapping completed. The connection is then
+ * established while progressing the execution context.
+ *
+ * @param econtext
+ * @return dpu_offload_status_t
+ */
+dpu_offload_status_t client_reconnect(execution_context_t *econtext)
 {
-    CHECK_ERR_RETURN((econtext == NULL), DO_ERROR, "undefined client handle");
+    CHECK_ERR_RETURN((econtext == NULL || econtext->type != CONTEXT_CLIENT), DO_ERROR, "invalid client handle");
     ECONTEXT_LOCK(econtext);
     dpu_offload_client_t *client = econtext->client;
-    CHECK_ERR_GOTO((client->conn_data.oob.local_addr == NULL), error_out, "undefined local address");
-    DBG("local address length: %lu", client->conn_data.oob.local_addr_len);
+    CHECK_ERR_GOTO((client->bootstrapping.phase != DISCONNECTED), error_out, "client is not disconnected");
+    if (client->conn_data.oob.sock >= 0)
+    {
+        close(client->conn_data.oob.sock);
+        client->conn_data.oob.sock = -1;
+    }
+    if (client->conn_data.oob.peer_addr != NULL)
+    {
+        free(client->conn_data.oob.peer_addr);
+        client->conn_data.oob.peer_addr = NULL;
+    }
+    oob_client_connect_fini(client);
+    TRACE_BEGIN(TRACE_PHASE_CLIENT_CONNECT, econtext, TRACE_NO_PEER);
+
+    if (RENDEZVOUS_BACKEND(econtext->engine) != RENDEZVOUS_OOB)
+    {
+        // The endpoint was created before sending the hello that was not answered
+        rendezvous_client_fini(econtext);
+        if (client->server_ep != NULL)
+        {
+            ep_close(GET_WORKER(econtext), client->server_ep);
+            client->server_ep = NULL;
+        }
+        int rc = rendezvous_client_connect(econtext);
+        CHECK_ERR_GOTO((rc), error_out, "rendezvous_client_connect() failed");
+        ECONTEXT_UNLOCK(econtext);
+        return DO_SUCCESS;
+    }
 
-    size_t addr_len;
     int rc = oob_client_connect(client, ai_family);
     CHECK_ERR_GOTO((rc), error_out, "oob_client_connect() failed");
-    ssize_t size_recvd = recv(client->conn_data.oob.sock, &addr_len, sizeof(addr_len), MSG_WAITALL);
-    DBG("Addr len received (len: %ld): %ld", size_recvd, addr_len);
-    assert(size_recvd == sizeof(addr_len));
-    client->conn_data.oob.peer_addr_len = addr_len;
-    client->conn_data.oob.peer_addr = DPU_OFFLOAD_MALLOC(client->conn_data.oob.peer_addr_len);
-    CHECK_ERR_GOTO((client->conn_data.oob.peer_addr == NULL), error_out, "Unable to allocate memory");
-    size_recvd = recv(client->conn_data.oob.sock, client->conn_data.oob.peer_addr, client->conn_data.oob.peer_addr_len, MSG_WAITALL);
-    DBG("Received the address (size: %ld)", size_recvd);
-    assert(size_recvd == client->conn_data.oob.peer_addr_len);
-    size_recvd = recv(client->conn_data.oob.sock, &(client->server_id), sizeof(client->server_id), MSG_WAITALL);
-    DBG("Received the server ID (size: %ld, id: %" PRIu64 ")", size_recvd, client->server_id);
-    assert(size_recvd == sizeof(client->server_id));
-    size_recvd = recv(client->conn_data.oob.sock, &(client->server_global_id), sizeof(client->server_global_id), MSG_WAITALL);
-    DBG("Received the server global ID (size: %ld, id: %" PRIu64 ")", size_recvd, client->server_global_id);
-    assert(size_recvd == sizeof(client->server_global_id));
-    size_recvd = recv(client->conn_data.oob.sock, &(client->id), sizeof(client->id), MSG_WAITALL);
-    DBG("Received the client ID: %" PRIu64 " (size: %ld)", client->id, size_recvd);
-    assert(size_recvd == sizeof(client->id));
-    econtext->client->bootstrapping.phase = OOB_CONNECT_DONE;
+    client->bootstrapping.phase = OOB_CONNECT_IN_PROGRESS;
     ECONTEXT_UNLOCK(econtext);
-    DBG("%s() done for econtext %p (engine: %p)", __func__, econtext, econtext->engine);
     return DO_SUCCESS;
 
 error_out:
@@ -889,6 +1274,21 @@ finalize_connection_to_remote_service_proc(offloading_engine_t *offload_engine,
                                                        remote_sp->idx,
                                                        remote_service_proc_info_t);
     assert(sp);
+    // Now that the bootstrapping completed, the client ID assigned by the server is known
+    assert(client->client->id != UINT64_MAX);
+    assert(client->client->server_global_id != UINT64_MAX);
+    CLIENT_SERVER_ADD(offload_engine,
+                      client->client->id,
+                      client->client->server_global_id,
+                      client);
+    if (sp->econtext != NULL && sp->econtext != client)
+    {
+        // With on-demand connections, the remote service process connected to us first and
+        // that connection is already used for notifications.
+        DBG("Service process #%" PRIu64 " already connected through execution context %p", remote_sp->idx, sp->econtext);
+        ENGINE_UNLOCK(offload_engine);
+        return DO_SUCCESS;
+    }
     sp->ep = client->client->server_ep;
     sp->econtext = client;
     sp->addr = client->client->conn_data.oob.peer_addr;
@@ -928,6 +1328,9 @@ static void progress_servers(offloading_engine_t *engine)
     }
 }
 
+extern dpu_offload_status_t progress_pending_sp_notifs(offloading_engine_t *engine);
+extern dpu_offload_status_t inter_sp_connect_mgr_progress(offloading_engine_t *engine);
+extern void inter_sp_connect_mgr_completed(offloading_engine_t *engine, remote_service_procs_connect_tracker_t *tracker);
 dpu_offload_status_t offload_engine_progress(offloading_engine_t *engine)
 {
     assert(engine);
@@ -973,10 +1376,15 @@ dpu_offload_status_t offload_engine_progress(offloading_engine_t *engine)
                                                                                      engine->inter_service_proc_clients[c].remote_service_proc_info,
                                                                                      engine->inter_service_proc_clients[c].client_econtext);
                 CHECK_ERR_RETURN((rc), DO_ERROR, "finalize_connection_to_remote_service_proc() failed");
-                ECONTEXT_UNLOCK(c_econtext);
+                inter_sp_connect_mgr_completed(engine, &(engine->inter_service_proc_clients[c]));
+                ECONTEXT_LOCK(c_econtext);
             }
             ECONTEXT_UNLOCK(c_econtext);
         }
+
+        // Restart failed connections and initiate the queued ones
+        dpu_offload_status_t connect_rc = inter_sp_connect_mgr_progress(engine);
+        CHECK_ERR_RETURN((connect_rc), DO_ERROR, "inter_sp_connect_mgr_progress() failed");
         progress_servers(engine);
 
         // Progress all the execution context used to connect to other service processes
@@ -996,6 +1404,13 @@ dpu_offload_status_t offload_engine_progress(offloading_engine_t *engine)
 
             econtext->progress(econtext);
         }
+
+        // Send the notifications that were waiting for a connection to be established
+        if (!ucs_list_is_empty(&(engine->pending_sp_notifs)))
+        {
+            dpu_offload_status_t rc = progress_pending_sp_notifs(engine);
+            CHECK_ERR_RETURN((rc), DO_ERROR, "progress_pending_sp_notifs() failed");
+        }
     }
     else
     {
@@ -1005,7 +1420,12 @@ dpu_offload_status_t offload_engine_progress(offloading_engine_t *engine)
         }
         progress_servers(engine);
     }
-    return DO_SUCCESS;
+
+    // No group cache handle is in use at this point, evict group caches if above the memory budget
+    group_cache_enforce_mem_budget(&(engine->procs_cache));
+
+    // Continue the construction of the lookup tables of large groups, if any
+    return group_cache_lookup_tables_progress(engine);
 }
 
 dpu_offload_status_t lib_progress(execution_context_t *econtext)
@@ -1061,6 +1481,12 @@ dpu_offload_status_t offload_engine_init(offloading_engine_t **engine)
     rc = engine_get_env_config(d);
     CHECK_ERR_GOTO((rc != DO_SUCCESS), error_out, "engine_get_env_config() failed");
 
+    if (d->settings.trace_dir != NULL && trace_init(d->settings.trace_dir, d->settings.trace_ring_size) != 0)
+    {
+        WARN_MSG("unable to create the bootstrap trace in %s, tracing is disabled", d->settings.trace_dir);
+        d->settings.trace_dir = NULL;
+    }
+
     if (d->settings.buddy_buffer_system_enabled)
         SMART_BUFFS_INIT(&(d->smart_buffer_sys), NULL);
     if (d->settings.ucx_am_backend_enabled)
@@ -1105,6 +1531,16 @@ dpu_offload_status_t offload_engine_init(offloading_engine_t **engine)
         self_econtext,
         self_econtext->scope_id);
 
+    rc = alltoallv_register(d);
+    CHECK_ERR_GOTO((rc), error_out, "alltoallv_register() failed");
+    rc = allreduce_register(d);
+    CHECK_ERR_GOTO((rc), error_out, "allreduce_register() failed");
+    rc = bcast_register(d);
+    CHECK_ERR_GOTO((rc), error_out, "bcast_register() failed");
+    // Cache entries of the local ranks of other service processes, see broadcast_group_cache()
+    rc = bcast_register_handler(d, BCAST_TYPE_GROUP_CACHE, recv_peer_cache_entries);
+    CHECK_ERR_GOTO((rc), error_out, "bcast_register_handler() failed");
+
     *engine = d;
     return DO_SUCCESS;
 error_out:
@@ -1154,7 +1590,7 @@ static void progress_server_event_recv(execution_context_t *econtext)
     size_t idx = 0;
     int rc;
     ECONTEXT_LOCK(econtext);
-    while (n_client < econtext->server->connected_clients.num_connected_clients)
+    while (n_client < econtext->server->connected_clients.num_connected_clients && idx < econtext->server->connected_clients.num_slots)
     {
         peer_info_t *client_info = DYN_ARRAY_GET_ELT(&(econtext->server->connected_clients.clients), idx, peer_info_t);
         if (client_info == NULL || client_info->bootstrapping.phase != BOOTSTRAP_DONE)
@@ -1424,6 +1860,7 @@ add_cache_entry_for_new_client(peer_info_t *client_info, execution_context_t *ct
                                                  client_info->rank_data.group_rank,
                                                  client_info->rank_data.group_size);
         assert(cache_entry);
+        PREPARE_PEER_CACHE_ENTRY(cache_entry);
         COPY_RANK_INFO(&(client_info->rank_data), &(cache_entry->peer.proc_info));
         cache_entry->client_id = client_info->id;
         cache_entry->num_shadow_service_procs = 1;
@@ -1448,6 +1885,7 @@ add_cache_entry_for_new_client(peer_info_t *client_info, execution_context_t *ct
         }
         gp_cache->n_local_ranks_populated++;
         gp_cache->num_local_entries++;
+        group_cache_record_milestone(ctx->engine, gp_cache, GROUP_CACHE_MILESTONE_FIRST_LOCAL_RANK);
         cache_entry->client_id = client_info->id;
         cache_entry->peer.addr_len = client_info->peer_addr_len;
         if (client_info->peer_addr != NULL)
@@ -1475,155 +1913,128 @@ add_cache_entry_for_new_client(peer_info_t *client_info, execution_context_t *ct
 
 static void progress_server_econtext(execution_context_t *ctx)
 {
+    // Clients connecting through a rendezvous backend join the ongoing connections once their hello is handled
+    rendezvous_server_progress(ctx);
+
+    if (ctx->server->connected_clients.num_disconnected_clients > 0 ||
+        ctx->server->connected_clients.num_parked_clients > 0)
+    {
+        ECONTEXT_LOCK(ctx);
+        client_slots_reclaim(ctx);
+        ECONTEXT_UNLOCK(ctx);
+    }
+
     if (ctx->server->connected_clients.num_ongoing_connections > 0)
     {
         size_t i = 0; // Number of ongoing connections we already handled
         size_t idx = 0;
         // Find the clients that are currently connecting
-        while (i < ctx->server->connected_clients.num_ongoing_connections && idx < ctx->server->connected_clients.clients.capacity)
+        while (i < ctx->server->connected_clients.num_ongoing_connections && idx < ctx->server->connected_clients.num_slots)
         {
             peer_info_t *client_info = DYN_ARRAY_GET_ELT(&(ctx->server->connected_clients.clients), idx, peer_info_t);
             assert(client_info);
             if (client_info->bootstrapping.phase == OOB_CONNECT_DONE)
             {
+                // The OOB handshake gave us the client's address and group/rank,
+                // the endpoint is all that is left to fully connect the client.
                 dpu_offload_status_t rc;
-                if (client_info->bootstrapping.addr_size_ctx.complete == false && client_info->bootstrapping.addr_size_request == NULL)
-                {
-                    DBG("UCX level bootstrap - client #%" PRIu64 ", step 1 - Getting address size", idx);
-                    rc = oob_server_ucx_client_connection_step1(ctx, client_info);
-                    if (rc)
-                    {
-                        ERR_MSG("oob_server_ucx_client_connection_step1() failed");
-                        return;
-                    }
-                }
-
-                if (client_info->bootstrapping.addr_size_ctx.complete == true && client_info->bootstrapping.addr_size_request != NULL)
-                {
-                    // The send did not complete right away but now is, some clean up to do
-                    ucp_request_free(client_info->bootstrapping.addr_size_request);
-                    client_info->bootstrapping.addr_size_request = NULL;
-                }
-
-                if (client_info->bootstrapping.addr_size_ctx.complete == true && client_info->bootstrapping.addr_ctx.complete == false && client_info->bootstrapping.addr_request == NULL)
+                ECONTEXT_LOCK(ctx);
+                TRACE_BEGIN(TRACE_PHASE_SERVER_BOOTSTRAP, ctx, client_info->id);
+                rc = oob_server_create_client_ep(ctx, client_info);
+                if (rc)
                 {
-                    DBG("UCX level bootstrap - client #%" PRIu64 ", step 2 - Getting address", idx);
-                    rc = oob_server_ucx_client_connection_step2(ctx, client_info);
-                    if (rc)
-                    {
-                        ERR_MSG("oob_server_ucx_client_connection_step2() failed");
-                        return;
-                    }
+                    ERR_MSG("oob_server_create_client_ep() failed");
+                    ECONTEXT_UNLOCK(ctx);
+                    return;
                 }
-
-                if (client_info->bootstrapping.addr_ctx.complete == true && client_info->bootstrapping.addr_request != NULL)
+                client_info->bootstrapping.phase = UCX_CONNECT_DONE;
+                rc = rendezvous_server_welcome(ctx, client_info);
+                if (rc)
                 {
-                    // The send did not complete right away but now is, some clean up to do
-                    ucp_request_free(client_info->bootstrapping.addr_request);
-                    client_info->bootstrapping.addr_request = NULL;
+                    ERR_MSG("rendezvous_server_welcome() failed");
+                    ECONTEXT_UNLOCK(ctx);
+                    return;
                 }
-
-                if (client_info->bootstrapping.addr_ctx.complete == true && client_info->bootstrapping.rank_ctx.complete == false && client_info->bootstrapping.rank_request == NULL)
+                DBG("group/rank received: (0x%x/%" PRId64 "); group_size: %ld, local ranks: %ld",
+                    client_info->rank_data.group_uid,
+                    client_info->rank_data.group_rank,
+                    client_info->rank_data.group_size,
+                    client_info->rank_data.n_local_ranks);
+
+                // add_cache_entry_for_new_client checks if the data actually needs to be put in the cache
+                rc = add_cache_entry_for_new_client(client_info, ctx);
+                if (rc == DO_ERROR)
                 {
-                    DBG("UCX level bootstrap - client #%" PRIu64 ", step 3 - Getting rank info", idx);
-                    rc = oob_server_ucx_client_connection_step3(ctx, client_info);
-                    if (rc)
-                    {
-                        ERR_MSG("oob_server_ucx_client_connection_step3() failed");
-                        return;
-                    }
+                    ECONTEXT_UNLOCK(ctx);
+                    return;
                 }
 
-                if (client_info->bootstrapping.rank_ctx.complete == true)
+                if (ECONTEXT_ON_DPU(ctx) && ctx->scope_id == SCOPE_INTER_SERVICE_PROCS)
                 {
-                    if (client_info->bootstrapping.rank_request != NULL)
-                    {
-                        // The send did not complete right away but now is, some clean up to do
-                        ucp_request_free(client_info->bootstrapping.rank_request);
-                        client_info->bootstrapping.rank_request = NULL;
-                    }
-
-                    // If we got the rank info but still in the OOB_CONNECT_DONE phase,
-                    // it means we received all the data but did not update the local cache
-                    // and fully complete the local initialization for the client.
-                    ECONTEXT_LOCK(ctx);
-                    client_info->bootstrapping.phase = UCX_CONNECT_DONE;
-                    DBG("group/rank received: (0x%x/%" PRId64 "); group_size: %ld, local ranks: %ld",
-                        client_info->rank_data.group_uid,
-                        client_info->rank_data.group_rank,
-                        client_info->rank_data.group_size,
-                        client_info->rank_data.n_local_ranks);
-
-                    // add_cache_entry_for_new_client checks if the data actually needs to be put in the cache
-                    rc = add_cache_entry_for_new_client(client_info, ctx);
-                    if (rc == DO_ERROR)
+                    size_t service_proc = client_info->rank_data.group_rank;
+                    remote_service_proc_info_t *sp = DYN_ARRAY_GET_ELT(GET_ENGINE_LIST_SERVICE_PROCS(ctx->engine),
+                                                                       service_proc,
+                                                                       remote_service_proc_info_t);
+                    assert(sp);
+                    assert(service_proc < ctx->engine->num_service_procs);
+                    assert(ctx->engine);
+                    // With on-demand connections, our own connection to that service process may have completed first
+                    if (sp->conn_status != CONNECT_STATUS_CONNECTED)
                     {
-                        ECONTEXT_UNLOCK(ctx);
-                        return;
-                    }
-
-                    if (ECONTEXT_ON_DPU(ctx) && ctx->scope_id == SCOPE_INTER_SERVICE_PROCS)
-                    {
-                        size_t service_proc = client_info->rank_data.group_rank;
-                        remote_service_proc_info_t *sp = DYN_ARRAY_GET_ELT(GET_ENGINE_LIST_SERVICE_PROCS(ctx->engine),
-                                                                           service_proc,
-                                                                           remote_service_proc_info_t);
-                        assert(sp);
-                        assert(service_proc < ctx->engine->num_service_procs);
-                        assert(ctx->engine);
                         // Set the endpoint to communicate with that remote service process
                         sp->ep = client_info->ep;
                         // Set the pointer to the execution context in the list of know service processes. Used for notifications with the remote service process.
                         sp->econtext = ctx;
-                        DBG("-> Service process #%ld: addr=%s, port=%d, ep=%p, econtext=%p, client_id=%" PRIu64 ", server_id=%" PRIu64 "", service_proc,
-                            sp->init_params.conn_params->addr_str,
-                            sp->init_params.conn_params->port,
-                            sp->ep,
-                            ctx,
-                            client_info->id,
-                            ctx->server->id);
                     }
-
-                    client_info->bootstrapping.phase = BOOTSTRAP_DONE;
-                    ctx->server->connected_clients.num_ongoing_connections--;
-                    ctx->server->connected_clients.num_connected_clients++;
-                    ctx->server->connected_clients.num_total_connected_clients++;
-                    DBG("****** Bootstrapping of client #%ld now completed in scope %d (econtext: %p, engine: %p), %ld are now connected (connected service processes: %ld)",
-                        idx,
-                        ctx->scope_id,
+                    DBG("-> Service process #%ld: addr=%s, port=%d, ep=%p, econtext=%p, client_id=%" PRIu64 ", server_id=%" PRIu64 "", service_proc,
+                        sp->init_params.conn_params->addr_str,
+                        sp->init_params.conn_params->port,
+                        sp->ep,
                         ctx,
-                        ctx->engine,
-                        ctx->server->connected_clients.num_connected_clients,
-                        ctx->engine->num_connected_service_procs);
-
-                    // Trigger the exchange of the cache between service processes when all the local ranks are connected
-                    // Do not check for errors, it may fail at this point (if all service processes are not connected) and it is okay
-                    if (ECONTEXT_ON_DPU(ctx) &&
-                        ctx->scope_id == SCOPE_HOST_DPU &&
-                        client_info->rank_data.group_uid != INT_MAX &&
-                        client_info->rank_data.group_rank != INVALID_RANK)
-                    {
-                        if (ctx->engine->host_id == UINT64_MAX)
-                            ctx->engine->host_id = client_info->rank_data.host_info;
-                        GROUP_CACHE_EXCHANGE(ctx->engine,
-                                             client_info->rank_data.group_uid,
-                                             client_info->rank_data.n_local_ranks);
-                    }
+                        client_info->id,
+                        ctx->server->id);
+                }
 
-                    if (ctx->server->connected_cb != NULL)
-                    {
-                        DBG("Invoking connection completion callback...");
-                        connected_peer_data_t cb_data = {
-                            .addr = client_info->peer_addr,
-                            .addr_len = client_info->peer_addr_len,
-                            .econtext = ctx,
-                            .peer_id = idx,
-                            .rank_info = client_info->rank_data,
-                        };
-                        ctx->server->connected_cb(&cb_data);
-                    }
-                    ECONTEXT_UNLOCK(ctx);
+                client_info->bootstrapping.phase = BOOTSTRAP_DONE;
+                ctx->server->connected_clients.num_ongoing_connections--;
+                ctx->server->connected_clients.num_connected_clients++;
+                ctx->server->connected_clients.num_total_connected_clients++;
+                DBG("****** Bootstrapping of client #%ld now completed in scope %d (econtext: %p, engine: %p), %ld are now connected (connected service processes: %ld)",
+                    idx,
+                    ctx->scope_id,
+                    ctx,
+                    ctx->engine,
+                    ctx->server->connected_clients.num_connected_clients,
+                    ctx->engine->num_connected_service_procs);
+
+                // Trigger the exchange of the cache between service processes when all the local ranks are connected
+                // Do not check for errors, it may fail at this point (if all service processes are not connected) and it is okay
+                if (ECONTEXT_ON_DPU(ctx) &&
+                    ctx->scope_id == SCOPE_HOST_DPU &&
+                    client_info->rank_data.group_uid != INT_MAX &&
+                    client_info->rank_data.group_rank != INVALID_RANK)
+                {
+                    if (ctx->engine->host_id == UINT64_MAX)
+                        ctx->engine->host_id = client_info->rank_data.host_info;
+                    GROUP_CACHE_EXCHANGE(ctx->engine,
+                                         client_info->rank_data.group_uid,
+                                         client_info->rank_data.n_local_ranks);
                 }
+
+                if (ctx->server->connected_cb != NULL)
+                {
+                    DBG("Invoking connection completion callback...");
+                    connected_peer_data_t cb_data = {
+                        .addr = client_info->peer_addr,
+                        .addr_len = client_info->peer_addr_len,
+                        .econtext = ctx,
+                        .peer_id = idx,
+                        .rank_info = client_info->rank_data,
+                    };
+                    ctx->server->connected_cb(&cb_data);
+                }
+                TRACE_END(TRACE_PHASE_SERVER_BOOTSTRAP, ctx, client_info->id);
+                ECONTEXT_UNLOCK(ctx);
                 i++; // We just finished handling a client in the process of connecting
             }
             idx++;
@@ -1633,88 +2044,52 @@ static void progress_server_econtext(execution_context_t *ctx)
 
 static void progress_client_econtext(execution_context_t *ctx)
 {
-    if (ctx->client->bootstrapping.phase == OOB_CONNECT_DONE)
+    if (ctx->client->bootstrapping.phase == OOB_CONNECT_IN_PROGRESS)
     {
+        bool connected = false;
         dpu_offload_status_t rc;
-        // Need now to progress UCX bootstrapping
-        if (ctx->client->bootstrapping.addr_size_ctx.complete == false && ctx->client->bootstrapping.addr_size_request == NULL)
-        {
-            DBG("UCX level bootstrap - step 1");
-            rc = client_ucx_bootstrap_step1(ctx);
-            if (rc)
-            {
-                ERR_MSG("client_ucx_bootstrap_step1() failed");
-                return;
-            }
-        }
-
-        if (ctx->client->bootstrapping.addr_size_ctx.complete == true && ctx->client->bootstrapping.addr_size_request != NULL)
-        {
-            // The send did not complete right away but now is, some clean up to do
-            ucp_request_free(ctx->client->bootstrapping.addr_size_request);
-            ctx->client->bootstrapping.addr_size_request = NULL;
-        }
-
-        if (ctx->client->bootstrapping.addr_size_ctx.complete == true && ctx->client->bootstrapping.addr_ctx.complete == false && ctx->client->bootstrapping.addr_request == NULL)
-        {
-            DBG("UCX level boostrap - step 2");
-            rc = client_ucx_bootstrap_step2(ctx);
-            if (rc)
-            {
-                ERR_MSG("client_ucx_boostrap_step2() failed");
-                return;
-            }
-        }
-
-        if (ctx->client->bootstrapping.addr_ctx.complete == true && ctx->client->bootstrapping.addr_request != NULL)
+        ECONTEXT_LOCK(ctx);
+        if (ctx->client->conn_data.oob.rdv.active)
         {
-            // The send did not complete right away but now is, some clean up to do
-            ucp_request_free(ctx->client->bootstrapping.addr_request);
-            ctx->client->bootstrapping.addr_request = NULL;
+            // The connection completes when the server's welcome is received
+            rc = rendezvous_client_connect_progress(ctx);
         }
-
-        if (ctx->client->bootstrapping.addr_ctx.complete == true && ctx->client->bootstrapping.rank_ctx.complete == false && ctx->client->bootstrapping.rank_request == NULL)
+        else
         {
-            DBG("UCX level boostrap - step 3");
-            rc = client_ucx_boostrap_step3(ctx);
-            if (rc)
-            {
-                ERR_MSG("client_ucx_boostrap_step3() failed");
-                return;
-            }
+            rc = oob_client_connect_progress(ctx->client, &connected);
+            if (rc == DO_SUCCESS && connected)
+                rc = oob_client_bootstrap(ctx);
         }
-
-        if (ctx->client->bootstrapping.rank_ctx.complete == true && ctx->client->bootstrapping.rank_request != NULL)
+        if (rc != DO_SUCCESS)
         {
-            // The send did not complete right away but now is, some clean up to do
-            ucp_request_free(ctx->client->bootstrapping.rank_request);
-            ctx->client->bootstrapping.rank_request = NULL;
-            ctx->client->bootstrapping.phase = UCX_CONNECT_DONE;
+            ERR_MSG("connection to server %s:%" PRIu16 " failed",
+                    ctx->client->conn_params.addr_str, ctx->client->conn_params.port);
+            ctx->client->bootstrapping.phase = DISCONNECTED;
+            TRACE_END(TRACE_PHASE_CLIENT_CONNECT, ctx, TRACE_NO_PEER);
         }
+        ECONTEXT_UNLOCK(ctx);
+    }
 
-        if (ctx->client->bootstrapping.addr_size_ctx.complete == true &&
-            ctx->client->bootstrapping.addr_ctx.complete == true &&
-            ctx->client->bootstrapping.rank_ctx.complete == true &&
-            ctx->client->bootstrapping.addr_size_request == NULL &&
-            ctx->client->bootstrapping.addr_request == NULL &&
-            ctx->client->bootstrapping.rank_request == NULL)
+    if (ctx->client->bootstrapping.phase == OOB_CONNECT_DONE)
+    {
+        // Everything was exchanged during the OOB handshake and the endpoint to the server is ready
+        ctx->client->bootstrapping.phase = BOOTSTRAP_DONE;
+        TRACE_END(TRACE_PHASE_CLIENT_CONNECT, ctx, TRACE_NO_PEER);
+        resume_token_save(ctx);
+        if (ctx->client->connected_cb != NULL)
         {
-            ctx->client->bootstrapping.phase = BOOTSTRAP_DONE;
-            if (ctx->client->connected_cb != NULL)
-            {
-                DBG("Successfully connected, invoking connected callback (econtext: %p, client: %p, cb: %p)",
-                    ctx, ctx->client, ctx->client->connected_cb);
-                connected_peer_data_t cb_data;
-                assert(ctx->client);
-                assert(ctx->client->conn_params.addr_str);
-                cb_data.addr = ctx->client->conn_params.addr_str;
-                cb_data.addr_len = strlen(ctx->client->conn_params.addr_str);
-                cb_data.econtext = ctx;
-                cb_data.peer_id = ctx->client->server_id;
-                cb_data.global_peer_id = ctx->client->server_global_id;
-                cb_data.rank_info = ctx->rank;
-                ctx->client->connected_cb(&cb_data);
-            }
+            DBG("Successfully connected, invoking connected callback (econtext: %p, client: %p, cb: %p)",
+                ctx, ctx->client, ctx->client->connected_cb);
+            connected_peer_data_t cb_data;
+            assert(ctx->client);
+            assert(ctx->client->conn_params.addr_str);
+            cb_data.addr = ctx->client->conn_params.addr_str;
+            cb_data.addr_len = strlen(ctx->client->conn_params.addr_str);
+            cb_data.econtext = ctx;
+            cb_data.peer_id = ctx->client->server_id;
+            cb_data.global_peer_id = ctx->client->server_global_id;
+            cb_data.rank_info = ctx->rank;
+            ctx->client->connected_cb(&cb_data);
         }
     }
 }
@@ -1744,6 +2119,8 @@ static void term_notification_completed(execution_context_t *econtext)
         break;
     default:
         // OOB
+        oob_client_connect_fini(econtext->client);
+        rendezvous_client_fini(econtext);
         if (econtext->client->conn_data.oob.sock > 0)
         {
             close(econtext->client->conn_data.oob.sock);
@@ -1917,6 +2294,7 @@ execution_context_t *client_init(offloading_engine_t *offload_engine, init_param
 {
     execution_context_t *ctx = NULL;
 
+    TRACE_BEGIN(TRACE_PHASE_CLIENT_INIT, NULL, TRACE_NO_PEER);
     CHECK_ERR_GOTO((offload_engine == NULL), error_out, "Undefined handle");
     CHECK_ERR_GOTO((offload_engine->client != NULL), error_out, "offload engine already initialized as a client");
 
@@ -1992,6 +2370,23 @@ execution_context_t *client_init(offloading_engine_t *offload_engine, init_param
     ctx->client->event_channels->econtext = (struct execution_context *)ctx;
     DBG("event channels successfully initialized");
 
+    // We add ourselves to the local EP cache as shadow service process. It is done before
+    // connecting so the group/rank sent during bootstrapping includes the group's sequence number.
+    if (ctx->rank.group_uid != INT_MAX &&
+        ctx->rank.group_rank != INVALID_RANK &&
+        !is_in_cache(&(offload_engine->procs_cache), ctx->rank.group_uid, ctx->rank.group_rank, ctx->rank.group_size))
+    {
+        dpu_offload_state_t ret;
+        group_cache_t *gp_cache = NULL;
+        assert(offload_engine->procs_cache.world_group == ctx->rank.group_uid);
+        gp_cache = GET_GROUP_CACHE(&(offload_engine->procs_cache), ctx->rank.group_uid);
+        assert(gp_cache);
+        assert(gp_cache->persistent.num == 0); // The group is not in use yet so its seq num should be 0
+        ctx->rank.group_seq_num = gp_cache->persistent.num = 1; // Now we mark it as in use so the seq num is set to 1
+        ret = host_add_local_rank_to_cache(offload_engine, &(ctx->rank));
+        CHECK_ERR_GOTO((ret != DO_SUCCESS), error_out, "host_add_local_rank_to_cache() failed (rc: %d)", ret);
+    }
+
     switch (ctx->client->mode)
     {
     case UCX_LISTENER:
@@ -2014,24 +2409,10 @@ execution_context_t *client_init(offloading_engine_t *offload_engine, init_param
     ECONTEXT_UNLOCK(ctx);
     CHECK_ERR_GOTO((rc), error_out, "register_default_notfications() failed");
 
-    // We add ourselves to the local EP cache as shadow service process
-    if (ctx->rank.group_uid != INT_MAX &&
-        ctx->rank.group_rank != INVALID_RANK &&
-        !is_in_cache(&(offload_engine->procs_cache), ctx->rank.group_uid, ctx->rank.group_rank, ctx->rank.group_size))
-    {
-        dpu_offload_state_t ret;
-        group_cache_t *gp_cache = NULL;
-        assert(offload_engine->procs_cache.world_group == ctx->rank.group_uid);
-        gp_cache = GET_GROUP_CACHE(&(offload_engine->procs_cache), ctx->rank.group_uid);
-        assert(gp_cache);
-        assert(gp_cache->persistent.num == 0); // The group is not in use yet so its seq num should be 0
-        ctx->rank.group_seq_num = gp_cache->persistent.num = 1; // Now we mark it as in use so the seq num is set to 1
-        ret = host_add_local_rank_to_cache(offload_engine, &(ctx->rank));
-        CHECK_ERR_GOTO((ret != DO_SUCCESS), error_out, "host_add_local_rank_to_cache() failed (rc: %d)", ret);
-    }
-
+    TRACE_END(TRACE_PHASE_CLIENT_INIT, NULL, TRACE_NO_PEER);
     return ctx;
 error_out:
+    TRACE_END(TRACE_PHASE_CLIENT_INIT, NULL, TRACE_NO_PEER);
     if (offload_engine->client != NULL)
     {
         free(offload_engine->client);
@@ -2040,22 +2421,95 @@ error_out:
     return NULL;
 }
 
+dpu_offload_status_t offload_engine_job_reset(offloading_engine_t *engine)
+{
+    size_t i;
+    CHECK_ERR_RETURN((engine == NULL), DO_ERROR, "undefined engine");
+
+    // The ranks of the job must be gone, the connections between service processes are not affected
+    for (i = 0; i < engine->num_servers; i++)
+    {
+        execution_context_t *econtext = engine->servers[i];
+        connected_clients_t *clients;
+        size_t slot;
+        if (econtext == NULL || econtext->scope_id != SCOPE_HOST_DPU)
+            continue;
+        ECONTEXT_LOCK(econtext);
+        clients = &(econtext->server->connected_clients);
+        if (clients->num_connected_clients > 0 || clients->num_ongoing_connections > 0 || clients->num_oob_handshakes > 0)
+        {
+            ERR_MSG("%ld ranks of the job are still connected to server %" PRIu64,
+                    clients->num_connected_clients + clients->num_ongoing_connections + clients->num_oob_handshakes,
+                    econtext->server->id);
+            ECONTEXT_UNLOCK(econtext);
+            return DO_ERROR;
+        }
+        // Slots of ranks that disconnected are released or parked right away
+        client_slots_reclaim(econtext);
+        // Parked slots are kept for the ranks of the next job but the cache entries they
+        // reference are about to be released
+        for (slot = 0; slot < clients->num_slots; slot++)
+        {
+            peer_info_t *client_info = DYN_ARRAY_GET_ELT(&(clients->clients), slot, peer_info_t);
+            assert(client_info);
+            if (client_info->cache_entries.base != NULL)
+                memset(client_info->cache_entries.base, 0, client_info->cache_entries.capacity * client_info->cache_entries.type_size);
+        }
+        econtext->server->done = false;
+        ECONTEXT_UNLOCK(econtext);
+    }
+
+    group_caches_reset(engine);
+    ep_pool_flush(engine);
+    op_queues_reset(engine);
+    engine->num_jobs++;
+    DBG("Per-job state released, %" PRIu64 " job(s) completed (%ld service processes connected)",
+        engine->num_jobs, engine->num_connected_service_procs);
+    return DO_SUCCESS;
+}
+
 void offload_engine_fini(offloading_engine_t **offload_engine)
 {
     size_t i;
     assert(offload_engine);
     assert(*offload_engine);
+    oob_reactor_fini(*offload_engine);
+    rendezvous_fini(*offload_engine);
     event_channels_fini(&((*offload_engine)->default_notifications));
+    if ((*offload_engine)->settings.dump_group_cache_timelines)
+        group_cache_timelines_dump(*offload_engine, stderr);
     GROUPS_CACHE_FINI(&((*offload_engine)->procs_cache));
+    ep_pool_fini(*offload_engine);
+    for (i = 0; i < (*offload_engine)->num_registered_ops; i++)
+    {
+        offload_op_t **op = DYN_ARRAY_GET_ELT(&((*offload_engine)->registered_ops), i, offload_op_t *);
+        free(*op);
+    }
+    DYN_ARRAY_FREE(&((*offload_engine)->registered_ops));
+    op_pending_msgs_fini(*offload_engine);
+    op_queues_fini(*offload_engine);
     DYN_LIST_FREE((*offload_engine)->free_op_descs, op_desc_t, item);
     DYN_LIST_FREE((*offload_engine)->free_cache_entry_requests, cache_entry_request_t, item);
     DYN_LIST_FREE((*offload_engine)->pool_conn_params, conn_params_t, item);
     DYN_LIST_FREE((*offload_engine)->pool_remote_dpu_info, remote_dpu_info_t, item);
-    DYN_LIST_FREE((*offload_engine)->pool_group_revoke_msgs_from_sps, group_revoke_msg_from_sp_t, item);
+    group_revoke_msg_pool_fini(&((*offload_engine)->pool_group_revoke_msgs_from_sps));
     DYN_LIST_FREE((*offload_engine)->pool_group_revoke_msgs_from_ranks, group_revoke_msg_from_rank_t, item);
     DYN_LIST_FREE((*offload_engine)->pool_pending_recv_group_add, pending_group_add_t, item);
     DYN_LIST_FREE((*offload_engine)->pool_pending_send_group_add, pending_send_group_add_t, item);
     DYN_LIST_FREE((*offload_engine)->pool_pending_recv_cache_entries, pending_recv_cache_entry_t, item);
+    DYN_LIST_FREE((*offload_engine)->pool_pending_host_cache_requests, pending_host_cache_request_t, item);
+    {
+        // Notifications still waiting for a connection to a service process are dropped
+        pending_sp_notif_t *pending_notif = NULL, *next_pending_notif = NULL;
+        ucs_list_for_each_safe(pending_notif, next_pending_notif, &((*offload_engine)->pending_sp_notifs), item)
+        {
+            ucs_list_del(&(pending_notif->item));
+            if (pending_notif->payload != NULL)
+                free(pending_notif->payload);
+            DYN_LIST_RETURN((*offload_engine)->pool_pending_sp_notifs, pending_notif, item);
+        }
+    }
+    DYN_LIST_FREE((*offload_engine)->pool_pending_sp_notifs, pending_sp_notif_t, item);
     DYN_LIST_FREE((*offload_engine)->free_sp_cache_hash_obj, sp_cache_data_t, item);
     DYN_LIST_FREE((*offload_engine)->free_host_cache_hash_obj, host_cache_data_t, item);
     DYN_ARRAY_FREE(&((*offload_engine)->dpus));
@@ -2138,6 +2592,9 @@ void offload_engine_fini(offloading_engine_t **offload_engine)
         (*offload_engine)->ucp_context = NULL;
     }
 
+    if ((*offload_engine)->settings.trace_dir != NULL)
+        trace_fini();
+
     if ((*offload_engine)->settings.buddy_buffer_system_enabled)
     {
         SMART_BUFFS_FINI(&((*offload_engine)->smart_buffer_sys));
@@ -2332,84 +2789,196 @@ static void oob_recv_rank_handler(void *request, ucs_status_t status,
 }
 #endif
 
-// This function assumes the execution context is properly locked before it is invoked
-static inline uint64_t generate_unique_client_id(execution_context_t *econtext)
+/**
+ * @brief Create the non-blocking socket the server listens on for OOB connections.
+ * The connections are then accepted by the engine's OOB reactor.
+ * Note that this function assumes the execution context is NOT locked before it is invoked.
+ *
+ * @param econtext
+ * @return dpu_offload_status_t
+ */
+dpu_offload_status_t oob_server_listen(execution_context_t *econtext)
+{
+    struct sockaddr_in servaddr;
+    int optval = 1;
+    int rc;
+
+    ECONTEXT_LOCK(econtext);
+    uint16_t server_port = econtext->server->conn_params.port;
+    CHECK_ERR_GOTO((econtext->server->conn_data.oob.listenfd != -1),
+                   error_out,
+                   "already listening on socket %d",
+                   econtext->server->conn_data.oob.listenfd);
+
+    econtext->server->conn_data.oob.listenfd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    CHECK_ERR_GOTO((econtext->server->conn_data.oob.listenfd == -1), error_out, "socket() failed: %s", strerror(errno));
+
+    memset(&servaddr, 0, sizeof(servaddr));
+    servaddr.sin_family = AF_INET;
+    servaddr.sin_addr.s_addr = htonl(INADDR_ANY);
+    servaddr.sin_port = htons(server_port);
+
+    setsockopt(econtext->server->conn_data.oob.listenfd, SOL_SOCKET, SO_REUSEADDR, &optval, sizeof(optval));
+
+    rc = bind(econtext->server->conn_data.oob.listenfd, (struct sockaddr *)&servaddr, sizeof(servaddr));
+    CHECK_ERR_GOTO((rc), error_close, "bind() failed on port %d: %s", server_port, strerror(errno));
+    rc = listen(econtext->server->conn_data.oob.listenfd, SOMAXCONN);
+    CHECK_ERR_GOTO((rc), error_close, "listen() failed: %s", strerror(errno));
+
+    DBG("Listening for connections on port %" PRIu16 "... (server: %" PRIu64 ", econtext: %p, scope_id=%d)",
+        server_port, econtext->server->id, econtext, econtext->scope_id);
+    ECONTEXT_UNLOCK(econtext);
+    return DO_SUCCESS;
+
+error_close:
+    close(econtext->server->conn_data.oob.listenfd);
+    econtext->server->conn_data.oob.listenfd = -1;
+error_out:
+    ECONTEXT_UNLOCK(econtext);
+    return DO_ERROR;
+}
+
+/**
+ * @brief A client was just accepted, the server's frame is prepared once the client's
+ * frame is received so a client presenting a resume token can get its slot back
+ * (see oob_server_handshake_reply()).
+ * Note that this function assumes the execution context is NOT locked before it is invoked.
+ *
+ * @param econtext
+ * @param conn Handle of the accepted connection in the OOB reactor
+ * @return dpu_offload_status_t
+ */
+dpu_offload_status_t oob_server_handshake_start(execution_context_t *econtext, oob_reactor_handle_t *conn)
 {
-    // For now we only use the slot that the client will have in the list of connected clients
-    return (uint64_t)(econtext->server->connected_clients.num_total_connected_clients + econtext->server->connected_clients.num_ongoing_connections);
+    ECONTEXT_LOCK(econtext);
+    conn->client_id = UINT64_MAX;
+    econtext->server->connected_clients.num_oob_handshakes++;
+    DBG("Handshake with %s started", conn->peer_addr_str);
+    ECONTEXT_UNLOCK(econtext);
+    return DO_SUCCESS;
 }
 
 /**
- * @brief Note that this function assumes the execution context is NOT locked before it is invoked.
+ * @brief The client's frame was received: assign an identifier to the client and prepare
+ * the server's bootstrapping frame for the client.
+ * Note that this function assumes the execution context is NOT locked before it is invoked.
  *
  * @param econtext
+ * @param conn Handle of the connection in the OOB reactor
  * @return dpu_offload_status_t
  */
-static dpu_offload_status_t oob_server_listen(execution_context_t *econtext)
+dpu_offload_status_t oob_server_handshake_reply(execution_context_t *econtext, oob_reactor_handle_t *conn)
 {
-    /* OOB connection establishment */
-    char client_addr[INET_ADDRSTRLEN];
-    dpu_offload_status_t rc = oob_server_accept(econtext, client_addr);
-    CHECK_ERR_RETURN((rc), DO_ERROR, "oob_server_accept() failed");
+    oob_server_hello_t hello;
+
     ECONTEXT_LOCK(econtext);
-    DBG("Sending my worker's data...\n");
-    ssize_t size_sent = send(econtext->server->conn_data.oob.sock,
-                             &(econtext->server->conn_data.oob.local_addr_len),
-                             sizeof(econtext->server->conn_data.oob.local_addr_len),
-                             0);
-    DBG("Addr length sent (len: %ld)", size_sent);
-    assert(size_sent == sizeof(econtext->server->conn_data.oob.local_addr_len));
-    size_sent = send(econtext->server->conn_data.oob.sock,
-                     econtext->server->conn_data.oob.local_addr,
-                     econtext->server->conn_data.oob.local_addr_len,
-                     0);
-    DBG("Address sent (len: %ld)", size_sent);
-    assert(size_sent == econtext->server->conn_data.oob.local_addr_len);
-    size_sent = send(econtext->server->conn_data.oob.sock,
-                     &(econtext->server->id),
-                     sizeof(econtext->server->id),
-                     0);
-    DBG("Server ID sent (len: %ld, id: %" PRIu64 ")", size_sent, econtext->server->id);
+    memset(&hello, 0, sizeof(hello));
+    hello.server_global_id = UINT64_MAX;
     if (econtext->engine->on_dpu)
-    {
-        size_sent = send(econtext->server->conn_data.oob.sock,
-                         &(econtext->engine->config->local_service_proc.info.global_id),
-                         sizeof(econtext->engine->config->local_service_proc.info.global_id),
-                         0);
-        assert(size_sent == sizeof(econtext->engine->config->local_service_proc.info.global_id));
-    }
-    else
-    {
-        uint64_t val = UINT64_MAX;
-        size_sent = send(econtext->server->conn_data.oob.sock,
-                         &val,
-                         sizeof(econtext->engine->config->local_service_proc.info.global_id),
-                         0);
-        assert(size_sent == sizeof(econtext->engine->config->local_service_proc.info.global_id));
-    }
-    DBG("Global ID sent (len: %ld)", size_sent);
-    uint64_t client_id = generate_unique_client_id(econtext);
+        hello.server_global_id = econtext->engine->config->local_service_proc.info.global_id;
+    hello.server_id = econtext->server->id;
+    peer_info_t *client_info = client_slot_get(econtext, conn->hello.resume_token, &(conn->hello.rank_info));
+    hello.client_id = conn->client_id = client_info->id;
+    hello.resume_token = client_info->resume_token;
 #if !NDEBUG
     if (econtext->engine->on_dpu && econtext->scope_id == SCOPE_INTER_SERVICE_PROCS)
     {
-        assert(client_id < econtext->engine->num_service_procs);
+        assert(CLIENT_ID_SLOT(conn->client_id) < econtext->engine->num_service_procs);
     }
 #endif
-    size_sent = send(econtext->server->conn_data.oob.sock, &client_id, sizeof(uint64_t), 0);
-    DBG("Client ID sent (len: %ld, value: %" PRIu64 ")", size_sent, client_id);
-    assert(size_sent == sizeof(uint64_t));
+    hello.addr_len = econtext->server->conn_data.oob.local_addr_len;
+    hello.frame_len = sizeof(hello) + hello.addr_len;
+    conn->frame_len = hello.frame_len;
+    conn->frame_offset = 0;
+    conn->frame = DPU_OFFLOAD_MALLOC(conn->frame_len);
+    CHECK_ERR_GOTO((conn->frame == NULL), error_free_slot, "unable to allocate handshake frame (%ld bytes)", conn->frame_len);
+    memcpy(conn->frame, &hello, sizeof(hello));
+    memcpy((char *)conn->frame + sizeof(hello), econtext->server->conn_data.oob.local_addr, hello.addr_len);
+    TRACE_BEGIN(TRACE_PHASE_OOB_ACCEPT, econtext, conn->client_id);
+    DBG("Replying to client #%" PRIu64 " (%s)", conn->client_id, conn->peer_addr_str);
+    ECONTEXT_UNLOCK(econtext);
+    return DO_SUCCESS;
+error_free_slot:
+    client_slot_reset(econtext, CLIENT_ID_SLOT(conn->client_id));
+    conn->client_id = UINT64_MAX;
+    ECONTEXT_UNLOCK(econtext);
+    return DO_ERROR;
+}
 
-    /* All done, the rest is done when progressing the execution contexts */
-    peer_info_t *client_info = DYN_ARRAY_GET_ELT(&(econtext->server->connected_clients.clients), client_id, peer_info_t);
+/**
+ * @brief The bootstrapping frames were exchanged with the client, the endpoint to the
+ * client is created when progressing the execution context.
+ * Note that this function assumes the execution context is NOT locked before it is invoked.
+ *
+ * @param econtext
+ * @param conn Handle of the connection in the OOB reactor
+ */
+void oob_server_handshake_done(execution_context_t *econtext, oob_reactor_handle_t *conn)
+{
+    ECONTEXT_LOCK(econtext);
+    peer_info_t *client_info = GET_CLIENT_INFO(econtext, conn->client_id);
     assert(client_info);
+    client_info->peer_addr_str = strdup(conn->peer_addr_str);
+    // The client's address is now owned by the client's data
+    client_info->peer_addr = conn->peer_addr;
+    client_info->peer_addr_len = conn->hello.addr_len;
+    conn->peer_addr = NULL;
+    COPY_RANK_INFO(&(conn->hello.rank_info), &(client_info->rank_data));
     client_info->bootstrapping.phase = OOB_CONNECT_DONE;
-    client_info->id = client_id;
-    client_info->peer_addr_str = client_addr;
+    econtext->server->connected_clients.num_oob_handshakes--;
     econtext->server->connected_clients.num_ongoing_connections++;
-    DBG("Client #%" PRIu64 " (%p) is now in the OOB_CONNECT_DONE state", client_id, client_info);
+    TRACE_END(TRACE_PHASE_OOB_ACCEPT, econtext, conn->client_id);
+    DBG("Client #%" PRIu64 " (%p) is now in the OOB_CONNECT_DONE state", conn->client_id, client_info);
     DBG("Total number of ongoing connections: %ld\n", econtext->server->connected_clients.num_ongoing_connections);
     ECONTEXT_UNLOCK(econtext);
-    return DO_SUCCESS;
+}
+
+/**
+ * @brief The handshake with a client failed or the server is being finalized.
+ * Note that this function assumes the execution context is NOT locked before it is invoked.
+ *
+ * @param econtext
+ * @param conn Handle of the connection in the OOB reactor
+ */
+void oob_server_handshake_abort(execution_context_t *econtext, oob_reactor_handle_t *conn)
+{
+    ECONTEXT_LOCK(econtext);
+    assert(econtext->server->connected_clients.num_oob_handshakes > 0);
+    // The slot was assigned when the client's frame was received, it can be given to the next client
+    if (conn->client_id != UINT64_MAX)
+    {
+        client_slot_reset(econtext, CLIENT_ID_SLOT(conn->client_id));
+        TRACE_END(TRACE_PHASE_OOB_ACCEPT, econtext, conn->client_id);
+    }
+    econtext->server->connected_clients.num_oob_handshakes--;
+    ECONTEXT_UNLOCK(econtext);
+}
+
+/**
+ * @brief A client connecting through a rendezvous backend sent its hello: the client is assigned
+ * an identifier and its endpoint is then created when progressing the execution context, like
+ * after an OOB handshake.
+ * Note that this function assumes the execution context is NOT locked before it is invoked.
+ *
+ * @param econtext
+ * @param hello Header of the client's hello
+ * @param peer_addr Client's worker address, now owned by the client's data
+ */
+void rendezvous_server_hello(execution_context_t *econtext, rendezvous_hello_t *hello, void *peer_addr)
+{
+    ECONTEXT_LOCK(econtext);
+    peer_info_t *client_info = client_slot_get(econtext, hello->resume_token, &(hello->rank_info));
+    uint64_t client_id = client_info->id;
+    client_info->peer_addr = peer_addr;
+    client_info->peer_addr_len = hello->addr_len;
+    COPY_RANK_INFO(&(hello->rank_info), &(client_info->rank_data));
+    client_info->rdv_welcome.token = hello->token;
+    client_info->rdv_welcome.client_id = client_id;
+    client_info->rdv_welcome.resume_token = client_info->resume_token;
+    client_info->bootstrapping.phase = OOB_CONNECT_DONE;
+    econtext->server->connected_clients.num_ongoing_connections++;
+    DBG("Client #%" PRIu64 " (%p) is now in the OOB_CONNECT_DONE state after its hello", client_id, client_info);
+    ECONTEXT_UNLOCK(econtext);
 }
 
 static void *connect_thread(void *arg)
@@ -2421,42 +2990,25 @@ static void *connect_thread(void *arg)
         pthread_exit(NULL);
     }
 
+    // Only used with the UCX listener mode, OOB connections are handled by the engine's OOB reactor
+    assert(econtext->server->mode == UCX_LISTENER);
     ECONTEXT_LOCK(econtext);
     bool done = econtext->server->done;
-    int mode = econtext->server->mode;
     ECONTEXT_UNLOCK(econtext);
     while (!done)
     {
-        switch (mode)
-        {
-        case UCX_LISTENER:
+        ucx_listener_server(econtext->server);
+        DBG("Waiting for connection on UCX listener...");
+        while (econtext->server->conn_data.ucx_listener.context.conn_request == NULL)
         {
-            ucx_listener_server(econtext->server);
-            DBG("Waiting for connection on UCX listener...");
-            while (econtext->server->conn_data.ucx_listener.context.conn_request == NULL)
-            {
-                DBG("Progressing worker...");
-                ucp_worker_progress(GET_WORKER(econtext));
-            }
-
-            if (econtext->server->connected_cb != NULL)
-            {
-                DBG("Invoking connection completion callback...");
-                econtext->server->connected_cb(NULL);
-            }
-
-            break;
+            DBG("Progressing worker...");
+            ucp_worker_progress(GET_WORKER(econtext));
         }
-        default:
+
+        if (econtext->server->connected_cb != NULL)
         {
-            // Note: the connection completion callback is called at the end of oob_server_listen()
-            int rc = oob_server_listen(econtext);
-            if (rc)
-            {
-                ERR_MSG("oob_server_listen() failed");
-                pthread_exit(NULL);
-            }
-        }
+            DBG("Invoking connection completion callback...");
+            econtext->server->connected_cb(NULL);
         }
 
         ECONTEXT_LOCK(econtext);
@@ -2472,12 +3024,26 @@ static dpu_offload_status_t start_server(execution_context_t *econtext)
     CHECK_ERR_RETURN((econtext == NULL), DO_ERROR, "undefined execution context");
     CHECK_ERR_RETURN((econtext->server == NULL), DO_ERROR, "undefined server handle");
 
-    int rc = pthread_create(&econtext->server->connect_tid, NULL, &connect_thread, econtext);
-    CHECK_ERR_RETURN((rc), DO_ERROR, "unable to start connection thread");
+    if (econtext->server->mode == UCX_LISTENER)
+    {
+        int rc = pthread_create(&econtext->server->connect_tid, NULL, &connect_thread, econtext);
+        CHECK_ERR_RETURN((rc), DO_ERROR, "unable to start connection thread");
+        return DO_SUCCESS;
+    }
+
+    if (RENDEZVOUS_BACKEND(econtext->engine) != RENDEZVOUS_OOB)
+    {
+        // Clients read our address instead of connecting to a socket
+        dpu_offload_status_t rc = rendezvous_server_publish(econtext);
+        CHECK_ERR_RETURN((rc), DO_ERROR, "rendezvous_server_publish() failed");
+        return DO_SUCCESS;
+    }
+
+    dpu_offload_status_t rc = oob_reactor_add_server(econtext->engine, econtext);
+    CHECK_ERR_RETURN((rc), DO_ERROR, "oob_reactor_add_server() failed");
     return DO_SUCCESS;
 }
 
-#define MAX_CACHE_ENTRIES_PER_PROC (8)
 dpu_offload_status_t server_init_context(execution_context_t *econtext, init_params_t *init_params)
 {
     int ret;
@@ -2493,17 +3059,9 @@ dpu_offload_status_t server_init_context(execution_context_t *econtext, init_par
     {
         peer_info_t *peer_info = DYN_ARRAY_GET_ELT(&(econtext->server->connected_clients.clients), i, peer_info_t);
         assert(peer_info);
-        peer_info->bootstrapping.phase = BOOTSTRAP_NOT_INITIATED;
-        peer_info->bootstrapping.addr_ctx.complete = false;
-        peer_info->bootstrapping.addr_size_ctx.complete = false;
-        peer_info->bootstrapping.rank_ctx.complete = false;
-#if USE_AM_IMPLEM
-        peer_info->ctx.complete = false;
-#else
-        peer_info->notif_recv.ctx.complete = true; // to make sure we can post the initial recv
-#endif
-        DYN_ARRAY_ALLOC(&(peer_info->cache_entries), MAX_CACHE_ENTRIES_PER_PROC, peer_cache_entry_t *);
+        init_client_slot(peer_info);
     }
+    DYN_ARRAY_ALLOC(&(econtext->server->connected_clients.free_slots), DEFAULT_MAX_NUM_CLIENTS, uint64_t);
 
     if (init_params == NULL || init_params->conn_params == NULL)
     {
@@ -2556,6 +3114,10 @@ dpu_offload_status_t server_init_context(execution_context_t *econtext, init_par
         econtext->server->conn_data.oob.local_addr_len = 0;
         econtext->server->conn_data.oob.peer_addr_len = 0;
         econtext->server->conn_data.oob.listenfd = -1;
+        econtext->server->conn_data.oob.listener = NULL;
+        econtext->server->conn_data.oob.rdv.published = false;
+        econtext->server->conn_data.oob.rdv.map = NULL;
+        econtext->server->conn_data.oob.rdv.map_len = 0;
         ucp_worker_h worker = GET_WORKER(econtext);
         assert(worker);
         ucs_status_t status = ucp_worker_get_address(worker,
@@ -2600,6 +3162,7 @@ static ucs_status_t server_create_ep(ucp_worker_h data_worker,
  */
 execution_context_t *server_init(offloading_engine_t *offloading_engine, init_params_t *init_params)
 {
+    TRACE_BEGIN(TRACE_PHASE_SERVER_INIT, NULL, TRACE_NO_PEER);
     CHECK_ERR_GOTO((offloading_engine == NULL), error_out, "Handle is NULL");
 
     execution_context_t *execution_context;
@@ -2665,9 +3228,11 @@ execution_context_t *server_init(offloading_engine_t *offloading_engine, init_pa
     ENGINE_UNLOCK(offloading_engine);
     ECONTEXT_UNLOCK(execution_context);
 
+    TRACE_END(TRACE_PHASE_SERVER_INIT, NULL, TRACE_NO_PEER);
     return execution_context;
 
 error_out:
+    TRACE_END(TRACE_PHASE_SERVER_INIT, NULL, TRACE_NO_PEER);
     ECONTEXT_UNLOCK(execution_context);
     ENGINE_UNLOCK(offloading_engine);
     if (execution_context != NULL)
@@ -2691,13 +3256,21 @@ void server_fini(execution_context_t **exec_ctx)
     }
 
     dpu_offload_server_t *server = (*exec_ctx)->server;
-    pthread_cancel(server->connect_tid);
+    if (server->mode == UCX_LISTENER)
+    {
+        pthread_cancel(server->connect_tid);
+    }
+    else
+    {
+        rendezvous_server_unpublish(context);
+        oob_reactor_remove_server(context->engine, context);
+    }
 #if OFFLOADING_MT_ENABLE
     pthread_mutex_destroy(&(server->mutex));
 #endif
 
     /* Close the clients' endpoint */
-    for (i = 0; i < server->connected_clients.num_connected_clients; i++)
+    for (i = 0; i < server->connected_clients.num_slots; i++)
     {
         peer_info_t *peer_info = DYN_ARRAY_GET_ELT(&(server->connected_clients.clients), i, peer_info_t);
         assert(peer_info);
@@ -2706,7 +3279,13 @@ void server_fini(execution_context_t **exec_ctx)
             ep_close(GET_WORKER(*exec_ctx), peer_info->ep);
             peer_info->ep = NULL;
         }
+        if (peer_info->peer_addr_str != NULL)
+        {
+            free(peer_info->peer_addr_str);
+            peer_info->peer_addr_str = NULL;
+        }
     }
+    DYN_ARRAY_FREE(&(server->connected_clients.free_slots));
 
     switch (server->mode)
     {
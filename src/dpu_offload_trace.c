@@ -0,0 +1,170 @@
+//
+// Copyright (c) 2023, NVIDIA CORPORATION. All rights reserved.
+//
+// See LICENSE.txt for license information
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <inttypes.h>
+#include <time.h>
+#include <pthread.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+
+#include "dpu_offload_types.h"
+#include "dpu_offload_debug.h"
+#include "dpu_offload_trace.h"
+
+/*
+ * The ring is a process-wide singleton: the connections of all the engines of a process end up
+ * in the same file. Writers reserve a record with an atomic increment of the head of the ring,
+ * which is the only synchronization on the fast path, so the reactor thread and the threads
+ * progressing the engines can record events concurrently. The timestamp of a record is written
+ * last so a record being written is ignored when converting a ring that is still in use.
+ */
+
+static struct
+{
+    pthread_mutex_t mutex;
+    size_t refcount;
+    trace_ring_hdr_t *hdr;
+    trace_record_t *records;
+    size_t map_len;
+} trace_ring = {
+    .mutex = PTHREAD_MUTEX_INITIALIZER,
+    .refcount = 0,
+    .hdr = NULL,
+    .records = NULL,
+    .map_len = 0,
+};
+
+static inline uint64_t trace_clock_ns(clockid_t clock)
+{
+    struct timespec ts;
+    clock_gettime(clock, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000 + (uint64_t)ts.tv_nsec;
+}
+
+int trace_init(const char *dir, uint64_t num_records)
+{
+    char hostname[64];
+    char path[PATH_MAX];
+    void *map;
+    int fd;
+
+    pthread_mutex_lock(&(trace_ring.mutex));
+    if (trace_ring.refcount > 0)
+    {
+        trace_ring.refcount++;
+        pthread_mutex_unlock(&(trace_ring.mutex));
+        return 0;
+    }
+
+    if (num_records == 0)
+        num_records = DEFAULT_TRACE_RING_SIZE;
+    memset(hostname, 0, sizeof(hostname));
+    gethostname(hostname, sizeof(hostname) - 1);
+    snprintf(path, sizeof(path), "%s/%s.%s.%d.bin", dir, TRACE_FILE_PREFIX, hostname, (int)getpid());
+    trace_ring.map_len = sizeof(trace_ring_hdr_t) + num_records * sizeof(trace_record_t);
+
+    fd = open(path, O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd == -1)
+    {
+        ERR_MSG("unable to create trace file %s: %s", path, strerror(errno));
+        goto error_out;
+    }
+    // The file is zero-filled so records that were never written have a null timestamp
+    if (ftruncate(fd, trace_ring.map_len) == -1)
+    {
+        ERR_MSG("ftruncate() failed on %s: %s", path, strerror(errno));
+        goto error_close;
+    }
+    map = mmap(NULL, trace_ring.map_len, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (map == MAP_FAILED)
+    {
+        ERR_MSG("mmap() failed on %s: %s", path, strerror(errno));
+        goto error_close;
+    }
+    close(fd);
+
+    trace_ring.hdr = (trace_ring_hdr_t *)map;
+    trace_ring.records = (trace_record_t *)((char *)map + sizeof(trace_ring_hdr_t));
+    trace_ring.hdr->version = TRACE_RING_VERSION;
+    trace_ring.hdr->record_size = sizeof(trace_record_t);
+    trace_ring.hdr->capacity = num_records;
+    trace_ring.hdr->head = 0;
+    trace_ring.hdr->pid = (uint64_t)getpid();
+    trace_ring.hdr->clock_offset = (int64_t)(trace_clock_ns(CLOCK_REALTIME) - trace_clock_ns(CLOCK_MONOTONIC));
+    memcpy(trace_ring.hdr->hostname, hostname, sizeof(trace_ring.hdr->hostname));
+    __atomic_store_n(&(trace_ring.hdr->magic), TRACE_RING_MAGIC, __ATOMIC_RELEASE);
+    trace_ring.refcount = 1;
+    DBG("Bootstrap trace recorded in %s (%" PRIu64 " records)", path, num_records);
+    pthread_mutex_unlock(&(trace_ring.mutex));
+    return 0;
+
+error_close:
+    close(fd);
+    unlink(path);
+error_out:
+    trace_ring.map_len = 0;
+    pthread_mutex_unlock(&(trace_ring.mutex));
+    return -1;
+}
+
+void trace_fini(void)
+{
+    pthread_mutex_lock(&(trace_ring.mutex));
+    if (trace_ring.refcount == 0)
+    {
+        pthread_mutex_unlock(&(trace_ring.mutex));
+        return;
+    }
+    trace_ring.refcount--;
+    if (trace_ring.refcount == 0)
+    {
+        trace_ring_hdr_t *hdr = trace_ring.hdr;
+        // Stop the writers before unmapping the ring. The engines are finalized at this point,
+        // including the OOB reactor, so no thread is expected to be recording an event.
+        __atomic_store_n(&(trace_ring.hdr), NULL, __ATOMIC_RELEASE);
+        munmap(hdr, trace_ring.map_len);
+        trace_ring.records = NULL;
+        trace_ring.map_len = 0;
+    }
+    pthread_mutex_unlock(&(trace_ring.mutex));
+}
+
+void trace_event(trace_phase_t phase, trace_event_type_t type, struct execution_context *ctx, uint64_t peer)
+{
+    trace_ring_hdr_t *hdr = __atomic_load_n(&(trace_ring.hdr), __ATOMIC_ACQUIRE);
+    execution_context_t *econtext = (execution_context_t *)ctx;
+    trace_record_t *record;
+    uint64_t idx, ts;
+
+    if (hdr == NULL)
+        return;
+
+    ts = trace_clock_ns(CLOCK_MONOTONIC);
+    idx = __atomic_fetch_add(&(hdr->head), 1, __ATOMIC_RELAXED) % hdr->capacity;
+    record = &(trace_ring.records[idx]);
+    // Invalidate the record while it is overwritten
+    __atomic_store_n(&(record->ts), 0, __ATOMIC_RELAXED);
+    record->id = (uint64_t)(uintptr_t)econtext;
+    record->peer = peer;
+    record->phase = (uint8_t)phase;
+    record->type = (uint8_t)type;
+    record->role = TRACE_ROLE_PROCESS;
+    record->scope = UINT8_MAX;
+    if (econtext != NULL)
+    {
+        record->role = econtext->type == CONTEXT_SERVER ? TRACE_ROLE_SERVER : TRACE_ROLE_CLIENT;
+        record->scope = (uint8_t)econtext->scope_id;
+    }
+    record->tid = (uint32_t)syscall(SYS_gettid);
+    __atomic_store_n(&(record->ts), ts, __ATOMIC_RELEASE);
+}
@@ -19,6 +19,8 @@
 #include "dpu_offload_event_channels.h"
 #include "dpu_offload_envvars.h"
 #include "dpu_offload_group_cache.h"
+#include "dpu_offload_ops.h"
+#include "dpu_offload_collectives.h"
 
 #if !NDEBUG
 debug_config_t dbg_cfg = {
@@ -134,22 +136,18 @@ static void *revoke_msg_from_rank_get(void *pool, void *args)
 
 static void revoke_msg_from_sp_return(void *pool, void *buf)
 {
-    dyn_list_t *dlist = NULL;
-    group_revoke_msg_from_sp_t *msg = NULL;
     assert(pool);
     assert(buf);
-    dlist = (dyn_list_t *)pool;
-    msg = (group_revoke_msg_from_sp_t *) buf;
-    DYN_LIST_RETURN(dlist, msg, item);
+    group_revoke_msg_return((group_revoke_msg_pool_t *)pool, (group_revoke_msg_from_sp_t *)buf);
 }
 
+// Revoke messages from SPs have a variable size, args points to the size of the encoded list of ranks
 static void *revoke_msg_from_sp_get(void *pool, void *args)
 {
-    dyn_list_t *dlist = NULL;
     group_revoke_msg_from_sp_t *msg = NULL;
     assert(pool);
-    dlist = (dyn_list_t *)pool;
-    DYN_LIST_GET(dlist, group_revoke_msg_from_sp_t, item, msg);
+    assert(args);
+    msg = group_revoke_msg_get((group_revoke_msg_pool_t *)pool, *((size_t *)args));
     assert(msg);
     return msg;
 }
@@ -254,6 +252,7 @@ dpu_offload_status_t send_revoke_group_rank_request_through_list_ranks(execution
     group_revoke_msg_from_sp_t *desc = NULL;
     dpu_offload_event_info_t ev_info;
     group_cache_t *gp_cache = NULL;
+    size_t data_size = 0;
 
     // Check the validity of the group
     if (gp_uid == INT_MAX)
@@ -265,11 +264,13 @@ dpu_offload_status_t send_revoke_group_rank_request_through_list_ranks(execution
     gp_cache = GET_GROUP_CACHE(&(econtext->engine->procs_cache), gp_uid);
     assert(gp_cache);
 
+    // The receiver only needs to know the group is fully revoked, not which ranks revoked it
     RESET_EVENT_INFO(&ev_info);
-    ev_info.pool.element_size = sizeof(group_revoke_msg_from_sp_t);
+    ev_info.pool.element_size = GROUP_REVOKE_MSG_FROM_SP_SIZE(data_size);
     ev_info.pool.get_buf = revoke_msg_from_sp_get;
+    ev_info.pool.get_buf_args = &data_size;
     ev_info.pool.return_buf = revoke_msg_from_sp_return;
-    ev_info.pool.mem_pool = econtext->engine->pool_group_revoke_msgs_from_sps;
+    ev_info.pool.mem_pool = &(econtext->engine->pool_group_revoke_msgs_from_sps);
 
     rc = event_get(econtext->event_channels, &ev_info, &ev);
     CHECK_ERR_RETURN((rc != DO_SUCCESS), DO_ERROR, "event_get() failed");
@@ -278,6 +279,7 @@ dpu_offload_status_t send_revoke_group_rank_request_through_list_ranks(execution
     desc->gp_uid = gp_uid;
     assert(num_ranks);
     desc->num_ranks = num_ranks;
+    desc->encoding = GROUP_REVOKE_ENCODING_RANGES;
     desc->group_size = gp_cache->group_size;
     desc->gp_seq_num = gp_cache->persistent.num;
     assert(desc->group_size);
@@ -329,33 +331,35 @@ dpu_offload_status_t get_local_sp_id(offloading_engine_t *engine, uint64_t globa
 /* TODO: move to dpu_offload_group_cache.c  */
 /********************************************/
 
-dpu_offload_status_t do_send_cache_entry_request(execution_context_t *econtext, ucp_ep_h ep, uint64_t dest_id, rank_info_t *requested_peer, dpu_offload_event_t *ev)
+dpu_offload_status_t do_send_cache_entry_request(execution_context_t *econtext, ucp_ep_h ep, uint64_t dest_id, cache_entries_request_t *request, dpu_offload_event_t *ev)
 {
     int rc;
-    DBG("Sending cache entry request for rank:%ld/gp:0x%x (econtext: %p, scope_id: %d)",
-        requested_peer->group_rank,
-        requested_peer->group_uid,
+    DBG("Sending cache entries request for ranks %" PRId64 "-%" PRId64 "/gp:0x%x (econtext: %p, scope_id: %d)",
+        request->rank_start,
+        request->rank_start + request->num_ranks - 1,
+        request->gp_uid,
         econtext,
         econtext->scope_id);
+    assert(request->num_ranks > 0);
     rc = event_channel_emit_with_payload(&ev,
                                          AM_PEER_CACHE_ENTRIES_REQUEST_MSG_ID,
                                          ep,
                                          dest_id,
                                          NULL,
-                                         requested_peer,
-                                         sizeof(rank_info_t));
+                                         request,
+                                         sizeof(cache_entries_request_t));
     CHECK_ERR_RETURN((rc != EVENT_DONE && rc != EVENT_INPROGRESS), DO_ERROR, "event_channel_emit_with_payload() failed");
     return DO_SUCCESS;
 }
 
-dpu_offload_status_t send_cache_entry_request(execution_context_t *econtext, ucp_ep_h ep, uint64_t dest_id, rank_info_t *requested_peer, dpu_offload_event_t **ev)
+dpu_offload_status_t send_cache_entry_request(execution_context_t *econtext, ucp_ep_h ep, uint64_t dest_id, cache_entries_request_t *request, dpu_offload_event_t **ev)
 {
     dpu_offload_event_t *cache_entry_request_ev;
     dpu_offload_status_t rc;
     rc = event_get(econtext->event_channels, NULL, &cache_entry_request_ev);
     CHECK_ERR_GOTO((rc), error_out, "event_get() failed");
 
-    rc = do_send_cache_entry_request(econtext, ep, dest_id, requested_peer, cache_entry_request_ev);
+    rc = do_send_cache_entry_request(econtext, ep, dest_id, request, cache_entry_request_ev);
     CHECK_ERR_GOTO((rc), error_out, "do_send_cache_entry_request() failed");
 
     *ev = cache_entry_request_ev;
@@ -365,6 +369,75 @@ error_out:
     return DO_ERROR;
 }
 
+/**
+ * @brief send_cache_entries_range sends the cache entries that are available for a range of ranks
+ * of a group. Contiguous runs of entries are sent with a single notification, the entries that are
+ * not in the cache are skipped.
+ *
+ * @param econtext Execution context to use to send the entries
+ * @param ep Endpoint of the destination
+ * @param dest_id Identifier of the destination
+ * @param request Range of ranks to send
+ * @param metaev Meta-event to track all the sends
+ * @param n_sent Number of entries that were sent
+ * @return dpu_offload_status_t
+ */
+dpu_offload_status_t send_cache_entries_range(execution_context_t *econtext, ucp_ep_h ep, uint64_t dest_id, cache_entries_request_t *request, dpu_offload_event_t *metaev, size_t *n_sent)
+{
+    cache_t *cache;
+    group_cache_t *gp_cache;
+    int64_t rank, rank_end;
+    assert(econtext);
+    assert(econtext->engine);
+    assert(metaev);
+    assert(EVENT_HDR_TYPE(metaev) == META_EVENT_TYPE);
+    assert(n_sent);
+    cache = &(econtext->engine->procs_cache);
+    gp_cache = GET_GROUP_CACHE(cache, request->gp_uid);
+    assert(gp_cache);
+    *n_sent = 0;
+    if (!gp_cache->initialized || gp_cache->group_size <= 0)
+        return DO_SUCCESS;
+
+    rank = request->rank_start < 0 ? 0 : request->rank_start;
+    rank_end = request->rank_start + request->num_ranks;
+    if (rank_end > gp_cache->group_size)
+        rank_end = gp_cache->group_size;
+    while (rank < rank_end)
+    {
+        int64_t run_start;
+        dpu_offload_event_t *e;
+        int rc;
+
+        if (!is_in_cache(cache, request->gp_uid, rank, gp_cache->group_size))
+        {
+            rank++;
+            continue;
+        }
+        run_start = rank;
+        while (rank < rank_end && is_in_cache(cache, request->gp_uid, rank, gp_cache->group_size))
+            rank++;
+
+        rc = event_get(econtext->event_channels, NULL, &e);
+        CHECK_ERR_RETURN((rc), DO_ERROR, "event_get() failed");
+        e->is_subevent = true;
+        DBG("Sending cache entries %" PRId64 "-%" PRId64 " of group 0x%x to %" PRIu64,
+            run_start, rank - 1, request->gp_uid, dest_id);
+        rc = event_channel_emit_with_payload(&e,
+                                             AM_PEER_CACHE_ENTRIES_MSG_ID,
+                                             ep,
+                                             dest_id,
+                                             NULL,
+                                             GET_GROUP_RANK_CACHE_ENTRY(cache, request->gp_uid, run_start, gp_cache->group_size),
+                                             (rank - run_start) * sizeof(peer_cache_entry_t));
+        CHECK_ERR_RETURN((rc != EVENT_DONE && rc != EVENT_INPROGRESS), DO_ERROR, "event_channel_emit_with_payload() failed");
+        if (e != NULL)
+            QUEUE_SUBEVENT(metaev, e);
+        *n_sent += rank - run_start;
+    }
+    return DO_SUCCESS;
+}
+
 dpu_offload_status_t do_send_cache_entry(execution_context_t *econtext, ucp_ep_h ep, uint64_t dest_id, peer_cache_entry_t *cache_entry, dpu_offload_event_t *ev)
 {
     int rc;
@@ -450,7 +523,9 @@ bool find_range_local_ranks(execution_context_t *econtext, group_uid_t gp_uid, i
     return true;
 }
 
-// send_local_revoke_rank_group_cache is used to send revoke via group_revoke_msg_from_sp_t messages
+// send_local_revoke_rank_group_cache is used to send revoke via a group_revoke_msg_from_sp_t message.
+// The ranks that revoked the group are encoded as ranges or as a bitmap, whichever is the smallest,
+// so a single message is sent regardless of the group size.
 static dpu_offload_status_t send_local_revoke_rank_group_cache(execution_context_t *econtext,
                                                                ucp_ep_h dest_ep,
                                                                uint64_t dest_id,
@@ -461,7 +536,8 @@ static dpu_offload_status_t send_local_revoke_rank_group_cache(execution_context
     dpu_offload_event_t *e = NULL;
     group_revoke_msg_from_sp_t *payload = NULL;
     dpu_offload_event_info_t ev_info;
-    size_t ranks_sent = 0, current_sends = 0, remaining_sends = 0;
+    group_revoke_encoding_t encoding;
+    size_t data_size;
 
     assert(econtext);
     assert(econtext->engine);
@@ -473,72 +549,42 @@ static dpu_offload_status_t send_local_revoke_rank_group_cache(execution_context
         return DO_SUCCESS;
     }
     assert(gp_cache->group_size > 0);
-    remaining_sends = gp_cache->group_size;
-
-    while (ranks_sent < gp_cache->group_size)
-    {
-        size_t relative_idx;
-        // Get a revoke buffer for the message
-        RESET_EVENT_INFO(&ev_info);
-        ev_info.pool.element_size = sizeof(group_revoke_msg_from_sp_t);
-        ev_info.pool.get_buf = revoke_msg_from_sp_get;
-        ev_info.pool.return_buf = revoke_msg_from_sp_return;
-        ev_info.pool.mem_pool = econtext->engine->pool_group_revoke_msgs_from_sps;
-
-        // Send the notification and queue the sub-event
-        rc = event_get(econtext->event_channels, &ev_info, &e);
-        CHECK_ERR_RETURN((rc), DO_ERROR, "event_get() failed");
-        payload = (group_revoke_msg_from_sp_t *)e->payload;
+    data_size = group_revoke_msg_encoded_size(gp_cache, &encoding);
 
-        // We can only send a maximum of 1024 rank info at a time.
-        // Figure out how many we are about to send.
-        if (remaining_sends < 1024)
-            current_sends = remaining_sends;
-        else
-            current_sends = 1024;
-
-        payload->num_ranks = current_sends;
-        payload->rank_start = ranks_sent;
-        // The remote SP may not be involved in the group and may receive the
-        // revoke message before knowing anything about the group so we add
-        // the group size to be able to correctly track everything on the
-        // receiver side.
-        assert(gp_cache->group_size);
-        payload->group_size = gp_cache->group_size;
-        payload->gp_seq_num = gp_cache->persistent.num;
-
-        DBG("Sending revoke data for ranks %ld - %ld (group: 0x%x, group_size: %ld)",
-            ranks_sent, ranks_sent+current_sends, gp_cache->group_uid, gp_cache->group_size);
-        for (relative_idx = 0; relative_idx < current_sends; relative_idx++)
-        {
-            if (GROUP_CACHE_BITSET_TEST(gp_cache->revokes.ranks, payload->rank_start + relative_idx))
-            {
-                payload->ranks[relative_idx] = 1;
-                DBG("Rank %ld marked as revoking the group (seq num: %ld)",
-                    payload->rank_start + relative_idx, gp_cache->persistent.num);
-            }
-            else
-            {
-                payload->ranks[relative_idx] = 0;
-                DBG("Rank %ld marked as NOT revoking the group (seq num: %ld)",
-                    payload->rank_start + relative_idx, gp_cache->persistent.num);
-            }
-        }
-        payload->gp_uid = gp_cache->group_uid;
-        e->is_subevent = true;
-        rc = event_channel_emit(&e, AM_REVOKE_GP_SP_MSG_ID, dest_ep, dest_id, NULL);
-        if (rc != EVENT_DONE && rc != EVENT_INPROGRESS)
-        {
-            ERR_MSG("event_channel_emit_with_payload() failed");
-            return DO_ERROR;
-        }
-        if (e != NULL)
-        {
-            QUEUE_SUBEVENT(metaev, e);
-        }
+    // Get a revoke buffer for the message
+    RESET_EVENT_INFO(&ev_info);
+    ev_info.pool.element_size = GROUP_REVOKE_MSG_FROM_SP_SIZE(data_size);
+    ev_info.pool.get_buf = revoke_msg_from_sp_get;
+    ev_info.pool.get_buf_args = &data_size;
+    ev_info.pool.return_buf = revoke_msg_from_sp_return;
+    ev_info.pool.mem_pool = &(econtext->engine->pool_group_revoke_msgs_from_sps);
 
-        ranks_sent += current_sends;
-        remaining_sends -= current_sends;
+    // Send the notification and queue the sub-event
+    rc = event_get(econtext->event_channels, &ev_info, &e);
+    CHECK_ERR_RETURN((rc), DO_ERROR, "event_get() failed");
+    payload = (group_revoke_msg_from_sp_t *)e->payload;
+
+    // The remote SP may not be involved in the group and may receive the
+    // revoke message before knowing anything about the group so we add
+    // the group size to be able to correctly track everything on the
+    // receiver side.
+    payload->group_size = gp_cache->group_size;
+    payload->gp_seq_num = gp_cache->persistent.num;
+    payload->gp_uid = gp_cache->group_uid;
+    group_revoke_msg_encode(gp_cache, encoding, payload);
+
+    DBG("Sending revoke data for %ld ranks (group: 0x%x, group_size: %ld, encoding: %d, data size: %ld)",
+        payload->num_ranks, gp_cache->group_uid, gp_cache->group_size, encoding, data_size);
+    e->is_subevent = true;
+    rc = event_channel_emit(&e, AM_REVOKE_GP_SP_MSG_ID, dest_ep, dest_id, NULL);
+    if (rc != EVENT_DONE && rc != EVENT_INPROGRESS)
+    {
+        ERR_MSG("event_channel_emit_with_payload() failed");
+        return DO_ERROR;
+    }
+    if (e != NULL)
+    {
+        QUEUE_SUBEVENT(metaev, e);
     }
 
     return DO_SUCCESS;
@@ -644,9 +690,201 @@ bool all_service_procs_connected(offloading_engine_t *engine)
     if (!engine->on_dpu)
         return false;
 
+    // In on-demand mode, connections are established on first use and queued notifications
+    // are sent once connected, there is therefore nothing to wait for.
+    if (LAZY_INTER_SP_CONNECT(engine))
+        return true;
+
     return (engine->num_service_procs == (engine->num_connected_service_procs + 1)); // Plus one because we do not connect to ourselves
 }
 
+extern dpu_offload_status_t connect_to_remote_service_proc_on_demand(remote_service_proc_info_t *sp);
+
+/**
+ * @brief Queue a notification for a service process that is not connected yet and make sure
+ * the connection is being established. The notification is sent by
+ * progress_pending_sp_notifs() once the connection completes.
+ */
+static dpu_offload_status_t
+queue_sp_notif(offloading_engine_t *engine, remote_service_proc_info_t *sp, pending_sp_notif_type_t type, group_uid_t gp_uid, uint64_t notif_id, void *payload, size_t payload_size)
+{
+    pending_sp_notif_t *pending_notif = NULL;
+    dpu_offload_status_t rc;
+
+    DYN_LIST_GET(engine->pool_pending_sp_notifs, pending_sp_notif_t, item, pending_notif);
+    CHECK_ERR_RETURN((pending_notif == NULL), DO_ERROR, "unable to get a pending notification object");
+    RESET_PENDING_SP_NOTIF(pending_notif);
+    pending_notif->type = type;
+    pending_notif->sp_gid = sp->idx;
+    pending_notif->gp_uid = gp_uid;
+    pending_notif->notif_id = notif_id;
+    if (payload_size > 0)
+    {
+        pending_notif->payload = DPU_OFFLOAD_MALLOC(payload_size);
+        if (pending_notif->payload == NULL)
+        {
+            DYN_LIST_RETURN(engine->pool_pending_sp_notifs, pending_notif, item);
+            ERR_MSG("unable to allocate buffer for pending notification");
+            return DO_ERROR;
+        }
+        memcpy(pending_notif->payload, payload, payload_size);
+        pending_notif->payload_size = payload_size;
+    }
+    ucs_list_add_tail(&(engine->pending_sp_notifs), &(pending_notif->item));
+    DBG("Notification of type %d for service process #%" PRIu64 " queued until the connection is established",
+        type, sp->idx);
+
+    rc = connect_to_remote_service_proc_on_demand(sp);
+    CHECK_ERR_RETURN((rc), DO_ERROR, "connect_to_remote_service_proc_on_demand() failed");
+    return DO_SUCCESS;
+}
+
+// Whether notifications can be sent right away to a remote service process
+#define SP_READY_FOR_NOTIFS(_engine, _sp) \
+    (!LAZY_INTER_SP_CONNECT(_engine) || (_sp)->conn_status == CONNECT_STATUS_CONNECTED)
+
+static dpu_offload_status_t send_group_cache_revoke_to_sp(offloading_engine_t *engine, remote_service_proc_info_t *sp, group_cache_t *gp_cache)
+{
+    dpu_offload_status_t rc;
+    // Meta-event to be used to track all that need to happen
+    dpu_offload_event_t *ev;
+    ucp_ep_h dest_ep;
+    uint64_t dest_id = sp->idx;
+
+    assert(sp->econtext);
+    event_get(sp->econtext->event_channels, NULL, &ev);
+    assert(ev);
+    EVENT_HDR_TYPE(ev) = META_EVENT_TYPE;
+    dest_ep = GET_REMOTE_SERVICE_PROC_EP(engine, sp->idx);
+    // If the econtext is a client to connect to a server, the dest_id is the index;
+    // otherwise we need to find the client ID based on the index
+    if (sp->econtext->type == CONTEXT_SERVER)
+        dest_id = sp->client_id;
+    DBG("Sending group 0x%x cache revoke to service process #%ld (econtext: %p, scope_id: %d, dest_id: %ld, ep: %p)",
+        gp_cache->group_uid, sp->idx, sp->econtext, sp->econtext->scope_id, dest_id, dest_ep);
+    rc = send_local_revoke_rank_group_cache(sp->econtext, dest_ep, dest_id, gp_cache, ev);
+    CHECK_ERR_RETURN((rc), DO_ERROR, "send_local_revoke_rank_group_cache() failed");
+    if (!event_completed(ev))
+        QUEUE_EVENT(ev);
+    else
+        event_return(&ev);
+    return DO_SUCCESS;
+}
+
+static dpu_offload_status_t send_group_cache_to_sp(offloading_engine_t *engine, remote_service_proc_info_t *sp, group_cache_t *group_cache)
+{
+    dpu_offload_status_t rc;
+    ucp_ep_h dest_ep;
+    uint64_t dest_id = sp->idx;
+    // Meta-event to be used to track all that needs to happen
+    dpu_offload_event_t *ev = NULL;
+
+    assert(sp->econtext);
+    event_get(sp->econtext->event_channels, NULL, &ev);
+    assert(ev);
+    EVENT_HDR_TYPE(ev) = META_EVENT_TYPE;
+    dest_ep = GET_REMOTE_SERVICE_PROC_EP(engine, sp->idx);
+    // If the econtext is a client to connect to a server, the dest_id is the index, i.e., the global SP ID;
+    // otherwise we need to find the client ID based on the index
+    if (sp->econtext->type == CONTEXT_SERVER)
+    {
+        dest_id = sp->client_id;
+    }
+    DBG("Sending group cache 0x%x (seq num: %ld) to service process #%ld (econtext: %p, scope_id: %d, dest_id: %ld, ep: %p)",
+        group_cache->group_uid,
+        group_cache->persistent.num,
+        sp->idx,
+        sp->econtext,
+        sp->econtext->scope_id,
+        dest_id,
+        dest_ep);
+    rc = send_local_rank_group_cache(sp->econtext, dest_ep, dest_id, group_cache->group_uid, ev);
+    CHECK_ERR_RETURN((rc), DO_ERROR, "send_local_rank_group_cache() failed");
+    if (!event_completed(ev))
+        QUEUE_EVENT(ev);
+    else
+        event_return(&ev);
+    return DO_SUCCESS;
+}
+
+static dpu_offload_status_t emit_notif_to_sp(offloading_engine_t *engine, remote_service_proc_info_t *sp, uint64_t notif_id, void *payload, size_t payload_size)
+{
+    dpu_offload_event_t *ev = NULL;
+    dpu_offload_event_info_t ev_info;
+    dpu_offload_status_t rc;
+    uint64_t dest_id = sp->idx;
+    int ret;
+
+    assert(sp->econtext);
+    RESET_EVENT_INFO(&ev_info);
+    ev_info.payload_size = payload_size;
+    rc = event_get(sp->econtext->event_channels, payload_size > 0 ? &ev_info : NULL, &ev);
+    CHECK_ERR_RETURN((rc), DO_ERROR, "event_get() failed");
+    if (payload_size > 0)
+        memcpy(ev->payload, payload, payload_size);
+    if (sp->econtext->type == CONTEXT_SERVER)
+        dest_id = sp->client_id;
+    ret = event_channel_emit(&ev, notif_id, GET_REMOTE_SERVICE_PROC_EP(engine, sp->idx), dest_id, NULL);
+    CHECK_ERR_RETURN((ret != EVENT_DONE && ret != EVENT_INPROGRESS), DO_ERROR, "event_channel_emit() failed");
+    return DO_SUCCESS;
+}
+
+dpu_offload_status_t send_notif_to_sp(offloading_engine_t *engine, uint64_t sp_gid, uint64_t notif_id, void *payload, size_t payload_size)
+{
+    remote_service_proc_info_t *sp;
+
+    CHECK_ERR_RETURN((engine == NULL), DO_ERROR, "engine is undefined");
+    CHECK_ERR_RETURN((!engine->on_dpu), DO_ERROR, "not on a DPU");
+    CHECK_ERR_RETURN((sp_gid >= engine->num_service_procs),
+                     DO_ERROR,
+                     "request service process #%ld but only %ld service processes are known",
+                     sp_gid, engine->num_service_procs);
+    sp = DYN_ARRAY_GET_ELT(GET_ENGINE_LIST_SERVICE_PROCS(engine), sp_gid, remote_service_proc_info_t);
+    assert(sp);
+
+    if (!SP_READY_FOR_NOTIFS(engine, sp))
+        return queue_sp_notif(engine, sp, PENDING_SP_NOTIF_EMIT, INT_MAX, notif_id, payload, payload_size);
+    return emit_notif_to_sp(engine, sp, notif_id, payload, payload_size);
+}
+
+dpu_offload_status_t progress_pending_sp_notifs(offloading_engine_t *engine)
+{
+    pending_sp_notif_t *pending_notif = NULL, *next_pending_notif = NULL;
+    ucs_list_for_each_safe(pending_notif, next_pending_notif, &(engine->pending_sp_notifs), item)
+    {
+        dpu_offload_status_t rc = DO_SUCCESS;
+        group_cache_t *gp_cache = NULL;
+        remote_service_proc_info_t *sp;
+        sp = DYN_ARRAY_GET_ELT(GET_ENGINE_LIST_SERVICE_PROCS(engine), pending_notif->sp_gid, remote_service_proc_info_t);
+        assert(sp);
+        if (sp->conn_status != CONNECT_STATUS_CONNECTED)
+            continue;
+
+        // Notifications are sent in the order they were queued for a given service process
+        ucs_list_del(&(pending_notif->item));
+        DBG("Connection to service process #%" PRIu64 " now established, sending queued notification of type %d",
+            pending_notif->sp_gid, pending_notif->type);
+        switch (pending_notif->type)
+        {
+        case PENDING_SP_NOTIF_GROUP_CACHE:
+            gp_cache = GET_GROUP_CACHE(&(engine->procs_cache), pending_notif->gp_uid);
+            rc = send_group_cache_to_sp(engine, sp, gp_cache);
+            break;
+        case PENDING_SP_NOTIF_GROUP_REVOKE:
+            gp_cache = GET_GROUP_CACHE(&(engine->procs_cache), pending_notif->gp_uid);
+            rc = send_group_cache_revoke_to_sp(engine, sp, gp_cache);
+            break;
+        default:
+            rc = emit_notif_to_sp(engine, sp, pending_notif->notif_id, pending_notif->payload, pending_notif->payload_size);
+        }
+        if (pending_notif->payload != NULL)
+            free(pending_notif->payload);
+        DYN_LIST_RETURN(engine->pool_pending_sp_notifs, pending_notif, item);
+        CHECK_ERR_RETURN((rc), DO_ERROR, "unable to send queued notification to service process #%" PRIu64, sp->idx);
+    }
+    return DO_SUCCESS;
+}
+
 // Note: used to exchange the cache between SPs
 dpu_offload_status_t broadcast_group_cache_revoke(offloading_engine_t *engine, group_cache_t *gp_cache)
 {
@@ -670,10 +908,6 @@ dpu_offload_status_t broadcast_group_cache_revoke(offloading_engine_t *engine, g
     for (sp_gid = 0; sp_gid < engine->num_service_procs; sp_gid++)
     {
         dpu_offload_status_t rc;
-        // Meta-event to be used to track all that need to happen
-        dpu_offload_event_t *ev;
-        ucp_ep_h dest_ep;
-        uint64_t dest_id = sp_gid;
         remote_service_proc_info_t *sp;
         sp = DYN_ARRAY_GET_ELT(GET_ENGINE_LIST_SERVICE_PROCS(engine), sp_gid, remote_service_proc_info_t);
         assert(sp);
@@ -683,27 +917,78 @@ dpu_offload_status_t broadcast_group_cache_revoke(offloading_engine_t *engine, g
         if (sp_gid == cfg->local_service_proc.info.global_id)
             continue;
 
-        assert(sp->econtext);
-        event_get(sp->econtext->event_channels, NULL, &ev);
-        assert(ev);
-        EVENT_HDR_TYPE(ev) = META_EVENT_TYPE;
-        dest_ep = GET_REMOTE_SERVICE_PROC_EP(engine, sp_gid);
-        // If the econtext is a client to connect to a server, the dest_id is the index;
-        // otherwise we need to find the client ID based on the index
-        if (sp->econtext->type == CONTEXT_SERVER)
-            dest_id = sp->client_id;
-        DBG("Sending group 0x%x cache revoke to service process #%ld (econtext: %p, scope_id: %d, dest_id: %ld, ep: %p)",
-            gp_cache->group_uid, sp_gid, sp->econtext, sp->econtext->scope_id, dest_id, dest_ep);
-        rc = send_local_revoke_rank_group_cache(sp->econtext, dest_ep, dest_id, gp_cache, ev);
-        CHECK_ERR_RETURN((rc), DO_ERROR, "send_local_revoke_rank_group_cache() failed");
-        if (!event_completed(ev))
-            QUEUE_EVENT(ev);
-        else
-            event_return(&ev);
+        if (!SP_READY_FOR_NOTIFS(engine, sp))
+        {
+            rc = queue_sp_notif(engine, sp, PENDING_SP_NOTIF_GROUP_REVOKE, gp_cache->group_uid, UINT64_MAX, NULL, 0);
+            CHECK_ERR_RETURN((rc), DO_ERROR, "queue_sp_notif() failed");
+            continue;
+        }
+        rc = send_group_cache_revoke_to_sp(engine, sp, gp_cache);
+        CHECK_ERR_RETURN((rc), DO_ERROR, "send_group_cache_revoke_to_sp() failed");
     }
     return DO_SUCCESS;
 }
 
+static void group_cache_bcast_completed(op_desc_t *desc, void *ctx)
+{
+    if (desc->state != OP_STATE_COMPLETED)
+        ERR_MSG("broadcast of the cache entries of the local ranks failed (status: %d)", desc->status);
+    free(ctx);
+    op_desc_return(desc->econtext->engine, &desc);
+}
+
+/**
+ * @brief bcast_local_rank_group_cache distributes the cache entries of the local ranks to the other
+ * service processes with a segmented broadcast, which is pipelined along a tree of service processes
+ * instead of sending the entire set of entries to each of them.
+ *
+ * @param engine Associated offloading engine
+ * @param gp_cache Group cache whose local ranks are complete
+ * @return dpu_offload_status_t
+ */
+static dpu_offload_status_t bcast_local_rank_group_cache(offloading_engine_t *engine, group_cache_t *gp_cache)
+{
+    execution_context_t *econtext = engine->self_econtext;
+    peer_cache_entry_t *entries = NULL;
+    size_t count = 0, idx = 0;
+    bcast_params_t params;
+    op_desc_t *desc = NULL;
+    dpu_offload_status_t rc;
+    uint64_t id;
+
+    entries = DPU_OFFLOAD_MALLOC(gp_cache->n_local_ranks_populated * sizeof(peer_cache_entry_t));
+    CHECK_ERR_RETURN((entries == NULL), DO_ERROR, "unable to allocate memory");
+    while (count < gp_cache->n_local_ranks_populated)
+    {
+        size_t n_entries, idx_start;
+        peer_cache_entry_t *first_entry;
+        find_range_local_ranks(econtext, gp_cache->group_uid, gp_cache->group_size, idx, gp_cache->n_local_ranks_populated, count, &idx_start, &n_entries, &idx);
+        first_entry = GET_GROUP_RANK_CACHE_ENTRY(&(engine->procs_cache), gp_cache->group_uid, idx_start, gp_cache->group_size);
+        memcpy(&(entries[count]), first_entry, n_entries * sizeof(peer_cache_entry_t));
+        count += n_entries;
+    }
+
+    // Every service process broadcasts the entries of its local ranks for every version of the group
+    id = (gp_cache->persistent.num << 32) | engine->config->local_service_proc.info.global_id;
+    memset(&params, 0, sizeof(params));
+    params.gp_uid = gp_cache->group_uid;
+    params.type = BCAST_TYPE_GROUP_CACHE;
+    params.buf = entries;
+    params.len = count * sizeof(peer_cache_entry_t);
+    DBG("Broadcasting %ld cache entries of group 0x%x (seq num: %ld, %ld bytes)",
+        count, gp_cache->group_uid, gp_cache->persistent.num, params.len);
+    rc = bcast_post(econtext, id, &params, &desc);
+    if (rc != DO_SUCCESS)
+    {
+        free(entries);
+        ERR_MSG("bcast_post() failed");
+        return DO_ERROR;
+    }
+    desc->completion_cb = group_cache_bcast_completed;
+    desc->completion_ctx = entries;
+    return DO_SUCCESS;
+}
+
 dpu_offload_status_t broadcast_group_cache(offloading_engine_t *engine, group_cache_t *group_cache)
 {
     size_t sp_gid;
@@ -728,17 +1013,26 @@ dpu_offload_status_t broadcast_group_cache(offloading_engine_t *engine, group_ca
         ERR_MSG("Not on a DPU, not allowed to broadcast group cache");
         return DO_ERROR;
     }
-
-    if (engine->num_service_procs > 1)
+    // Only recorded when the broadcast actually starts, i.e., all the service processes are connected
+    group_cache_record_milestone(engine, group_cache, GROUP_CACHE_MILESTONE_LOCAL_RANKS_COMPLETE);
+
+    // When connections are established on demand, the entries always go through the broadcast
+    // tree so each service process only connects to its neighbours in the trees instead of
+    // creating the full mesh
+    if (engine->num_service_procs > 1 &&
+        (LAZY_INTER_SP_CONNECT(engine) ||
+         (engine->settings.cache_bcast_threshold > 0 &&
+          group_cache->n_local_ranks_populated * sizeof(peer_cache_entry_t) >= engine->settings.cache_bcast_threshold)))
+    {
+        dpu_offload_status_t rc = bcast_local_rank_group_cache(engine, group_cache);
+        CHECK_ERR_RETURN((rc), DO_ERROR, "bcast_local_rank_group_cache() failed");
+    }
+    else if (engine->num_service_procs > 1)
     {
         for (sp_gid = 0; sp_gid < engine->num_service_procs; sp_gid++)
         {
             dpu_offload_status_t rc;
-            ucp_ep_h dest_ep;
-            uint64_t dest_id = sp_gid;
             remote_service_proc_info_t *sp;
-            // Meta-event to be used to track all that needs to happen
-            dpu_offload_event_t *ev = NULL;
 
             sp = DYN_ARRAY_GET_ELT(GET_ENGINE_LIST_SERVICE_PROCS(engine), sp_gid, remote_service_proc_info_t);
             assert(sp);
@@ -748,33 +1042,19 @@ dpu_offload_status_t broadcast_group_cache(offloading_engine_t *engine, group_ca
             if (sp_gid == cfg->local_service_proc.info.global_id)
                 continue;
 
-            assert(sp->econtext);
-            event_get(sp->econtext->event_channels, NULL, &ev);
-            assert(ev);
-            EVENT_HDR_TYPE(ev) = META_EVENT_TYPE;
-            dest_ep = GET_REMOTE_SERVICE_PROC_EP(engine, sp_gid);
-            // If the econtext is a client to connect to a server, the dest_id is the index, i.e., the global SP ID;
-            // otherwise we need to find the client ID based on the index
-            if (sp->econtext->type == CONTEXT_SERVER)
+            if (!SP_READY_FOR_NOTIFS(engine, sp))
             {
-                dest_id = sp->client_id;
+                // The entries are packed when the notification is actually sent so
+                // the remote service process gets the latest content of the cache
+                rc = queue_sp_notif(engine, sp, PENDING_SP_NOTIF_GROUP_CACHE, group_cache->group_uid, UINT64_MAX, NULL, 0);
+                CHECK_ERR_RETURN((rc), DO_ERROR, "queue_sp_notif() failed");
+                continue;
             }
-            DBG("Sending group cache 0x%x (seq num: %ld) to service process #%ld (econtext: %p, scope_id: %d, dest_id: %ld, ep: %p)",
-                group_cache->group_uid,
-                group_cache->persistent.num,
-                sp_gid,
-                sp->econtext,
-                sp->econtext->scope_id,
-                dest_id,
-                dest_ep);
-            rc = send_local_rank_group_cache(sp->econtext, dest_ep, dest_id, group_cache->group_uid, ev);
-            CHECK_ERR_RETURN((rc), DO_ERROR, "send_local_rank_group_cache() failed");
-            if (!event_completed(ev))
-                QUEUE_EVENT(ev);
-            else
-                event_return(&ev);
+            rc = send_group_cache_to_sp(engine, sp, group_cache);
+            CHECK_ERR_RETURN((rc), DO_ERROR, "send_group_cache_to_sp() failed");
         }
     }
+    group_cache_record_milestone(engine, group_cache, GROUP_CACHE_MILESTONE_BCAST_POSTED);
 
     // Timing for sending/receiving cache entries is obviously not always the same
     // so we check if the cache is full and needs to be sent to the local ranks
@@ -958,6 +1238,21 @@ dpu_offload_status_t get_sp_ep_by_id(offloading_engine_t *engine, uint64_t sp_id
         return DO_SUCCESS;
     }
 
+    if (LAZY_INTER_SP_CONNECT(engine) &&
+        sp_id != engine->config->local_service_proc.info.global_id &&
+        sp->conn_status != CONNECT_STATUS_CONNECTED)
+    {
+        // First use of the service process, the connection is established on demand.
+        // Like above, the caller is expected to try again later.
+        dpu_offload_status_t rc = connect_to_remote_service_proc_on_demand(sp);
+        CHECK_ERR_RETURN((rc), DO_ERROR, "connect_to_remote_service_proc_on_demand() failed");
+        *sp_ep = NULL;
+        *econtext_comm = NULL;
+        *comm_id = UINT64_MAX;
+        DBG("Connection to service process #%" PRIu64 " in progress, endpoint not available yet", sp_id);
+        return DO_SUCCESS;
+    }
+
     // If not, we find the appropriate client or server
     *sp_ep = GET_REMOTE_SERVICE_PROC_EP(engine, sp_id);
     if (*sp_ep == NULL && !engine->on_dpu && sp_id == engine->config->local_service_proc.info.global_id)
@@ -1683,6 +1978,223 @@ dpu_offload_status_t engine_get_env_config(offloading_engine_t *engine)
     {
         engine->settings.persistent_endpoint_cache = atoi(persistent_cache_envvar);
     }
+
+    char *mem_budget_envvar = getenv(MIMOSA_GROUP_CACHE_MEM_BUDGET);
+    engine->settings.group_cache_mem_budget = 0;
+    if (mem_budget_envvar != NULL)
+    {
+        engine->settings.group_cache_mem_budget = strtoull(mem_budget_envvar, NULL, 10);
+    }
+
+    char *max_evicted_groups_envvar = getenv(MIMOSA_GROUP_CACHE_MAX_EVICTED_GROUPS);
+    engine->settings.group_cache_max_evicted_groups = DEFAULT_GROUP_CACHE_MAX_EVICTED_GROUPS;
+    if (max_evicted_groups_envvar != NULL)
+    {
+        engine->settings.group_cache_max_evicted_groups = strtoull(max_evicted_groups_envvar, NULL, 10);
+    }
+
+    char *lookup_tables_budget_envvar = getenv(MIMOSA_LOOKUP_TABLES_BUILD_BUDGET);
+    engine->settings.lookup_tables_build_budget = DEFAULT_LOOKUP_TABLES_BUILD_BUDGET_US;
+    if (lookup_tables_budget_envvar != NULL)
+    {
+        engine->settings.lookup_tables_build_budget = strtoull(lookup_tables_budget_envvar, NULL, 10);
+    }
+
+    char *timelines_envvar = getenv(MIMOSA_GROUP_CACHE_TIMELINES);
+    engine->settings.dump_group_cache_timelines = false;
+    if (timelines_envvar != NULL)
+    {
+        engine->settings.dump_group_cache_timelines = atoi(timelines_envvar);
+    }
+
+    char *connect_timeout_envvar = getenv(MIMOSA_CONNECT_TIMEOUT);
+    engine->settings.connect_timeout = 0;
+    if (connect_timeout_envvar != NULL)
+    {
+        engine->settings.connect_timeout = strtoull(connect_timeout_envvar, NULL, 10);
+    }
+
+    char *backoff_min_envvar = getenv(MIMOSA_CONNECT_BACKOFF_MIN);
+    engine->settings.connect_backoff_min = DEFAULT_CONNECT_BACKOFF_MIN_US;
+    if (backoff_min_envvar != NULL)
+    {
+        engine->settings.connect_backoff_min = strtoull(backoff_min_envvar, NULL, 10);
+    }
+
+    char *backoff_max_envvar = getenv(MIMOSA_CONNECT_BACKOFF_MAX);
+    engine->settings.connect_backoff_max = DEFAULT_CONNECT_BACKOFF_MAX_US;
+    if (backoff_max_envvar != NULL)
+    {
+        engine->settings.connect_backoff_max = strtoull(backoff_max_envvar, NULL, 10);
+    }
+    if (engine->settings.connect_backoff_max < engine->settings.connect_backoff_min)
+        engine->settings.connect_backoff_max = engine->settings.connect_backoff_min;
+
+    char *async_connect_envvar = getenv(MIMOSA_ASYNC_CONNECT);
+    engine->settings.async_connect = false;
+    if (async_connect_envvar != NULL)
+    {
+        engine->settings.async_connect = atoi(async_connect_envvar);
+    }
+
+    char *lazy_inter_sp_connect_envvar = getenv(MIMOSA_LAZY_INTER_SP_CONNECT);
+    engine->settings.lazy_inter_sp_connect = false;
+    if (lazy_inter_sp_connect_envvar != NULL)
+    {
+        engine->settings.lazy_inter_sp_connect = atoi(lazy_inter_sp_connect_envvar);
+    }
+
+    char *inter_sp_connect_max_inflight_envvar = getenv(MIMOSA_INTER_SP_CONNECT_MAX_INFLIGHT);
+    engine->settings.inter_sp_connect_max_inflight = DEFAULT_INTER_SP_CONNECT_MAX_INFLIGHT;
+    if (inter_sp_connect_max_inflight_envvar != NULL)
+    {
+        engine->settings.inter_sp_connect_max_inflight = strtoull(inter_sp_connect_max_inflight_envvar, NULL, 10);
+    }
+
+    char *inter_sp_connect_retries_envvar = getenv(MIMOSA_INTER_SP_CONNECT_RETRIES);
+    engine->settings.inter_sp_connect_retries = DEFAULT_INTER_SP_CONNECT_RETRIES;
+    if (inter_sp_connect_retries_envvar != NULL)
+    {
+        engine->settings.inter_sp_connect_retries = strtoull(inter_sp_connect_retries_envvar, NULL, 10);
+    }
+
+    engine->settings.trace_dir = getenv(MIMOSA_TRACE_DIR);
+    char *trace_ring_size_envvar = getenv(MIMOSA_TRACE_RING_SIZE);
+    engine->settings.trace_ring_size = DEFAULT_TRACE_RING_SIZE;
+    if (trace_ring_size_envvar != NULL)
+    {
+        engine->settings.trace_ring_size = strtoull(trace_ring_size_envvar, NULL, 10);
+    }
+
+    char *resume_ttl_envvar = getenv(MIMOSA_RESUME_TTL);
+    engine->settings.resume_ttl = 0;
+    if (resume_ttl_envvar != NULL)
+    {
+        engine->settings.resume_ttl = strtoull(resume_ttl_envvar, NULL, 10);
+    }
+    engine->settings.resume_dir = getenv(MIMOSA_RESUME_DIR);
+
+    char *max_jobs_envvar = getenv(MIMOSA_MAX_JOBS);
+    // Resuming only makes sense if the service processes serve the following jobs
+    engine->settings.max_jobs = engine->settings.resume_ttl > 0 ? 0 : 1;
+    if (max_jobs_envvar != NULL)
+    {
+        engine->settings.max_jobs = strtoull(max_jobs_envvar, NULL, 10);
+    }
+
+    char *alltoallv_window_envvar = getenv(MIMOSA_ALLTOALLV_WINDOW);
+    engine->settings.alltoallv_window = DEFAULT_ALLTOALLV_WINDOW;
+    if (alltoallv_window_envvar != NULL)
+    {
+        engine->settings.alltoallv_window = strtoull(alltoallv_window_envvar, NULL, 10);
+        if (engine->settings.alltoallv_window == 0)
+            engine->settings.alltoallv_window = 1;
+    }
+
+    char *bcast_segment_size_envvar = getenv(MIMOSA_BCAST_SEGMENT_SIZE);
+    engine->settings.bcast_segment_size = DEFAULT_BCAST_SEGMENT_SIZE;
+    if (bcast_segment_size_envvar != NULL)
+    {
+        engine->settings.bcast_segment_size = strtoull(bcast_segment_size_envvar, NULL, 10);
+        if (engine->settings.bcast_segment_size == 0)
+            engine->settings.bcast_segment_size = DEFAULT_BCAST_SEGMENT_SIZE;
+    }
+
+    char *bcast_tree_envvar = getenv(MIMOSA_BCAST_TREE);
+    engine->settings.bcast_tree = BCAST_TREE_KNOMIAL;
+    if (bcast_tree_envvar != NULL)
+    {
+        if (strcmp(bcast_tree_envvar, "chain") == 0)
+            engine->settings.bcast_tree = BCAST_TREE_CHAIN;
+        else if (strcmp(bcast_tree_envvar, "knomial") != 0)
+        {
+            ERR_MSG("invalid value for %s: %s (expected: knomial or chain)", MIMOSA_BCAST_TREE, bcast_tree_envvar);
+            return DO_ERROR;
+        }
+    }
+
+    char *bcast_radix_envvar = getenv(MIMOSA_BCAST_RADIX);
+    engine->settings.bcast_radix = DEFAULT_BCAST_RADIX;
+    if (bcast_radix_envvar != NULL)
+    {
+        engine->settings.bcast_radix = strtoull(bcast_radix_envvar, NULL, 10);
+        if (engine->settings.bcast_radix < 2)
+            engine->settings.bcast_radix = 2;
+    }
+
+    char *cache_bcast_threshold_envvar = getenv(MIMOSA_CACHE_BCAST_THRESHOLD);
+    engine->settings.cache_bcast_threshold = DEFAULT_CACHE_BCAST_THRESHOLD;
+    if (cache_bcast_threshold_envvar != NULL)
+    {
+        engine->settings.cache_bcast_threshold = strtoull(cache_bcast_threshold_envvar, NULL, 10);
+    }
+
+    char *ops_progress_budget_envvar = getenv(MIMOSA_OPS_PROGRESS_BUDGET);
+    engine->settings.ops_progress_budget = DEFAULT_OPS_PROGRESS_BUDGET_US;
+    if (ops_progress_budget_envvar != NULL)
+    {
+        engine->settings.ops_progress_budget = strtoull(ops_progress_budget_envvar, NULL, 10);
+    }
+
+    char *ops_max_rma_envvar = getenv(MIMOSA_OPS_MAX_RMA);
+    engine->settings.ops_max_rma = DEFAULT_OPS_MAX_RMA;
+    if (ops_max_rma_envvar != NULL)
+    {
+        engine->settings.ops_max_rma = strtoull(ops_max_rma_envvar, NULL, 10);
+    }
+
+    char *op_queue_weight_envvar = getenv(MIMOSA_OP_QUEUE_WEIGHT);
+    engine->settings.op_queue_weight = DEFAULT_OP_QUEUE_WEIGHT;
+    if (op_queue_weight_envvar != NULL)
+    {
+        engine->settings.op_queue_weight = strtoull(op_queue_weight_envvar, NULL, 10);
+        if (engine->settings.op_queue_weight == 0)
+            engine->settings.op_queue_weight = 1;
+    }
+
+    char *op_msg_timeout_envvar = getenv(MIMOSA_OP_MSG_TIMEOUT);
+    engine->settings.op_msg_timeout = DEFAULT_OP_MSG_TIMEOUT_MS;
+    if (op_msg_timeout_envvar != NULL)
+    {
+        engine->settings.op_msg_timeout = strtoull(op_msg_timeout_envvar, NULL, 10);
+    }
+
+    char *dump_op_queue_stats_envvar = getenv(MIMOSA_DUMP_OP_QUEUE_STATS);
+    engine->settings.dump_op_queue_stats = false;
+    if (dump_op_queue_stats_envvar != NULL)
+    {
+        engine->settings.dump_op_queue_stats = atoi(dump_op_queue_stats_envvar);
+    }
+
+    char *ep_pool_max_idle_envvar = getenv(MIMOSA_EP_POOL_MAX_IDLE);
+    if (ep_pool_max_idle_envvar != NULL)
+    {
+        engine->ep_pool.max_idle = strtoull(ep_pool_max_idle_envvar, NULL, 10);
+    }
+    return DO_SUCCESS;
+}
+
+dpu_offload_status_t get_rendezvous_config(offloading_config_t *config_data)
+{
+    char *rendezvous_envvar = getenv(MIMOSA_RENDEZVOUS);
+    char *rendezvous_path_envvar = getenv(MIMOSA_RENDEZVOUS_PATH);
+
+    if (rendezvous_envvar != NULL)
+    {
+        if (strcmp(rendezvous_envvar, "oob") == 0)
+            config_data->rendezvous.backend = RENDEZVOUS_OOB;
+        else if (strcmp(rendezvous_envvar, "file") == 0)
+            config_data->rendezvous.backend = RENDEZVOUS_FILE;
+        else if (strcmp(rendezvous_envvar, "shm") == 0)
+            config_data->rendezvous.backend = RENDEZVOUS_SHM;
+        else
+        {
+            ERR_MSG("invalid value for %s: %s (expected: oob, file or shm)", MIMOSA_RENDEZVOUS, rendezvous_envvar);
+            return DO_ERROR;
+        }
+    }
+    if (rendezvous_path_envvar != NULL)
+        config_data->rendezvous.path = rendezvous_path_envvar;
     return DO_SUCCESS;
 }
 
@@ -1703,6 +2215,9 @@ dpu_offload_status_t get_host_config(offloading_config_t *config_data)
     hostname[1023] = '\0';
     gethostname(hostname, 1023);
 
+    rc = get_rendezvous_config(config_data);
+    CHECK_ERR_RETURN((rc), DO_ERROR, "get_rendezvous_config() failed");
+
     config_data->list_dpus = NULL;                                                         // Not used on host
     RESET_INIT_PARAMS(&(config_data->local_service_proc.inter_service_procs_init_params)); // Not used on host
     RESET_INIT_PARAMS(&(config_data->local_service_proc.host_init_params));                // Not used on host
@@ -9,6 +9,7 @@
 #include <inttypes.h>
 #include <stdbool.h>
 #include <string.h>
+#include <time.h>
 #include <unistd.h>
 
 #include "dpu_offload_types.h"
@@ -29,6 +30,7 @@ rank_info_t invalid_group_rank = {
 
 extern execution_context_t *server_init(offloading_engine_t *, init_params_t *);
 extern execution_context_t *client_init(offloading_engine_t *, init_params_t *);
+extern dpu_offload_status_t client_reconnect(execution_context_t *econtext);
 
 // dpu: remote_dpu_info_t struct
 #define ADD_LOCAL_SPS_TO_DPU_CONFIG(_cfg, _dpu)                                                                             \
@@ -272,6 +274,18 @@ void connected_to_server_dpu(void *data)
 
     assert(connected_peer->econtext);
     assert(connected_peer->econtext->engine);
+    remote_service_proc_info_t *sp = DYN_ARRAY_GET_ELT(GET_ENGINE_LIST_SERVICE_PROCS(connected_peer->econtext->engine),
+                                                       connected_peer->global_peer_id,
+                                                       remote_service_proc_info_t);
+    assert(sp);
+    if (sp->conn_status == CONNECT_STATUS_CONNECTED)
+    {
+        // With on-demand connections, both service processes may connect to each other at the same
+        // time. The connection that completed first is used, this one is kept but remains unused.
+        DBG("Service process %" PRIu64 " is already connected, not using the new connection", connected_peer->global_peer_id);
+        return;
+    }
+    sp->conn_status = CONNECT_STATUS_CONNECTED;
     if (connected_peer->econtext->engine->num_connected_service_procs + 1 == connected_peer->econtext->engine->num_service_procs)
         can_exchange_cache = true;
     connected_peer->econtext->engine->num_connected_service_procs++;
@@ -292,6 +306,10 @@ dpu_offload_status_t connect_to_remote_service_proc(remote_service_proc_info_t *
     CHECK_ERR_RETURN((remote_service_proc_info == NULL), DO_ERROR, "Remote DPU info is NULL");
     offloading_engine_t *offload_engine = remote_service_proc_info->offload_engine;
     CHECK_ERR_RETURN((offload_engine == NULL), DO_ERROR, "undefined offload_engine");
+    CHECK_ERR_RETURN((offload_engine->num_inter_service_proc_clients >= offload_engine->num_max_inter_service_proc_clients),
+                     DO_ERROR,
+                     "max number of connections to other service processes (%ld) has been reached",
+                     offload_engine->num_max_inter_service_proc_clients);
 
     assert(remote_service_proc_info->service_proc.global_id != UINT64_MAX);
     assert(remote_service_proc_info->init_params.conn_params->addr_str);
@@ -312,42 +330,177 @@ dpu_offload_status_t connect_to_remote_service_proc(remote_service_proc_info_t *
     remote_service_proc_info->init_params.proc_info = &service_proc_info;
     remote_service_proc_info->init_params.connected_cb = connected_to_server_dpu;
     remote_service_proc_info->init_params.scope_id = SCOPE_INTER_SERVICE_PROCS;
+    // The connection is driven by the connection manager while progressing the engine
+    remote_service_proc_info->init_params.async_connect = true;
     // We make sure that we use the inter-service-process port here because we do not know the context while
     // parsing the configuration file (host or DPU) and updating the value while parsing ends up beinng confusing
     remote_service_proc_info->init_params.conn_params->port = remote_service_proc_info->config->version_1.intersp_port;
+    remote_service_proc_info->conn_status = CONNECT_STATUS_IN_PROGRESS;
     execution_context_t *client = client_init(offload_engine, &(remote_service_proc_info->init_params));
+    if (client == NULL)
+        remote_service_proc_info->conn_status = CONNECT_STATUS_DISCONNECTED;
     CHECK_ERR_RETURN((client == NULL), DO_ERROR, "Unable to connect to %s\n", remote_service_proc_info->init_params.conn_params->addr_str);
     ENGINE_LOCK(offload_engine);
     offload_engine->inter_service_proc_clients[offload_engine->num_inter_service_proc_clients].client_econtext = client;
     offload_engine->inter_service_proc_clients[offload_engine->num_inter_service_proc_clients].remote_service_proc_info = remote_service_proc_info;
+    offload_engine->inter_service_proc_clients[offload_engine->num_inter_service_proc_clients].in_progress = true;
     offload_engine->num_inter_service_proc_clients++;
-    assert(client->client->id != UINT64_MAX);
-    assert(client->client->server_global_id != UINT64_MAX);
-    CLIENT_SERVER_ADD(offload_engine,
-                      client->client->id,
-                      client->client->server_global_id,
-                      client);
+    remote_service_proc_info->num_connect_attempts++;
+    // The client is added to the client/server lookup table once its ID is known,
+    // see finalize_connection_to_remote_service_proc()
     ENGINE_UNLOCK(offload_engine);
     return DO_SUCCESS;
 }
 
+/**
+ * @brief Queue a connection to a remote service process. The connection is initiated by
+ * inter_sp_connect_mgr_progress() as soon as the number of connections in progress allows it.
+ *
+ * @param engine Associated offloading engine
+ * @param sp Remote service process to connect to
+ */
+static void inter_sp_connect_mgr_queue(offloading_engine_t *engine, remote_service_proc_info_t *sp)
+{
+    inter_sp_connect_mgr_t *mgr = &(engine->inter_sp_connect_mgr);
+    if (mgr->start == 0)
+        mgr->start = monotonic_time_us();
+    sp->conn_status = CONNECT_STATUS_IN_PROGRESS;
+    // Includes the time spent in the queue, waiting for other connections to complete
+    TRACE_BEGIN(TRACE_PHASE_INTER_SP_CONNECT, NULL, sp->idx);
+    ucs_list_add_tail(&(mgr->queue), &(sp->connect_item));
+    mgr->num_connections++;
+}
+
+/**
+ * @brief Make progress on the outgoing connections to other service processes: restart the
+ * connections that failed, initiate queued connections while fewer than
+ * settings.inter_sp_connect_max_inflight are in progress and record the time it took to build
+ * the full mesh. Invoked while progressing the engine.
+ *
+ * @param engine Associated offloading engine
+ * @return dpu_offload_status_t
+ */
+dpu_offload_status_t inter_sp_connect_mgr_progress(offloading_engine_t *engine)
+{
+    inter_sp_connect_mgr_t *mgr = &(engine->inter_sp_connect_mgr);
+    size_t c;
+
+    if (mgr->start == 0 || (mgr->num_in_flight == 0 && ucs_list_is_empty(&(mgr->queue)) && mgr->time_to_full_mesh != 0))
+        return DO_SUCCESS;
+
+    // Restart the connections that could not be established before the deadline
+    for (c = 0; c < engine->num_inter_service_proc_clients && mgr->num_in_flight > 0; c++)
+    {
+        remote_service_procs_connect_tracker_t *tracker = &(engine->inter_service_proc_clients[c]);
+        execution_context_t *c_econtext = tracker->client_econtext;
+        remote_service_proc_info_t *sp = tracker->remote_service_proc_info;
+        dpu_offload_status_t rc;
+
+        if (!tracker->in_progress || c_econtext->client->bootstrapping.phase != DISCONNECTED)
+            continue;
+        if (sp->conn_status == CONNECT_STATUS_CONNECTED)
+        {
+            // The remote service process connected to us in the meantime (on-demand connections)
+            tracker->in_progress = false;
+            mgr->num_in_flight--;
+            TRACE_END(TRACE_PHASE_INTER_SP_CONNECT, NULL, sp->idx);
+            continue;
+        }
+        if (sp->num_connect_attempts > engine->settings.inter_sp_connect_retries)
+        {
+            sp->conn_status = CONNECT_STATUS_DISCONNECTED;
+            tracker->in_progress = false;
+            mgr->num_in_flight--;
+            TRACE_END(TRACE_PHASE_INTER_SP_CONNECT, NULL, sp->idx);
+            ERR_MSG("unable to connect to service process #%" PRIu64 " after %ld attempt(s)", sp->idx, sp->num_connect_attempts);
+            return DO_ERROR;
+        }
+        DBG("Connection to service process #%" PRIu64 " failed, restarting it (attempt #%ld)",
+            sp->idx, sp->num_connect_attempts + 1);
+        rc = client_reconnect(c_econtext);
+        CHECK_ERR_RETURN((rc), DO_ERROR, "client_reconnect() failed");
+        sp->num_connect_attempts++;
+        mgr->num_restarts++;
+    }
+
+    // Initiate queued connections
+    while (!ucs_list_is_empty(&(mgr->queue)) &&
+           (engine->settings.inter_sp_connect_max_inflight == 0 ||
+            mgr->num_in_flight < engine->settings.inter_sp_connect_max_inflight))
+    {
+        dpu_offload_status_t rc;
+        remote_service_proc_info_t *sp = ucs_list_extract_head(&(mgr->queue), remote_service_proc_info_t, connect_item);
+        assert(sp);
+        rc = connect_to_remote_service_proc(sp);
+        CHECK_ERR_RETURN((rc), DO_ERROR, "connect_to_remote_service_proc() failed");
+        mgr->num_in_flight++;
+    }
+
+    if (mgr->time_to_full_mesh == 0 &&
+        !LAZY_INTER_SP_CONNECT(engine) &&
+        engine->num_service_procs == engine->num_connected_service_procs + 1)
+    {
+        mgr->time_to_full_mesh = monotonic_time_us() - mgr->start;
+        TRACE_END(TRACE_PHASE_INTER_SP_CONNECT_MGR, NULL, TRACE_NO_PEER);
+        INFO_MSG("connected to all %ld other service processes in %" PRIu64 " us (outgoing connections: %ld, restarts: %ld)",
+                 engine->num_connected_service_procs,
+                 mgr->time_to_full_mesh,
+                 mgr->num_connections,
+                 mgr->num_restarts);
+    }
+    return DO_SUCCESS;
+}
+
+/**
+ * @brief Invoked when an outgoing connection to a service process completes.
+ *
+ * @param engine Associated offloading engine
+ * @param tracker Tracker of the connection
+ */
+void inter_sp_connect_mgr_completed(offloading_engine_t *engine, remote_service_procs_connect_tracker_t *tracker)
+{
+    if (!tracker->in_progress)
+        return;
+    assert(engine->inter_sp_connect_mgr.num_in_flight > 0);
+    tracker->in_progress = false;
+    engine->inter_sp_connect_mgr.num_in_flight--;
+    engine->inter_sp_connect_mgr.num_completed++;
+    TRACE_END(TRACE_PHASE_INTER_SP_CONNECT, NULL, tracker->remote_service_proc_info->idx);
+}
+
+/**
+ * @brief Start connecting to a remote service process the first time it is needed, when
+ * connections between service processes are established on demand. Nothing is done if the
+ * service process is already connected or if a connection is in progress, regardless of
+ * which side initiated it.
+ *
+ * @param sp Remote service process to connect to
+ * @return dpu_offload_status_t
+ */
+dpu_offload_status_t connect_to_remote_service_proc_on_demand(remote_service_proc_info_t *sp)
+{
+    assert(sp);
+    if (sp->conn_status == CONNECT_STATUS_CONNECTED || sp->conn_status == CONNECT_STATUS_IN_PROGRESS)
+        return DO_SUCCESS;
+    DBG("First use of service process #%" PRIu64 ", connecting to it", sp->idx);
+    inter_sp_connect_mgr_queue(sp->offload_engine, sp);
+    return inter_sp_connect_mgr_progress(sp->offload_engine);
+}
+
 static dpu_offload_status_t
 connect_to_service_procs(offloading_engine_t *offload_engine, service_procs_inter_connect_info_t *info_connect_to, init_params_t *init_params)
 {
     assert(offload_engine);
     assert(info_connect_to);
     assert(init_params);
-    // Create a connection thread for all the required connection
+    // All the connections are handed over to the connection manager, which initiates them
+    // in the background and limits how many are in progress at the same time
     connect_to_service_proc_t *conn_info, *conn_info_next;
     ucs_list_for_each_safe(conn_info, conn_info_next, &(info_connect_to->sps_connect_to), item)
     {
-        // Initiate the connection to the remote service process running on a specific DPU.
-        // This is a non-blocking operation, meaning there is no guarantee the connection
-        // will not be fully established when the function returns
-        dpu_offload_status_t rc = connect_to_remote_service_proc(conn_info->sp);
-        CHECK_ERR_RETURN((rc), DO_ERROR, "unable to start connection thread");
+        inter_sp_connect_mgr_queue(offload_engine, conn_info->sp);
     }
-    return DO_SUCCESS;
+    return inter_sp_connect_mgr_progress(offload_engine);
 }
 
 static uint64_t get_dpu_global_id_from_service_proc_id(offloading_engine_t *engine, uint64_t service_proc_global_id)
@@ -410,6 +563,13 @@ void client_service_proc_connected(void *data)
     // Update data in the list of DPUs
     sp = DYN_ARRAY_GET_ELT(GET_ENGINE_LIST_SERVICE_PROCS(connected_peer->econtext->engine), service_proc_global_id, remote_service_proc_info_t);
     assert(sp);
+    if (sp->conn_status == CONNECT_STATUS_CONNECTED)
+    {
+        // Our own connection to that service process completed first (on-demand connections), keep using it
+        DBG("Service process #%" PRIu64 " is already connected, not using the new connection", service_proc_global_id);
+        return;
+    }
+    sp->conn_status = CONNECT_STATUS_CONNECTED;
     sp->addr = connected_peer->addr;
     sp->addr_len = connected_peer->addr_len;
     sp->econtext = connected_peer->econtext;
@@ -418,8 +578,8 @@ void client_service_proc_connected(void *data)
     {
         uint64_t my_sp_gid;
         my_sp_gid = econtext->engine->config->local_service_proc.info.global_id;
-        // We can only be a server for SPs with a lower GID
-        assert(service_proc_global_id < my_sp_gid);
+        // We can only be a server for SPs with a lower GID, unless connections are established on demand
+        assert(LAZY_INTER_SP_CONNECT(econtext->engine) || service_proc_global_id < my_sp_gid);
     }
 #endif
 
@@ -455,6 +615,10 @@ dpu_offload_status_t inter_dpus_connect_mgr(offloading_engine_t *engine, offload
     CHECK_ERR_RETURN((cfg == NULL), DO_ERROR, "undefined configuration");
 
     engine->on_dpu = true;
+    // Used to report the time it takes to get connected to all the other service processes
+    engine->inter_sp_connect_mgr.start = monotonic_time_us();
+    // Ends once the full mesh is built, see inter_sp_connect_mgr_progress()
+    TRACE_BEGIN(TRACE_PHASE_INTER_SP_CONNECT_MGR, NULL, TRACE_NO_PEER);
 
     DBG("Connection manager: expecting %ld inbound connections and %ld outbound connections",
         cfg->num_connecting_service_procs, cfg->info_connecting_to.num_connect_to);
@@ -495,7 +659,9 @@ dpu_offload_status_t inter_dpus_connect_mgr(offloading_engine_t *engine, offload
 
     assert(cfg->offloading_engine->num_servers == 0);
 
-    if (cfg->num_connecting_service_procs > 0)
+    // With on-demand connections, any other service process may connect to us
+    if (cfg->num_connecting_service_procs > 0 ||
+        (LAZY_INTER_SP_CONNECT(engine) && engine->num_service_procs > 1))
     {
         // Some service processes will be connecting to us so we start a new server.
         DBG("Starting server to let other service processes connect to us (init_params=%p, conn_params=%p)...",
@@ -514,6 +680,15 @@ dpu_offload_status_t inter_dpus_connect_mgr(offloading_engine_t *engine, offload
         // Nothing else to do in this context.
     }
 
+    if (LAZY_INTER_SP_CONNECT(engine))
+    {
+        // Connections to other service processes are established on first use, see get_sp_ep_by_id()
+        DBG("On-demand connections between service processes, not connecting to the %ld other service processes",
+            cfg->info_connecting_to.num_connect_to);
+        TRACE_END(TRACE_PHASE_INTER_SP_CONNECT_MGR, NULL, TRACE_NO_PEER);
+        return DO_SUCCESS;
+    }
+
     if (cfg->info_connecting_to.num_connect_to > 0)
     {
         // We need to connect to one or more other service processes
@@ -540,6 +715,9 @@ dpu_offload_status_t get_dpu_config(offloading_engine_t *offload_engine, offload
     config_data->local_service_proc.hostname[1023] = '\0';
     gethostname(config_data->local_service_proc.hostname, 1023);
 
+    rc = get_rendezvous_config(config_data);
+    CHECK_ERR_RETURN((rc), DO_ERROR, "get_rendezvous_config() failed");
+
     config_data->list_dpus = getenv(LIST_DPUS_ENVVAR);
     CHECK_ERR_RETURN((config_data->list_dpus == NULL),
                      DO_ERROR,
@@ -0,0 +1,76 @@
+//
+// Copyright (c) 2023, NVIDIA CORPORATION. All rights reserved.
+//
+// See LICENSE.txt for license information
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <assert.h>
+
+#include <dpu_offload_types.h>
+
+#define NUM_BITS (200)
+
+int main(int argc, char **argv)
+{
+    group_cache_bitset_t *bitset1 = NULL;
+    group_cache_bitset_t *bitset2 = NULL;
+    size_t i, n_found = 0, expected_bit = 0;
+
+    GROUP_CACHE_BITSET_CREATE(bitset1, NUM_BITS);
+    GROUP_CACHE_BITSET_CREATE(bitset2, NUM_BITS);
+    assert(bitset1);
+    assert(bitset2);
+
+    // Set every third bit, including bits at word boundaries
+    for (i = 0; i < NUM_BITS; i += 3)
+        GROUP_CACHE_BITSET_SET(bitset1, i);
+    if (GROUP_CACHE_BITSET_COUNT(bitset1, NUM_BITS) != (NUM_BITS + 2) / 3)
+    {
+        fprintf(stderr, "ERROR: invalid number of bits set: %ld\n", GROUP_CACHE_BITSET_COUNT(bitset1, NUM_BITS));
+        return EXIT_FAILURE;
+    }
+    // Only bits 0, 3, 6 are before bit 7
+    if (GROUP_CACHE_BITSET_COUNT(bitset1, 7) != 3)
+    {
+        fprintf(stderr, "ERROR: invalid number of bits set before bit 7: %ld\n", GROUP_CACHE_BITSET_COUNT(bitset1, 7));
+        return EXIT_FAILURE;
+    }
+
+    GROUP_CACHE_BITSET_FOREACH(bitset1, NUM_BITS, bit, {
+        if (bit != expected_bit)
+        {
+            fprintf(stderr, "ERROR: found bit %ld instead of %ld\n", bit, expected_bit);
+            return EXIT_FAILURE;
+        }
+        expected_bit += 3;
+        n_found++;
+    });
+    if (n_found != (NUM_BITS + 2) / 3)
+    {
+        fprintf(stderr, "ERROR: iterated over %ld bits instead of %d\n", n_found, (NUM_BITS + 2) / 3);
+        return EXIT_FAILURE;
+    }
+
+    // Merge even bits: only the ones that are not multiples of 3 are new
+    for (i = 0; i < NUM_BITS; i += 2)
+        GROUP_CACHE_BITSET_SET(bitset2, i);
+    n_found = GROUP_CACHE_BITSET_OR_COUNT_NEW(bitset1, bitset2, NUM_BITS);
+    if (n_found != (NUM_BITS / 2) - ((NUM_BITS + 5) / 6))
+    {
+        fprintf(stderr, "ERROR: %ld new bits after merge\n", n_found);
+        return EXIT_FAILURE;
+    }
+    GROUP_CACHE_BITSET_CLEAR(bitset1, 0);
+    if (GROUP_CACHE_BITSET_TEST(bitset1, 0) || !GROUP_CACHE_BITSET_TEST(bitset1, 198))
+    {
+        fprintf(stderr, "ERROR: invalid bitset after merge\n");
+        return EXIT_FAILURE;
+    }
+
+    GROUP_CACHE_BITSET_DESTROY(bitset1);
+    GROUP_CACHE_BITSET_DESTROY(bitset2);
+    fprintf(stdout, "%s: test succeeded\n", argv[0]);
+    return EXIT_SUCCESS;
+}
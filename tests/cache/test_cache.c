@@ -581,6 +581,42 @@ dpu_offload_status_t test_topo_api(offloading_engine_t *engine)
         return DO_ERROR;
     }
 
+    // Check the batch queries are consistent with the single-rank queries
+    fprintf(stdout, "-> testing get_sp_ids_by_group_ranks() and get_group_ranks_host()...\n");
+    {
+        int64_t batch_sp_ids[NUM_FAKE_CACHE_ENTRIES];
+        uint64_t batch_host_ids[NUM_FAKE_CACHE_ENTRIES];
+        size_t n_missing;
+        rc = get_sp_ids_by_group_ranks(engine, gpuid, NULL, NUM_FAKE_CACHE_ENTRIES, 0, batch_sp_ids, &n_missing);
+        if (rc != DO_SUCCESS || n_missing != 0)
+        {
+            fprintf(stderr, "ERROR: get_sp_ids_by_group_ranks() failed (missing: %ld)\n", n_missing);
+            return DO_ERROR;
+        }
+        rc = get_group_ranks_host(engine, gpuid, NULL, NUM_FAKE_CACHE_ENTRIES, batch_host_ids, &n_missing);
+        if (rc != DO_SUCCESS || n_missing != 0)
+        {
+            fprintf(stderr, "ERROR: get_group_ranks_host() failed (missing: %ld)\n", n_missing);
+            return DO_ERROR;
+        }
+        for (i = 0; i < NUM_FAKE_CACHE_ENTRIES; i++)
+        {
+            uint64_t host_id;
+            size_t host_sp_idx = get_host_idx(i) * NUM_FAKE_DPU_PER_HOST * NUM_FAKE_SP_PER_DPU;
+            if (batch_sp_ids[i] != (int64_t)(host_sp_idx + i % (NUM_FAKE_DPU_PER_HOST * NUM_FAKE_SP_PER_DPU)))
+            {
+                fprintf(stderr, "ERROR: rank %ld is reported as associated to SP %" PRId64 "\n", i, batch_sp_ids[i]);
+                return DO_ERROR;
+            }
+            rc = get_group_rank_host(engine, gpuid, i, &host_id);
+            if (rc != DO_SUCCESS || host_id != batch_host_ids[i])
+            {
+                fprintf(stderr, "ERROR: rank %ld is reported on host 0x%lx instead of 0x%lx\n", i, batch_host_ids[i], host_id);
+                return DO_ERROR;
+            }
+        }
+    }
+
     return DO_SUCCESS;
 }
 
@@ -0,0 +1,226 @@
+//
+// Copyright (c) 2023, NVIDIA CORPORATION. All rights reserved.
+//
+// See LICENSE.txt for license information
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <dpu_offload_collectives.h>
+
+/*
+ * Check the schedule of the allreduce between service processes for groups spread over several of
+ * them: the leaders and the peers of every step are computed for various placements of the ranks,
+ * then the exchange between leaders is simulated to check that every leader ends up with the data of
+ * all the service processes, reduced in the same order. To run the test, simply execute:
+ * $ ./allreduce_schedule_test
+ */
+
+#define MAX_GROUP_SIZE (64)
+#define MAX_EXPR_LEN (4096)
+
+typedef enum
+{
+    PLACEMENT_BLOCK = 0, // Consecutive ranks on the same service process
+    PLACEMENT_CYCLIC,    // Ranks distributed round-robin
+    PLACEMENT_SCATTERED, // Pseudo-random service process for each rank
+    PLACEMENT_LAST,
+} placement_t;
+
+static const char *placement_names[PLACEMENT_LAST] = {"block", "cyclic", "scattered"};
+
+static void place_ranks(placement_t placement, int64_t group_size, int64_t num_sps, int64_t *sp_ids)
+{
+    int64_t i;
+    for (i = 0; i < group_size; i++)
+    {
+        switch (placement)
+        {
+        case PLACEMENT_BLOCK:
+            sp_ids[i] = i * num_sps / group_size;
+            break;
+        case PLACEMENT_CYCLIC:
+            sp_ids[i] = i % num_sps;
+            break;
+        default:
+            sp_ids[i] = (i * 7 + 3) % num_sps;
+            break;
+        }
+        // Global IDs of the service processes are not the index of the service process in the group
+        sp_ids[i] = sp_ids[i] * 3 + 1;
+    }
+}
+
+// The data of the lowest rank is the first operand of every reduction
+static void combine(char *acc, int64_t acc_rank, const char *data, int64_t data_rank)
+{
+    char tmp[MAX_EXPR_LEN];
+    strcpy(tmp, "(");
+    strcat(tmp, acc_rank < data_rank ? acc : data);
+    strcat(tmp, "+");
+    strcat(tmp, acc_rank < data_rank ? data : acc);
+    strcat(tmp, ")");
+    strcpy(acc, tmp);
+}
+
+static int check_leaders(const int64_t *sp_ids, int64_t group_size, const int64_t *leaders, size_t num_leaders)
+{
+    size_t num_sps = 0, l;
+    int64_t i, j;
+
+    for (i = 0; i < group_size; i++)
+    {
+        bool first_of_sp = true;
+        for (j = 0; j < i && first_of_sp; j++)
+        {
+            if (sp_ids[j] == sp_ids[i])
+                first_of_sp = false;
+        }
+        if (!first_of_sp)
+            continue;
+        if (num_sps >= num_leaders || leaders[num_sps] != i)
+        {
+            fprintf(stderr, "rank %" PRId64 " is not leader %zu\n", i, num_sps);
+            return EXIT_FAILURE;
+        }
+        num_sps++;
+    }
+    if (num_sps != num_leaders)
+    {
+        fprintf(stderr, "%zu leaders instead of %zu\n", num_leaders, num_sps);
+        return EXIT_FAILURE;
+    }
+    for (l = 1; l < num_leaders; l++)
+    {
+        if (leaders[l] <= leaders[l - 1])
+        {
+            fprintf(stderr, "leaders are not in rank order\n");
+            return EXIT_FAILURE;
+        }
+    }
+    return EXIT_SUCCESS;
+}
+
+// Simulate the exchange between the leaders as done by the allreduce, step by step
+static int check_steps(const int64_t *leaders, size_t num_leaders)
+{
+    static char data[MAX_GROUP_SIZE][MAX_EXPR_LEN];
+    static char in[MAX_GROUP_SIZE][MAX_EXPR_LEN];
+    size_t num_steps = allreduce_get_num_steps(num_leaders);
+    size_t p2 = (size_t)1 << num_steps;
+    size_t l, step;
+
+    if (p2 > num_leaders || p2 * 2 <= num_leaders)
+    {
+        fprintf(stderr, "%zu steps for %zu leaders\n", num_steps, num_leaders);
+        return EXIT_FAILURE;
+    }
+    for (l = 0; l < num_leaders; l++)
+        snprintf(data[l], MAX_EXPR_LEN, "%" PRId64, leaders[l]);
+
+    for (step = 0; step <= num_steps; step++)
+    {
+        for (l = 0; l < num_leaders; l++)
+        {
+            int64_t peer = allreduce_get_step_peer(num_leaders, l, step);
+            in[l][0] = '\0';
+            if (peer == -1)
+            {
+                if ((step == 0 && l < p2 && l + p2 < num_leaders) || (step > 0 && l < p2))
+                {
+                    fprintf(stderr, "leader %zu has no peer at step %zu\n", l, step);
+                    return EXIT_FAILURE;
+                }
+                continue;
+            }
+            if (peer < 0 || (size_t)peer >= num_leaders || (size_t)peer == l ||
+                allreduce_get_step_peer(num_leaders, (size_t)peer, step) != (int64_t)l)
+            {
+                fprintf(stderr, "leader %zu and its peer %" PRId64 " at step %zu do not match\n", l, peer, step);
+                return EXIT_FAILURE;
+            }
+            // During the fold, only the leaders below the largest power of two receive data
+            if (step > 0 || l < p2)
+                strcpy(in[l], data[peer]);
+        }
+        for (l = 0; l < num_leaders; l++)
+        {
+            int64_t peer = allreduce_get_step_peer(num_leaders, l, step);
+            if (in[l][0] != '\0')
+                combine(data[l], leaders[l], in[l], leaders[peer]);
+        }
+    }
+    // The leaders that folded their data get the result of their peer
+    for (l = p2; l < num_leaders; l++)
+        strcpy(data[l], data[allreduce_get_step_peer(num_leaders, l, 0)]);
+
+    for (l = 0; l < num_leaders; l++)
+    {
+        size_t k;
+        for (k = 0; k < num_leaders; k++)
+        {
+            char leader_str[32];
+            snprintf(leader_str, sizeof(leader_str), "%" PRId64, leaders[k]);
+            // The expressions only contain leaders, parentheses and '+'
+            const char *p = data[l];
+            size_t n = 0, len = strlen(leader_str);
+            while ((p = strstr(p, leader_str)) != NULL)
+            {
+                if ((p == data[l] || p[-1] == '(' || p[-1] == '+') && (p[len] == '\0' || p[len] == ')' || p[len] == '+'))
+                    n++;
+                p += len;
+            }
+            if (n != 1)
+            {
+                fprintf(stderr, "leader %zu has the data of leader %zu %zu times: %s\n", l, k, n, data[l]);
+                return EXIT_FAILURE;
+            }
+        }
+        if (strcmp(data[l], data[0]) != 0)
+        {
+            fprintf(stderr, "leaders 0 and %zu reduced the data in a different order: %s vs. %s\n", l, data[0], data[l]);
+            return EXIT_FAILURE;
+        }
+    }
+    return EXIT_SUCCESS;
+}
+
+int main(int argc, char **argv)
+{
+    int64_t sp_ids[MAX_GROUP_SIZE];
+    int64_t leaders[MAX_GROUP_SIZE];
+    int64_t group_size, num_sps;
+    size_t num_leaders;
+    int placement;
+
+    // Out of range leaders and steps do not exchange anything
+    if (allreduce_get_step_peer(4, 4, 1) != -1 || allreduce_get_step_peer(4, 0, 3) != -1)
+    {
+        fprintf(stderr, "invalid leader or step has a peer\n");
+        return EXIT_FAILURE;
+    }
+
+    for (group_size = 1; group_size <= MAX_GROUP_SIZE; group_size++)
+    {
+        for (num_sps = 1; num_sps <= group_size; num_sps++)
+        {
+            for (placement = 0; placement < PLACEMENT_LAST; placement++)
+            {
+                place_ranks((placement_t)placement, group_size, num_sps, sp_ids);
+                num_leaders = allreduce_get_leaders(sp_ids, group_size, leaders);
+                if (check_leaders(sp_ids, group_size, leaders, num_leaders) != EXIT_SUCCESS ||
+                    check_steps(leaders, num_leaders) != EXIT_SUCCESS)
+                {
+                    fprintf(stderr, "ERROR: invalid schedule for %" PRId64 " ranks on %" PRId64 " service processes (%s)\n",
+                            group_size, num_sps, placement_names[placement]);
+                    return EXIT_FAILURE;
+                }
+            }
+        }
+    }
+
+    fprintf(stdout, "%s: test succeeded\n", argv[0]);
+    return EXIT_SUCCESS;
+}
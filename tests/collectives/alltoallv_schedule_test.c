@@ -0,0 +1,174 @@
+//
+// Copyright (c) 2023, NVIDIA CORPORATION. All rights reserved.
+//
+// See LICENSE.txt for license information
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <dpu_offload_collectives.h>
+
+/*
+ * Check the order in which the operations of an alltoallv send their ready-to-receive (RTR) messages
+ * for various placements of the ranks on hosts and various counts: every rank sends exactly one RTR to
+ * each rank it receives data from, to the ranks on other hosts first, in rank order starting after
+ * itself; when all the ranks are on the same host, no two ranks target the same peer at the same
+ * time. To run the test, simply execute: $ ./alltoallv_schedule_test
+ */
+
+#define MAX_GROUP_SIZE (32)
+#define MAX_HOSTS (4)
+
+typedef enum
+{
+    COUNTS_ALL = 0, // Data from every rank, including itself
+    COUNTS_NO_SELF, // Data from every rank but itself
+    COUNTS_SPARSE,  // Data from some of the ranks only
+    COUNTS_LAST,
+} counts_t;
+
+static void set_counts(counts_t counts, int64_t group_rank, int64_t group_size, int64_t *recvcounts)
+{
+    int64_t i;
+    for (i = 0; i < group_size; i++)
+    {
+        switch (counts)
+        {
+        case COUNTS_ALL:
+            recvcounts[i] = i + 1;
+            break;
+        case COUNTS_NO_SELF:
+            recvcounts[i] = i == group_rank ? 0 : 1;
+            break;
+        default:
+            recvcounts[i] = (i + group_rank) % 3 == 0 ? 0 : 2;
+            break;
+        }
+    }
+}
+
+// Distance from a rank to a peer, in rank order starting after the rank
+static int64_t distance(int64_t group_rank, int64_t group_size, int64_t peer)
+{
+    int64_t d = (peer - group_rank + group_size) % group_size;
+    return d == 0 ? group_size : d;
+}
+
+static int check_order(int64_t group_rank, int64_t group_size, const int64_t *recvcounts, const uint64_t *hosts)
+{
+    int64_t order[MAX_GROUP_SIZE];
+    size_t num_rtrs, expected = 0, i;
+    int seen[MAX_GROUP_SIZE];
+    bool prev_remote, remote;
+    int64_t peer;
+
+    num_rtrs = alltoallv_get_rtr_order(group_rank, group_size, recvcounts, hosts, order);
+    for (peer = 0; peer < group_size; peer++)
+    {
+        if (recvcounts[peer] > 0)
+            expected++;
+    }
+    if (num_rtrs != expected)
+    {
+        fprintf(stderr, "rank %" PRId64 " sends %zu RTRs instead of %zu\n", group_rank, num_rtrs, expected);
+        return EXIT_FAILURE;
+    }
+
+    memset(seen, 0, sizeof(seen));
+    for (i = 0; i < num_rtrs; i++)
+    {
+        if (order[i] < 0 || order[i] >= group_size || recvcounts[order[i]] == 0 || seen[order[i]])
+        {
+            fprintf(stderr, "rank %" PRId64 " sends an unexpected RTR to rank %" PRId64 "\n", group_rank, order[i]);
+            return EXIT_FAILURE;
+        }
+        seen[order[i]] = 1;
+        if (i == 0)
+            continue;
+        // Peers on other hosts first, then in rank order starting after the rank
+        prev_remote = hosts[order[i - 1]] != hosts[group_rank];
+        remote = hosts[order[i]] != hosts[group_rank];
+        if ((remote && !prev_remote) ||
+            (remote == prev_remote && distance(group_rank, group_size, order[i]) < distance(group_rank, group_size, order[i - 1])))
+        {
+            fprintf(stderr, "rank %" PRId64 " sends its RTR to rank %" PRId64 " after rank %" PRId64 "\n", group_rank, order[i], order[i - 1]);
+            return EXIT_FAILURE;
+        }
+    }
+    return EXIT_SUCCESS;
+}
+
+// With all the ranks on the same host, the peers targeted by the ranks at every step are all different
+static int check_spread(int64_t group_size)
+{
+    static int64_t orders[MAX_GROUP_SIZE][MAX_GROUP_SIZE];
+    int64_t recvcounts[MAX_GROUP_SIZE];
+    uint64_t hosts[MAX_GROUP_SIZE];
+    int64_t r;
+    size_t step;
+
+    for (r = 0; r < group_size; r++)
+        hosts[r] = 0;
+    for (r = 0; r < group_size; r++)
+    {
+        set_counts(COUNTS_ALL, r, group_size, recvcounts);
+        alltoallv_get_rtr_order(r, group_size, recvcounts, hosts, orders[r]);
+    }
+    for (step = 0; step < (size_t)group_size; step++)
+    {
+        int targeted[MAX_GROUP_SIZE];
+        memset(targeted, 0, sizeof(targeted));
+        for (r = 0; r < group_size; r++)
+        {
+            if (targeted[orders[r][step]])
+            {
+                fprintf(stderr, "rank %" PRId64 " is targeted twice at step %zu\n", orders[r][step], step);
+                return EXIT_FAILURE;
+            }
+            targeted[orders[r][step]] = 1;
+        }
+    }
+    return EXIT_SUCCESS;
+}
+
+int main(int argc, char **argv)
+{
+    int64_t recvcounts[MAX_GROUP_SIZE];
+    uint64_t hosts[MAX_GROUP_SIZE];
+    int64_t group_size, group_rank, i;
+    size_t num_hosts;
+    int counts;
+
+    for (group_size = 1; group_size <= MAX_GROUP_SIZE; group_size++)
+    {
+        if (check_spread(group_size) != EXIT_SUCCESS)
+        {
+            fprintf(stderr, "ERROR: RTRs of %" PRId64 " ranks are not spread\n", group_size);
+            return EXIT_FAILURE;
+        }
+        for (num_hosts = 1; num_hosts <= MAX_HOSTS; num_hosts++)
+        {
+            // Block placement for an even number of hosts, cyclic otherwise
+            for (i = 0; i < group_size; i++)
+                hosts[i] = num_hosts % 2 == 0 ? (uint64_t)(i * num_hosts / group_size) : (uint64_t)(i % num_hosts);
+            for (group_rank = 0; group_rank < group_size; group_rank++)
+            {
+                for (counts = 0; counts < COUNTS_LAST; counts++)
+                {
+                    set_counts((counts_t)counts, group_rank, group_size, recvcounts);
+                    if (check_order(group_rank, group_size, recvcounts, hosts) != EXIT_SUCCESS)
+                    {
+                        fprintf(stderr, "ERROR: invalid RTR order for rank %" PRId64 " of %" PRId64 " on %zu hosts\n",
+                                group_rank, group_size, num_hosts);
+                        return EXIT_FAILURE;
+                    }
+                }
+            }
+        }
+    }
+
+    fprintf(stdout, "%s: test succeeded\n", argv[0]);
+    return EXIT_SUCCESS;
+}
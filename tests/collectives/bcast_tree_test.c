@@ -0,0 +1,188 @@
+//
+// Copyright (c) 2023, NVIDIA CORPORATION. All rights reserved.
+//
+// See LICENSE.txt for license information
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <dpu_offload_collectives.h>
+
+/*
+ * Check the trees of the segmented broadcast: for chains and k-nomial trees of various radixes, every
+ * number of service processes up to MAX_SPS and every root, each service process other than the root
+ * must have exactly one parent, the root none, and the data must reach all of them within the expected
+ * depth. A few trees are also compared to their known shape. To run the test, simply execute:
+ * $ ./bcast_tree_test
+ */
+
+#define MAX_SPS (64)
+#define MAX_RADIX (5)
+
+typedef struct expected_tree
+{
+    bcast_tree_t tree;
+    size_t radix;
+    size_t num_sps;
+    uint64_t root;
+    uint64_t me;
+    size_t num_children;
+    uint64_t children[MAX_SPS];
+} expected_tree_t;
+
+static const expected_tree_t expected_trees[] = {
+    {BCAST_TREE_KNOMIAL, 2, 8, 0, 0, 3, {4, 2, 1}},
+    {BCAST_TREE_KNOMIAL, 2, 8, 0, 4, 2, {6, 5}},
+    {BCAST_TREE_KNOMIAL, 2, 8, 0, 7, 0, {0}},
+    {BCAST_TREE_KNOMIAL, 2, 8, 3, 3, 3, {7, 5, 4}},
+    {BCAST_TREE_KNOMIAL, 2, 8, 3, 7, 2, {1, 0}},
+    {BCAST_TREE_KNOMIAL, 2, 5, 0, 0, 3, {4, 2, 1}},
+    {BCAST_TREE_KNOMIAL, 3, 9, 0, 0, 4, {3, 6, 1, 2}},
+    {BCAST_TREE_KNOMIAL, 3, 9, 0, 6, 2, {7, 8}},
+    {BCAST_TREE_CHAIN, 2, 4, 2, 2, 1, {3}},
+    {BCAST_TREE_CHAIN, 2, 4, 2, 3, 1, {0}},
+    {BCAST_TREE_CHAIN, 2, 4, 2, 1, 0, {0}},
+    {BCAST_TREE_KNOMIAL, 2, 1, 0, 0, 0, {0}},
+};
+
+static int check_expected_trees(void)
+{
+    uint64_t children[MAX_SPS];
+    size_t i, j, n;
+
+    for (i = 0; i < sizeof(expected_trees) / sizeof(expected_trees[0]); i++)
+    {
+        const expected_tree_t *t = &(expected_trees[i]);
+        n = bcast_get_children(t->tree, t->radix, t->num_sps, t->root, t->me, children);
+        if (n != t->num_children)
+        {
+            fprintf(stderr, "service process %" PRIu64 " of tree %zu has %zu children instead of %zu\n", t->me, i, n, t->num_children);
+            return EXIT_FAILURE;
+        }
+        for (j = 0; j < n; j++)
+        {
+            if (children[j] != t->children[j])
+            {
+                fprintf(stderr, "child %zu of service process %" PRIu64 " of tree %zu is %" PRIu64 " instead of %" PRIu64 "\n",
+                        j, t->me, i, children[j], t->children[j]);
+                return EXIT_FAILURE;
+            }
+        }
+    }
+    return EXIT_SUCCESS;
+}
+
+// Maximum depth of a service process in a tree of num_sps service processes
+static size_t max_depth(bcast_tree_t tree, size_t radix, size_t num_sps)
+{
+    size_t depth = 0, reached = 1;
+    if (tree == BCAST_TREE_CHAIN)
+        return num_sps - 1;
+    while (reached < num_sps)
+    {
+        reached *= radix;
+        depth++;
+    }
+    return depth;
+}
+
+static int check_tree(bcast_tree_t tree, size_t radix, size_t num_sps, uint64_t root)
+{
+    uint64_t children[MAX_SPS];
+    uint64_t queue[MAX_SPS];
+    size_t num_parents[MAX_SPS];
+    size_t depth[MAX_SPS];
+    size_t head = 0, tail = 0, i, n;
+
+    memset(num_parents, 0, sizeof(num_parents));
+    for (i = 0; i < num_sps; i++)
+    {
+        size_t j;
+        n = bcast_get_children(tree, radix, num_sps, root, i, children);
+        if ((tree == BCAST_TREE_CHAIN && n > 1) || n >= num_sps)
+        {
+            fprintf(stderr, "service process %zu has %zu children\n", i, n);
+            return EXIT_FAILURE;
+        }
+        for (j = 0; j < n; j++)
+        {
+            if (children[j] >= num_sps || children[j] == i || children[j] == root)
+            {
+                fprintf(stderr, "invalid child %" PRIu64 " of service process %zu\n", children[j], i);
+                return EXIT_FAILURE;
+            }
+            num_parents[children[j]]++;
+        }
+    }
+    for (i = 0; i < num_sps; i++)
+    {
+        if (num_parents[i] != (i == root ? 0 : 1))
+        {
+            fprintf(stderr, "service process %zu has %zu parents\n", i, num_parents[i]);
+            return EXIT_FAILURE;
+        }
+    }
+
+    // Follow the tree from the root, every service process has one parent so it cannot loop
+    queue[tail++] = root;
+    depth[root] = 0;
+    while (head < tail)
+    {
+        uint64_t sp = queue[head++];
+        if (depth[sp] > max_depth(tree, radix, num_sps))
+        {
+            fprintf(stderr, "service process %" PRIu64 " is at depth %zu\n", sp, depth[sp]);
+            return EXIT_FAILURE;
+        }
+        n = bcast_get_children(tree, radix, num_sps, root, sp, children);
+        for (i = 0; i < n; i++)
+        {
+            depth[children[i]] = depth[sp] + 1;
+            queue[tail++] = children[i];
+        }
+    }
+    if (tail != num_sps)
+    {
+        fprintf(stderr, "%zu service processes out of %zu are reached\n", tail, num_sps);
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
+
+int main(int argc, char **argv)
+{
+    size_t radix, num_sps;
+    uint64_t root;
+
+    if (check_expected_trees() != EXIT_SUCCESS)
+    {
+        fprintf(stderr, "ERROR: unexpected tree shape\n");
+        return EXIT_FAILURE;
+    }
+
+    for (num_sps = 1; num_sps <= MAX_SPS; num_sps++)
+    {
+        for (root = 0; root < num_sps; root++)
+        {
+            if (check_tree(BCAST_TREE_CHAIN, 2, num_sps, root) != EXIT_SUCCESS)
+            {
+                fprintf(stderr, "ERROR: invalid chain of %zu service processes rooted at %" PRIu64 "\n", num_sps, root);
+                return EXIT_FAILURE;
+            }
+            for (radix = 2; radix <= MAX_RADIX; radix++)
+            {
+                if (check_tree(BCAST_TREE_KNOMIAL, radix, num_sps, root) != EXIT_SUCCESS)
+                {
+                    fprintf(stderr, "ERROR: invalid %zu-nomial tree of %zu service processes rooted at %" PRIu64 "\n",
+                            radix, num_sps, root);
+                    return EXIT_FAILURE;
+                }
+            }
+        }
+    }
+
+    fprintf(stdout, "%s: test succeeded\n", argv[0]);
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,199 @@
+//
+// Copyright (c) 2023, NVIDIA CORPORATION. All rights reserved.
+//
+// See LICENSE.txt for license information
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include <dpu_offload_collectives.h>
+
+/*
+ * Check the reduction kernels against a scalar reference for all the operations and datatypes, with
+ * counts that are not multiples of the vector size and unaligned buffers, then measure their
+ * throughput. To run the test, simply execute: $ ./reduce_kernels_test
+ */
+
+#define MAX_COUNT (1031)
+#define PERF_COUNT (1024 * 1024)
+#define PERF_ITERS (50)
+
+static const char *op_names[REDUCE_OP_LAST] = {"sum", "prod", "min", "max"};
+static const char *dt_names[REDUCE_DT_LAST] = {"int32", "int64", "float", "double"};
+
+#define REFERENCE(_type, _op, _a, _b, _count)                                           \
+    do                                                                                  \
+    {                                                                                   \
+        size_t _i;                                                                      \
+        for (_i = 0; _i < (_count); _i++)                                               \
+        {                                                                               \
+            _type _x = ((_type *)(_a))[_i], _y = ((_type *)(_b))[_i];                   \
+            switch (_op)                                                                \
+            {                                                                           \
+            case REDUCE_OP_SUM:                                                         \
+                ((_type *)(_a))[_i] = _x + _y;                                          \
+                break;                                                                  \
+            case REDUCE_OP_PROD:                                                        \
+                ((_type *)(_a))[_i] = _x * _y;                                          \
+                break;                                                                  \
+            case REDUCE_OP_MIN:                                                         \
+                ((_type *)(_a))[_i] = _x < _y ? _x : _y;                                \
+                break;                                                                  \
+            default:                                                                    \
+                ((_type *)(_a))[_i] = _x > _y ? _x : _y;                                \
+                break;                                                                  \
+            }                                                                           \
+        }                                                                               \
+    } while (0)
+
+#define FILL(_type, _buf, _count, _seed)                                                \
+    do                                                                                  \
+    {                                                                                   \
+        size_t _i;                                                                      \
+        for (_i = 0; _i < (_count); _i++)                                               \
+            ((_type *)(_buf))[_i] = (_type)((int)((_i * 7 + (_seed)) % 23) - 11);       \
+    } while (0)
+
+static void fill(reduce_dt_t dt, void *buf, size_t count, size_t seed)
+{
+    switch (dt)
+    {
+    case REDUCE_DT_INT32:
+        FILL(int32_t, buf, count, seed);
+        break;
+    case REDUCE_DT_INT64:
+        FILL(int64_t, buf, count, seed);
+        break;
+    case REDUCE_DT_FLOAT:
+        FILL(float, buf, count, seed);
+        break;
+    default:
+        FILL(double, buf, count, seed);
+        break;
+    }
+}
+
+static void reference(reduce_op_t op, reduce_dt_t dt, void *inout, void *in, size_t count)
+{
+    switch (dt)
+    {
+    case REDUCE_DT_INT32:
+        REFERENCE(int32_t, op, inout, in, count);
+        break;
+    case REDUCE_DT_INT64:
+        REFERENCE(int64_t, op, inout, in, count);
+        break;
+    case REDUCE_DT_FLOAT:
+        REFERENCE(float, op, inout, in, count);
+        break;
+    default:
+        REFERENCE(double, op, inout, in, count);
+        break;
+    }
+}
+
+static int check_kernel(reduce_op_t op, reduce_dt_t dt, size_t count, size_t offset)
+{
+    size_t dt_size = reduce_dt_size(dt);
+    // Extra room to shift the buffers and get unaligned addresses
+    uint8_t *a = malloc(MAX_COUNT * dt_size + 8);
+    uint8_t *b = malloc(MAX_COUNT * dt_size + 8);
+    uint8_t *expected = malloc(MAX_COUNT * dt_size);
+    int rc = 0;
+
+    if (a == NULL || b == NULL || expected == NULL)
+    {
+        fprintf(stderr, "ERROR: unable to allocate memory\n");
+        rc = -1;
+        goto out;
+    }
+    fill(dt, a + offset, count, 3);
+    fill(dt, b + offset, count, 5);
+    memcpy(expected, a + offset, count * dt_size);
+    reference(op, dt, expected, b + offset, count);
+    if (reduce_kernel(op, dt, a + offset, b + offset, count) != DO_SUCCESS)
+    {
+        fprintf(stderr, "ERROR: reduce_kernel() failed for %s/%s\n", op_names[op], dt_names[dt]);
+        rc = -1;
+        goto out;
+    }
+    if (memcmp(expected, a + offset, count * dt_size) != 0)
+    {
+        fprintf(stderr, "ERROR: invalid result for %s/%s, count=%zu, offset=%zu\n", op_names[op], dt_names[dt], count, offset);
+        rc = -1;
+    }
+out:
+    free(a);
+    free(b);
+    free(expected);
+    return rc;
+}
+
+static double measure_throughput(reduce_op_t op, reduce_dt_t dt)
+{
+    size_t len = PERF_COUNT * reduce_dt_size(dt);
+    void *a = malloc(len);
+    void *b = malloc(len);
+    struct timespec start, end;
+    double elapsed;
+    size_t i;
+
+    if (a == NULL || b == NULL)
+    {
+        free(a);
+        free(b);
+        return 0;
+    }
+    fill(dt, a, PERF_COUNT, 1);
+    fill(dt, b, PERF_COUNT, 2);
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (i = 0; i < PERF_ITERS; i++)
+        reduce_kernel(op, dt, a, b, PERF_COUNT);
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    elapsed = (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) / 1e9;
+    free(a);
+    free(b);
+    // Bytes read from both operands
+    return (2.0 * len * PERF_ITERS) / elapsed / 1e9;
+}
+
+int main(int argc, char **argv)
+{
+    int op, dt;
+    size_t count, offset;
+
+    for (op = 0; op < REDUCE_OP_LAST; op++)
+    {
+        for (dt = 0; dt < REDUCE_DT_LAST; dt++)
+        {
+            for (count = 0; count <= MAX_COUNT; count += (count < 67 ? 1 : 241))
+            {
+                for (offset = 0; offset < 8; offset += 3)
+                {
+                    if (check_kernel(op, dt, count, offset) != 0)
+                        return EXIT_FAILURE;
+                }
+            }
+        }
+    }
+
+    if (reduce_kernel(REDUCE_OP_LAST, REDUCE_DT_INT32, NULL, NULL, 0) != DO_ERROR ||
+        reduce_kernel(REDUCE_OP_SUM, REDUCE_DT_LAST, NULL, NULL, 0) != DO_ERROR)
+    {
+        fprintf(stderr, "ERROR: invalid operation or datatype not detected\n");
+        return EXIT_FAILURE;
+    }
+
+    fprintf(stdout, "Throughput (%d elements, GB/s):\n", PERF_COUNT);
+    for (op = 0; op < REDUCE_OP_LAST; op++)
+    {
+        for (dt = 0; dt < REDUCE_DT_LAST; dt++)
+            fprintf(stdout, "\t%s/%s: %.2f\n", op_names[op], dt_names[dt], measure_throughput(op, dt));
+    }
+
+    fprintf(stdout, "%s: test succeeded\n", argv[0]);
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,262 @@
+//
+// Copyright (c) 2023, NVIDIA CORPORATION. All rights reserved.
+//
+// See LICENSE.txt for license information
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "dpu_offload_service_daemon.h"
+#include "dpu_offload_event_channels.h"
+#include "dpu_offload_ops.h"
+#include "dpu_offload_collectives.h"
+
+/*
+ * Offloaded allreduce through the self execution context: the process acts as a service process and
+ * as the ranks of a group, all associated to it, so the algorithm can be checked and measured on a
+ * single Linux box. To run the test, simply execute: $ ./self_allreduce
+ */
+
+#define ALLREDUCE_GROUP_UID (42)
+#define NUM_RANKS (4)
+#define NUM_ELTS (100000)
+#define NUM_ITERS (10)
+#define FAKE_HOST_UID (1234)
+
+extern dpu_offload_status_t register_default_notifications(dpu_offload_ev_sys_t *);
+
+// Create a dummy configuration with a single host and service process, the local one
+static int create_dummy_config(offloading_engine_t *engine)
+{
+    remote_service_proc_info_t *sp = NULL;
+    host_info_t *host_info = NULL;
+    khiter_t host_key;
+    int ret;
+
+    engine->config = malloc(sizeof(offloading_config_t));
+    if (engine->config == NULL)
+        return -1;
+    INIT_DPU_CONFIG_DATA(engine->config);
+    host_info = DYN_ARRAY_GET_ELT(&(engine->config->hosts_config), 0, host_info_t);
+    host_info->idx = 0;
+    host_info->hostname = strdup("dummy");
+    host_info->uid = FAKE_HOST_UID;
+    host_key = kh_put(host_info_hash_t, engine->config->host_lookup_table, FAKE_HOST_UID, &ret);
+    kh_value(engine->config->host_lookup_table, host_key) = host_info;
+    engine->config->num_hosts = 1;
+
+    sp = DYN_ARRAY_GET_ELT(GET_ENGINE_LIST_SERVICE_PROCS(engine), 0, remote_service_proc_info_t);
+    sp->offload_engine = engine;
+    sp->idx = 0;
+    sp->service_proc.global_id = 0;
+    sp->service_proc.local_id = 0;
+    engine->num_service_procs = 1;
+
+    engine->on_dpu = true;
+    engine->config->local_service_proc.info.global_id = 0;
+    engine->config->local_service_proc.host_uid = FAKE_HOST_UID;
+    return 0;
+}
+
+static void destroy_dummy_config(offloading_engine_t *engine)
+{
+    host_info_t *host_info = DYN_ARRAY_GET_ELT(&(engine->config->hosts_config), 0, host_info_t);
+    if (host_info != NULL && host_info->hostname != NULL)
+    {
+        free(host_info->hostname);
+        host_info->hostname = NULL;
+    }
+}
+
+// Add the ranks of the group to the cache, all of them associated to the local service process
+static dpu_offload_status_t populate_cache(offloading_engine_t *engine)
+{
+    size_t rank;
+    for (rank = 0; rank < NUM_RANKS; rank++)
+    {
+        peer_cache_entry_t entry;
+        dpu_offload_event_t *ev = NULL;
+        dpu_offload_status_t rc;
+
+        memset(&entry, 0, sizeof(entry));
+        entry.set = true;
+        entry.peer.proc_info.group_uid = ALLREDUCE_GROUP_UID;
+        entry.peer.proc_info.group_rank = rank;
+        entry.peer.proc_info.group_size = NUM_RANKS;
+        entry.peer.proc_info.n_local_ranks = NUM_RANKS;
+        entry.peer.proc_info.local_rank = rank;
+        entry.peer.proc_info.host_info = FAKE_HOST_UID;
+        entry.peer.host_info = FAKE_HOST_UID;
+        entry.peer.addr_len = 8;
+        strcpy(entry.peer.addr, "deadbeef");
+        entry.num_shadow_service_procs = 1;
+        entry.shadow_service_procs[0] = 0;
+
+        rc = event_get(engine->self_econtext->event_channels, NULL, &ev);
+        if (rc != DO_SUCCESS)
+        {
+            fprintf(stderr, "ERROR: event_get() failed\n");
+            return DO_ERROR;
+        }
+        rc = event_channel_emit_with_payload(&ev, AM_PEER_CACHE_ENTRIES_MSG_ID, engine->self_ep, 0, NULL, &entry, sizeof(entry));
+        if (rc != DO_SUCCESS)
+        {
+            fprintf(stderr, "ERROR: event_channel_emit_with_payload() failed\n");
+            return DO_ERROR;
+        }
+    }
+    return DO_SUCCESS;
+}
+
+static int run_allreduce(offloading_engine_t *engine, uint64_t id, reduce_op_t op)
+{
+    double *sendbufs[NUM_RANKS], *recvbufs[NUM_RANKS];
+    op_desc_t *descs[NUM_RANKS];
+    dpu_offload_status_t rc;
+    size_t r, i, n_completed = 0;
+    int ret = -1;
+
+    memset(sendbufs, 0, sizeof(sendbufs));
+    memset(recvbufs, 0, sizeof(recvbufs));
+    memset(descs, 0, sizeof(descs));
+    for (r = 0; r < NUM_RANKS; r++)
+    {
+        sendbufs[r] = malloc(NUM_ELTS * sizeof(double));
+        recvbufs[r] = malloc(NUM_ELTS * sizeof(double));
+        if (sendbufs[r] == NULL || recvbufs[r] == NULL)
+        {
+            fprintf(stderr, "ERROR: unable to allocate memory\n");
+            goto out;
+        }
+        for (i = 0; i < NUM_ELTS; i++)
+        {
+            sendbufs[r][i] = (double)(r + i);
+            recvbufs[r][i] = -1;
+        }
+    }
+
+    for (r = 0; r < NUM_RANKS; r++)
+    {
+        allreduce_params_t params = {
+            .gp_uid = ALLREDUCE_GROUP_UID,
+            .group_rank = r,
+            .group_size = NUM_RANKS,
+            .op = op,
+            .dt = REDUCE_DT_DOUBLE,
+            .count = NUM_ELTS,
+            .sendbuf = sendbufs[r],
+            .recvbuf = recvbufs[r],
+        };
+        rc = allreduce_post(engine->self_econtext, id, &params, &descs[r]);
+        if (rc != DO_SUCCESS)
+        {
+            fprintf(stderr, "ERROR: allreduce_post() failed for rank %ld\n", r);
+            goto out;
+        }
+    }
+
+    while (n_completed < NUM_RANKS)
+    {
+        offload_engine_progress(engine);
+        n_completed = 0;
+        for (r = 0; r < NUM_RANKS; r++)
+        {
+            if (descs[r]->completed)
+                n_completed++;
+        }
+    }
+
+    for (r = 0; r < NUM_RANKS; r++)
+    {
+        if (descs[r]->state != OP_STATE_COMPLETED)
+        {
+            fprintf(stderr, "ERROR: allreduce of rank %ld did not complete successfully\n", r);
+            goto out;
+        }
+        for (i = 0; i < NUM_ELTS; i++)
+        {
+            double expected = op == REDUCE_OP_SUM ? (double)(NUM_RANKS * i + (NUM_RANKS * (NUM_RANKS - 1)) / 2) : (double)(NUM_RANKS - 1 + i);
+            if (recvbufs[r][i] != expected)
+            {
+                fprintf(stderr, "ERROR: rank %ld, element %ld is %f instead of %f\n", r, i, recvbufs[r][i], expected);
+                goto out;
+            }
+        }
+    }
+    ret = 0;
+out:
+    for (r = 0; r < NUM_RANKS; r++)
+    {
+        if (descs[r] != NULL && descs[r]->completed)
+            op_desc_return(engine, &descs[r]);
+        free(sendbufs[r]);
+        free(recvbufs[r]);
+    }
+    return ret;
+}
+
+int main(int argc, char **argv)
+{
+    offloading_engine_t *engine = NULL;
+    offloading_config_t *engine_config = NULL;
+    struct timespec start, end;
+    dpu_offload_status_t rc;
+    uint64_t id = 0;
+    size_t i;
+
+    rc = offload_engine_init(&engine);
+    if (rc || engine == NULL)
+    {
+        fprintf(stderr, "offload_engine_init() failed\n");
+        goto error_out;
+    }
+    if (create_dummy_config(engine) != 0)
+    {
+        fprintf(stderr, "ERROR: create_dummy_config() failed\n");
+        goto error_out;
+    }
+    engine_config = engine->config;
+
+    // The self execution context does not register the default event handlers so we explicitly do so
+    rc = register_default_notifications(engine->self_econtext->event_channels);
+    if (rc != DO_SUCCESS)
+    {
+        fprintf(stderr, "ERROR: register_default_notifications() failed\n");
+        goto error_out;
+    }
+    rc = populate_cache(engine);
+    if (rc != DO_SUCCESS)
+        goto error_out;
+
+    if (run_allreduce(engine, id++, REDUCE_OP_SUM) != 0 || run_allreduce(engine, id++, REDUCE_OP_MAX) != 0)
+        goto error_out;
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (i = 0; i < NUM_ITERS; i++)
+    {
+        if (run_allreduce(engine, id++, REDUCE_OP_SUM) != 0)
+            goto error_out;
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    fprintf(stdout, "Allreduce of %d doubles over %d ranks: %.2f us\n",
+            NUM_ELTS,
+            NUM_RANKS,
+            ((end.tv_sec - start.tv_sec) * 1e6 + (end.tv_nsec - start.tv_nsec) / 1e3) / NUM_ITERS);
+
+    destroy_dummy_config(engine);
+    offload_engine_fini(&engine);
+    free(engine_config);
+    fprintf(stdout, "%s: test succeeded\n", argv[0]);
+    return EXIT_SUCCESS;
+
+error_out:
+    if (engine != NULL)
+        offload_engine_fini(&engine);
+    if (engine_config != NULL)
+        free(engine_config);
+    fprintf(stderr, "%s: test failed\n", argv[0]);
+    return EXIT_FAILURE;
+}
@@ -0,0 +1,384 @@
+//
+// Copyright (c) 2023, NVIDIA CORPORATION. All rights reserved.
+//
+// See LICENSE.txt for license information
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "dpu_offload_service_daemon.h"
+#include "dpu_offload_event_channels.h"
+#include "dpu_offload_ops.h"
+
+/*
+ * Scheduling of the operations through the self execution context: the process submits operations
+ * to itself and checks the order in which they are progressed, i.e., by priority, in proportion to
+ * the weight of the queue of their group, within the time budget of a progress call and with a
+ * bounded number of RMA transfers in flight. To run the test, simply execute: $ ./self_ops_scheduler
+ */
+
+#define TEST_ALG_ID (0x5C4ED)
+#define MAX_OPS (64)
+#define MAX_TRACE (4096)
+#define MAX_PROGRESS_CALLS (100000)
+
+// Groups of the operations, one per check so the queues do not share their progress slots
+#define PRIORITY_GROUP_UID (1)
+#define HEAVY_GROUP_UID (2)
+#define LIGHT_GROUP_UID (3)
+#define RMA_GROUP_UID (4)
+#define BUDGET_GROUP_UID (5)
+
+#define HEAVY_WEIGHT (3)
+#define NUM_WEIGHTED_OPS (8)
+#define MAX_RMA (2)
+#define NUM_RMA_OPS (5)
+#define NUM_BUDGET_OPS (4)
+#define BUDGET_US (100)
+#define BUSY_US (300)
+
+extern dpu_offload_status_t register_default_notifications(dpu_offload_ev_sys_t *);
+
+// Behavior of the operation with a given ID
+typedef struct test_op
+{
+    // Number of times the operation is progressed before it completes
+    size_t num_progress;
+    // Hold an RMA slot for that many progress calls before completing
+    size_t rma_hold;
+    // Fail while holding the RMA slot
+    bool fail_with_rma;
+    // Time spent in each progress call, in microseconds
+    uint64_t busy_us;
+
+    size_t progressed;
+    size_t rma_progressed;
+    bool rma_held;
+    bool rma_done;
+} test_op_t;
+
+static test_op_t test_ops[MAX_OPS];
+static uint64_t next_id = 0;
+
+// IDs of the operations in the order they are progressed
+static uint64_t trace[MAX_TRACE];
+static size_t trace_len = 0;
+static size_t max_rma_in_flight = 0;
+
+static uint64_t now_us(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+static dpu_offload_status_t test_op_progress(op_desc_t *desc, bool *completed)
+{
+    offloading_engine_t *engine = desc->econtext->engine;
+    test_op_t *op = &(test_ops[desc->id]);
+
+    if (trace_len < MAX_TRACE)
+        trace[trace_len++] = desc->id;
+    op->progressed++;
+    if (op->busy_us > 0)
+    {
+        uint64_t start = now_us();
+        while (now_us() - start < op->busy_us)
+            ;
+    }
+
+    if (op->rma_hold > 0 && !op->rma_done)
+    {
+        if (!op->rma_held && op_rma_acquire(desc))
+            op->rma_held = true;
+        if (engine->ops_sched.num_rma > max_rma_in_flight)
+            max_rma_in_flight = engine->ops_sched.num_rma;
+        if (op->rma_held && op->fail_with_rma)
+            return DO_ERROR;
+        if (op->rma_held && ++op->rma_progressed > op->rma_hold)
+        {
+            op_rma_release(desc);
+            op->rma_held = false;
+            op->rma_done = true;
+        }
+    }
+
+    *completed = op->progressed >= op->num_progress && (op->rma_hold == 0 || op->rma_done);
+    return DO_SUCCESS;
+}
+
+static op_desc_t *submit_op(offloading_engine_t *engine, uint64_t op_id, group_uid_t gp_uid, op_priority_t priority, test_op_t *behavior)
+{
+    op_desc_t *desc = NULL;
+    uint64_t id = next_id++;
+
+    if (id >= MAX_OPS)
+    {
+        fprintf(stderr, "ERROR: too many operations\n");
+        return NULL;
+    }
+    memcpy(&(test_ops[id]), behavior, sizeof(test_op_t));
+    if (op_desc_get(engine, id, op_id, &desc) != DO_SUCCESS)
+    {
+        fprintf(stderr, "ERROR: op_desc_get() failed\n");
+        return NULL;
+    }
+    desc->gp_uid = gp_uid;
+    desc->group_rank = 0;
+    desc->priority = priority;
+    if (op_desc_submit(engine->self_econtext, desc) != DO_SUCCESS)
+    {
+        fprintf(stderr, "ERROR: op_desc_submit() failed\n");
+        op_desc_return(engine, &desc);
+        return NULL;
+    }
+    return desc;
+}
+
+// Progress the engine until all the operations complete, then return their descriptors
+static int wait_ops(offloading_engine_t *engine, op_desc_t **descs, size_t num_descs, op_state_t expected_state)
+{
+    size_t i, n_completed = 0, n_calls = 0;
+    int ret = 0;
+
+    while (n_completed < num_descs)
+    {
+        if (n_calls++ == MAX_PROGRESS_CALLS)
+        {
+            fprintf(stderr, "ERROR: operations did not complete\n");
+            return -1;
+        }
+        offload_engine_progress(engine);
+        n_completed = 0;
+        for (i = 0; i < num_descs; i++)
+        {
+            if (descs[i]->completed)
+                n_completed++;
+        }
+    }
+    for (i = 0; i < num_descs; i++)
+    {
+        if (descs[i]->state != expected_state)
+        {
+            fprintf(stderr, "ERROR: operation %" PRIu64 " is in state %d instead of %d\n", descs[i]->id, descs[i]->state, expected_state);
+            ret = -1;
+        }
+        op_desc_return(engine, &(descs[i]));
+    }
+    return ret;
+}
+
+// Operations of the highest priority are progressed first, whatever the order they were submitted in
+static int check_priorities(offloading_engine_t *engine, uint64_t op_id)
+{
+    test_op_t behavior = {.num_progress = 2};
+    op_desc_t *descs[OP_NUM_PRIORITIES];
+    int priority;
+
+    trace_len = 0;
+    for (priority = 0; priority < OP_NUM_PRIORITIES; priority++)
+    {
+        descs[priority] = submit_op(engine, op_id, PRIORITY_GROUP_UID, (op_priority_t)priority, &behavior);
+        if (descs[priority] == NULL)
+            return -1;
+    }
+    offload_engine_progress(engine);
+    if (trace_len != OP_NUM_PRIORITIES)
+    {
+        fprintf(stderr, "ERROR: %zu operations progressed instead of %d\n", trace_len, OP_NUM_PRIORITIES);
+        return -1;
+    }
+    for (priority = 0; priority < OP_NUM_PRIORITIES; priority++)
+    {
+        if (trace[priority] != descs[OP_NUM_PRIORITIES - 1 - priority]->id)
+        {
+            fprintf(stderr, "ERROR: operation of priority %d progressed in position %d\n", OP_NUM_PRIORITIES - 1 - priority, priority);
+            return -1;
+        }
+    }
+    return wait_ops(engine, descs, OP_NUM_PRIORITIES, OP_STATE_COMPLETED);
+}
+
+// Queues get progress slots in proportion to their weight
+static int check_weights(offloading_engine_t *engine, uint64_t op_id)
+{
+    test_op_t behavior = {.num_progress = 3};
+    op_desc_t *descs[2 * NUM_WEIGHTED_OPS];
+    size_t i, n_heavy = 0, round;
+
+    if (op_queue_set_weight(engine, HEAVY_GROUP_UID, HEAVY_WEIGHT) != DO_SUCCESS)
+    {
+        fprintf(stderr, "ERROR: op_queue_set_weight() failed\n");
+        return -1;
+    }
+    trace_len = 0;
+    // Operations of both groups are interleaved in the list of active operations
+    for (i = 0; i < NUM_WEIGHTED_OPS; i++)
+    {
+        descs[2 * i] = submit_op(engine, op_id, HEAVY_GROUP_UID, OP_PRIORITY_NORMAL, &behavior);
+        descs[2 * i + 1] = submit_op(engine, op_id, LIGHT_GROUP_UID, OP_PRIORITY_NORMAL, &behavior);
+        if (descs[2 * i] == NULL || descs[2 * i + 1] == NULL)
+            return -1;
+    }
+    offload_engine_progress(engine);
+    // Every operation is progressed once per call
+    if (trace_len != 2 * NUM_WEIGHTED_OPS)
+    {
+        fprintf(stderr, "ERROR: %zu operations progressed instead of %d\n", trace_len, 2 * NUM_WEIGHTED_OPS);
+        return -1;
+    }
+    // Rounds while both queues have operations left
+    for (round = 0; (round + 1) * HEAVY_WEIGHT <= NUM_WEIGHTED_OPS; round++)
+    {
+        for (i = round * (HEAVY_WEIGHT + 1); i < (round + 1) * (HEAVY_WEIGHT + 1); i++)
+        {
+            if (descs[trace[i] - descs[0]->id]->gp_uid == HEAVY_GROUP_UID)
+                n_heavy++;
+        }
+        if (n_heavy != (round + 1) * HEAVY_WEIGHT)
+        {
+            fprintf(stderr, "ERROR: %zu operations of the heavy queue progressed after %zu rounds\n", n_heavy, round + 1);
+            return -1;
+        }
+    }
+    return wait_ops(engine, descs, 2 * NUM_WEIGHTED_OPS, OP_STATE_COMPLETED);
+}
+
+// At most MIMOSA_OPS_MAX_RMA transfers are in flight and operations that fail give their slots back
+static int check_rma_limit(offloading_engine_t *engine, uint64_t op_id)
+{
+    test_op_t behavior = {.num_progress = 1, .rma_hold = 2};
+    test_op_t failing = {.num_progress = 1, .rma_hold = 2, .fail_with_rma = true};
+    op_desc_t *descs[NUM_RMA_OPS];
+    op_queue_stats_t stats;
+    size_t i;
+
+    engine->settings.ops_max_rma = MAX_RMA;
+    max_rma_in_flight = 0;
+    for (i = 0; i < NUM_RMA_OPS; i++)
+    {
+        descs[i] = submit_op(engine, op_id, RMA_GROUP_UID, OP_PRIORITY_NORMAL, &behavior);
+        if (descs[i] == NULL)
+            return -1;
+    }
+    if (wait_ops(engine, descs, NUM_RMA_OPS, OP_STATE_COMPLETED) != 0)
+        return -1;
+    if (max_rma_in_flight != MAX_RMA || engine->ops_sched.num_rma != 0)
+    {
+        fprintf(stderr, "ERROR: %zu RMA transfers in flight at most and %zu left instead of %d and 0\n",
+                max_rma_in_flight, engine->ops_sched.num_rma, MAX_RMA);
+        return -1;
+    }
+    if (op_queue_get_stats(engine, RMA_GROUP_UID, &stats) != DO_SUCCESS || stats.num_rma != NUM_RMA_OPS || stats.num_rma_throttled == 0)
+    {
+        fprintf(stderr, "ERROR: invalid RMA statistics\n");
+        return -1;
+    }
+
+    descs[0] = submit_op(engine, op_id, RMA_GROUP_UID, OP_PRIORITY_NORMAL, &failing);
+    if (descs[0] == NULL || wait_ops(engine, descs, 1, OP_STATE_FAILED) != 0)
+        return -1;
+    if (engine->ops_sched.num_rma != 0)
+    {
+        fprintf(stderr, "ERROR: the RMA slot of a failed operation was not released\n");
+        return -1;
+    }
+    return 0;
+}
+
+// Operations not progressed when the time budget is exhausted are the first ones next time
+static int check_budget(offloading_engine_t *engine, uint64_t op_id)
+{
+    test_op_t behavior = {.num_progress = 2, .busy_us = BUSY_US};
+    op_desc_t *descs[NUM_BUDGET_OPS];
+    op_queue_stats_t stats;
+    size_t i, j, n_calls = 0;
+
+    engine->settings.ops_progress_budget = BUDGET_US;
+    for (i = 0; i < NUM_BUDGET_OPS; i++)
+    {
+        descs[i] = submit_op(engine, op_id, BUDGET_GROUP_UID, OP_PRIORITY_NORMAL, &behavior);
+        if (descs[i] == NULL)
+            return -1;
+    }
+    trace_len = 0;
+    while (trace_len < NUM_BUDGET_OPS && n_calls++ < MAX_PROGRESS_CALLS)
+    {
+        size_t prev_len = trace_len;
+        offload_engine_progress(engine);
+        if (trace_len > prev_len + 1)
+        {
+            fprintf(stderr, "ERROR: %zu operations progressed within the time budget\n", trace_len - prev_len);
+            return -1;
+        }
+    }
+    for (i = 0; i < trace_len; i++)
+    {
+        for (j = 0; j < i; j++)
+        {
+            if (trace[i] == trace[j])
+            {
+                fprintf(stderr, "ERROR: operation %" PRIu64 " progressed twice before the others\n", trace[i]);
+                return -1;
+            }
+        }
+    }
+    if (op_queue_get_stats(engine, BUDGET_GROUP_UID, &stats) != DO_SUCCESS || stats.num_deferred == 0)
+    {
+        fprintf(stderr, "ERROR: no operation was deferred\n");
+        return -1;
+    }
+    engine->settings.ops_progress_budget = 0;
+    return wait_ops(engine, descs, NUM_BUDGET_OPS, OP_STATE_COMPLETED);
+}
+
+int main(int argc, char **argv)
+{
+    offloading_engine_t *engine = NULL;
+    offload_op_t op = {
+        .alg_id = TEST_ALG_ID,
+        .op_progress = test_op_progress,
+    };
+    dpu_offload_status_t rc;
+    uint64_t op_id;
+
+    rc = offload_engine_init(&engine);
+    if (rc || engine == NULL)
+    {
+        fprintf(stderr, "offload_engine_init() failed\n");
+        goto error_out;
+    }
+
+    // The self execution context does not register the default event handlers so we explicitly do so
+    rc = register_default_notifications(engine->self_econtext->event_channels);
+    if (rc != DO_SUCCESS)
+    {
+        fprintf(stderr, "ERROR: register_default_notifications() failed\n");
+        goto error_out;
+    }
+    rc = register_new_op(engine, &op, &op_id);
+    if (rc != DO_SUCCESS)
+    {
+        fprintf(stderr, "ERROR: register_new_op() failed\n");
+        goto error_out;
+    }
+
+    if (check_priorities(engine, op_id) != 0 ||
+        check_weights(engine, op_id) != 0 ||
+        check_rma_limit(engine, op_id) != 0 ||
+        check_budget(engine, op_id) != 0)
+        goto error_out;
+
+    offload_engine_fini(&engine);
+    fprintf(stdout, "%s: test succeeded\n", argv[0]);
+    return EXIT_SUCCESS;
+
+error_out:
+    if (engine != NULL)
+        offload_engine_fini(&engine);
+    fprintf(stderr, "%s: test failed\n", argv[0]);
+    return EXIT_FAILURE;
+}
@@ -0,0 +1,48 @@
+#!/bin/sh
+#
+
+# -*- shell-script -*-
+#
+# Copyright 2023 NVIDIA CORPORATIONS. All rights reserved.
+#
+# See COPYING in top-level directory.
+#
+# Additional copyrights may follow
+#
+# $HEADER$
+#
+
+# Connection storm benchmark: start many fake ranks at once so they all connect
+# to the service process at the same time, and report how long it takes for all
+# of them to complete their bootstrapping and get the group cache.
+# The service process (e.g., job_persistent_dpu_daemon) must already be running.
+#
+# Usage: ./connection_storm.sh [<dpu_ip> [<dpu_port> [<num_ranks>]]]
+
+DPU_IP=${1:-127.0.0.1}
+DPU_PORT=${2:-8888}
+NUM_RANKS=${3:-256}
+LOGDIR=$(mktemp -d)
+
+echo "Starting $NUM_RANKS fake ranks connecting to $DPU_IP:$DPU_PORT (logs in $LOGDIR)"
+start=$(date +%s%N)
+i=0
+while [ $i -lt $NUM_RANKS ]
+do
+    ./fake_mpi_rank $DPU_IP $DPU_PORT 0 1 $NUM_RANKS $i > $LOGDIR/rank$i.log 2>&1 &
+    i=$((i + 1))
+done
+
+failed=0
+for pid in $(jobs -p)
+do
+    wait $pid || failed=$((failed + 1))
+done
+end=$(date +%s%N)
+
+elapsed_ms=$(((end - start) / 1000000))
+echo "$NUM_RANKS ranks, $failed failed, total time: $elapsed_ms ms"
+if [ $failed -ne 0 ]; then
+    exit 1
+fi
+rm -rf $LOGDIR
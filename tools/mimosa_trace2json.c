@@ -0,0 +1,262 @@
+//
+// Copyright (c) 2023, NVIDIA CORPORATION. All rights reserved.
+//
+// See LICENSE.txt for license information
+//
+
+/*
+ * Convert the bootstrap traces recorded by processes running with MIMOSA_TRACE_DIR set to the
+ * Chrome trace format, which can be loaded in chrome://tracing or https://ui.perfetto.dev.
+ *
+ * Usage: mimosa_trace2json <trace file>... > trace.json
+ *
+ * Each trace file becomes a process. Within a process, each execution context and each client of
+ * a server gets its own track so the phases of the bootstrapping of every connection can be
+ * followed. Timestamps are aligned across nodes with the wall clock and relative to the earliest
+ * event of all the files.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <inttypes.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "dpu_offload_trace.h"
+
+typedef struct trace_file
+{
+    const char *path;
+    void *map;
+    size_t map_len;
+    trace_ring_hdr_t *hdr;
+    trace_record_t *records;
+} trace_file_t;
+
+typedef struct trace_track
+{
+    uint64_t id;
+    uint64_t peer;
+    uint8_t role;
+    uint8_t scope;
+} trace_track_t;
+
+static bool trace_file_open(trace_file_t *file, const char *path)
+{
+    struct stat st;
+    int fd;
+
+    memset(file, 0, sizeof(trace_file_t));
+    file->path = path;
+    fd = open(path, O_RDONLY);
+    if (fd == -1)
+    {
+        fprintf(stderr, "unable to open %s: %s\n", path, strerror(errno));
+        return false;
+    }
+    if (fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(trace_ring_hdr_t))
+    {
+        fprintf(stderr, "%s is not a trace file\n", path);
+        close(fd);
+        return false;
+    }
+    file->map_len = st.st_size;
+    file->map = mmap(NULL, file->map_len, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (file->map == MAP_FAILED)
+    {
+        fprintf(stderr, "mmap() of %s failed: %s\n", path, strerror(errno));
+        return false;
+    }
+    file->hdr = (trace_ring_hdr_t *)file->map;
+    file->records = (trace_record_t *)((char *)file->map + sizeof(trace_ring_hdr_t));
+    if (file->hdr->magic != TRACE_RING_MAGIC ||
+        file->hdr->version != TRACE_RING_VERSION ||
+        file->hdr->record_size != sizeof(trace_record_t) ||
+        file->map_len < sizeof(trace_ring_hdr_t) + file->hdr->capacity * sizeof(trace_record_t))
+    {
+        fprintf(stderr, "%s is not a trace file or was created by an incompatible version\n", path);
+        munmap(file->map, file->map_len);
+        file->map = NULL;
+        return false;
+    }
+    return true;
+}
+
+// Index of the oldest record and number of records of a ring, which may have wrapped around
+static void trace_file_range(trace_file_t *file, uint64_t *first, uint64_t *num)
+{
+    uint64_t head = file->hdr->head;
+    if (head > file->hdr->capacity)
+    {
+        *first = head % file->hdr->capacity;
+        *num = file->hdr->capacity;
+    }
+    else
+    {
+        *first = 0;
+        *num = head;
+    }
+}
+
+static int64_t trace_record_time(trace_file_t *file, trace_record_t *record)
+{
+    return (int64_t)record->ts + file->hdr->clock_offset;
+}
+
+static const char *trace_role_to_str(uint8_t role)
+{
+    switch (role)
+    {
+    case TRACE_ROLE_CLIENT:
+        return "client";
+    case TRACE_ROLE_SERVER:
+        return "server";
+    default:
+        return "process";
+    }
+}
+
+static void trace_track_name(trace_track_t *track, char *name, size_t len)
+{
+    if (track->role == TRACE_ROLE_PROCESS && track->peer == TRACE_NO_PEER)
+        snprintf(name, len, "process");
+    else if (track->role == TRACE_ROLE_PROCESS)
+        snprintf(name, len, "service process #%" PRIu64, track->peer);
+    else if (track->role == TRACE_ROLE_SERVER)
+        snprintf(name, len, "server 0x%" PRIx64 " (scope %u) client #%" PRIu64 " (slot %" PRIu64 ", gen %" PRIu64 ")",
+                 track->id, track->scope, track->peer, (uint64_t)(track->peer & 0xFFFFFFFF), (uint64_t)(track->peer >> 32));
+    else
+        snprintf(name, len, "%s 0x%" PRIx64 " (scope %u)", trace_role_to_str(track->role), track->id, track->scope);
+}
+
+static size_t trace_track_get(trace_track_t **tracks, size_t *num_tracks, size_t *capacity, trace_record_t *record, bool *created)
+{
+    size_t i;
+    *created = false;
+    for (i = 0; i < *num_tracks; i++)
+    {
+        if ((*tracks)[i].id == record->id && (*tracks)[i].peer == record->peer)
+            return i;
+    }
+    if (*num_tracks == *capacity)
+    {
+        *capacity = *capacity == 0 ? 64 : *capacity * 2;
+        *tracks = realloc(*tracks, *capacity * sizeof(trace_track_t));
+        if (*tracks == NULL)
+        {
+            fprintf(stderr, "out of memory\n");
+            exit(EXIT_FAILURE);
+        }
+    }
+    (*tracks)[*num_tracks].id = record->id;
+    (*tracks)[*num_tracks].peer = record->peer;
+    (*tracks)[*num_tracks].role = record->role;
+    (*tracks)[*num_tracks].scope = record->scope;
+    (*num_tracks)++;
+    *created = true;
+    return *num_tracks - 1;
+}
+
+int main(int argc, char **argv)
+{
+    trace_file_t *files;
+    int64_t origin = INT64_MAX;
+    bool first_event = true;
+    int i, num_files = 0;
+
+    if (argc < 2)
+    {
+        fprintf(stderr, "usage: %s <trace file>... > trace.json\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    files = calloc(argc - 1, sizeof(trace_file_t));
+    if (files == NULL)
+    {
+        fprintf(stderr, "out of memory\n");
+        return EXIT_FAILURE;
+    }
+    for (i = 1; i < argc; i++)
+    {
+        if (trace_file_open(&(files[num_files]), argv[i]))
+            num_files++;
+    }
+
+    // Timestamps are relative to the earliest event so they remain readable
+    for (i = 0; i < num_files; i++)
+    {
+        uint64_t first, num, r;
+        trace_file_range(&(files[i]), &first, &num);
+        for (r = 0; r < num; r++)
+        {
+            trace_record_t *record = &(files[i].records[(first + r) % files[i].hdr->capacity]);
+            if (record->ts != 0 && trace_record_time(&(files[i]), record) < origin)
+                origin = trace_record_time(&(files[i]), record);
+        }
+    }
+
+    printf("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[");
+    for (i = 0; i < num_files; i++)
+    {
+        trace_file_t *file = &(files[i]);
+        trace_track_t *tracks = NULL;
+        size_t num_tracks = 0, tracks_capacity = 0;
+        uint64_t first, num, r;
+
+        printf("%s\n{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":%d,\"args\":{\"name\":\"%s:%" PRIu64 "\"}}",
+               first_event ? "" : ",", i, file->hdr->hostname, file->hdr->pid);
+        first_event = false;
+
+        trace_file_range(file, &first, &num);
+        for (r = 0; r < num; r++)
+        {
+            trace_record_t *record = &(file->records[(first + r) % file->hdr->capacity]);
+            const char *ph;
+            bool created;
+            size_t track;
+
+            if (record->ts == 0)
+                continue; // Never written or being written
+            track = trace_track_get(&tracks, &num_tracks, &tracks_capacity, record, &created);
+            if (created)
+            {
+                char name[256];
+                trace_track_name(&(tracks[track]), name, sizeof(name));
+                printf(",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":%d,\"tid\":%zu,\"args\":{\"name\":\"%s\"}}",
+                       i, track, name);
+                printf(",\n{\"name\":\"thread_sort_index\",\"ph\":\"M\",\"pid\":%d,\"tid\":%zu,\"args\":{\"sort_index\":%zu}}",
+                       i, track, track);
+            }
+            switch (record->type)
+            {
+            case TRACE_EVENT_BEGIN:
+                ph = "B";
+                break;
+            case TRACE_EVENT_END:
+                ph = "E";
+                break;
+            default:
+                ph = "i";
+                break;
+            }
+            printf(",\n{\"name\":\"%s\",\"cat\":\"bootstrap\",\"ph\":\"%s\",\"ts\":%.3f,\"pid\":%d,\"tid\":%zu,\"args\":{\"os_tid\":%" PRIu32 "}}",
+                   trace_phase_to_str(record->phase),
+                   ph,
+                   (double)(trace_record_time(file, record) - origin) / 1000.0,
+                   i,
+                   track,
+                   record->tid);
+        }
+        free(tracks);
+        munmap(file->map, file->map_len);
+    }
+    printf("\n]}\n");
+    free(files);
+    return num_files > 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}